@@ -16,10 +16,15 @@
  */
 #include "luaexecutor.h"
 
+#include <QCryptographicHash>
+#include <QHash>
+
 #include <lua/lua.hpp>
 
 #include "luaapi.h"
 #include "luaruntime.h"
+#include "src/settings.h"
+#include "src/thememanager.h"
 
 namespace AddOn {
 
@@ -66,6 +71,15 @@ static QMap<QString, QMap<QString, lua_CFunction>> apiGroups{
          {"format", &luaApi_Util_format}, // (string, ...) -> string
      }}};
 
+// Add-ons are only run in the main thread, so the caches are not locked.
+
+// Compiled chunks (lua_dump), by scriptKey().
+// They are kept in memory only: loading bytecode from files is not safe.
+static QHash<QByteArray, QByteArray> chunkCache;
+
+// Results of theme scripts, by scriptKey() and the desktop settings they can read.
+static QHash<QByteArray, QJsonObject> themeResultCache;
+
 static void registerApiGroup(RaiiLuaState &L, const QString &name) {
     L.push(apiGroups[name]);
     L.setGlobal(name);
@@ -94,11 +108,21 @@ ThemeExecutor::ThemeExecutor() : SimpleExecutor(
 QJsonObject ThemeExecutor::operator()(const QByteArray &script,
                                       const QString &name) {
     using namespace std::chrono_literals;
+    // Theme scripts are run by the theme dialog and again at startup. They
+    // can only read the language and the system app mode, so the result is
+    // reused until one of them is changed.
+    QByteArray key = scriptKey(script, name);
+    key += pSettings->environment().language().toUtf8();
+    key += AppTheme::isSystemInDarkMode() ? "/dark" : "/light";
+    auto it = themeResultCache.constFind(key);
+    if (it != themeResultCache.constEnd())
+        return it.value();
     QJsonValue result = SimpleExecutor::runScript(script, "theme:" + name, 100ms);
-    if (result.isObject() || result.isNull())
-        return result.toObject();
-    else
+    if (!result.isObject() && !result.isNull())
         throw LuaError("Theme script must return an object.");
+    QJsonObject obj = result.toObject();
+    themeResultCache.insert(key, obj);
+    return obj;
 }
 
 SimpleExecutor::SimpleExecutor(const QString &kind, int major, int minor, const QList<QString> &apis)
@@ -124,7 +148,20 @@ QJsonValue SimpleExecutor::runScript(const QByteArray &script,
                                      const QString &name,
                                      std::chrono::microseconds timeLimit) {
     RaiiLuaState L(name, timeLimit);
-    int retLoad = L.loadBuffer(script, name);
+    // reuse the compiled chunk if the script is run before
+    QByteArray key = scriptKey(script, name);
+    auto it = chunkCache.constFind(key);
+    int retLoad;
+    if (it != chunkCache.constEnd()) {
+        retLoad = L.loadBuffer(it.value(), name);
+    } else {
+        retLoad = L.loadBuffer(script, name);
+        if (retLoad == 0) {
+            QByteArray chunk = L.dump();
+            if (!chunk.isEmpty())
+                chunkCache.insert(key, chunk);
+        }
+    }
     if (retLoad != 0)
         throw LuaError(QString("Lua load error: %1.").arg(L.popString()));
     L.setHook(&luaHook_timeoutKiller, LUA_MASKCOUNT, 1'000'000); // ~5ms on early 2020s desktop CPUs
@@ -164,6 +201,16 @@ QJsonValue SimpleExecutor::runScript(const QByteArray &script,
     return L.fetch(1);
 }
 
+QByteArray SimpleExecutor::scriptKey(const QByteArray &script, const QString &name)
+{
+    // the name is the chunk name in the bytecode
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(name.toUtf8());
+    hash.addData("\0", 1);
+    hash.addData(script);
+    return hash.result().toHex();
+}
+
 CompilerHintExecutor::CompilerHintExecutor() : SimpleExecutor(
     "compiler_hint", 0, 2,
     {"C_Debug", "C_Desktop", "C_FileSystem", "C_System", "C_Util"})
@@ -35,6 +35,8 @@ protected:
     QJsonValue runScript(const QByteArray &script, const QString &name,
                          std::chrono::microseconds timeLimit);
 
+    static QByteArray scriptKey(const QByteArray &script, const QString &name);
+
 private:
     QString mKind;
     int mMajor;
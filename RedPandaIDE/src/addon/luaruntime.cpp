@@ -213,6 +213,19 @@ int RaiiLuaState::loadBuffer(const QByteArray &buff, const QString &name)
     return luaL_loadbuffer(mLua, buff.constData(), buff.size(), name.toUtf8().constData());
 }
 
+extern "C" int luaWriter_appendToByteArray(lua_State *L [[maybe_unused]], const void *p, size_t sz, void *ud) noexcept {
+    static_cast<QByteArray *>(ud)->append(static_cast<const char *>(p), sz);
+    return 0;
+}
+
+QByteArray RaiiLuaState::dump()
+{
+    QByteArray result;
+    if (lua_dump(mLua, &luaWriter_appendToByteArray, &result, 0) != 0)
+        return QByteArray();
+    return result;
+}
+
 void RaiiLuaState::openLibs()
 {
     luaL_openlibs(mLua);
@@ -96,6 +96,8 @@ public:
     static int getTop(lua_State *L);
 
     int loadBuffer(const QByteArray &buff, const QString &name);
+    // the bytecode of the function on the top of the stack
+    QByteArray dump();
     void openLibs();
     int pCall(int nargs, int nresults, int msgh);
     int getGlobal(const QString &name);
@@ -283,6 +283,7 @@ void ColorManager::init()
 void ColorManager::reload()
 {
     mSchemes.clear();
+    mSchemeFiles.clear();
     //bundled schemes ( the lowest priority)
     loadSchemesInDir(mDirSettings->data(DirSettings::DataType::ColorScheme),true,false);
     //config schemes ( higher priority)
@@ -294,8 +295,11 @@ void ColorManager::reload()
 QStringList ColorManager::getSchemes(const QString &themeType)
 {
     if (themeType.isEmpty()) {
-        return mSchemes.keys();
+        QStringList lst = mSchemes.keys() + mSchemeFiles.keys();
+        lst.sort();
+        return lst;
     }
+    loadAllSchemes();
     QStringList lst;
     for (const QString &name:mSchemes.keys()) {
         PColorScheme scheme = mSchemes[name];
@@ -313,16 +317,16 @@ QStringList ColorManager::getDefines()
 
 bool ColorManager::exists(const QString name)
 {
-    return mSchemes.contains(name);
+    return mSchemes.contains(name) || mSchemeFiles.contains(name);
 }
 
 QString ColorManager::copy(const QString &sourceName)
 {
-    if (!mSchemes.contains(sourceName))
+    PColorScheme sourceScheme = get(sourceName);
+    if (!sourceScheme)
         return QString();
-    PColorScheme sourceScheme = mSchemes[sourceName];
     QString newName = sourceName+" Copy";
-    if (mSchemes.contains(newName))
+    if (exists(newName))
         return QString();
     // save source with the new name
     QString newFilepath = generateFullPathname(newName,false,false);
@@ -409,22 +413,20 @@ void ColorManager::loadSchemesInDir(const QString &dirName, bool isBundled, bool
             name.replace('_',' ');
             if (!isValidName(name))
                 continue;
-            PColorScheme scheme = ColorScheme::load(fileInfo.absoluteFilePath());
+            // only the file is remembered here, it's loaded in get()
+            SchemeFile schemeFile;
+            schemeFile.filename = fileInfo.absoluteFilePath();
             if (!isCustomed) {
-                scheme->setBundled(isBundled);
-                scheme->setCustomed(false);
+                schemeFile.bundled = isBundled;
+                schemeFile.customed = false;
             } else {
-                scheme->setBundled(false);
-                if (mSchemes.contains(name)) {
-                    PColorScheme oldScheme = mSchemes[name];
-                    if (oldScheme) {
-                        scheme->setBundled(oldScheme->bundled());
-                    }
-                    mSchemes.remove(name);
+                schemeFile.bundled = false;
+                if (mSchemeFiles.contains(name)) {
+                    schemeFile.bundled = mSchemeFiles[name].bundled;
                 }
-                scheme->setCustomed(true);
+                schemeFile.customed = true;
             }
-            mSchemes[name]=scheme;
+            mSchemeFiles[name]=schemeFile;
         }
     }
 }
@@ -598,7 +600,7 @@ void ColorManager::initItemDefines()
 
 bool ColorManager::rename(const QString &oldName, const QString &newName)
 {
-    if (mSchemes.contains(newName))
+    if (exists(newName))
         return false;
     if (!isValidName(newName))
         return false;
@@ -626,7 +628,7 @@ bool ColorManager::rename(const QString &oldName, const QString &newName)
 
 bool ColorManager::add(const QString &name, PColorScheme scheme)
 {
-    if (mSchemes.contains(name))
+    if (exists(name))
         throw FileError(QObject::tr("Scheme '%1' already exists!").arg(name));
     scheme->setBundled(false);
     scheme->setCustomed(false);
@@ -639,7 +641,23 @@ PColorScheme ColorManager::get(const QString &name)
 {
     if (mSchemes.contains(name))
         return mSchemes[name];
-    return PColorScheme();
+    if (!mSchemeFiles.contains(name))
+        return PColorScheme();
+    SchemeFile schemeFile = mSchemeFiles.take(name);
+    PColorScheme scheme = ColorScheme::load(schemeFile.filename);
+    if (!scheme)
+        return PColorScheme();
+    scheme->setBundled(schemeFile.bundled);
+    scheme->setCustomed(schemeFile.customed);
+    mSchemes[name]=scheme;
+    return scheme;
+}
+
+void ColorManager::loadAllSchemes()
+{
+    foreach (const QString& name, mSchemeFiles.keys()) {
+        get(name);
+    }
 }
 
 PColorSchemeItem ColorManager::getItem(const QString &schemeName, const QString &itemName)
@@ -142,6 +142,12 @@ private:
 
 using PColorSchemeItemDefine = std::shared_ptr<ColorSchemeItemDefine>;
 class DirSettings;
+/**
+ * @brief The color schemes in the bundled and the config folders
+ *
+ * Only the names of the schemes are read at startup. A scheme is loaded when
+ * it's used for the first time.
+ */
 class ColorManager {
 public:
     explicit ColorManager(DirSettings *dirSettings);
@@ -172,10 +178,17 @@ private:
     QString generateFullPathname(const QString& name, bool isBundled, bool isCustomed);
     QString generateFilename(const QString& name, bool isCustomed);
     void loadSchemesInDir(const QString& dirName, bool isBundled, bool isCustomed);
+    void loadAllSchemes();
     void initItemDefines();
 private:
+    struct SchemeFile {
+        QString filename;
+        bool bundled;
+        bool customed;
+    };
     QMap<QString,PColorSchemeItemDefine> mSchemeItemDefines;
     QMap<QString,PColorScheme> mSchemes;
+    QMap<QString,SchemeFile> mSchemeFiles; // schemes not loaded yet
     PColorSchemeItemDefine mDefaultSchemeItemDefine;
     DirSettings *mDirSettings;
 };
@@ -17,6 +17,7 @@
 #ifndef COMMON_H
 #define COMMON_H
 #include <QString>
+#include <QVector>
 #include <memory>
 #include <QMetaType>
 
@@ -35,6 +36,14 @@ enum class CompileIssueType {
     Error,
 };
 
+struct CompileIssueFixIt {
+    int line; // starts from 0
+    int column; // in bytes, starts from 0
+    int endLine;
+    int endColumn; // exclusive
+    QString text; // replacement of the range
+};
+
 struct CompileIssue {
     QString filename;
     int line;
@@ -42,10 +51,15 @@ struct CompileIssue {
     int endColumn;
     QString description;
     CompileIssueType type;
+    QVector<CompileIssueFixIt> fixIts; // only from json diagnostics
 };
 
 typedef std::shared_ptr<CompileIssue> PCompileIssue;
 
 Q_DECLARE_METATYPE(PCompileIssue);
 
+typedef QVector<PCompileIssue> CompileIssueList;
+
+Q_DECLARE_METATYPE(CompileIssueList);
+
 #endif // COMMON_H
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "buildtiming.h"
+#include "compilecache.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+BuildTimingRecorder::BuildTimingRecorder()
+{
+}
+
+void BuildTimingRecorder::clear()
+{
+    mStarted.clear();
+    mFinished.clear();
+}
+
+bool BuildTimingRecorder::processLine(const QString &line, qint64 elapsed)
+{
+    // build-timing: begin|end compile|link <target>
+    QString s = line.trimmed();
+    if (!s.startsWith(BUILD_TIMING_MARKER))
+        return false;
+    s = s.mid(QString(BUILD_TIMING_MARKER).length()).trimmed();
+    int pos = s.indexOf(' ');
+    if (pos < 0)
+        return true;
+    QString action = s.left(pos);
+    s = s.mid(pos + 1).trimmed();
+    pos = s.indexOf(' ');
+    if (pos < 0)
+        return true;
+    QString kind = s.left(pos);
+    QString target = s.mid(pos + 1).trimmed();
+    // quotes are kept by echo of cmd.exe
+    if (target.length() >= 2 && target.startsWith('"') && target.endsWith('"'))
+        target = target.mid(1, target.length() - 2);
+    if (action == "begin") {
+        mStarted.insert(target, elapsed);
+    } else if (action == "end" && mStarted.contains(target)) {
+        BuildTimingEntry entry;
+        entry.target = target;
+        entry.isLink = (kind == "link");
+        entry.start = mStarted.take(target);
+        entry.duration = elapsed - entry.start;
+        entry.lane = 0;
+        mFinished.append(entry);
+    }
+    return true;
+}
+
+bool BuildTimingRecorder::isEmpty() const
+{
+    return mFinished.isEmpty();
+}
+
+PBuildTimingReport BuildTimingRecorder::createReport(
+        const QHash<QString, QString> &dependencyFiles,
+        const QString &baseDir,
+        qint64 totalTime) const
+{
+    PBuildTimingReport report = std::make_shared<BuildTimingReport>();
+    report->totalTime = totalTime;
+    report->entries = mFinished;
+    std::sort(report->entries.begin(), report->entries.end(),
+              [](const BuildTimingEntry& e1, const BuildTimingEntry& e2) {
+        return e1.start < e2.start;
+    });
+    // put overlapping (parallel) jobs in different lanes
+    QList<qint64> laneEnds;
+    for (BuildTimingEntry& entry : report->entries) {
+        int lane = 0;
+        while (lane < laneEnds.count() && laneEnds[lane] > entry.start)
+            lane++;
+        if (lane == laneEnds.count())
+            laneEnds.append(0);
+        laneEnds[lane] = entry.start + entry.duration;
+        entry.lane = lane;
+    }
+
+    // a header costs the compile time of every unit that includes it
+    QDir dir(baseDir);
+    QHash<QString, BuildTimingHeader> headers;
+    foreach (const BuildTimingEntry& entry, report->entries) {
+        if (entry.isLink)
+            continue;
+        QString dependencyFile = dependencyFiles.value(entry.target);
+        if (dependencyFile.isEmpty())
+            continue;
+        QStringList dependencies = CompileCache::parseDependencyFile(dir.absoluteFilePath(dependencyFile));
+        // the first one is the source file
+        for (int i = 1; i < dependencies.count(); i++) {
+            QString filename = QDir::cleanPath(dir.absoluteFilePath(dependencies[i]));
+            BuildTimingHeader& header = headers[filename];
+            header.filename = filename;
+            header.unitCount++;
+            header.totalDuration += entry.duration;
+        }
+    }
+    report->headers = headers.values();
+    std::sort(report->headers.begin(), report->headers.end(),
+              [](const BuildTimingHeader& h1, const BuildTimingHeader& h2) {
+        return h1.totalDuration > h2.totalDuration;
+    });
+    return report;
+}
+
+bool BuildTimingRecorder::writeChromeTrace(const PBuildTimingReport &report, const QString &filename)
+{
+    QJsonArray events;
+    foreach (const BuildTimingEntry& entry, report->entries) {
+        QJsonObject event;
+        event["name"] = entry.target;
+        event["cat"] = entry.isLink ? "link" : "compile";
+        event["ph"] = "X";
+        // in microseconds
+        event["ts"] = static_cast<double>(entry.start * 1000);
+        event["dur"] = static_cast<double>(entry.duration * 1000);
+        event["pid"] = 1;
+        event["tid"] = entry.lane + 1;
+        events.append(event);
+    }
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    QFile file(filename);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) >= 0;
+}
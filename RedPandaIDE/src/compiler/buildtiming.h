@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef BUILDTIMING_H
+#define BUILDTIMING_H
+
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QString>
+#include <memory>
+
+// printed by the generated makefile around each recipe when BUILD_TIMING is defined
+#define BUILD_TIMING_MARKER "build-timing:"
+
+struct BuildTimingEntry {
+    QString target; // object file or the output binary
+    bool isLink;
+    qint64 start; // msecs since the build started
+    qint64 duration; // msecs
+    int lane; // parallel job slot, used in the trace
+};
+
+struct BuildTimingHeader {
+    QString filename;
+    int unitCount = 0; // units rebuilt in this build that include it
+    qint64 totalDuration = 0; // msecs spent compiling these units
+};
+
+struct BuildTimingReport {
+    QList<BuildTimingEntry> entries; // in starting order
+    QList<BuildTimingHeader> headers; // slowest first
+    qint64 totalTime;
+};
+
+using PBuildTimingReport = std::shared_ptr<BuildTimingReport>;
+Q_DECLARE_METATYPE(PBuildTimingReport);
+
+/**
+ * @brief Collects the begin/end markers printed by make into a timing report.
+ */
+class BuildTimingRecorder
+{
+public:
+    BuildTimingRecorder();
+    void clear();
+    /**
+     * @brief handle a line of make's standard output
+     * @return true if it's a timing marker
+     */
+    bool processLine(const QString& line, qint64 elapsed);
+    bool isEmpty() const;
+
+    /**
+     * @brief create the report of the finished targets
+     * @param dependencyFiles the .d file of each object, used to find slow headers
+     * @param baseDir relative paths in the .d files are relative to it
+     */
+    PBuildTimingReport createReport(const QHash<QString,QString>& dependencyFiles,
+                                    const QString& baseDir,
+                                    qint64 totalTime) const;
+
+    /**
+     * @brief save the report in the Chrome trace event format
+     *
+     * The result can be opened in chrome://tracing or Perfetto.
+     */
+    static bool writeChromeTrace(const PBuildTimingReport& report, const QString& filename);
+private:
+    QHash<QString, qint64> mStarted;
+    QList<BuildTimingEntry> mFinished;
+};
+
+#endif // BUILDTIMING_H
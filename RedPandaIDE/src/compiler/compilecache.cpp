@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "compilecache.h"
+#include "../systemconsts.h"
+#include <qt_utils/utils.h>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMutex>
+
+static QMutex indexMutex;
+
+CompileCache::CompileCache(const QString &cacheDir):
+    mCacheDir{cacheDir}
+{
+}
+
+QString CompileCache::dependencyFilename(const QString &sourceFilename) const
+{
+    QByteArray hash = QCryptographicHash::hash(sourceFilename.toUtf8(),
+                                               QCryptographicHash::Md5).toHex();
+    return includeTrailingPathDelimiter(mCacheDir) + QString::fromLatin1(hash) + ".d";
+}
+
+bool CompileCache::isUpToDate(const QString &sourceFilename, const QByteArray &key, const QString &outputFilename) const
+{
+    if (key.isEmpty())
+        return false;
+    QJsonObject entry;
+    {
+        // the index may be saved by another build meanwhile
+        QMutexLocker locker(&indexMutex);
+        entry = loadIndex()["entries"].toObject()[sourceFilename].toObject();
+    }
+    if (entry["key"].toString() != QString::fromLatin1(key))
+        return false;
+    QJsonObject output = entry["output"].toObject();
+    if (output["file"].toString() != outputFilename
+            || output != fileStamp(outputFilename))
+        return false;
+    foreach (const QJsonValue& value, entry["dependencies"].toArray()) {
+        QJsonObject stamp = value.toObject();
+        if (stamp != fileStamp(stamp["file"].toString()))
+            return false;
+    }
+    return true;
+}
+
+void CompileCache::update(const QString &sourceFilename, const QByteArray &key, const QString &outputFilename)
+{
+    if (key.isEmpty())
+        return;
+    QStringList dependencies = parseDependencyFile(dependencyFilename(sourceFilename));
+    if (dependencies.isEmpty())
+        return;
+    QDir sourceDir = QFileInfo(sourceFilename).absoluteDir();
+    QJsonArray stamps;
+    foreach (const QString& dependency, dependencies) {
+        stamps.append(fileStamp(QDir::cleanPath(sourceDir.absoluteFilePath(dependency))));
+    }
+    QJsonObject entry;
+    entry["key"] = QString::fromLatin1(key);
+    entry["output"] = fileStamp(outputFilename);
+    entry["dependencies"] = stamps;
+    entry["used"] = static_cast<double>(QDateTime::currentMSecsSinceEpoch());
+
+    QMutexLocker locker(&indexMutex);
+    QJsonObject index = loadIndex();
+    QJsonObject entries = index["entries"].toObject();
+    entries[sourceFilename] = entry;
+    while (entries.count() > MaxEntries) {
+        // drop the least recently built one
+        QString oldest;
+        double oldestTime = 0;
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            double used = it.value().toObject()["used"].toDouble();
+            if (oldest.isEmpty() || used < oldestTime) {
+                oldest = it.key();
+                oldestTime = used;
+            }
+        }
+        entries.remove(oldest);
+    }
+    index["entries"] = entries;
+    saveIndex(index);
+}
+
+QByteArray CompileCache::computeKey(const QString &compiler, const QStringList &arguments, const QString &sourceFilename)
+{
+    QFile source(sourceFilename);
+    if (!source.open(QFile::ReadOnly))
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    QFileInfo compilerInfo(compiler);
+    hash.addData(compilerInfo.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(compilerInfo.size()));
+    hash.addData(QByteArray::number(compilerInfo.lastModified().toMSecsSinceEpoch()));
+    foreach (const QString& argument, arguments) {
+        hash.addData(argument.toUtf8());
+        hash.addData("\0", 1);
+    }
+    hash.addData(source.readAll());
+    return hash.result().toHex();
+}
+
+QStringList CompileCache::parseDependencyFile(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly))
+        return QStringList();
+    QString content = QString::fromLocal8Bit(file.readAll());
+    int n = content.length();
+    int i = 0;
+    // skip the target (a drive letter colon isn't followed by a space)
+    while (i < n && !(content[i] == ':' && (i + 1 >= n || content[i + 1].isSpace())))
+        i++;
+    if (i >= n)
+        return QStringList();
+    i++;
+    QStringList result;
+    QString current;
+    for (; i < n; i++) {
+        QChar ch = content[i];
+        if (ch == '\\' && i + 1 < n) {
+            QChar next = content[i + 1];
+            if (next == '\n' || next == '\r') {
+                // line continuation
+                i++;
+                if (next == '\r' && i + 1 < n && content[i + 1] == '\n')
+                    i++;
+                ch = ' ';
+            } else if (next == ' ' || next == '#') {
+                current += next;
+                i++;
+                continue;
+            }
+        } else if (ch == '$' && i + 1 < n && content[i + 1] == '$') {
+            current += '$';
+            i++;
+            continue;
+        }
+        if (ch.isSpace()) {
+            if (!current.isEmpty()) {
+                result.append(current);
+                current.clear();
+            }
+            // end of the rule
+            if (ch == '\n')
+                break;
+            continue;
+        }
+        current += ch;
+    }
+    if (!current.isEmpty())
+        result.append(current);
+    return result;
+}
+
+QString CompileCache::indexFilename() const
+{
+    return includeTrailingPathDelimiter(mCacheDir) + DEV_COMPILE_CACHE_INDEX_FILE;
+}
+
+QJsonObject CompileCache::loadIndex() const
+{
+    QFile file(indexFilename());
+    if (!file.open(QFile::ReadOnly))
+        return QJsonObject();
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+        return QJsonObject();
+    return doc.object();
+}
+
+void CompileCache::saveIndex(const QJsonObject &index) const
+{
+    // it's only a cache, so failures are ignored
+    QDir().mkpath(mCacheDir);
+    QFile file(indexFilename());
+    if (file.open(QFile::WriteOnly | QFile::Truncate))
+        file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+}
+
+QJsonObject CompileCache::fileStamp(const QString &filename)
+{
+    QFileInfo info(filename);
+    QJsonObject stamp;
+    stamp["file"] = filename;
+    if (info.exists()) {
+        stamp["size"] = static_cast<double>(info.size());
+        stamp["modified"] = static_cast<double>(info.lastModified().toMSecsSinceEpoch());
+    }
+    return stamp;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef COMPILECACHE_H
+#define COMPILECACHE_H
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Remembers the last successful build of single source files.
+ *
+ * An entry is keyed by a hash of the compiler, the full argument list and
+ * the source content. The headers the compiler reported (through a
+ * dependency file) are recorded with their size and modification time, so
+ * a build can be reused only if none of them are changed.
+ */
+class CompileCache
+{
+public:
+    explicit CompileCache(const QString& cacheDir);
+
+    /**
+     * @brief the dependency file the compiler should write for the source file
+     */
+    QString dependencyFilename(const QString& sourceFilename) const;
+
+    /**
+     * @brief check if the output built last time can be reused
+     */
+    bool isUpToDate(const QString& sourceFilename,
+                    const QByteArray& key,
+                    const QString& outputFilename) const;
+
+    /**
+     * @brief record a successful build
+     *
+     * Does nothing if the dependency file can't be read.
+     */
+    void update(const QString& sourceFilename,
+                const QByteArray& key,
+                const QString& outputFilename);
+
+    static QByteArray computeKey(const QString& compiler,
+                                 const QStringList& arguments,
+                                 const QString& sourceFilename);
+    /**
+     * @brief parse the prerequisites in a makefile rule generated by gcc -MD
+     */
+    static QStringList parseDependencyFile(const QString& filename);
+    /**
+     * @brief the size and modification time of the file, used to detect changes
+     */
+    static QJsonObject fileStamp(const QString& filename);
+private:
+    static constexpr int MaxEntries = 100;
+    QString indexFilename() const;
+    QJsonObject loadIndex() const;
+    void saveIndex(const QJsonObject& index) const;
+private:
+    QString mCacheDir;
+};
+
+#endif // COMPILECACHE_H
@@ -25,6 +25,9 @@
 
 #include <cmath>
 #include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QProcess>
 #include <QString>
 #include <QTime>
@@ -39,13 +42,63 @@
 
 #define COMPILE_PROCESS_END "---//END//----"
 
+// hit/miss counters of ccache or sccache since they were last zeroed
+static bool queryCompilerCacheStats(const QString& program, qint64& hits, qint64& misses)
+{
+    bool isSccache = QFileInfo(program).baseName().compare("sccache", Qt::CaseInsensitive) == 0;
+    QProcess process;
+    if (isSccache)
+        process.start(program, {"--show-stats", "--stats-format=json"});
+    else
+        process.start(program, {"--print-stats"}); // ccache 4.x
+    if (!process.waitForFinished(5000)) {
+        process.kill();
+        process.waitForFinished(1000);
+        return false;
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+        return false;
+    QByteArray output = process.readAllStandardOutput();
+    hits = 0;
+    misses = 0;
+    if (isSccache) {
+        QJsonObject stats = QJsonDocument::fromJson(output).object()["stats"].toObject();
+        auto sumCounts = [&stats](const QString& name) {
+            qint64 sum = 0;
+            QJsonObject counts = stats[name].toObject()["counts"].toObject();
+            for (auto it = counts.begin(); it != counts.end(); ++it)
+                sum += static_cast<qint64>(it.value().toDouble());
+            return sum;
+        };
+        hits = sumCounts("cache_hits");
+        misses = sumCounts("cache_misses");
+        return stats.contains("cache_hits");
+    }
+    bool found = false;
+    foreach (const QByteArray& line, output.split('\n')) {
+        QList<QByteArray> fields = line.trimmed().split('\t');
+        if (fields.count() != 2)
+            continue;
+        if (fields[0] == "direct_cache_hit" || fields[0] == "preprocessed_cache_hit") {
+            hits += fields[1].toLongLong();
+            found = true;
+        } else if (fields[0] == "cache_miss") {
+            misses += fields[1].toLongLong();
+            found = true;
+        }
+    }
+    return found;
+}
+
 Compiler::Compiler(const QString &filename, bool onlyCheckSyntax):
     QThread{},
     mOnlyCheckSyntax{onlyCheckSyntax},
+    mOutputReused{false},
     mFilename{filename},
     mRebuild{false},
     mParserForFile{},
-    mForceEnglishOutput{false}
+    mForceEnglishOutput{false},
+    mJsonDiagnostics{false}
 {
     mParserForFile = nullptr;
 }
@@ -53,7 +106,9 @@ Compiler::Compiler(const QString &filename, bool onlyCheckSyntax):
 void Compiler::run()
 {
     emit compileStarted();
+    mFlushTimer.start();
     auto action = finally([this]{
+        flushOutput(true);
         emit compileFinished(mFilename);
     });
     try {
@@ -65,19 +120,34 @@ void Compiler::run()
         }
         mErrorCount = 0;
         mWarningCount = 0;
+        QString compilerCache;
+        qint64 cacheHits = 0;
+        qint64 cacheMisses = 0;
+        if (!mOutputReused && !mOnlyCheckSyntax) {
+            compilerCache = compilerSet()->compilerCacheProgram();
+            if (!compilerCache.isEmpty()
+                    && !queryCompilerCacheStats(compilerCache, cacheHits, cacheMisses))
+                compilerCache.clear();
+        }
         QElapsedTimer timer;
         timer.start();
-        runCommand(mCompiler, mArguments, mDirectory, pipedText());
-        for(int i=0;i<mExtraArgumentsList.count();i++) {
-            if (!beforeRunExtraCommand(i))
-                break;
-            QString command = escapeCommandForLog(mExtraCompilersList[i], mExtraArgumentsList[i]);
-            if (mExtraOutputFilesList[i].isEmpty()) {
-                log(tr(" - Command: %1").arg(command));
-            } else {
-                log(tr(" - Command: %1 > %2").arg(command, escapeArgumentForPlatformShell(mExtraOutputFilesList[i], false)));
+        if (mOutputReused) {
+            log(tr("Compile cache hit: the source file, its headers and the compile options are unchanged since the last build."));
+        } else {
+            runCommand(mCompiler, mArguments, mDirectory, pipedText());
+            for(int i=0;i<mExtraArgumentsList.count();i++) {
+                if (!beforeRunExtraCommand(i))
+                    break;
+                QString command = escapeCommandForLog(mExtraCompilersList[i], mExtraArgumentsList[i]);
+                if (mExtraOutputFilesList[i].isEmpty()) {
+                    log(tr(" - Command: %1").arg(command));
+                } else {
+                    log(tr(" - Command: %1 > %2").arg(command, escapeArgumentForPlatformShell(mExtraOutputFilesList[i], false)));
+                }
+                runCommand(mExtraCompilersList[i],mExtraArgumentsList[i],mDirectory, pipedText(),mExtraOutputFilesList[i]);
             }
-            runCommand(mExtraCompilersList[i],mExtraArgumentsList[i],mDirectory, pipedText(),mExtraOutputFilesList[i]);
+            if (mErrorCount == 0 && !mStop)
+                afterCompileSucceeded();
         }
         log("");
         log(tr("Compile Result:"));
@@ -85,12 +155,25 @@ void Compiler::run()
         log(tr("- Errors: %1").arg(mErrorCount));
         log(tr("- Warnings: %1").arg(mWarningCount));
         if (!mOutputFile.isEmpty()) {
-            log(tr("- Output Filename: %1").arg(mOutputFile));
+            if (mOutputReused)
+                log(tr("- Output Filename: %1 (reused)").arg(mOutputFile));
+            else
+                log(tr("- Output Filename: %1").arg(mOutputFile));
             QLocale locale = QLocale::system();
             log(tr("- Output Size: %1").arg(locale.formattedDataSize(QFileInfo(mOutputFile).size())));
         }
         log(tr("- Compilation Time: %1 secs").arg(timer.elapsed() / 1000.0));
+        qint64 newCacheHits;
+        qint64 newCacheMisses;
+        if (!compilerCache.isEmpty()
+                && queryCompilerCacheStats(compilerCache, newCacheHits, newCacheMisses)) {
+            log(tr("- Compiler Cache (%1): %2 hits, %3 misses")
+                .arg(extractFileName(compilerCache))
+                .arg(newCacheHits - cacheHits)
+                .arg(newCacheMisses - cacheMisses));
+        }
     } catch (CompileError e) {
+        flushOutput(true);
         emit compileErrorOccured(e.reason());
     }
 
@@ -240,11 +323,24 @@ bool Compiler::beforeRunExtraCommand(int /* idx */)
     return true;
 }
 
+void Compiler::afterCompileSucceeded()
+{
+}
+
+void Compiler::finishStandardOutput()
+{
+}
+
+void Compiler::processStandardOutput(const QString &text)
+{
+    log(text);
+}
+
 void Compiler::processOutput(QString &line)
 {
     if (line == COMPILE_PROCESS_END) {
         if (mLastIssue) {
-            emit compileIssue(mLastIssue);
+            reportIssue(mLastIssue);
             mLastIssue.reset();
         }
         return;
@@ -257,7 +353,7 @@ void Compiler::processOutput(QString &line)
             mLastIssue->filename = getFileNameFromOutputLine(line);
             //qDebug()<<line;
             mLastIssue->line = getLineNumberFromOutputLine(line);
-            emit compileIssue(mLastIssue);
+            reportIssue(mLastIssue);
             mLastIssue.reset();
             return;
     }
@@ -274,7 +370,7 @@ void Compiler::processOutput(QString &line)
             issue->column = getColunmnFromOutputLine(line) - 1; // editor ch starts from 0, gdb col starts from 1
         issue->type = getIssueTypeFromOutputLine(line);
         issue->description = inFilePrefix + issue->filename;
-        emit compileIssue(issue);
+        reportIssue(issue);
         return;
     } else if(line.startsWith(fromPrefix)) {
         line.remove(0,fromPrefix.length());
@@ -284,7 +380,7 @@ void Compiler::processOutput(QString &line)
             issue->column = getColunmnFromOutputLine(line) - 1; // editor ch starts from 0, gdb col starts from 1
         issue->type = getIssueTypeFromOutputLine(line);
         issue->description = "                 from " + issue->filename;
-        emit compileIssue(issue);
+        reportIssue(issue);
         return;
     }
 
@@ -309,7 +405,7 @@ void Compiler::processOutput(QString &line)
                     i++;
                 }
                 mLastIssue->endColumn = mLastIssue->column+i-pos;
-                emit compileIssue(mLastIssue);
+                reportIssue(mLastIssue);
                 mLastIssue.reset();
             }
         }
@@ -317,7 +413,7 @@ void Compiler::processOutput(QString &line)
     }
 
     if (mLastIssue) {
-        emit compileIssue(mLastIssue);
+        reportIssue(mLastIssue);
         mLastIssue.reset();
     }
 
@@ -339,7 +435,7 @@ void Compiler::processOutput(QString &line)
     if (issue->line<0 && (issue->filename=="ld" || issue->filename=="lld")) {
         mLastIssue = issue;
     } else if (issue->line<0) {
-        emit compileIssue(issue);
+        reportIssue(issue);
     } else
         mLastIssue = issue;
 }
@@ -782,9 +878,9 @@ void Compiler::runCommand(const QString &cmd, const QStringList &arguments, cons
             output.write(process.readAllStandardOutput());
         } else {
             if (outputUTF8)
-                this->log(QString::fromUtf8(process.readAllStandardOutput()));
+                this->processStandardOutput(QString::fromUtf8(process.readAllStandardOutput()));
             else
-                this->log(QString::fromLocal8Bit( process.readAllStandardOutput()));
+                this->processStandardOutput(QString::fromLocal8Bit( process.readAllStandardOutput()));
         }
     });
     process.connect(&process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),[this](){
@@ -803,6 +899,8 @@ void Compiler::runCommand(const QString &cmd, const QStringList &arguments, cons
             process.closeWriteChannel();
         }
         process.waitForFinished(100);
+        // messages may be buffered while the compiler is silent
+        flushOutput(false);
         if (process.state()!=QProcess::Running) {
             break;
         }
@@ -812,6 +910,7 @@ void Compiler::runCommand(const QString &cmd, const QStringList &arguments, cons
         if (errorOccurred)
             break;
     }
+    finishStandardOutput();
     if (errorOccurred) {
         switch (process.error()) {
         case QProcess::FailedToStart:
@@ -875,15 +974,100 @@ void Compiler::setRebuild(bool isRebuild)
 
 void Compiler::log(const QString &msg)
 {
-    emit compileOutput(msg);
+    // not running in the thread (e.g. building the makefile)
+    if (QThread::currentThread() != this) {
+        emit compileOutput(msg);
+        return;
+    }
+    mPendingOutput.append(msg);
+    flushOutput(false);
 }
 
 void Compiler::error(const QString &msg)
 {
+    if (mJsonDiagnostics) {
+        QStringList lines;
+        QList<QJsonObject> diagnostics;
+        if (msg == COMPILE_PROCESS_END)
+            mJsonDiagnosticsReader.finish(lines);
+        else
+            mJsonDiagnosticsReader.feed(msg, lines, diagnostics);
+        foreach (QString line, lines) {
+            if (line.isEmpty())
+                continue;
+            log(line);
+            processOutput(line);
+        }
+        foreach (const QJsonObject& diagnostic, diagnostics) {
+            processJsonDiagnostic(diagnostic);
+        }
+        if (msg == COMPILE_PROCESS_END) {
+            QString s = msg;
+            processOutput(s);
+        }
+        return;
+    }
     if (msg != COMPILE_PROCESS_END)
-        emit compileOutput(msg);
+        log(msg);
     for (QString& s:msg.split("\n")) {
         if (!s.isEmpty())
             processOutput(s);
     }
 }
+
+void Compiler::addJsonDiagnosticsArgument()
+{
+    if (!compilerSet()->useJsonDiagnostics() || !compilerSet()->supportJsonDiagnostics())
+        return;
+    mArguments << "-fdiagnostics-format=json";
+    mJsonDiagnostics = true;
+}
+
+void Compiler::processJsonDiagnostic(const QJsonObject &diagnostic)
+{
+    if (mLastIssue) {
+        reportIssue(mLastIssue);
+        mLastIssue.reset();
+    }
+    auto toFilename = [this](const QString& filename) {
+        if (filename.compare("<stdin>", Qt::CaseInsensitive)==0)
+            return mFilename;
+        if (!mDirectory.isEmpty() && QFileInfo(filename).isRelative())
+            return generateAbsolutePath(mDirectory, filename);
+        return cleanPath(filename);
+    };
+    CompileIssueList issues;
+    QStringList lines;
+    convertJsonDiagnostic(diagnostic, toFilename, issues, lines, mErrorCount, mWarningCount);
+    foreach (const QString& line, lines) {
+        log(line);
+    }
+    foreach (const PCompileIssue& issue, issues) {
+        reportIssue(issue);
+    }
+}
+
+void Compiler::reportIssue(PCompileIssue issue)
+{
+    if (QThread::currentThread() != this) {
+        emit compileIssues(CompileIssueList{issue});
+        return;
+    }
+    mPendingIssues.append(issue);
+    flushOutput(false);
+}
+
+void Compiler::flushOutput(bool force)
+{
+    if (!force && mFlushTimer.isValid() && mFlushTimer.elapsed() < FlushInterval)
+        return;
+    if (!mPendingOutput.isEmpty()) {
+        emit compileOutput(mPendingOutput.join('\n'));
+        mPendingOutput.clear();
+    }
+    if (!mPendingIssues.isEmpty()) {
+        emit compileIssues(mPendingIssues);
+        mPendingIssues.clear();
+    }
+    mFlushTimer.start();
+}
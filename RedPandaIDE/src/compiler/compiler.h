@@ -17,11 +17,13 @@
 #ifndef COMPILER_H
 #define COMPILER_H
 
+#include <QElapsedTimer>
 #include <QThread>
 #include "../settings.h"
 #include "../common.h"
 #include "../parser/cppparser.h"
 #include "../utils/file.h"
+#include "jsondiagnostics.h"
 
 class Project;
 class Compiler : public QThread
@@ -51,8 +53,9 @@ public:
 signals:
     void compileStarted();
     void compileFinished(const QString& filename);
+    // lines are sent in chunks, joined by '\n'
     void compileOutput(const QString& msg);
-    void compileIssue(PCompileIssue issue);
+    void compileIssues(const CompileIssueList& issues);
     void compileErrorOccured(const QString& reason);
 public slots:
     void stopCompile();
@@ -71,6 +74,12 @@ protected:
     virtual QByteArray pipedText();
     virtual bool prepareForRebuild() = 0;
     virtual bool beforeRunExtraCommand(int idx);
+    virtual void afterCompileSucceeded();
+    virtual void processStandardOutput(const QString& text);
+    /**
+     * @brief the command is ended, the output held back by processStandardOutput() should be processed
+     */
+    virtual void finishStandardOutput();
     virtual QStringList getCharsetArgument(const QByteArray& encoding, FileType fileType, bool onlyCheckSyntax);
     virtual QStringList getCppGccImportStdSources(bool checkSyntax);
     virtual QStringList getCCompileArguments(bool checkSyntax);
@@ -87,6 +96,17 @@ protected:
             QSet<QString>& parsedFiles);
     void log(const QString& msg);
     void error(const QString& msg);
+    void reportIssue(PCompileIssue issue);
+    /**
+     * @brief let gcc print diagnostics in json, if enabled in the compiler set
+     */
+    void addJsonDiagnosticsArgument();
+    void processJsonDiagnostic(const QJsonObject& diagnostic);
+    /**
+     * @brief send the buffered log lines and issues to the GUI thread
+     * @param force if false, do nothing unless FlushInterval has passed since the last flush
+     */
+    void flushOutput(bool force);
     void runCommand(const QString& cmd, const QStringList& arguments, const QString& workingDir, const QByteArray& inputText=QByteArray(), const QString& outputFile=QString());
     QString escapeCommandForLog(const QString &cmd, const QStringList &arguments);
 
@@ -98,6 +118,7 @@ protected:
     QList<QStringList> mExtraArgumentsList;
     QList<QString> mExtraOutputFilesList;
     QString mOutputFile;
+    bool mOutputReused; // the output of the last build is up to date
     int mErrorCount;
     int mWarningCount;
     PCompileIssue mLastIssue;
@@ -108,9 +129,16 @@ protected:
     bool mSetLANG;
     PCppParser mParserForFile;
     bool mForceEnglishOutput;
+    bool mJsonDiagnostics;
 
 private:
+    // a flood of messages would freeze the GUI if they're sent one by one
+    static constexpr int FlushInterval = 100; // msecs
     bool mStop;
+    QStringList mPendingOutput;
+    CompileIssueList mPendingIssues;
+    QElapsedTimer mFlushTimer;
+    JsonDiagnosticsReader mJsonDiagnosticsReader;
 };
 
 
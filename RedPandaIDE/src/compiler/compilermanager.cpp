@@ -33,7 +33,10 @@
 #include "../utils/terminal.h"
 #include "../systemconsts.h"
 #include "../settings.h"
+#include <QCryptographicHash>
+#include <QFileInfo>
 #include <QMessageBox>
+#include <QTimer>
 #include <QUuid>
 #include "projectcompiler.h"
 #ifdef Q_OS_MACOS
@@ -61,6 +64,7 @@ CompilerManager::~CompilerManager()
     stopAllRunners();
     stopCompile();
     stopCheckSyntax();
+    PrecompiledHeaderBuilder::stopAll();
     stopRun();
 }
 
@@ -73,7 +77,7 @@ bool CompilerManager::compiling() const
 bool CompilerManager::backgroundSyntaxChecking() const
 {
     QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
-    return mBackgroundSyntaxChecker!=nullptr;
+    return mSyntaxCheckScheduler.running();
 }
 
 bool CompilerManager::running() const
@@ -112,13 +116,13 @@ void CompilerManager::compile(const QString& filename, FileType fileType, const
         mCompiler->setRebuild(rebuild);
         connect(mCompiler, &Compiler::finished, mCompiler, &QObject::deleteLater);
         connect(mCompiler, &Compiler::compileFinished, this, &CompilerManager::onCompileFinished);
-        connect(mCompiler, &Compiler::compileIssue, this, &CompilerManager::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, this, &CompilerManager::onCompileIssues);
         if (mMainWindow) {
             connect(mCompiler, &Compiler::compileStarted, mMainWindow, &MainWindow::onCompileStarted);
             connect(mCompiler, &Compiler::compileStarted, mMainWindow, &MainWindow::clearToolsOutput);
 
             connect(mCompiler, &Compiler::compileOutput, mMainWindow, &MainWindow::logToolsOutput);
-            connect(mCompiler, &Compiler::compileIssue, mMainWindow, &MainWindow::onCompileIssue);
+            connect(mCompiler, &Compiler::compileIssues, mMainWindow, &MainWindow::onCompileIssues);
             connect(mCompiler, &Compiler::compileErrorOccured, mMainWindow, &MainWindow::onCompileErrorOccured);
         }
         mCompiler->start();
@@ -141,19 +145,21 @@ void CompilerManager::compileProject(std::shared_ptr<Project> project, bool rebu
         mCompileErrorCount = 0;
         mCompileIssueCount = 0;
         //deleted when thread finished
-        mCompiler = createProjectCompiler(project);
+        ProjectCompiler* compiler = createProjectCompiler(project);
+        mCompiler = compiler;
         mCompiler->setRebuild(rebuild);
         connect(mCompiler, &Compiler::finished, mCompiler, &QObject::deleteLater);
         connect(mCompiler, &Compiler::compileFinished, this, &CompilerManager::onCompileFinished);
 
-        connect(mCompiler, &Compiler::compileIssue, this, &CompilerManager::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, this, &CompilerManager::onCompileIssues);
         if (mMainWindow) {
             connect(mCompiler, &Compiler::compileStarted, mMainWindow, &MainWindow::onProjectCompileStarted);
             connect(mCompiler, &Compiler::compileStarted, mMainWindow, &MainWindow::clearToolsOutput);
 
             connect(mCompiler, &Compiler::compileOutput, mMainWindow, &MainWindow::logToolsOutput);
-            connect(mCompiler, &Compiler::compileIssue, mMainWindow, &MainWindow::onCompileIssue);
+            connect(mCompiler, &Compiler::compileIssues, mMainWindow, &MainWindow::onCompileIssues);
             connect(mCompiler, &Compiler::compileErrorOccured, mMainWindow, &MainWindow::onCompileErrorOccured);
+            connect(compiler, &ProjectCompiler::buildTimingReady, mMainWindow, &MainWindow::onBuildTimingReady);
         }
         mCompiler->start();
     }
@@ -182,13 +188,13 @@ void CompilerManager::cleanProject(std::shared_ptr<Project> project)
         connect(mCompiler, &Compiler::finished, mCompiler, &QObject::deleteLater);
         connect(mCompiler, &Compiler::compileFinished, this, &CompilerManager::onCompileFinished);
 
-        connect(mCompiler, &Compiler::compileIssue, this, &CompilerManager::onCompileIssue);
+        connect(mCompiler, &Compiler::compileIssues, this, &CompilerManager::onCompileIssues);
         if (mMainWindow) {
             connect(mCompiler, &Compiler::compileStarted, mMainWindow, &MainWindow::onProjectCompileStarted);
             connect(mCompiler, &Compiler::compileStarted, mMainWindow, &MainWindow::clearToolsOutput);
 
             connect(mCompiler, &Compiler::compileOutput, mMainWindow, &MainWindow::logToolsOutput);
-            connect(mCompiler, &Compiler::compileIssue, mMainWindow, &MainWindow::onCompileIssue);
+            connect(mCompiler, &Compiler::compileIssues, mMainWindow, &MainWindow::onCompileIssues);
             connect(mCompiler, &Compiler::compileErrorOccured, mMainWindow, &MainWindow::onCompileErrorOccured);
         }
         mCompiler->start();
@@ -222,31 +228,122 @@ void CompilerManager::checkSyntax(const QString &filename, const QByteArray& enc
                               tr("No compiler set is configured.")+tr("Can't start debugging."));
         return;
     }
+    PSyntaxCheckRequest request = std::make_shared<SyntaxCheckRequest>();
+    request->filename = filename;
+    request->encoding = encoding;
+    request->content = content;
+    request->project = project;
     {
         QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
-        if (mBackgroundSyntaxChecker!=nullptr) {
+        if (!mSyntaxCheckScheduler.request(request))
             return;
-        }
+        startSyntaxCheck(request);
+    }
+}
 
-        mSyntaxCheckErrorCount = 0;
-        mSyntaxCheckIssueCount = 0;
+void CompilerManager::startSyntaxCheck(PSyntaxCheckRequest request)
+{
+    QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+    mSyntaxCheckErrorCount = 0;
+    mSyntaxCheckIssueCount = 0;
+    if (mSyntaxCheckScheduler.start(syntaxCheckKey(request))
+            == SyntaxCheckScheduler<PSyntaxCheckRequest>::Action::Replay) {
+        QString filename = request->filename;
+        QTimer::singleShot(0, this, [this, filename](){
+            replaySyntaxCheck(filename);
+        });
+        return;
+    }
+    mLastSyntaxCheckIssues.clear();
+
+    //deleted when thread finished
+    mBackgroundSyntaxChecker = new StdinCompiler(request->filename, request->encoding, request->content, true);
+    if (!request->project)
+        mBackgroundSyntaxChecker->setParserForFile(getParserForFile(request->filename));
+    mBackgroundSyntaxChecker->setProject(request->project);
+    connect(mBackgroundSyntaxChecker, &Compiler::finished, mBackgroundSyntaxChecker, &QThread::deleteLater);
+    connect(mBackgroundSyntaxChecker, &Compiler::compileIssues, this, &CompilerManager::onSyntaxCheckIssues);
+    connect(mBackgroundSyntaxChecker, &Compiler::compileFinished, this, &CompilerManager::onSyntaxCheckFinished);
+    if (mMainWindow) {
+        connect(mBackgroundSyntaxChecker, &Compiler::compileStarted, mMainWindow, &MainWindow::onSyntaxCheckStarted);
+        connect(mBackgroundSyntaxChecker, &Compiler::compileIssues, mMainWindow, &MainWindow::onCompileIssues);
+        connect(mBackgroundSyntaxChecker, &Compiler::compileErrorOccured, mMainWindow, &MainWindow::onCompileErrorOccured);
+        //connect(mBackgroundSyntaxChecker, &Compiler::compileOutput, mMainWindow, &MainWindow::logToolsOutput);
+    }
+    mBackgroundSyntaxChecker->start();
+}
 
-        //deleted when thread finished
-        mBackgroundSyntaxChecker = new StdinCompiler(filename,encoding, content,true);
-        if (!project)
-            mBackgroundSyntaxChecker->setParserForFile(getParserForFile(filename));
-        mBackgroundSyntaxChecker->setProject(project);
-        connect(mBackgroundSyntaxChecker, &Compiler::finished, mBackgroundSyntaxChecker, &QThread::deleteLater);
-        connect(mBackgroundSyntaxChecker, &Compiler::compileIssue, this, &CompilerManager::onSyntaxCheckIssue);
-        connect(mBackgroundSyntaxChecker, &Compiler::compileFinished, this, &CompilerManager::onSyntaxCheckFinished);
-        if (mMainWindow) {
-            connect(mBackgroundSyntaxChecker, &Compiler::compileStarted, mMainWindow, &MainWindow::onSyntaxCheckStarted);
-            connect(mBackgroundSyntaxChecker, &Compiler::compileIssue, mMainWindow, &MainWindow::onCompileIssue);
-            connect(mBackgroundSyntaxChecker, &Compiler::compileErrorOccured, mMainWindow, &MainWindow::onCompileErrorOccured);
-            //connect(mBackgroundSyntaxChecker, &Compiler::compileOutput, mMainWindow, &MainWindow::logToolsOutput);
+void CompilerManager::replaySyntaxCheck(const QString &filename)
+{
+    QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+    // report the result of the last check again, as if it's just checked
+    if (mMainWindow)
+        mMainWindow->onSyntaxCheckStarted();
+    foreach (const PCompileIssue& issue, mLastSyntaxCheckIssues) {
+        if (issue->type == CompileIssueType::Error)
+            mSyntaxCheckErrorCount++;
+        if (issue->type == CompileIssueType::Error ||
+                issue->type == CompileIssueType::Warning)
+            mSyntaxCheckIssueCount++;
+    }
+    if (mMainWindow)
+        mMainWindow->onCompileIssues(mLastSyntaxCheckIssues);
+    PSyntaxCheckRequest pending;
+    bool hasPending = mSyntaxCheckScheduler.finish(pending);
+    emit compileFinished(filename, true);
+    if (hasPending)
+        startPendingSyntaxCheck(pending);
+}
+
+QByteArray CompilerManager::syntaxCheckKey(const PSyntaxCheckRequest &request)
+{
+    PCompilerSet compilerSet;
+    if (request->project)
+        compilerSet = pSettings->compilerSets().getSet(request->project->options().compilerSet);
+    else
+        compilerSet = pSettings->compilerSets().defaultSet();
+    if (!compilerSet)
+        return QByteArray();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    auto addString = [&hash](const QString& s) {
+        hash.addData(s.toUtf8());
+        hash.addData("\0", 1);
+    };
+    addString(request->filename);
+    hash.addData(request->encoding);
+    hash.addData("\0", 1);
+    addString(request->content);
+    addString(compilerSet->name());
+    addString(compilerSet->customCompileParams());
+    const QMap<QString, QString>& options = compilerSet->compileOptions();
+    for (auto it = options.begin(); it != options.end(); ++it) {
+        addString(it.key());
+        addString(it.value());
+    }
+    if (request->project) {
+        addString(request->project->filename());
+        addString(request->project->options().compilerCmd);
+        addString(request->project->options().cppCompilerCmd);
+        const QMap<QString, QString>& projectOptions = request->project->options().compilerOptions;
+        for (auto it = projectOptions.begin(); it != projectOptions.end(); ++it) {
+            addString(it.key());
+            addString(it.value());
         }
-        mBackgroundSyntaxChecker->start();
     }
+    // included headers may be changed without changing the checked file
+    PCppParser parser = request->project ? request->project->cppParser() : getParserForFile(request->filename);
+    if (!parser || parser->parsing())
+        return QByteArray();
+    QStringList includedFiles = parser->getIncludedFiles(request->filename).values();
+    includedFiles.sort();
+    foreach (const QString& includedFile, includedFiles) {
+        if (includedFile == request->filename)
+            continue;
+        QFileInfo info(includedFile);
+        addString(includedFile);
+        addString(QString::number(info.exists() ? info.lastModified().toMSecsSinceEpoch() : -1));
+    }
+    return hash.result();
 }
 
 void CompilerManager::run(
@@ -394,6 +491,7 @@ void CompilerManager::doRunProblem(const QString &filename, const QString &argum
         execRunner->setExecTimeout(timeLimit);
     if (memoryLimit)
         execRunner->setMemoryLimit(memoryLimit);
+    execRunner->setParallelJobs(pSettings->executor().caseParallelJobs());
     connect(mRunner, &Runner::finished, this ,&CompilerManager::onRunnerTerminated);
     connect(mRunner, &Runner::finished, mRunner ,&Runner::deleteLater);
     if (mMainWindow) {
@@ -447,6 +545,7 @@ void CompilerManager::stopCompile()
 void CompilerManager::stopCheckSyntax()
 {
     QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+    mSyntaxCheckScheduler.stop();
     if (mBackgroundSyntaxChecker!=nullptr)
         mBackgroundSyntaxChecker->stopCompile();
 }
@@ -483,27 +582,48 @@ void CompilerManager::onRunnerPausing()
     mTempFileOwner=nullptr;
 }
 
-void CompilerManager::onCompileIssue(PCompileIssue issue)
+void CompilerManager::onCompileIssues(const CompileIssueList& issues)
 {
-    if (issue->type == CompileIssueType::Error)
-        mCompileErrorCount++;
-    mCompileIssueCount++;
+    foreach (const PCompileIssue& issue, issues) {
+        if (issue->type == CompileIssueType::Error)
+            mCompileErrorCount++;
+        mCompileIssueCount++;
+    }
 }
 
 void CompilerManager::onSyntaxCheckFinished(const QString& filename)
 {
     QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
     mBackgroundSyntaxChecker=nullptr;
+    PSyntaxCheckRequest pending;
+    bool hasPending = mSyntaxCheckScheduler.finish(pending);
     emit compileFinished(filename, true);
+    if (hasPending)
+        startPendingSyntaxCheck(pending);
+}
+
+void CompilerManager::startPendingSyntaxCheck(PSyntaxCheckRequest request)
+{
+    QMutexLocker locker(&mBackgroundSyntaxCheckMutex);
+    // a newer check may be started by the compileFinished handlers
+    if (mSyntaxCheckScheduler.running())
+        return;
+    // the compiler may be started meanwhile
+    if (compiling())
+        return;
+    startSyntaxCheck(request);
 }
 
-void CompilerManager::onSyntaxCheckIssue(PCompileIssue issue)
+void CompilerManager::onSyntaxCheckIssues(const CompileIssueList& issues)
 {
-    if (issue->type == CompileIssueType::Error)
-        mSyntaxCheckErrorCount++;
-    if (issue->type == CompileIssueType::Error ||
-            issue->type == CompileIssueType::Warning)
-        mSyntaxCheckIssueCount++;
+    mLastSyntaxCheckIssues.append(issues);
+    foreach (const PCompileIssue& issue, issues) {
+        if (issue->type == CompileIssueType::Error)
+            mSyntaxCheckErrorCount++;
+        if (issue->type == CompileIssueType::Error ||
+                issue->type == CompileIssueType::Warning)
+            mSyntaxCheckIssueCount++;
+    }
 }
 
 ProjectCompiler *CompilerManager::createProjectCompiler(std::shared_ptr<Project> project)
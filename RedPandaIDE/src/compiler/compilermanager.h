@@ -23,6 +23,7 @@
 #include "../utils.h"
 #include "../utils/file.h"
 #include "../common.h"
+#include "syntaxcheck.h"
 
 class MainWindow;
 class Runner;
@@ -94,12 +95,23 @@ private slots:
     void onRunnerTerminated();
     void onRunnerPausing();
     void onCompileFinished(const QString& filename);
-    void onCompileIssue(PCompileIssue issue);
+    void onCompileIssues(const CompileIssueList& issues);
     void onSyntaxCheckFinished(const QString& filename);
-    void onSyntaxCheckIssue(PCompileIssue issue);
+    void onSyntaxCheckIssues(const CompileIssueList& issues);
 private:
+    struct SyntaxCheckRequest {
+        QString filename;
+        QByteArray encoding;
+        QString content;
+        std::shared_ptr<Project> project;
+    };
+    using PSyntaxCheckRequest = std::shared_ptr<SyntaxCheckRequest>;
     ProjectCompiler* createProjectCompiler(std::shared_ptr<Project> project);
     PCppParser getParserForFile(const QString& filename);
+    void startSyntaxCheck(PSyntaxCheckRequest request);
+    void startPendingSyntaxCheck(PSyntaxCheckRequest request);
+    void replaySyntaxCheck(const QString& filename);
+    QByteArray syntaxCheckKey(const PSyntaxCheckRequest& request);
 private:
     MainWindow *mMainWindow;
     Compiler* mCompiler;
@@ -108,6 +120,9 @@ private:
     int mSyntaxCheckErrorCount;
     int mSyntaxCheckIssueCount;
     Compiler* mBackgroundSyntaxChecker;
+    SyntaxCheckScheduler<PSyntaxCheckRequest> mSyntaxCheckScheduler;
+    // result of the last finished check, replayed if nothing is changed
+    CompileIssueList mLastSyntaxCheckIssues;
     Runner* mRunner;
     PNonExclusiveTemporaryFileOwner mTempFileOwner;
     mutable QRecursiveMutex mCompileMutex;
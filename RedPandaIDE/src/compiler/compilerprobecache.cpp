@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "compilerprobecache.h"
+#include "compilecache.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+
+CompilerProbeCache &CompilerProbeCache::instance()
+{
+    static CompilerProbeCache cache;
+    return cache;
+}
+
+CompilerProbeCache::CompilerProbeCache():
+    mLoaded{false},
+    mModified{false}
+{
+}
+
+void CompilerProbeCache::setFilename(const QString &filename)
+{
+    QMutexLocker locker(&mMutex);
+    if (mFilename == filename)
+        return;
+    mFilename = filename;
+    mEntries.clear();
+    mLoaded = false;
+    mModified = false;
+}
+
+bool CompilerProbeCache::find(const QString &compiler, const QStringList &arguments, QByteArray &output)
+{
+    QString filename = QFileInfo(compiler).absoluteFilePath();
+    QJsonObject stamp = CompileCache::fileStamp(filename);
+    QMutexLocker locker(&mMutex);
+    load();
+    auto it = mEntries.find(filename);
+    if (it == mEntries.end())
+        return false;
+    if (it->stamp != stamp) {
+        // the compiler is upgraded
+        mEntries.erase(it);
+        mModified = true;
+        return false;
+    }
+    auto outputIt = it->outputs.constFind(argumentsKey(arguments));
+    if (outputIt == it->outputs.constEnd())
+        return false;
+    output = outputIt.value();
+    return true;
+}
+
+void CompilerProbeCache::insert(const QString &compiler, const QStringList &arguments, const QByteArray &output)
+{
+    QString filename = QFileInfo(compiler).absoluteFilePath();
+    QJsonObject stamp = CompileCache::fileStamp(filename);
+    // the compiler doesn't exist
+    if (!stamp.contains("size"))
+        return;
+    QMutexLocker locker(&mMutex);
+    load();
+    Entry& entry = mEntries[filename];
+    if (entry.stamp != stamp) {
+        entry.stamp = stamp;
+        entry.outputs.clear();
+    }
+    entry.outputs.insert(argumentsKey(arguments), output);
+    mModified = true;
+}
+
+void CompilerProbeCache::save()
+{
+    QMutexLocker locker(&mMutex);
+    if (!mModified || mFilename.isEmpty())
+        return;
+    QJsonObject compilers;
+    for (auto it = mEntries.constBegin(); it != mEntries.constEnd(); ++it) {
+        QJsonObject outputs;
+        for (auto outputIt = it->outputs.constBegin(); outputIt != it->outputs.constEnd(); ++outputIt) {
+            outputs[outputIt.key()] = QString::fromLatin1(outputIt.value().toBase64());
+        }
+        QJsonObject entry;
+        entry["stamp"] = it->stamp;
+        entry["outputs"] = outputs;
+        compilers[it.key()] = entry;
+    }
+    QJsonObject root;
+    root["compilers"] = compilers;
+    // it's only a cache, so failures are ignored
+    QFile file(mFilename);
+    if (file.open(QFile::WriteOnly | QFile::Truncate))
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    mModified = false;
+}
+
+void CompilerProbeCache::load()
+{
+    if (mLoaded)
+        return;
+    mLoaded = true;
+    if (mFilename.isEmpty())
+        return;
+    QFile file(mFilename);
+    if (!file.open(QFile::ReadOnly))
+        return;
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+        return;
+    QJsonObject compilers = doc.object()["compilers"].toObject();
+    for (auto it = compilers.constBegin(); it != compilers.constEnd(); ++it) {
+        QJsonObject value = it.value().toObject();
+        Entry entry;
+        entry.stamp = value["stamp"].toObject();
+        QJsonObject outputs = value["outputs"].toObject();
+        for (auto outputIt = outputs.constBegin(); outputIt != outputs.constEnd(); ++outputIt) {
+            entry.outputs.insert(outputIt.key(),
+                                 QByteArray::fromBase64(outputIt.value().toString().toLatin1()));
+        }
+        mEntries.insert(it.key(), entry);
+    }
+}
+
+QString CompilerProbeCache::argumentsKey(const QStringList &arguments)
+{
+    return arguments.join('\n');
+}
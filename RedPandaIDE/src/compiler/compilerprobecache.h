@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef COMPILERPROBECACHE_H
+#define COMPILERPROBECACHE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Remembers the outputs of compiler probes (-v, -dumpmachine, -dM -E...)
+ *
+ * The outputs of a compiler are dropped when the size or the modification
+ * time of its executable is changed. It's used from several threads when
+ * compilers are searched in parallel.
+ */
+class CompilerProbeCache
+{
+public:
+    static CompilerProbeCache& instance();
+    CompilerProbeCache(const CompilerProbeCache&) = delete;
+    CompilerProbeCache& operator=(const CompilerProbeCache&) = delete;
+
+    /**
+     * @brief the file the cache is loaded from and saved to
+     *
+     * The cache is loaded when it's used for the first time.
+     */
+    void setFilename(const QString& filename);
+    bool find(const QString& compiler, const QStringList& arguments, QByteArray& output);
+    void insert(const QString& compiler, const QStringList& arguments, const QByteArray& output);
+    /**
+     * @brief save the cache if it's changed
+     */
+    void save();
+private:
+    CompilerProbeCache();
+    struct Entry {
+        QJsonObject stamp;
+        QHash<QString, QByteArray> outputs;
+    };
+    void load();
+    static QString argumentsKey(const QStringList& arguments);
+private:
+    QMutex mMutex;
+    QString mFilename;
+    bool mLoaded;
+    bool mModified;
+    QHash<QString, Entry> mEntries; // by absolute paths of the compilers
+};
+
+#endif // COMPILERPROBECACHE_H
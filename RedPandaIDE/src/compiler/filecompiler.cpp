@@ -20,6 +20,7 @@
 #include "qsynedit/syntaxer/asm.h"
 #include "../systemconsts.h"
 
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QMessageBox>
@@ -31,7 +32,8 @@ FileCompiler::FileCompiler(const QString &filename, const QByteArray &encoding,
     Compiler{filename, onlyCheckSyntax},
     mEncoding{encoding},
     mCompileType{compileType},
-    mFileType{fileType}
+    mFileType{fileType},
+    mCompileCache{includeTrailingPathDelimiter(pSettings->dirs().config()) + DEV_COMPILE_CACHE_DIR}
 {
 
 }
@@ -75,6 +77,12 @@ bool FileCompiler::prepareForCompile()
         (compilerType == CompilerType::GCC)) {
         mArguments += getCppGccImportStdSources(mOnlyCheckSyntax);
     }
+    // only executables built from one source file are cached
+    // (`import std;` sources are compiled with it if added)
+    bool useCompileCache = !mOnlyCheckSyntax
+            && mArguments.isEmpty()
+            && stage == CompilerSet::CompilationStage::GenerateExecutable
+            && (compilerType == CompilerType::GCC || compilerType == CompilerType::Clang);
 
     mArguments += QStringList{localizePath(mFilename)};
     if (!mOnlyCheckSyntax) {
@@ -116,14 +124,6 @@ bool FileCompiler::prepareForCompile()
                 mArguments << "-masm=intel";
         }
 #endif
-        //remove the old file if it exists
-        QFile outputFile(mOutputFile);
-        if (outputFile.exists()) {
-            if (!outputFile.remove()) {
-                error(tr("Can't delete the old executable file \"%1\".\n").arg(mOutputFile));
-                return false;
-            }
-        }
     }
 
     mArguments += getCharsetArgument(mEncoding, mFileType, mOnlyCheckSyntax);
@@ -145,6 +145,7 @@ bool FileCompiler::prepareForCompile()
         mArguments += getCCompileArguments(mOnlyCheckSyntax);
         mArguments += getCIncludeArguments();
         mArguments += getProjectIncludeArguments();
+        addJsonDiagnosticsArgument();
         strFileType = "C";
         mCompiler = compilerSet()->CCompiler();
         break;
@@ -152,6 +153,7 @@ bool FileCompiler::prepareForCompile()
         mArguments += getCppCompileArguments(mOnlyCheckSyntax);
         mArguments += getCppIncludeArguments();
         mArguments += getProjectIncludeArguments();
+        addJsonDiagnosticsArgument();
         strFileType = "C++";
         mCompiler = compilerSet()->cppCompiler();
         break;
@@ -161,6 +163,27 @@ bool FileCompiler::prepareForCompile()
     if (!mOnlyCheckSyntax)
         mArguments += getLibraryArguments(mFileType);
 
+    if (useCompileCache) {
+        // let the compiler tell us the headers used
+        QString dependencyFile = mCompileCache.dependencyFilename(mFilename);
+        QDir().mkpath(extractFileDir(dependencyFile));
+        mArguments += {"-MD", "-MF", localizePath(dependencyFile)};
+        mCompileCacheKey = CompileCache::computeKey(mCompiler, mArguments, mFilename);
+        mOutputReused = !mRebuild
+                && mCompileCache.isUpToDate(mFilename, mCompileCacheKey, mOutputFile);
+    }
+
+    if (!mOnlyCheckSyntax && !mOutputReused) {
+        //remove the old file if it exists
+        QFile outputFile(mOutputFile);
+        if (outputFile.exists()) {
+            if (!outputFile.remove()) {
+                error(tr("Can't delete the old executable file \"%1\".\n").arg(mOutputFile));
+                return false;
+            }
+        }
+    }
+
 //    if (isASMSourceFile(fileType)) {
 //        bool hasStart=false;
 //        QStringList lines=readFileToLines(mFilename);
@@ -204,12 +227,25 @@ bool FileCompiler::prepareForCompile()
     log(tr("Processing %1 source file:").arg(strFileType));
     log("------------------");
     log(tr("%1 Compiler: %2").arg(strFileType,mCompiler));
+    // route the compiler through ccache/sccache
+    QString compilerCache = compilerSet()->compilerCacheProgram();
+    if (!compilerCache.isEmpty() && mFileType != FileType::GAS) {
+        mArguments.prepend(mCompiler);
+        mCompiler = compilerCache;
+    }
     QString command = escapeCommandForLog(mCompiler, mArguments);
     log(tr("Command: %1").arg(command));
     mDirectory = extractFileDir(mFilename);
     return true;
 }
 
+void FileCompiler::afterCompileSucceeded()
+{
+    if (mCompileCacheKey.isEmpty() || !fileExists(mOutputFile))
+        return;
+    mCompileCache.update(mFilename, mCompileCacheKey, mOutputFile);
+}
+
 bool FileCompiler::prepareForRebuild()
 {
     QString exeName=compilerSet()->getOutputFilename(mFilename);
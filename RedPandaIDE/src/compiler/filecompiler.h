@@ -18,6 +18,7 @@
 #define FILECOMPILER_H
 
 #include "compiler.h"
+#include "compilecache.h"
 
 class FileCompiler : public Compiler
 {
@@ -32,11 +33,14 @@ public:
 
 protected:
     bool prepareForCompile() override;
+    void afterCompileSucceeded() override;
 
 private:
     QByteArray mEncoding;
     CppCompileType mCompileType;
     FileType mFileType;
+    CompileCache mCompileCache;
+    QByteArray mCompileCacheKey; // empty if the build can't be cached
     // Compiler interface
 protected:
     bool prepareForRebuild() override;
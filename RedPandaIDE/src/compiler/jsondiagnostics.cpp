@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "jsondiagnostics.h"
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+JsonDiagnosticsReader::JsonDiagnosticsReader():
+    mInArray{false},
+    mDepth{0},
+    mInString{false},
+    mEscaped{false}
+{
+}
+
+void JsonDiagnosticsReader::feed(const QString &text, QStringList &lines, QList<QJsonObject> &diagnostics)
+{
+    for (int i=0;i<text.length();i++) {
+        QChar ch = text[i];
+        if (!mInArray) {
+            if (ch == '\n') {
+                if (mLine.endsWith('\r'))
+                    mLine.chop(1);
+                lines.append(mLine);
+                mLine.clear();
+            } else if (ch == '[' && mLine.trimmed().isEmpty()) {
+                mLine.clear();
+                mInArray = true;
+                mDepth = 0;
+            } else {
+                mLine += ch;
+            }
+            continue;
+        }
+        if (mDepth == 0) {
+            // between the elements
+            if (ch == '{') {
+                mElement = ch;
+                mDepth = 1;
+                mInString = false;
+                mEscaped = false;
+            } else if (ch == ']') {
+                mInArray = false;
+            }
+            continue;
+        }
+        mElement += ch;
+        if (mInString) {
+            if (mEscaped)
+                mEscaped = false;
+            else if (ch == '\\')
+                mEscaped = true;
+            else if (ch == '"')
+                mInString = false;
+            continue;
+        }
+        switch (ch.unicode()) {
+        case '"':
+            mInString = true;
+            break;
+        case '{':
+        case '[':
+            mDepth++;
+            break;
+        case '}':
+        case ']':
+            mDepth--;
+            if (mDepth == 0) {
+                QJsonDocument doc = QJsonDocument::fromJson(mElement.toUtf8());
+                if (doc.isObject())
+                    diagnostics.append(doc.object());
+                mElement.clear();
+            }
+            break;
+        }
+    }
+}
+
+void JsonDiagnosticsReader::finish(QStringList &lines)
+{
+    if (!mLine.isEmpty())
+        lines.append(mLine);
+    mLine.clear();
+    mElement.clear();
+    mInArray = false;
+    mDepth = 0;
+}
+
+void convertJsonDiagnostic(const QJsonObject &diagnostic,
+                           const std::function<QString (const QString &)> &toFilename,
+                           CompileIssueList &issues, QStringList &logLines,
+                           int &errorCount, int &warningCount)
+{
+    QString kind = diagnostic["kind"].toString();
+    QString message = diagnostic["message"].toString();
+    QString option = diagnostic["option"].toString();
+    PCompileIssue issue = std::make_shared<CompileIssue>();
+    issue->line = -1;
+    issue->column = -1;
+    issue->endColumn = -1;
+    // counted in the same way as the text messages
+    if (kind.contains("error")) {
+        errorCount += 1;
+        issue->type = CompileIssueType::Error;
+        issue->description = QCoreApplication::translate("Compiler", "[Error] ") + message;
+    } else if (kind.contains("warning")) {
+        warningCount += 1;
+        issue->type = CompileIssueType::Warning;
+        issue->description = QCoreApplication::translate("Compiler", "[Warning] ") + message;
+    } else if (kind == "note") {
+        warningCount += 1;
+        issue->type = CompileIssueType::Note;
+        issue->description = QCoreApplication::translate("Compiler", "[Note] ") + message;
+    } else {
+        issue->type = CompileIssueType::Other;
+        issue->description = message;
+    }
+    if (!option.isEmpty())
+        issue->description += QString(" [%1]").arg(option);
+
+    QJsonArray locations = diagnostic["locations"].toArray();
+    QString filename;
+    if (!locations.isEmpty()) {
+        QJsonObject location = locations[0].toObject();
+        QJsonObject caret = location["caret"].toObject();
+        filename = caret["file"].toString();
+        issue->filename = toFilename(filename);
+        issue->line = caret["line"].toInt() - 1;
+        issue->column = caret["column"].toInt() - 1;
+        // "finish" is the last column of the range
+        QJsonObject finish = location["finish"].toObject();
+        if (finish["line"].toInt() == caret["line"].toInt())
+            issue->endColumn = finish["column"].toInt();
+    }
+    foreach (const QJsonValue& value, diagnostic["fixits"].toArray()) {
+        QJsonObject fixIt = value.toObject();
+        QJsonObject start = fixIt["start"].toObject();
+        QJsonObject next = fixIt["next"].toObject();
+        if (toFilename(start["file"].toString()) != issue->filename)
+            continue;
+        CompileIssueFixIt item;
+        item.line = start["line"].toInt() - 1;
+        item.column = start.value("byte-column").toInt(start["column"].toInt()) - 1;
+        item.endLine = next["line"].toInt() - 1;
+        item.endColumn = next.value("byte-column").toInt(next["column"].toInt()) - 1;
+        item.text = fixIt["string"].toString();
+        issue->fixIts.append(item);
+    }
+    if (issue->line >= 0)
+        logLines.append(QString("%1:%2:%3: %4: %5").arg(filename).arg(issue->line+1).arg(issue->column+1).arg(kind, message));
+    else
+        logLines.append(QString("%1: %2").arg(kind, message));
+    issues.append(issue);
+
+    // events of the static analyzer
+    foreach (const QJsonValue& value, diagnostic["path"].toArray()) {
+        QJsonObject event = value.toObject();
+        QJsonObject location = event["location"].toObject();
+        PCompileIssue eventIssue = std::make_shared<CompileIssue>();
+        eventIssue->type = CompileIssueType::Note;
+        eventIssue->filename = toFilename(location["file"].toString());
+        eventIssue->line = location["line"].toInt() - 1;
+        eventIssue->column = location["column"].toInt() - 1;
+        eventIssue->endColumn = -1;
+        eventIssue->description = QCoreApplication::translate("Compiler", "[Note] ") + event["description"].toString();
+        issues.append(eventIssue);
+    }
+    // related locations, e.g. "candidate: ..." and "declared here"
+    foreach (const QJsonValue& value, diagnostic["children"].toArray()) {
+        convertJsonDiagnostic(value.toObject(), toFilename, issues, logLines, errorCount, warningCount);
+    }
+}
+
+int byteColumnToCharColumn(const QString& lineText, int byteColumn)
+{
+    int bytes = 0;
+    int i = 0;
+    while (i < lineText.length() && bytes < byteColumn) {
+        if (lineText[i].isHighSurrogate() && i+1 < lineText.length()) {
+            bytes += lineText.mid(i, 2).toUtf8().length();
+            i += 2;
+        } else {
+            bytes += QString(lineText[i]).toUtf8().length();
+            i++;
+        }
+    }
+    return i;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef JSONDIAGNOSTICS_H
+#define JSONDIAGNOSTICS_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include "../common.h"
+
+/**
+ * @brief Splits the stderr of gcc -fdiagnostics-format=json into diagnostics.
+ *
+ * gcc prints the diagnostics as one JSON array, which may be large and may
+ * arrive in several chunks. Each element of the array is parsed as soon as
+ * it's complete. Text outside the array (linker messages, "compilation
+ * terminated." etc.) is returned line by line.
+ */
+class JsonDiagnosticsReader
+{
+public:
+    JsonDiagnosticsReader();
+    void feed(const QString& text, QStringList& lines, QList<QJsonObject>& diagnostics);
+    /**
+     * @brief the output is finished, return the unterminated line
+     */
+    void finish(QStringList& lines);
+private:
+    QString mLine; // the unterminated text line
+    QString mElement; // the incomplete array element
+    bool mInArray;
+    int mDepth;
+    bool mInString;
+    bool mEscaped;
+};
+
+/**
+ * @brief convert a diagnostic and its children to compile issues
+ *
+ * The events of the static analyzer's path are converted to notes.
+ * Errors, warnings and notes are counted in the same way as the text messages.
+ * @param toFilename maps the file names in the diagnostic to the absolute ones
+ * @param logLines the diagnostics in gcc's text format, one line for each
+ */
+void convertJsonDiagnostic(const QJsonObject& diagnostic,
+                           const std::function<QString (const QString&)>& toFilename,
+                           CompileIssueList& issues, QStringList& logLines,
+                           int& errorCount, int& warningCount);
+
+/**
+ * @brief gcc reports fix-it columns in utf-8 bytes, convert one to the column in lineText
+ */
+int byteColumnToCharColumn(const QString& lineText, int byteColumn);
+
+#endif // JSONDIAGNOSTICS_H
@@ -18,18 +18,40 @@
 #include "../utils.h"
 #include "../settings.h"
 #include "../systemconsts.h"
+#include <QDir>
 #include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutex>
 #include <QProcess>
+#include <QTemporaryDir>
+#include <QWaitCondition>
 #ifdef Q_OS_WINDOWS
 #include <psapi.h>
 #endif
+#ifdef Q_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#endif
 
+// limits of the files copied to the working directory of each parallel case
+static constexpr int MaxCopiedWorkDirFiles = 100;
+static constexpr qint64 MaxCopiedWorkDirSize = 64 * 1024 * 1024;
 
 OJProblemCasesRunner::OJProblemCasesRunner(const QString& filename, const QStringList& arguments, const QString& workDir,
                                            const QVector<POJProblemCase>& problemCases, QObject *parent):
     Runner(filename,arguments,workDir,parent),
     mExecTimeout(0),
-    mMemoryLimit(0)
+    mMemoryLimit(0),
+    mParallelJobs(1)
 {
     mProblemCases = problemCases;
     mBufferSize = 8192;
@@ -41,7 +63,8 @@ OJProblemCasesRunner::OJProblemCasesRunner(const QString& filename, const QStrin
                                            POJProblemCase problemCase, QObject *parent):
     Runner(filename,arguments,workDir,parent),
     mExecTimeout(0),
-    mMemoryLimit(0)
+    mMemoryLimit(0),
+    mParallelJobs(1)
 {
     mProblemCases.append(problemCase);
     mBufferSize = 8192;
@@ -49,27 +72,11 @@ OJProblemCasesRunner::OJProblemCasesRunner(const QString& filename, const QStrin
     setWaitForFinishTime(100);
 }
 
-void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
+QProcessEnvironment OJProblemCasesRunner::caseEnvironment() const
 {
-    emit caseStarted(problemCase->id(),index, mProblemCases.count());
-    auto action = finally([this,&index, &problemCase]{
-        emit caseFinished(problemCase->id(), index, mProblemCases.count());
-    });
-    QProcess process;
-    bool errorOccurred = false;
-    QByteArray readed;
-    QByteArray buffer;
-    QByteArray output;
-    int noOutputTime = 0;
-    QElapsedTimer elapsedTimer;
-    bool execTimeouted = false;
-    process.setProgram(mFilename);
-    process.setArguments(mArguments);
-    process.setWorkingDirectory(mWorkDir);
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     QString path = env.value("PATH");
     QStringList pathAdded;
-    bool writeChannelClosed = false;
     if (pSettings->compilerSets().defaultSet()) {
         foreach(const QString& dir, pSettings->compilerSets().defaultSet()->binDirs()) {
             pathAdded.append(dir);
@@ -82,9 +89,41 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         path = pathAdded.join(PATH_SEPARATOR);
     }
     env.insert("PATH",path);
-    process.setProcessEnvironment(env);
-    if (pSettings->executor().redirectStderrToToolLog()) {
-        emit logStderrOutput("\n"+tr("--- stderr from %1 ---").arg(problemCase->name()+"\n"));
+    return env;
+}
+
+void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase, const QString& workDir, bool parallel, QString& stderrOutput)
+{
+#ifdef Q_OS_LINUX
+    runCaseWithRusage(index, problemCase, workDir, parallel, stderrOutput);
+#else
+    QProcess process;
+    bool errorOccurred = false;
+    QByteArray readed;
+    QByteArray buffer;
+    QByteArray output;
+    QElapsedTimer elapsedTimer;
+    QElapsedTimer refreshTimer;
+    qint64 wallTime = -1;
+    bool execTimeouted = false;
+    // output of parallel cases is shown when they are reported, not while running
+    bool streamOutput = !parallel;
+    if (streamOutput)
+        emit caseStarted(problemCase->id(),index, mProblemCases.count());
+    process.setProgram(mFilename);
+    process.setArguments(mArguments);
+    process.setWorkingDirectory(workDir);
+    bool writeChannelClosed = false;
+    process.setProcessEnvironment(caseEnvironment());
+    bool redirectStderr = pSettings->executor().redirectStderrToToolLog();
+    auto logStderr = [this, streamOutput, &stderrOutput](const QString& s) {
+        if (streamOutput)
+            emit logStderrOutput(s);
+        else
+            stderrOutput += s;
+    };
+    if (redirectStderr) {
+        logStderr("\n"+tr("--- stderr from %1 ---").arg(problemCase->name()+"\n"));
     } else {
         process.setProcessChannelMode(QProcess::MergedChannels);
         process.setReadChannel(QProcess::StandardOutput);
@@ -94,6 +133,19 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
                 [&](){
         errorOccurred= true;
     });
+    // wall time is taken when the process really starts and exits,
+    // not when the polling loop below notices it
+    process.connect(
+                &process, &QProcess::started,
+                [&](){
+        elapsedTimer.start();
+    });
+    process.connect(
+                &process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+                [&](){
+        if (elapsedTimer.isValid())
+            wallTime = elapsedTimer.elapsed();
+    });
     problemCase->output.clear();
     process.start();
     process.waitForStarted(5000);
@@ -111,13 +163,21 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         process.waitForFinished(0);
     }
 
-    elapsedTimer.start();
+    if (!elapsedTimer.isValid())
+        elapsedTimer.start();
+    refreshTimer.start();
     while (true) {
         if (process.bytesToWrite()==0 && !writeChannelClosed) {
             writeChannelClosed = true;
             process.closeWriteChannel();
         }
-        process.waitForFinished(mWaitForFinishTime);
+        int waitTime = mWaitForFinishTime;
+        if (mExecTimeout>0) {
+            // don't oversleep the time limit
+            qint64 remaining = mExecTimeout - elapsedTimer.elapsed() + 1;
+            waitTime = std::max<qint64>(1, std::min<qint64>(waitTime, remaining));
+        }
+        process.waitForFinished(waitTime);
         if (process.state()!=QProcess::Running) {
             break;
         }
@@ -134,25 +194,24 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
         }
         if (errorOccurred)
             break;
-        if (pSettings->executor().redirectStderrToToolLog()) {
+        if (redirectStderr) {
             QString s = QString::fromLocal8Bit(process.readAllStandardError());
             if (!s.isEmpty())
-                emit logStderrOutput(s);
+                logStderr(s);
         }
         readed = process.read(mBufferSize);
         buffer += readed;
-        if (buffer.length()>=mBufferSize || noOutputTime > mOutputRefreshTime) {
+        if (buffer.length()>=mBufferSize || refreshTimer.elapsed() > mOutputRefreshTime) {
             if (!buffer.isEmpty()) {
-                emit newOutputGetted(problemCase->id(),QString::fromLocal8Bit(buffer));
+                if (streamOutput)
+                    emit newOutputGetted(problemCase->id(),QString::fromLocal8Bit(buffer));
                 output.append(buffer);
                 buffer.clear();
             }
-            noOutputTime = 0;
-        } else {
-            noOutputTime += mWaitForFinishTime;
+            refreshTimer.start();
         }
     }
-    problemCase->runningTime=elapsedTimer.elapsed();
+    problemCase->runningTime = (wallTime >= 0) ? wallTime : elapsedTimer.elapsed();
     problemCase->runningMemory = 0;
 #ifdef Q_OS_WIN
     if (hProcess!=NULL) {
@@ -176,19 +235,22 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
 #endif
     if (execTimeouted) {
         problemCase->output = tr("Time limit exceeded!");
-        emit resetOutput(problemCase->id(), problemCase->output);
+        if (streamOutput)
+            emit resetOutput(problemCase->id(), problemCase->output);
     } else if (mMemoryLimit>0 && problemCase->runningMemory>mMemoryLimit) {
         problemCase->output = tr("Memory limit exceeded!");
-        emit resetOutput(problemCase->id(), problemCase->output);
+        if (streamOutput)
+            emit resetOutput(problemCase->id(), problemCase->output);
     } else {
-        if (pSettings->executor().redirectStderrToToolLog()) {
+        if (redirectStderr) {
             QString s = QString::fromLocal8Bit(process.readAllStandardError());
             if (!s.isEmpty())
-                emit logStderrOutput(s);
+                logStderr(s);
         }
         if (process.state() == QProcess::ProcessState::NotRunning)
             buffer += process.readAll();
-        emit newOutputGetted(problemCase->id(),QString::fromLocal8Bit(buffer));
+        if (streamOutput)
+            emit newOutputGetted(problemCase->id(),QString::fromLocal8Bit(buffer));
         output.append(buffer);
         problemCase->output = QString::fromLocal8Bit(output);
 
@@ -216,6 +278,399 @@ void OJProblemCasesRunner::runCase(int index,POJProblemCase problemCase)
             }
         }
     }
+#endif
+}
+
+#ifdef Q_OS_LINUX
+static void setNonBlocking(int fd)
+{
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+void OJProblemCasesRunner::runCaseWithRusage(int index, POJProblemCase problemCase, const QString &workDir, bool parallel, QString &stderrOutput)
+{
+    bool streamOutput = !parallel;
+    if (streamOutput)
+        emit caseStarted(problemCase->id(),index, mProblemCases.count());
+    bool redirectStderr = pSettings->executor().redirectStderrToToolLog();
+    auto logStderr = [this, streamOutput, &stderrOutput](const QString& s) {
+        if (streamOutput)
+            emit logStderrOutput(s);
+        else
+            stderrOutput += s;
+    };
+    if (redirectStderr)
+        logStderr("\n"+tr("--- stderr from %1 ---").arg(problemCase->name()+"\n"));
+    problemCase->output.clear();
+
+    QByteArray input;
+    if (fileExists(problemCase->inputFileName()))
+        input = readFileToByteArray(problemCase->inputFileName());
+    else
+        input = problemCase->input().toLocal8Bit();
+
+    // everything used by the child is prepared before fork()
+    QByteArray program = QFile::encodeName(mFilename);
+    QByteArray workDirPath = QFile::encodeName(workDir);
+    QList<QByteArray> argStrings;
+    argStrings.append(program);
+    foreach (const QString& arg, mArguments)
+        argStrings.append(arg.toLocal8Bit());
+    QList<QByteArray> envStrings;
+    foreach (const QString& var, caseEnvironment().toStringList())
+        envStrings.append(var.toLocal8Bit());
+    std::vector<char*> argv;
+    for (QByteArray& arg : argStrings)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+    std::vector<char*> envp;
+    for (QByteArray& var : envStrings)
+        envp.push_back(var.data());
+    envp.push_back(nullptr);
+
+    struct rlimit cpuLimit{RLIM_INFINITY, RLIM_INFINITY};
+    if (mExecTimeout > 0) {
+        // in seconds, the wall clock limit below is more precise
+        rlim_t seconds = (mExecTimeout + 999) / 1000 + 1;
+        cpuLimit = {seconds, seconds + 1};
+    }
+    struct rlimit dataLimit{RLIM_INFINITY, RLIM_INFINITY};
+    struct rlimit stackLimit{RLIM_INFINITY, RLIM_INFINITY};
+    getrlimit(RLIMIT_STACK, &stackLimit);
+    if (mMemoryLimit > 0) {
+        // a guard against runaway allocations. MLE is judged by the peak rss,
+        // so programs slightly over the limit still finish and are reported.
+        dataLimit.rlim_cur = dataLimit.rlim_max = 2 * (rlim_t)mMemoryLimit;
+        // judges usually allow the whole memory limit for the stack
+        if (stackLimit.rlim_max == RLIM_INFINITY || stackLimit.rlim_max >= mMemoryLimit)
+            stackLimit.rlim_cur = mMemoryLimit;
+    }
+
+    int stdinPipe[2];
+    int stdoutPipe[2];
+    int stderrPipe[2] = {-1, -1};
+    int execPipe[2]; // reports the errno if exec() fails
+    auto reportPipeError = [this]() {
+        emit runErrorOccurred(tr("Can't create pipes for the runner process '%1'.").arg(mFilename)
+                              + " " + QString::fromLocal8Bit(strerror(errno)));
+    };
+    if (pipe2(stdinPipe, O_CLOEXEC) != 0) {
+        reportPipeError();
+        return;
+    }
+    if (pipe2(stdoutPipe, O_CLOEXEC) != 0) {
+        reportPipeError();
+        close(stdinPipe[0]); close(stdinPipe[1]);
+        return;
+    }
+    if (pipe2(execPipe, O_CLOEXEC) != 0) {
+        reportPipeError();
+        close(stdinPipe[0]); close(stdinPipe[1]);
+        close(stdoutPipe[0]); close(stdoutPipe[1]);
+        return;
+    }
+    if (redirectStderr && pipe2(stderrPipe, O_CLOEXEC) != 0) {
+        reportPipeError();
+        close(stdinPipe[0]); close(stdinPipe[1]);
+        close(stdoutPipe[0]); close(stdoutPipe[1]);
+        close(execPipe[0]); close(execPipe[1]);
+        return;
+    }
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    pid_t pid = fork();
+    if (pid == 0) {
+        // an ignored SIGPIPE is inherited through execve()
+        struct sigaction defaultAction{};
+        defaultAction.sa_handler = SIG_DFL;
+        sigemptyset(&defaultAction.sa_mask);
+        sigaction(SIGPIPE, &defaultAction, nullptr);
+        dup2(stdinPipe[0], STDIN_FILENO);
+        dup2(stdoutPipe[1], STDOUT_FILENO);
+        dup2(redirectStderr ? stderrPipe[1] : stdoutPipe[1], STDERR_FILENO);
+        setrlimit(RLIMIT_CPU, &cpuLimit);
+        setrlimit(RLIMIT_DATA, &dataLimit);
+        setrlimit(RLIMIT_STACK, &stackLimit);
+        if (chdir(workDirPath.constData()) == 0)
+            execve(argv[0], argv.data(), envp.data());
+        int error = errno;
+        ssize_t written = write(execPipe[1], &error, sizeof(error));
+        Q_UNUSED(written);
+        _exit(127);
+    }
+    close(stdinPipe[0]);
+    close(stdoutPipe[1]);
+    close(execPipe[1]);
+    if (redirectStderr)
+        close(stderrPipe[1]);
+    if (pid < 0) {
+        close(stdinPipe[1]);
+        close(stdoutPipe[0]);
+        close(execPipe[0]);
+        if (redirectStderr)
+            close(stderrPipe[0]);
+        emit runErrorOccurred(tr("The runner process '%1' failed to start.").arg(mFilename));
+        return;
+    }
+    // the child may exit without reading all its input, writing to the pipe
+    // must fail with EPIPE instead of killing the IDE
+    sigset_t pipeSignals;
+    sigset_t oldSignals;
+    sigemptyset(&pipeSignals);
+    sigaddset(&pipeSignals, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSignals, &oldSignals);
+    bool inputBroken = false;
+    auto restoreSignals = finally([&]{
+        if (inputBroken && !sigismember(&oldSignals, SIGPIPE)) {
+            // discard the pending SIGPIPE raised by the failed write
+            struct timespec noWait{0, 0};
+            while (sigtimedwait(&pipeSignals, nullptr, &noWait) > 0) {}
+        }
+        pthread_sigmask(SIG_SETMASK, &oldSignals, nullptr);
+    });
+    int execError = 0;
+    bool execFailed = read(execPipe[0], &execError, sizeof(execError)) == sizeof(execError);
+    close(execPipe[0]);
+
+    int inputFd = stdinPipe[1];
+    int outputFd = stdoutPipe[0];
+    int errorFd = redirectStderr ? stderrPipe[0] : -1;
+    setNonBlocking(inputFd);
+    setNonBlocking(outputFd);
+    if (errorFd >= 0)
+        setNonBlocking(errorFd);
+    if (input.isEmpty() || execFailed) {
+        close(inputFd);
+        inputFd = -1;
+    }
+
+    qint64 inputWritten = 0;
+    QByteArray buffer;
+    QByteArray output;
+    QElapsedTimer refreshTimer;
+    refreshTimer.start();
+    bool execTimeouted = false;
+    bool exited = false;
+    int status = 0;
+    struct rusage usage{};
+    char readBuffer[65536];
+    auto readAvailable = [&readBuffer](int& fd, QByteArray& data) {
+        while (fd >= 0) {
+            ssize_t n = read(fd, readBuffer, sizeof(readBuffer));
+            if (n > 0) {
+                data.append(readBuffer, n);
+            } else if (n == 0 || (errno != EAGAIN && errno != EINTR)) {
+                close(fd);
+                fd = -1;
+            } else if (errno == EAGAIN) {
+                break;
+            }
+        }
+    };
+    while (!exited) {
+        struct pollfd fds[3];
+        int count = 0;
+        if (inputFd >= 0)
+            fds[count++] = {inputFd, POLLOUT, 0};
+        if (outputFd >= 0)
+            fds[count++] = {outputFd, POLLIN, 0};
+        if (errorFd >= 0)
+            fds[count++] = {errorFd, POLLIN, 0};
+        int waitTime = mWaitForFinishTime;
+        if (mExecTimeout > 0) {
+            qint64 remaining = mExecTimeout - elapsedTimer.elapsed() + 1;
+            waitTime = std::max<qint64>(1, std::min<qint64>(waitTime, remaining));
+        }
+        // wakes up as soon as the pipes are closed by the exiting child
+        poll(fds, count, (count > 0) ? waitTime : std::min(waitTime, 1));
+        if (inputFd >= 0) {
+            ssize_t n = write(inputFd, input.constData() + inputWritten, input.size() - inputWritten);
+            if (n > 0)
+                inputWritten += n;
+            // EPIPE: the input is closed by the child, the rest is dropped
+            if (n < 0 && errno == EPIPE)
+                inputBroken = true;
+            if ((n < 0 && errno != EAGAIN && errno != EINTR) || inputWritten >= input.size()) {
+                close(inputFd);
+                inputFd = -1;
+            }
+        }
+        readAvailable(outputFd, buffer);
+        if (errorFd >= 0) {
+            QByteArray errorOutput;
+            readAvailable(errorFd, errorOutput);
+            if (!errorOutput.isEmpty())
+                logStderr(QString::fromLocal8Bit(errorOutput));
+        }
+        if (buffer.length()>=mBufferSize || refreshTimer.elapsed() > mOutputRefreshTime) {
+            if (!buffer.isEmpty()) {
+                if (streamOutput)
+                    emit newOutputGetted(problemCase->id(),QString::fromLocal8Bit(buffer));
+                output.append(buffer);
+                buffer.clear();
+            }
+            refreshTimer.start();
+        }
+        pid_t w = wait4(pid, &status, WNOHANG, &usage);
+        if (w == pid || (w < 0 && errno != EINTR)) {
+            exited = true;
+            break;
+        }
+        if (mExecTimeout > 0 && elapsedTimer.elapsed() > mExecTimeout)
+            execTimeouted = true;
+        if (mStop || execTimeouted) {
+            kill(pid, SIGKILL);
+            wait4(pid, &status, 0, &usage);
+            exited = true;
+        }
+    }
+    // pipes may be still open in the grandchildren
+    if (outputFd >= 0) {
+        readAvailable(outputFd, buffer);
+        if (outputFd >= 0)
+            close(outputFd);
+    }
+    if (errorFd >= 0) {
+        QByteArray errorOutput;
+        readAvailable(errorFd, errorOutput);
+        if (errorFd >= 0)
+            close(errorFd);
+        if (!errorOutput.isEmpty())
+            logStderr(QString::fromLocal8Bit(errorOutput));
+    }
+    if (inputFd >= 0)
+        close(inputFd);
+
+    qint64 cpuTime = (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000
+            + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+    // like a judge, cpu time is reported
+    problemCase->runningTime = execFailed ? 0 : cpuTime;
+    problemCase->runningMemory = execFailed ? 0 : (qulonglong)usage.ru_maxrss * 1024; // ru_maxrss is in kb
+    if (!execTimeouted && mExecTimeout > 0) {
+        execTimeouted = cpuTime > mExecTimeout
+                || (WIFSIGNALED(status) && WTERMSIG(status) == SIGXCPU);
+    }
+
+    if (execFailed) {
+        emit runErrorOccurred(tr("The runner process '%1' failed to start.").arg(mFilename)
+                              + " " + QString::fromLocal8Bit(strerror(execError)));
+    } else if (execTimeouted) {
+        problemCase->output = tr("Time limit exceeded!");
+        if (streamOutput)
+            emit resetOutput(problemCase->id(), problemCase->output);
+    } else if (mMemoryLimit>0 && problemCase->runningMemory>mMemoryLimit) {
+        problemCase->output = tr("Memory limit exceeded!");
+        if (streamOutput)
+            emit resetOutput(problemCase->id(), problemCase->output);
+    } else {
+        if (streamOutput)
+            emit newOutputGetted(problemCase->id(),QString::fromLocal8Bit(buffer));
+        output.append(buffer);
+        problemCase->output = QString::fromLocal8Bit(output);
+    }
+}
+#endif
+
+bool OJProblemCasesRunner::listWorkDirFiles(QStringList &files) const
+{
+    QDir dir(mWorkDir);
+    QFileInfo programInfo(mFilename);
+    qint64 totalSize = 0;
+    foreach (const QFileInfo& info, dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot)) {
+        if (info == programInfo)
+            continue;
+        totalSize += info.size();
+        if (files.count() >= MaxCopiedWorkDirFiles || totalSize > MaxCopiedWorkDirSize)
+            return false;
+        files.append(info.fileName());
+    }
+    return true;
+}
+
+void OJProblemCasesRunner::copyWorkDirFiles(const QStringList &files, const QString &dir) const
+{
+    QDir sourceDir(mWorkDir);
+    QDir targetDir(dir);
+    // copies, not links: a case writing to a file must not change it for the others
+    foreach (const QString& fileName, files) {
+        QFile::copy(sourceDir.absoluteFilePath(fileName), targetDir.absoluteFilePath(fileName));
+    }
+}
+
+void OJProblemCasesRunner::runCasesInParallel(int jobs, const QStringList& workDirFiles)
+{
+    int total = mProblemCases.count();
+    QMutex mutex;
+    QWaitCondition caseDone;
+    int nextCase = 0;
+    int runningWorkers = jobs;
+    QVector<bool> finished(total, false);
+    QVector<QString> stderrOutputs(total);
+
+    auto worker = [&]() {
+        while (true) {
+            int index;
+            {
+                QMutexLocker locker(&mutex);
+                if (mStop || nextCase >= total)
+                    break;
+                index = nextCase++;
+            }
+            QString stderrOutput;
+            {
+                // cases may write files, don't let them see each other's
+                QTemporaryDir workDir;
+                if (workDir.isValid()) {
+                    copyWorkDirFiles(workDirFiles, workDir.path());
+                    runCase(index, mProblemCases[index], workDir.path(), true, stderrOutput);
+                } else {
+                    runCase(index, mProblemCases[index], mWorkDir, true, stderrOutput);
+                }
+            }
+            QMutexLocker locker(&mutex);
+            stderrOutputs[index] = stderrOutput;
+            finished[index] = true;
+            caseDone.wakeAll();
+        }
+        QMutexLocker locker(&mutex);
+        runningWorkers--;
+        caseDone.wakeAll();
+    };
+    QList<QThread*> threads;
+    for (int i=0;i<jobs;i++) {
+        QThread* thread = QThread::create(worker);
+        threads.append(thread);
+        thread->start();
+    }
+
+    // report in case order, as if they were run one by one
+    int reported = 0;
+    {
+        QMutexLocker locker(&mutex);
+        while (reported < total) {
+            if (finished[reported]) {
+                POJProblemCase problemCase = mProblemCases[reported];
+                QString stderrOutput = stderrOutputs[reported];
+                locker.unlock();
+                emit caseStarted(problemCase->id(), reported, total);
+                if (!stderrOutput.isEmpty())
+                    emit logStderrOutput(stderrOutput);
+                emit resetOutput(problemCase->id(), problemCase->output);
+                emit caseFinished(problemCase->id(), reported, total);
+                locker.relock();
+                reported++;
+                continue;
+            }
+            if (runningWorkers == 0)
+                break;
+            caseDone.wait(&mutex);
+        }
+    }
+    foreach (QThread* thread, threads) {
+        thread->wait();
+        delete thread;
+    }
 }
 
 void OJProblemCasesRunner::run()
@@ -223,14 +678,34 @@ void OJProblemCasesRunner::run()
     auto action = finally([this]{
         emit terminated();
     });
+    int jobs = std::min<int>(mParallelJobs, mProblemCases.size());
+    // solutions may open the files in the working directory by relative paths,
+    // each parallel case gets its own copy of them, or the cases are run one by one
+    QStringList workDirFiles;
+    if (jobs > 1 && listWorkDirFiles(workDirFiles)) {
+        runCasesInParallel(jobs, workDirFiles);
+        return;
+    }
     for (int i=0; i < mProblemCases.size(); i++) {
         if (mStop)
             break;
         POJProblemCase problemCase = mProblemCases[i];
-        runCase(i,problemCase);
+        QString stderrOutput;
+        runCase(i, problemCase, mWorkDir, false, stderrOutput);
+        emit caseFinished(problemCase->id(), i, mProblemCases.count());
     }
 }
 
+int OJProblemCasesRunner::parallelJobs() const
+{
+    return mParallelJobs;
+}
+
+void OJProblemCasesRunner::setParallelJobs(int newParallelJobs)
+{
+    mParallelJobs = newParallelJobs;
+}
+
 int OJProblemCasesRunner::execTimeout() const
 {
     return mExecTimeout;
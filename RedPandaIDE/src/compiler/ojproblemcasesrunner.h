@@ -18,6 +18,7 @@
 #define OJPROBLEMCASESRUNNER_H
 
 #include "runner.h"
+#include <QProcessEnvironment>
 #include <QVector>
 #include "../problems/ojproblemset.h"
 
@@ -49,6 +50,10 @@ public:
 
     void setMemoryLimit(size_t limit);
 
+    // number of cases run at the same time
+    int parallelJobs() const;
+    void setParallelJobs(int newParallelJobs);
+
     bool includeOutputFromStderr() const;
     void setIncludeOutputFromStderr(bool newIncludeOutputFromStderr);
 
@@ -59,7 +64,29 @@ signals:
     void resetOutput(const QString &caseId, const QString &newOutputLine);
     void logStderrOutput(const QString& msg);
 private:
-    void runCase(int index, POJProblemCase problemCase);
+    /**
+     * @param parallel if true, nothing is shown while it's running, and the
+     *   stderr output is returned in stderrOutput
+     */
+    void runCase(int index, POJProblemCase problemCase, const QString& workDir,
+                 bool parallel, QString& stderrOutput);
+    void runCasesInParallel(int jobs, const QStringList& workDirFiles);
+    /**
+     * @brief list the files in the working directory, to be copied to each case's own one
+     * @return false if there are too many or they are too large to be copied
+     */
+    bool listWorkDirFiles(QStringList& files) const;
+    void copyWorkDirFiles(const QStringList& files, const QString& dir) const;
+    QProcessEnvironment caseEnvironment() const;
+#ifdef Q_OS_LINUX
+    /**
+     * @brief run the case with fork/exec, to get its cpu time and peak memory
+     *
+     * The time and memory limits are also enforced with setrlimit().
+     */
+    void runCaseWithRusage(int index, POJProblemCase problemCase, const QString& workDir,
+                           bool parallel, QString& stderrOutput);
+#endif
 private:
     QVector<POJProblemCase> mProblemCases;
 
@@ -71,6 +98,7 @@ private:
     int mOutputRefreshTime;
     int mExecTimeout;
     size_t mMemoryLimit;
+    int mParallelJobs;
     bool mIncludeOutputFromStderr;
 };
 
@@ -64,10 +64,12 @@ void ProjectCompiler::createStandardMakeFile()
     QString exeCommand = escapeArgumentForMakefileRecipe(executable, false);
     writeln(file, exeTarget + ": $(OBJ)\n");
     if (!mOnlyCheckSyntax) {
+        writeMakeTimingMarker(file, "begin", "link", executable);
         if (mProject->options().isCpp) {
             writeln(file, "\t$(CXX) $(LINKOBJ) -o " + exeCommand + " $(LIBS)");
         } else
             writeln(file, "\t$(CC) $(LINKOBJ) -o " + exeCommand + " $(LIBS)");
+        writeMakeTimingMarker(file, "end", "link", executable);
     }
     writeMakeObjFilesRules(file);
 }
@@ -80,8 +82,10 @@ void ProjectCompiler::createStaticMakeFile()
     QString libTarget = escapeFilenameForMakefileTarget(libFilename);
     QString libCommand = escapeArgumentForMakefileRecipe(libFilename, false);
     writeln(file, libTarget + ": $(OBJ)");
+    writeMakeTimingMarker(file, "begin", "link", libFilename);
     writeln(file, "\tar r " + libCommand + " $(LINKOBJ)");
     writeln(file, "\tranlib " + libCommand);
+    writeMakeTimingMarker(file, "end", "link", libFilename);
     writeMakeObjFilesRules(file);
 }
 
@@ -94,6 +98,7 @@ void ProjectCompiler::createDynamicMakeFile()
     QString dynamicLibTarget = escapeFilenameForMakefileTarget(dynamicLibFilename);
     QString dynamicLibCommand = escapeArgumentForMakefileRecipe(dynamicLibFilename, false);
     writeln(file, dynamicLibTarget + ": $(DEF) $(OBJ)");
+    writeMakeTimingMarker(file, "begin", "link", dynamicLibFilename);
     if (genModuleDef) {
         if (mProject->options().isCpp) {
             writeln(file, "\t$(CXX) -mdll $(LINKOBJ) -o " + dynamicLibCommand + " $(LIBS) $(DEF) -Wl,--output-def,$(OUTPUT_DEF),--out-implib,$(STATIC)");
@@ -107,6 +112,7 @@ void ProjectCompiler::createDynamicMakeFile()
             writeln(file, "\t$(CC) -mdll $(LINKOBJ) -o " + dynamicLibCommand + " $(LIBS) $(DEF) -Wl,--out-implib,$(STATIC)");
         }
     }
+    writeMakeTimingMarker(file, "end", "link", dynamicLibFilename);
     writeMakeObjFilesRules(file);
 }
 
@@ -177,6 +183,7 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
     QStringList objects;
     QStringList LinkObjects;
     QStringList cleanObjects;
+    QStringList depFiles;
     QStringList moduleDefines;
 
     genModuleDef = false;
@@ -199,11 +206,15 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
                 if (unit->link()) {
                     LinkObjects << relativeObjFile;
                 }
+                if (isC_CPPSourceFile(fileType))
+                    depFiles << changeFileExt(relativeObjFile, DEP_EXT);
             } else {
                 objects << changeFileExt(relativeName, OBJ_EXT);
                 cleanObjects << localizeMakefilePath(changeFileExt(relativeName, OBJ_EXT));
                 if (unit->link())
                     LinkObjects << changeFileExt(relativeName, OBJ_EXT);
+                if (isC_CPPSourceFile(fileType))
+                    depFiles << changeFileExt(relativeName, DEP_EXT);
             }
         }
         if (fileType == FileType::ModuleDef)
@@ -279,8 +290,15 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
     QString pch = extractRelativePath(mProject->makeFileName(), mProject->options().precompiledHeader + "." GCH_EXT);
 
     // programs
-    writeln(file, "CXX      = " + escapeArgumentForMakefileVariableValue(cxx, true));
-    writeln(file, "CC       = " + escapeArgumentForMakefileVariableValue(cc, true));
+    QString compilerCache = compilerSet()->compilerCacheProgram();
+    if (!compilerCache.isEmpty()) {
+        QString launcher = escapeArgumentForMakefileVariableValue(compilerCache, true);
+        writeln(file, "CXX      = " + launcher + " " + escapeArgumentForMakefileVariableValue(cxx, false));
+        writeln(file, "CC       = " + launcher + " " + escapeArgumentForMakefileVariableValue(cc, false));
+    } else {
+        writeln(file, "CXX      = " + escapeArgumentForMakefileVariableValue(cxx, true));
+        writeln(file, "CC       = " + escapeArgumentForMakefileVariableValue(cc, true));
+    }
 #if defined(ARCH_X86_64) || defined(ARCH_X86)
     if (fileExists(pSettings->compile().NASMPath())) {
         writeln(file, "NASM       = " + escapeArgumentForMakefileVariableValue(pSettings->compile().NASMPath(), true));
@@ -298,6 +316,8 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
     writeln(file, "CXXINCS  = " + escapeArgumentsForMakefileVariableValue(cxxIncludeArguments));
     writeln(file, "CXXFLAGS = $(CXXINCS) " + escapeArgumentsForMakefileVariableValue(cxxCompileArguments));
     writeln(file, "CFLAGS   = $(INCS) " + escapeArgumentsForMakefileVariableValue(cCompileArguments));
+    // let the compiler write the headers each object depends on into a .d file
+    writeln(file, "DEPFLAGS = -MMD -MP");
 
 #if defined(ARCH_X86_64) || defined(ARCH_X86)
     writeln(file, "NASM_FLAGS   =  " + escapeArgumentsForMakefileVariableValue(nasmArguments));
@@ -315,6 +335,10 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
         writeln(file, "OBJ      = " + escapeFilenamesForMakefilePrerequisite(objects));
     };
     writeln(file, "BIN      = " + escapeFilenameForMakefilePrerequisite(executable));
+    QStringList escapedDepFiles;
+    foreach(const QString& depFile, depFiles)
+        escapedDepFiles << escapeFilenameForMakefileInclude(depFile);
+    writeln(file, "DEPS     = " + escapedDepFiles.join(' '));
     if (mProject->options().usePrecompiledHeader
             && fileExists(mProject->options().precompiledHeader)){
         writeln(file, "PCH_H    = " + escapeFilenameForMakefilePrerequisite(pchHeader));
@@ -323,6 +347,8 @@ void ProjectCompiler::writeMakeDefines(QFile &file, bool &genModuleDef)
 
     // object referenced in command arguments
     // use them in targets or prerequisites, they have different escaping rules
+    foreach(const QString& depFile, depFiles)
+        cleanObjects << localizeMakefilePath(depFile);
     if (!objResFile.isEmpty()) {
         writeln(file, "LINKOBJ  = " + escapeArgumentsForMakefileVariableValue(LinkObjects) + " " + escapeArgumentForMakefileVariableValue(objResFile, false));
         writeln(file, "CLEANOBJ = " + escapeArgumentsForMakefileVariableValue(cleanObjects) + " " + escapeArgumentForMakefileVariableValue(cleanRes, false) + " " + escapeArgumentForMakefileVariableValue(cleanExe, false));
@@ -397,8 +423,11 @@ void ProjectCompiler::writeMakeClean(QFile &file)
 
 void ProjectCompiler::writeMakeObjFilesRules(QFile &file)
 {
-    PCppParser parser = mProject->cppParser();
+    mDependencyFiles.clear();
     QString precompileStr;
+    if (mProject->options().usePrecompiledHeader
+            && fileExists(mProject->options().precompiledHeader))
+        precompileStr = " $(PCH)";
 
     QList<PProjectUnit> projectUnits=mProject->unitList();
     foreach(const PProjectUnit &unit, projectUnits) {
@@ -412,49 +441,27 @@ void ProjectCompiler::writeMakeObjFilesRules(QFile &file)
         QString shortFileName = extractRelativePath(mProject->makeFileName(),unit->fileName());
 
         writeln(file);
+        // headers are added by the .d files generated by the compiler
         QString objStr = escapeFilenameForMakefilePrerequisite(shortFileName);
-        // if we have scanned it, use scanned info
-        if (parser && parser->fileScanned(unit->fileName())) {
-            QSet<QString> includedFiles = parser->getIncludedFiles(unit->fileName());
-            foreach(const PProjectUnit &unit2, projectUnits) {
-                if (unit2==unit)
-                    continue;
-                if (includedFiles.contains(unit2->fileName())) {
-                    if (mProject->options().usePrecompiledHeader &&
-                           unit2->fileName() == mProject->options().precompiledHeader)
-                        precompileStr = " $(PCH) ";
-                    else {
-                        QString prereq = extractRelativePath(mProject->makeFileName(), unit2->fileName());
-                        objStr = objStr + ' ' + escapeFilenameForMakefilePrerequisite(prereq);
-                    }
-                }
-            }
-        } else {
-            foreach(const PProjectUnit &unit2, projectUnits) {
-                FileType fileType2 = getFileType(unit2->fileName());
-                if (isC_CPPHeaderFile(fileType2)) {
-                    QString prereq = extractRelativePath(mProject->makeFileName(), unit2->fileName());
-                    objStr = objStr + ' ' + escapeFilenameForMakefilePrerequisite(prereq);
-                }
-            }
-        }
-        QString objFileNameTarget;
-        QString objFileNameCommand;
+        if (isC_CPPSourceFile(fileType) && unit->compileCpp())
+            objStr += precompileStr;
+        QString objectFile;
         if (!mProject->options().folderForObjFiles.isEmpty()) {
             QString fullObjname = includeTrailingPathDelimiter(mProject->options().folderForObjFiles) +
                     extractFileName(unit->fileName());
-            QString objectFile = extractRelativePath(mProject->makeFileName(), changeFileExt(fullObjname, OBJ_EXT));
-            objFileNameTarget = escapeFilenameForMakefileTarget(objectFile);
-            objFileNameCommand = escapeArgumentForMakefileRecipe(objectFile, false);
+            objectFile = extractRelativePath(mProject->makeFileName(), changeFileExt(fullObjname, OBJ_EXT));
         } else {
-            QString objectFile = changeFileExt(shortFileName, OBJ_EXT);
-            objFileNameTarget = escapeFilenameForMakefileTarget(objectFile);
-            objFileNameCommand = escapeArgumentForMakefileRecipe(objectFile, false);
+            objectFile = changeFileExt(shortFileName, OBJ_EXT);
         }
+        QString objFileNameTarget = escapeFilenameForMakefileTarget(objectFile);
+        QString objFileNameCommand = escapeArgumentForMakefileRecipe(objectFile, false);
+        if (isC_CPPSourceFile(fileType))
+            mDependencyFiles.insert(objectFile, changeFileExt(objectFile, DEP_EXT));
 
-        objStr = objFileNameTarget + ": " + objStr + precompileStr;
+        objStr = objFileNameTarget + ": " + objStr;
 
         writeln(file,objStr);
+        writeMakeTimingMarker(file, "begin", "compile", objectFile);
 
         // Write custom build command
         if (unit->overrideBuildCmd() && !unit->buildCmd().isEmpty()) {
@@ -517,15 +524,16 @@ void ProjectCompiler::writeMakeObjFilesRules(QFile &file)
             }
             if (isC_CPPSourceFile(fileType)) {
                 if (unit->compileCpp())
-                    writeln(file, "\t$(CXX) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CXXFLAGS) " + encodingStr);
+                    writeln(file, "\t$(CXX) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CXXFLAGS) $(DEPFLAGS) " + encodingStr);
                 else
-                    writeln(file, "\t$(CC) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CFLAGS) " + encodingStr);
+                    writeln(file, "\t$(CC) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CFLAGS) $(DEPFLAGS) " + encodingStr);
             } else if (fileType == FileType::GAS) {
                 writeln(file, "\t$(CC) -c " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(CFLAGS) " + encodingStr);
             } else if (fileType == FileType::NASM) {
                 writeln(file, "\t$(NASM) " + escapeArgumentForMakefileRecipe(shortFileName, false) + " -o " + objFileNameCommand + " $(NASM_FLAGS) " );
             }
         }
+        writeMakeTimingMarker(file, "end", "compile", objectFile);
     }
 
 #ifdef Q_OS_WIN
@@ -577,6 +585,21 @@ void ProjectCompiler::writeMakeObjFilesRules(QFile &file)
         writeln(file);
     }
 #endif
+
+    // missing .d files (not compiled yet) are silently ignored
+    writeln(file);
+    writeln(file, "-include $(DEPS)");
+}
+
+void ProjectCompiler::writeMakeTimingMarker(QFile &file, const QString &action, const QString &kind, const QString &target)
+{
+    if (!mProject->options().reportBuildTiming)
+        return;
+    // only printed when make is called with BUILD_TIMING=1
+    writeln(file, "ifdef BUILD_TIMING");
+    writeln(file, QString("\t@echo " BUILD_TIMING_MARKER " %1 %2 %3")
+            .arg(action, kind, escapeArgumentForMakefileRecipe(target, false)));
+    writeln(file, "endif");
 }
 
 void ProjectCompiler::writeln(QFile &file, const QString &s)
@@ -651,6 +674,10 @@ bool ProjectCompiler::prepareForCompile()
         makefile,
         "all",
     };
+    mBuildTiming.clear();
+    mPendingOutput.clear();
+    if (mProject->options().reportBuildTiming)
+        makeAllArgs << "BUILD_TIMING=1";
     if (mOnlyClean) {
         mArguments = cleanArgs;
     } else if (mRebuild) {
@@ -672,5 +699,75 @@ bool ProjectCompiler::prepareForCompile()
     log(tr("- Command: %1").arg(command));
     log("");
 
+    mBuildTimer.start();
     return true;
 }
+
+void ProjectCompiler::afterCompileSucceeded()
+{
+    if (!mProject->options().reportBuildTiming || mBuildTiming.isEmpty())
+        return;
+    PBuildTimingReport report = mBuildTiming.createReport(
+                mDependencyFiles, mProject->directory(), mBuildTimer.elapsed());
+    QList<BuildTimingEntry> entries = report->entries;
+    std::sort(entries.begin(), entries.end(),
+              [](const BuildTimingEntry& e1, const BuildTimingEntry& e2) {
+        return e1.duration > e2.duration;
+    });
+    log("");
+    log(tr("Slowest Targets:"));
+    log("------------------");
+    for (int i = 0; i < entries.count() && i < 10; i++) {
+        log(tr("- %1: %2 secs").arg(entries[i].target).arg(entries[i].duration / 1000.0));
+    }
+    if (mProject->options().writeBuildTrace) {
+        QString traceFile = includeTrailingPathDelimiter(mProject->directory()) + BUILD_TRACE_FILE;
+        if (BuildTimingRecorder::writeChromeTrace(report, traceFile))
+            log(tr("- Build Trace: %1").arg(traceFile));
+        else
+            log(tr("Can't write build trace file \"%1\".").arg(traceFile));
+    }
+    emit buildTimingReady(report);
+}
+
+void ProjectCompiler::finishStandardOutput()
+{
+    // the last line may end without a newline
+    if (!mBuildTiming.processLine(mPendingOutput, mBuildTimer.elapsed())
+            && !mPendingOutput.trimmed().isEmpty())
+        log(mPendingOutput);
+    mPendingOutput.clear();
+}
+
+void ProjectCompiler::processStandardOutput(const QString &text)
+{
+    if (!mProject->options().reportBuildTiming) {
+        Compiler::processStandardOutput(text);
+        return;
+    }
+    // timing markers are consumed, not logged
+    qint64 elapsed = mBuildTimer.elapsed();
+    QString output = mPendingOutput + text;
+    mPendingOutput.clear();
+    QStringList lines = output.split('\n');
+    // a marker may be split across chunks: hold back an unterminated tail that could be one
+    QString tail = lines.last().trimmed();
+    if (QString(BUILD_TIMING_MARKER).startsWith(tail) || tail.startsWith(BUILD_TIMING_MARKER)) {
+        mPendingOutput = lines.takeLast();
+        output.chop(mPendingOutput.length());
+    }
+    QStringList logLines;
+    bool hasMarkers = false;
+    foreach (const QString& line, lines) {
+        if (mBuildTiming.processLine(line, elapsed))
+            hasMarkers = true;
+        else
+            logLines.append(line);
+    }
+    if (!hasMarkers) {
+        if (!output.isEmpty())
+            log(output);
+    } else if (!logLines.join('\n').trimmed().isEmpty()) {
+        log(logLines.join('\n').trimmed());
+    }
+}
@@ -18,8 +18,10 @@
 #define PROJECTCOMPILER_H
 
 #include "compiler.h"
+#include "buildtiming.h"
 #include <QObject>
 #include <QFile>
+#include <QElapsedTimer>
 
 class Project;
 class ProjectCompiler : public Compiler
@@ -33,6 +35,8 @@ public:
 
     bool onlyClean() const;
     void setOnlyClean(bool newOnlyClean);
+signals:
+    void buildTimingReady(PBuildTimingReport report);
 
 private:
     void createStandardMakeFile();
@@ -46,13 +50,21 @@ private:
     void writeMakeIncludes(QFile& file);
     void writeMakeClean(QFile& file);
     void writeMakeObjFilesRules(QFile& file);
+    void writeMakeTimingMarker(QFile& file, const QString& action, const QString& kind, const QString& target);
     void writeln(QFile& file, const QString& s="");
     // Compiler interface
 private:
     bool mOnlyClean;
+    BuildTimingRecorder mBuildTiming;
+    QElapsedTimer mBuildTimer;
+    QString mPendingOutput; // unterminated line that may be a timing marker
+    QHash<QString,QString> mDependencyFiles; // object -> .d file
 protected:
     bool prepareForCompile() override;
     bool prepareForRebuild() override;
+    void afterCompileSucceeded() override;
+    void processStandardOutput(const QString& text) override;
+    void finishStandardOutput() override;
 };
 
 #endif // PROJECTCOMPILER_H
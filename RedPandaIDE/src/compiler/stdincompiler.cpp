@@ -16,14 +16,28 @@
  */
 #include "stdincompiler.h"
 #include "compilermanager.h"
+#include "syntaxcheck.h"
 #include "../utils/file.h"
+#include "../systemconsts.h"
+#include "../settings.h"
+#include <qt_utils/utils.h>
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
+#include <QProcess>
+
+// precompiled headers are large, only keep the recently built ones
+static constexpr int MaxPrecompiledHeaders = 4;
+static QRecursiveMutex pchMutex;
 
 StdinCompiler::StdinCompiler(const QString &filename,const QByteArray& encoding, const QString& content, bool onlyCheckSyntax):
     Compiler(filename, onlyCheckSyntax),
     mContent(content),
-    mEncoding(encoding)
+    mEncoding(encoding),
+    mPCHCache{includeTrailingPathDelimiter(pSettings->dirs().config()) + DEV_SYNTAX_CHECK_PCH_DIR}
 {
 }
 
@@ -50,6 +64,7 @@ bool StdinCompiler::prepareForCompile()
         mArguments += getCCompileArguments(mOnlyCheckSyntax);
         mArguments += getCIncludeArguments();
         mArguments += getProjectIncludeArguments();
+        addJsonDiagnosticsArgument();
         strFileType = "C";
         mCompiler = compilerSet()->CCompiler();
         break;
@@ -67,6 +82,7 @@ bool StdinCompiler::prepareForCompile()
         mArguments += getCppCompileArguments(mOnlyCheckSyntax);
         mArguments += getCppIncludeArguments();
         mArguments += getProjectIncludeArguments();
+        addJsonDiagnosticsArgument();
         strFileType = "C++";
         mCompiler = compilerSet()->cppCompiler();
         break;
@@ -84,12 +100,16 @@ bool StdinCompiler::prepareForCompile()
             return false;
     }
 
+    // relative include dirs of the precompiled header are resolved against it too
+    mDirectory = extractFileDir(mFilename);
+    if (mOnlyCheckSyntax)
+        preparePrecompiledHeader(fileType);
+
     log(tr("Processing %1 source file:").arg(strFileType));
     log("------------------");
     log(tr("%1 Compiler: %2").arg(strFileType, mCompiler));
     QString command = escapeCommandForLog(mCompiler, mArguments);
     log(tr("Command: %1").arg(command));
-    mDirectory = extractFileDir(mFilename);
     return true;
 }
 
@@ -110,3 +130,186 @@ bool StdinCompiler::prepareForRebuild()
 {
     return true;
 }
+
+void StdinCompiler::preparePrecompiledHeader(FileType fileType)
+{
+    CompilerType compilerType = compilerSet()->compilerType();
+    if (compilerType != CompilerType::GCC && compilerType != CompilerType::Clang)
+        return;
+    QString language;
+    switch(fileType) {
+    case FileType::CSource:
+        language = "c-header";
+        break;
+    case FileType::CppSource:
+    case FileType::CCppHeader:
+        language = "c++-header";
+        break;
+    default:
+        return;
+    }
+    int sourceIndex = mArguments.indexOf("-");
+    if (sourceIndex < 2 || mArguments[sourceIndex-2] != "-x")
+        return;
+    QStringList lines = mContent.split('\n');
+    QList<int> includeLines = findLeadingSystemIncludes(lines);
+    if (includeLines.isEmpty())
+        return;
+    QByteArray headerContent;
+    foreach (int line, includeLines) {
+        headerContent += lines[line].trimmed().toUtf8() + "\n";
+    }
+
+    // same options as the check, so the header is compiled in the same way
+    QStringList arguments = mArguments;
+    arguments.removeAll("-fsyntax-only");
+    sourceIndex = arguments.indexOf("-");
+    arguments[sourceIndex-1] = language;
+
+    QString header = includeTrailingPathDelimiter(pSettings->dirs().config())
+            + DEV_SYNTAX_CHECK_PCH_DIR + QDir::separator()
+            + precompiledHeaderName(compilerSet()->name(), mCompiler, mDirectory,
+                                    arguments, headerContent);
+    QString output = precompiledHeaderOutput(header);
+
+    {
+        QMutexLocker locker(&pchMutex);
+        QDir().mkpath(extractFileDir(header));
+        QFile file(header);
+        if (!file.exists() && file.open(QFile::WriteOnly | QFile::Truncate)) {
+            file.write(headerContent);
+            file.close();
+        }
+        arguments[sourceIndex] = header;
+        arguments << "-o" << output;
+        arguments << "-MD" << "-MF" << mPCHCache.dependencyFilename(header);
+        QByteArray key = CompileCache::computeKey(mCompiler, arguments, header);
+        if (!mPCHCache.isUpToDate(header, key, output)) {
+            // built in the background, this check goes on without it
+            if (!PrecompiledHeaderBuilder::isBuilding(header)) {
+                log(tr("Building precompiled header in background..."));
+                startPrecompiledHeaderBuild(header, arguments, key, output);
+            }
+            return;
+        }
+    }
+
+    // blank the includes out, so line numbers in the messages are unchanged
+    foreach (int line, includeLines) {
+        lines[line].clear();
+    }
+    mContent = lines.join('\n');
+    if (compilerType == CompilerType::Clang)
+        mArguments << "-include-pch" << output;
+    else
+        mArguments << "-include" << header;
+    log(tr("Using precompiled header: %1").arg(output));
+}
+
+void StdinCompiler::startPrecompiledHeaderBuild(const QString &header, const QStringList &arguments, const QByteArray &key, const QString &output)
+{
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    QStringList binDirs = compilerSet()->binDirs();
+    binDirs.prepend(extractFileDir(mCompiler));
+    QString path = env.value("PATH");
+    env.insert("PATH", path.isEmpty() ? binDirs.join(PATH_SEPARATOR)
+                                      : binDirs.join(PATH_SEPARATOR) + PATH_SEPARATOR + path);
+    PrecompiledHeaderBuilder *builder = new PrecompiledHeaderBuilder(
+                mCompiler, arguments, env, mDirectory, header, key, output);
+    // this thread ends with the check, the builder is deleted by the main thread
+    builder->moveToThread(QCoreApplication::instance()->thread());
+    connect(builder, &QThread::finished, builder, &QObject::deleteLater);
+    builder->start(QThread::LowPriority);
+}
+
+QString StdinCompiler::precompiledHeaderOutput(const QString &header)
+{
+    // gcc finds "<header>.gch" by itself when the header is included
+    if (compilerSet()->compilerType() == CompilerType::Clang)
+        return header + ".pch";
+    return header + ".gch";
+}
+
+// Only touched with pchMutex locked
+static QList<PrecompiledHeaderBuilder*> pchBuilders;
+
+PrecompiledHeaderBuilder::PrecompiledHeaderBuilder(const QString &compiler, const QStringList &arguments,
+                                                   const QProcessEnvironment &env, const QString &workingDir,
+                                                   const QString &header, const QByteArray &key, const QString &output):
+    QThread{},
+    mCompiler{compiler},
+    mArguments{arguments},
+    mEnvironment{env},
+    mWorkingDir{workingDir},
+    mHeader{header},
+    mKey{key},
+    mOutput{output},
+    mCache{extractFileDir(header)},
+    mStop{false}
+{
+    QMutexLocker locker(&pchMutex);
+    pchBuilders.append(this);
+}
+
+bool PrecompiledHeaderBuilder::isBuilding(const QString &header)
+{
+    QMutexLocker locker(&pchMutex);
+    foreach (PrecompiledHeaderBuilder* builder, pchBuilders) {
+        if (builder->mHeader == header)
+            return true;
+    }
+    return false;
+}
+
+void PrecompiledHeaderBuilder::stopAll()
+{
+    QList<PrecompiledHeaderBuilder*> builders;
+    {
+        QMutexLocker locker(&pchMutex);
+        builders = pchBuilders;
+        foreach (PrecompiledHeaderBuilder* builder, builders)
+            builder->mStop = true;
+    }
+    // builders are deleted in the main thread, the one calling this
+    foreach (PrecompiledHeaderBuilder* builder, builders)
+        builder->wait();
+}
+
+void PrecompiledHeaderBuilder::run()
+{
+    QProcess process;
+    process.setProcessEnvironment(mEnvironment);
+    process.setWorkingDirectory(mWorkingDir);
+    process.setProgram(mCompiler);
+    process.setArguments(mArguments);
+    process.start();
+    while (!process.waitForFinished(100)) {
+        if (process.state() != QProcess::Running)
+            break;
+        if (mStop)
+            process.kill();
+    }
+    QMutexLocker locker(&pchMutex);
+    pchBuilders.removeOne(this);
+    if (mStop
+            || process.exitStatus() != QProcess::NormalExit
+            || process.exitCode() != 0) {
+        // don't keep a broken one around
+        QFile::remove(mOutput);
+        return;
+    }
+    mCache.update(mHeader, mKey, mOutput);
+    removeUnusedPrecompiledHeaders();
+}
+
+void PrecompiledHeaderBuilder::removeUnusedPrecompiledHeaders()
+{
+    QDir dir(extractFileDir(mHeader));
+    QFileInfoList outputs = dir.entryInfoList({"*.h.gch", "*.h.pch"}, QDir::Files, QDir::Time);
+    for (int i = MaxPrecompiledHeaders; i < outputs.count(); i++) {
+        QString header = outputs[i].absolutePath() + "/" + outputs[i].completeBaseName();
+        QFile::remove(outputs[i].absoluteFilePath());
+        QFile::remove(header);
+        QFile::remove(mCache.dependencyFilename(header));
+    }
+}
@@ -18,6 +18,9 @@
 #define STDINCOMPILER_H
 
 #include "compiler.h"
+#include "compilecache.h"
+#include <QProcessEnvironment>
+#include <atomic>
 
 class StdinCompiler : public Compiler
 {
@@ -31,9 +34,21 @@ public:
 protected:
     bool prepareForCompile() override;
 
+private:
+    /**
+     * @brief use the precompiled header of the leading system includes
+     *
+     * Only for syntax checking. If the header isn't built yet (or is out of
+     * date), it's built in the background, and used by the later checks.
+     */
+    void preparePrecompiledHeader(FileType fileType);
+    void startPrecompiledHeaderBuild(const QString& header, const QStringList& arguments,
+                                     const QByteArray& key, const QString& output);
+    QString precompiledHeaderOutput(const QString& header);
 private:
     QString mContent;
     QByteArray mEncoding;
+    CompileCache mPCHCache;
 
     // Compiler interface
 protected:
@@ -45,4 +60,38 @@ protected:
 
 };
 
+/**
+ * @brief Builds a precompiled header for the syntax checks.
+ *
+ * Runs on its own, so checks don't wait for it. Only one builder runs for
+ * a header at a time.
+ */
+class PrecompiledHeaderBuilder : public QThread
+{
+    Q_OBJECT
+public:
+    PrecompiledHeaderBuilder(const QString& compiler, const QStringList& arguments,
+                             const QProcessEnvironment& env, const QString& workingDir,
+                             const QString& header, const QByteArray& key, const QString& output);
+    static bool isBuilding(const QString& header);
+    /**
+     * @brief stop the running builders and wait for them, must be called from the main thread
+     */
+    static void stopAll();
+protected:
+    void run() override;
+private:
+    void removeUnusedPrecompiledHeaders();
+private:
+    QString mCompiler;
+    QStringList mArguments;
+    QProcessEnvironment mEnvironment;
+    QString mWorkingDir;
+    QString mHeader;
+    QByteArray mKey;
+    QString mOutput;
+    CompileCache mCache;
+    std::atomic_bool mStop;
+};
+
 #endif // STDINCOMPILER_H
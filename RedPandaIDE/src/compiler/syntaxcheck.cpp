@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "syntaxcheck.h"
+#include <QCryptographicHash>
+
+QList<int> findLeadingSystemIncludes(const QStringList& lines)
+{
+    QList<int> result;
+    bool inComment = false;
+    for (int i=0;i<lines.count();i++) {
+        QString line = lines[i].trimmed();
+        if (inComment) {
+            int pos = line.indexOf("*/");
+            if (pos < 0)
+                continue;
+            inComment = false;
+            line = line.mid(pos+2).trimmed();
+        }
+        while (line.startsWith("/*")) {
+            int pos = line.indexOf("*/", 2);
+            if (pos < 0) {
+                inComment = true;
+                line.clear();
+                break;
+            }
+            line = line.mid(pos+2).trimmed();
+        }
+        if (line.isEmpty() || line.startsWith("//"))
+            continue;
+        if (!line.startsWith('#'))
+            break;
+        line = line.mid(1).trimmed();
+        if (!line.startsWith("include"))
+            break;
+        line = line.mid(QString("include").length()).trimmed();
+        int pos = line.indexOf('>');
+        if (!line.startsWith('<') || pos < 0)
+            break;
+        QString rest = line.mid(pos+1).trimmed();
+        if (!rest.isEmpty() && !rest.startsWith("//"))
+            break;
+        result.append(i);
+    }
+    return result;
+}
+
+QString precompiledHeaderName(const QString &compilerSetName, const QString &compiler,
+                              const QString &workingDir, const QStringList &arguments,
+                              const QByteArray &headerContent)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(compilerSetName.toUtf8());
+    hash.addData(compiler.toUtf8());
+    hash.addData(workingDir.toUtf8());
+    hash.addData("\0", 1);
+    foreach (const QString& argument, arguments) {
+        hash.addData(argument.toUtf8());
+        hash.addData("\0", 1);
+    }
+    hash.addData(headerContent);
+    return QString::fromLatin1(hash.result().toHex()) + ".h";
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef SYNTAXCHECK_H
+#define SYNTAXCHECK_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief find the "#include <...>" lines before any other code
+ *
+ * Blank lines and comments are skipped.
+ * @return their (0-based) line numbers
+ */
+QList<int> findLeadingSystemIncludes(const QStringList& lines);
+
+/**
+ * @brief name of the precompiled header of the leading system includes
+ *
+ * The header is compiled with the same options as the check, in the same
+ * working directory (relative include dirs are resolved against it).
+ */
+QString precompiledHeaderName(const QString& compilerSetName,
+                              const QString& compiler,
+                              const QString& workingDir,
+                              const QStringList& arguments,
+                              const QByteArray& headerContent);
+
+/**
+ * @brief Decides when the background syntax checks are run.
+ *
+ * Only one check runs at a time. A request made meanwhile is kept, and
+ * replaces the older kept one: only the latest content is worth checking.
+ * A check whose key is the same as the last finished one replays its
+ * result instead of running the compiler. An empty key is never replayed.
+ */
+template <typename Request>
+class SyntaxCheckScheduler
+{
+public:
+    enum class Action {
+        Check,
+        Replay
+    };
+
+    SyntaxCheckScheduler():
+        mRunning{false},
+        mStopped{false},
+        mHasPending{false}
+    {
+    }
+
+    bool running() const {
+        return mRunning;
+    }
+
+    /**
+     * @return false if a check is running, the request is kept to be run after it
+     */
+    bool request(const Request& request) {
+        if (!mRunning)
+            return true;
+        mPending = request;
+        mHasPending = true;
+        return false;
+    }
+
+    Action start(const QByteArray& key) {
+        mRunning = true;
+        mStopped = false;
+        mKey = key;
+        if (!mLastKey.isEmpty() && key == mLastKey)
+            return Action::Replay;
+        mLastKey.clear();
+        return Action::Check;
+    }
+
+    /**
+     * @brief drop the kept request, the result of the running check won't be replayed
+     */
+    void stop() {
+        mPending = Request{};
+        mHasPending = false;
+        if (mRunning)
+            mStopped = true;
+    }
+
+    /**
+     * @brief the running check is finished (or replayed)
+     * @return true if a request is kept, it's returned in pending
+     */
+    bool finish(Request& pending) {
+        if (!mStopped)
+            mLastKey = mKey;
+        mRunning = false;
+        if (!mHasPending)
+            return false;
+        pending = mPending;
+        mPending = Request{};
+        mHasPending = false;
+        return true;
+    }
+private:
+    bool mRunning;
+    bool mStopped;
+    QByteArray mKey; // of the running check
+    QByteArray mLastKey; // of the last finished check
+    Request mPending;
+    bool mHasPending;
+};
+
+#endif // SYNTAXCHECK_H
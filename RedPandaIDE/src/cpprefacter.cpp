@@ -18,7 +18,9 @@
 #include <QFile>
 #include <QMessageBox>
 #include <QProgressDialog>
+#include <QThreadPool>
 #include <qsynedit/document.h>
+#include <qsynedit/syntaxer/cpp.h>
 #include "cpprefacter.h"
 #include "mainwindow.h"
 #include "settings.h"
@@ -93,6 +95,14 @@ bool CppRefacter::findOccurence(Editor * editor, const QString &statementFullnam
     return true;
 }
 
+static QList<int> allLines(int lineCount) {
+    QList<int> lines;
+    lines.reserve(lineCount);
+    for (int i=0;i<lineCount;i++)
+        lines.append(i);
+    return lines;
+}
+
 static QString fullParentName(PStatement statement) {
     PStatement parent = statement->parentScope.lock();
     if (parent) {
@@ -244,6 +254,125 @@ void CppRefacter::renameUndefinedLocalVariable(Editor *editor, const CharPos &po
     editor->endEditing();
 }
 
+/**
+ * Can be called outside the GUI thread, and by several threads at the same time.
+ */
+static QList<SymbolOccurenceCandidate> findOccurenceCandidates(
+        const QString &filename,
+        const QStringList &lines,
+        const PStatement &statement,
+        const PCppParser& parser)
+{
+    QList<SymbolOccurenceCandidate> result;
+    // lines that contain the symbol name are recorded by the parser (macros excepted)
+    QList<int> candidateLines;
+    bool indexed = parser->findStatementReferenceLines(filename, statement, candidateLines);
+    if (!indexed)
+        candidateLines = allLines(lines.count());
+    while (!candidateLines.isEmpty() && candidateLines.last()>=lines.count())
+        candidateLines.removeLast();
+    if (candidateLines.isEmpty())
+        return result;
+
+    // syntax states at the end of each line, needed to start parsing the next line
+    QSynedit::CppSyntaxer syntaxer;
+    QList<QSynedit::PSyntaxState> states;
+    states.reserve(candidateLines.last()+1);
+    syntaxer.resetState();
+    for (int i=0;i<=candidateLines.last();i++) {
+        syntaxer.setLine(i, lines[i], i);
+        syntaxer.nextToEol();
+        states.append(syntaxer.getState());
+    }
+    StartParseLineFunc startParseLine = [&lines, &states](QSynedit::Syntaxer *syntaxer, int line) {
+        if (line == 0) {
+            syntaxer->resetState();
+        } else {
+            syntaxer->setState(states[line-1]);
+        }
+        syntaxer->setLine(line, lines[line], line);
+    };
+
+    foreach (int posY, candidateLines) {
+        if (posY<0)
+            continue;
+        const QString& line = lines[posY];
+        if (line.isEmpty())
+            continue;
+
+        startParseLine(&syntaxer, posY);
+        while (!syntaxer.eol()) {
+            int start = syntaxer.getTokenPos();
+            QString token = syntaxer.getToken();
+            QSynedit::PTokenAttribute attr = syntaxer.getTokenAttribute();
+            if (attr && attr->tokenType()==QSynedit::TokenType::Identifier) {
+                if (token == statement->command) {
+                    CharPos p;
+                    p.line = posY;
+                    p.ch = start;
+                    SymbolOccurenceCandidate candidate;
+                    candidate.line = posY;
+                    candidate.start = start;
+                    candidate.len = token.length();
+                    candidate.expression = Editor::getExpressionAtPosition(
+                                p, lines.count(), startParseLine);
+                    candidate.text = line;
+                    result.append(candidate);
+                }
+            }
+            syntaxer.next();
+        }
+    }
+    return result;
+}
+
+/**
+ * Keeps the candidates that are the statement. Can be called outside the GUI thread.
+ */
+static PSearchResultTreeItem resolveOccurenceCandidates(
+        const QString &filename,
+        const QList<SymbolOccurenceCandidate> &candidates,
+        const PStatement &statement,
+        const PCppParser& parser)
+{
+    PSearchResultTreeItem parentItem = std::make_shared<SearchResultTreeItem>();
+    parentItem->filename = filename;
+    parentItem->parent = nullptr;
+    foreach (const SymbolOccurenceCandidate& candidate, candidates) {
+        //same name symbol , test if the same statement;
+        PStatement tokenStatement = parser->findStatementOf(
+                    filename,
+                    candidate.expression, candidate.line);
+        if (tokenStatement
+                && (tokenStatement->line == statement->line)
+                && (tokenStatement->fileName == statement->fileName)) {
+            PSearchResultTreeItem item = std::make_shared<SearchResultTreeItem>();
+            item->filename = filename;
+            item->line = candidate.line;
+            item->start = candidate.start;
+            item->len = candidate.len;
+            item->parent = parentItem.get();
+            item->text = candidate.text;
+            item->text.replace('\t',' ');
+            parentItem->results.append(item);
+        }
+    }
+    return parentItem;
+}
+
+static PSearchResultTreeItem findOccurenceInLines(
+        const QString &filename,
+        const QStringList &lines,
+        const PStatement &statement,
+        const PCppParser& parser)
+{
+    return resolveOccurenceCandidates(
+                filename,
+                findOccurenceCandidates(filename, lines, statement, parser),
+                statement,
+                parser);
+}
+
 void CppRefacter::doFindOccurenceInEditor(const PStatement &statement , Editor *editor, const PCppParser &parser)
 {
     PSearchResults results = mMainWindow->searchResultModel()->addSearchResults(
@@ -251,9 +380,9 @@ void CppRefacter::doFindOccurenceInEditor(const PStatement &statement , Editor *
                 statement->fullName,
                 SearchFileScope::currentFile
                 );
-    PSearchResultTreeItem item = findOccurenceInFile(
+    PSearchResultTreeItem item = findOccurenceInLines(
                 editor->filename(),
-                editor->editorEncoding(),
+                editor->content(),
                 statement,
                 parser);
     if (item && !(item->results.isEmpty())) {
@@ -268,123 +397,176 @@ void CppRefacter::doFindOccurenceInProject(const PStatement &statement, std::sha
                 statement->fullName,
                 SearchFileScope::wholeProject
                 );
-    QProgressDialog progressDlg(
+    // contents of opened editors can only be read in the GUI thread
+    QList<ProjectOccurenceSearcher::SourceFile> files;
+    foreach (const PProjectUnit& unit, project->unitList()) {
+        if (isCFile(unit->fileName()) || isHFile(unit->fileName())) {
+            ProjectOccurenceSearcher::SourceFile file;
+            file.filename = unit->fileName();
+            file.encoding = (unit->encoding() == ENCODING_PROJECT) ?
+                        project->options().encoding : unit->encoding();
+            file.opened = mMainWindow->editorManager()->getContentFromOpenedEditor(
+                        file.filename, file.contents);
+            files.append(file);
+        }
+    }
+    ProjectOccurenceSearcher *searcher = new ProjectOccurenceSearcher(statement, parser, files);
+    QProgressDialog *progressDlg = new QProgressDialog(
                 tr("Searching..."),
                 tr("Abort"),
                 0,
-                mMainWindow->project()->unitList().count(),
+                searcher->fileCount(),
                 mMainWindow);
-    progressDlg.setWindowModality(Qt::WindowModal);
-    progressDlg.setMinimumDuration(500);
-    progressDlg.show();
-    int i=0;
-    foreach (const PProjectUnit& unit, project->unitList()) {
-        i++;
-        if (isCFile(unit->fileName()) || isHFile(unit->fileName())) {
-            progressDlg.setValue(i);
-            progressDlg.setLabelText(tr("Searching...")+"<br/>"+unit->fileName());
-            QCoreApplication::processEvents();
-            if (progressDlg.wasCanceled())
-                break;
-            PSearchResultTreeItem item = findOccurenceInFile(
-                        unit->fileName(),
-                        unit->encoding()==ENCODING_PROJECT?project->options().encoding:unit->encoding(),
-                        statement,
-                        parser);
-            if (item && !(item->results.isEmpty())) {
-                mMainWindow->searchResultModel()->addResultToSearchResults(results,item);
-            }
+    progressDlg->setWindowModality(Qt::NonModal);
+    progressDlg->setMinimumDuration(500);
+    SearchResultModel *model = mMainWindow->searchResultModel();
+    connect(progressDlg, &QProgressDialog::canceled,
+            searcher, &ProjectOccurenceSearcher::cancel);
+    connect(searcher, &ProjectOccurenceSearcher::fileSearched,
+            model, [searcher, progressDlg, model, results](){
+        foreach (const PSearchResultTreeItem& item, searcher->takeFoundItems()) {
+            model->addResultToSearchResults(results, item);
         }
-    }
+        if (!searcher->isCancelled())
+            progressDlg->setValue(searcher->searchedFileCount());
+    });
+    connect(searcher, &QThread::finished,
+            progressDlg, &QObject::deleteLater);
+    connect(searcher, &QThread::finished,
+            searcher, &QObject::deleteLater);
+    searcher->start();
 }
 
-PSearchResultTreeItem CppRefacter::findOccurenceInFile(
-        const QString &filename,
-        const QByteArray& fileEncoding,
+ProjectOccurenceSearcher::ProjectOccurenceSearcher(
         const PStatement &statement,
-        const PCppParser& parser)
+        const PCppParser &parser,
+        const QList<SourceFile> &files,
+        QObject *parent):
+    QThread{parent},
+    mStatement{statement},
+    mParser{parser},
+    mFiles{files},
+    mCancelled{false},
+    mSearchedFileCount{0},
+    mScannedFileCount{0}
 {
-    PSearchResultTreeItem parentItem = std::make_shared<SearchResultTreeItem>();
-    parentItem->filename = filename;
-    parentItem->parent = nullptr;
-    QStringList buffer;
-    Editor editor(nullptr);
-    editor.setEditorSettings(&pSettings->editor());
-    FileType fileType = getFileType(filename);
-    if (!isC_CPPSourceFile(fileType))
-        fileType = FileType::CCppHeader;
-    editor.setFileType(fileType);
-    if (mMainWindow->editorManager()->getContentFromOpenedEditor(
-                filename,buffer)){
-        editor.setContent(buffer);
-    } else if (!fileExists(filename)){
-        return parentItem;
-    } else {
-        QByteArray encoding;
-        try {
-            editor.loadFromFile(filename,fileEncoding,encoding);
-        } catch (FileError e) {
-            //don't handle it;
-            return parentItem;
-        }
-    }
-    QSynedit::PSyntaxer pSyntaxer= SyntaxerManager::getSyntaxer(QSynedit::ProgrammingLanguage::CPP);
-    editor.setSyntaxer(pSyntaxer);
-    int posY = 0;
-    while (posY < editor.lineCount()) {
-        QString line = editor.lineText(posY);
-        if (line.isEmpty()) {
-            posY++;
-            continue;
-        }
+}
 
-        editor.startParseLine(pSyntaxer.get(), posY);
-        while (!pSyntaxer->eol()) {
-            int start = pSyntaxer->getTokenPos();
-            QString token = pSyntaxer->getToken();
-            QSynedit::PTokenAttribute attr = pSyntaxer->getTokenAttribute();
-            if (attr && attr->tokenType()==QSynedit::TokenType::Identifier) {
-                if (token == statement->command) {
-                    //same name symbol , test if the same statement;
-                    CharPos p;
-                    p.line = posY;
-                    p.ch = start;
-                    QStringList expression = editor.getExpressionAtPosition(p);
-                    PStatement tokenStatement = parser->findStatementOf(
-                                filename,
-                                expression, p.line);
-                    if (tokenStatement
-                            && (tokenStatement->line == statement->line)
-                            && (tokenStatement->fileName == statement->fileName)) {
-                        PSearchResultTreeItem item = std::make_shared<SearchResultTreeItem>();
-                        item->filename = filename;
-                        item->line = p.line;
-                        item->start = start;
-                        item->len = token.length();
-                        item->parent = parentItem.get();
-                        item->text = line;
-                        item->text.replace('\t',' ');
-                        parentItem->results.append(item);
-                    }
-                }
+void ProjectOccurenceSearcher::cancel()
+{
+    mCancelled = true;
+}
+
+bool ProjectOccurenceSearcher::isCancelled() const
+{
+    return mCancelled;
+}
+
+int ProjectOccurenceSearcher::fileCount() const
+{
+    return mFiles.count();
+}
+
+int ProjectOccurenceSearcher::searchedFileCount() const
+{
+    return mSearchedFileCount;
+}
+
+QList<PSearchResultTreeItem> ProjectOccurenceSearcher::takeFoundItems()
+{
+    QMutexLocker locker(&mFoundItemsMutex);
+    QList<PSearchResultTreeItem> items = mFoundItems;
+    mFoundItems.clear();
+    return items;
+}
+
+void ProjectOccurenceSearcher::run()
+{
+    // the parser must not change while searching
+    while (!mParser->freeze()) {
+        if (isCancelled() || !mParser->enabled())
+            return;
+        msleep(20);
+    }
+    auto action = finally([this]{
+        mParser->unFreeze();
+    });
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    foreach (const SourceFile& file, mFiles) {
+        pool.start(QRunnable::create([this, file](){
+            scanFile(file);
+        }));
+    }
+    ScannedFile scannedFile;
+    while (takeScannedFile(scannedFile)) {
+        if (!isCancelled() && !scannedFile.candidates.isEmpty()) {
+            PSearchResultTreeItem item = resolveOccurenceCandidates(
+                        scannedFile.filename,
+                        scannedFile.candidates,
+                        mStatement,
+                        mParser);
+            if (!item->results.isEmpty()) {
+                QMutexLocker locker(&mFoundItemsMutex);
+                mFoundItems.append(item);
             }
-            pSyntaxer->next();
         }
-        posY++;
+        mSearchedFileCount.fetchAndAddOrdered(1);
+        emit fileSearched();
     }
-    return parentItem;
+    pool.waitForDone();
+}
+
+void ProjectOccurenceSearcher::scanFile(const SourceFile &file)
+{
+    ScannedFile scannedFile;
+    scannedFile.filename = file.filename;
+    if (!isCancelled()) {
+        QStringList contents;
+        if (file.opened)
+            contents = file.contents;
+        else
+            contents = readFileToLines(file.filename, file.encoding);
+        scannedFile.candidates = findOccurenceCandidates(
+                    file.filename,
+                    contents,
+                    mStatement,
+                    mParser);
+    }
+    QMutexLocker locker(&mScannedFilesMutex);
+    mScannedFiles.append(scannedFile);
+    mScannedFilesCondition.wakeAll();
+}
+
+bool ProjectOccurenceSearcher::takeScannedFile(ScannedFile &scannedFile)
+{
+    QMutexLocker locker(&mScannedFilesMutex);
+    if (mScannedFileCount == mFiles.count())
+        return false;
+    while (mScannedFiles.isEmpty())
+        mScannedFilesCondition.wait(&mScannedFilesMutex);
+    scannedFile = mScannedFiles.takeFirst();
+    mScannedFileCount++;
+    return true;
 }
 
 void CppRefacter::renameSymbolInFile(const QString &filename, const PStatement &statement,  const QString &newWord, const PCppParser &parser)
 {
     QStringList buffer;
+    QList<int> candidateLines;
+    bool indexed = parser->findStatementReferenceLines(filename, statement, candidateLines);
+    if (indexed && candidateLines.isEmpty())
+        return;
     Editor * oldEditor=mMainWindow->editorManager()->getOpenedEditor(filename);
     if (oldEditor){
         QSynedit::PSyntaxer syntaxer = SyntaxerManager::getSyntaxer(QSynedit::ProgrammingLanguage::CPP);
-        int posY = 0;
+        if (!indexed)
+            candidateLines = allLines(oldEditor->lineCount());
         oldEditor->clearSelection();
         oldEditor->beginEditing();
-        while (posY < oldEditor->lineCount()) {
+        foreach (int posY, candidateLines) {
+            if (posY<0 || posY >= oldEditor->lineCount())
+                continue;
             QString line = oldEditor->lineText(posY);
             QString newLine;
             oldEditor->startParseLine(syntaxer.get(), posY);
@@ -411,7 +593,6 @@ void CppRefacter::renameSymbolInFile(const QString &filename, const PStatement &
             }
             if (newLine!=line)
                 oldEditor->replaceLine(posY,newLine);
-            posY++;
         }
         oldEditor->setCaretXY(oldEditor->ensureCharPosValid(oldEditor->caretXY()));
         oldEditor->endEditing();
@@ -18,6 +18,9 @@
 #define CPPREFACTER_H
 
 #include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
 #include "parser/parserutils.h"
 #include "widgets/searchresultview.h"
 #include "parser/cppparser.h"
@@ -27,6 +30,79 @@ namespace QSynedit {
     struct CharPos;
 }
 class Project;
+
+// a token with the same name as the searched statement
+struct SymbolOccurenceCandidate {
+    int line;
+    int start;
+    int len;
+    QStringList expression; // the expression at the token
+    QString text; // the whole line
+};
+
+/**
+ * @brief Find occurences of a statement in project files, in background.
+ *
+ * Files are read and scanned for tokens with the statement's name in
+ * parallel by a thread pool. The tokens are then checked against the
+ * statement one by one in the searcher's own thread, since the parser can
+ * only answer one query at a time. The parser is kept frozen until the
+ * search ends; requests it gets meanwhile are run after that.
+ */
+class ProjectOccurenceSearcher : public QThread
+{
+    Q_OBJECT
+public:
+    struct SourceFile {
+        QString filename;
+        bool opened; // contents is taken from an opened editor
+        QByteArray encoding; // to read the file if it's not opened
+        QStringList contents;
+    };
+
+    explicit ProjectOccurenceSearcher(const PStatement& statement,
+                                      const PCppParser& parser,
+                                      const QList<SourceFile>& files,
+                                      QObject *parent = nullptr);
+    void cancel();
+    bool isCancelled() const;
+    int fileCount() const;
+    int searchedFileCount() const;
+    /**
+     * @brief take the results found since the last call
+     * @return results (one item for each file)
+     */
+    QList<PSearchResultTreeItem> takeFoundItems();
+signals:
+    /**
+     * @brief a file is searched.
+     *
+     * Emitted from worker threads; call takeFoundItems() to get the results.
+     */
+    void fileSearched();
+protected:
+    void run() override;
+private:
+    struct ScannedFile {
+        QString filename;
+        QList<SymbolOccurenceCandidate> candidates;
+    };
+    void scanFile(const SourceFile& file);
+    bool takeScannedFile(ScannedFile& scannedFile);
+private:
+    PStatement mStatement;
+    PCppParser mParser;
+    QList<SourceFile> mFiles;
+    QAtomicInt mCancelled;
+    QAtomicInt mSearchedFileCount;
+    QMutex mFoundItemsMutex;
+    QList<PSearchResultTreeItem> mFoundItems;
+    QMutex mScannedFilesMutex;
+    QWaitCondition mScannedFilesCondition;
+    QList<ScannedFile> mScannedFiles; // waiting to be checked
+    int mScannedFileCount;
+};
+
 class CppRefacter : public QObject
 {
     Q_OBJECT
@@ -41,11 +117,6 @@ public:
 private:
     void doFindOccurenceInEditor(const PStatement &statement, Editor* editor, const PCppParser& parser);
     void doFindOccurenceInProject(const PStatement &statement, std::shared_ptr<Project> project, const PCppParser& parser);
-    PSearchResultTreeItem findOccurenceInFile(
-            const QString& filename,
-            const QByteArray& fileEncoding,
-            const PStatement& statement,
-            const PCppParser& parser);
     void renameSymbolInFile(
             const QString& filename,
             const PStatement& statement,
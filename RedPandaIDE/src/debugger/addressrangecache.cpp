@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "addressrangecache.h"
+#include <algorithm>
+#include <iterator>
+
+void MemoryCache::clear()
+{
+    mChunks.clear();
+}
+
+bool MemoryCache::isEmpty() const
+{
+    return mChunks.isEmpty();
+}
+
+void MemoryCache::insert(qulonglong address, const QByteArray &bytes)
+{
+    if (bytes.isEmpty())
+        return;
+    qulonglong start = address;
+    qulonglong end = address + bytes.length();
+    QByteArray merged = bytes;
+    // merge with the overlapping and adjacent chunks
+    auto it = mChunks.upperBound(address);
+    if (it != mChunks.begin()) {
+        auto prev = std::prev(it);
+        qulonglong prevEnd = prev.key() + prev.value().length();
+        if (prevEnd >= address) {
+            merged = prev.value().left(address - prev.key()) + bytes;
+            if (prevEnd > end) {
+                merged += prev.value().mid(end - prev.key());
+                end = prevEnd;
+            }
+            start = prev.key();
+            it = mChunks.erase(prev);
+        }
+    }
+    while (it != mChunks.end() && it.key() <= end) {
+        qulonglong chunkEnd = it.key() + it.value().length();
+        if (chunkEnd > end) {
+            merged += it.value().mid(end - it.key());
+            end = chunkEnd;
+        }
+        it = mChunks.erase(it);
+    }
+    mChunks.insert(start, merged);
+}
+
+QByteArray MemoryCache::read(qulonglong address, int size) const
+{
+    auto it = mChunks.upperBound(address);
+    if (it == mChunks.begin())
+        return QByteArray();
+    --it;
+    qulonglong offset = address - it.key();
+    if (offset >= (qulonglong)it.value().length())
+        return QByteArray();
+    return it.value().mid(offset, size);
+}
+
+QList<AddressRange> MemoryCache::missingRanges(qulonglong address, int size) const
+{
+    QList<AddressRange> ranges;
+    qulonglong pos = address;
+    qulonglong end = address + size;
+    auto it = mChunks.upperBound(address);
+    if (it != mChunks.begin()) {
+        auto prev = std::prev(it);
+        pos = std::max(pos, prev.key() + prev.value().length());
+    }
+    while (pos < end) {
+        if (it == mChunks.end() || it.key() >= end) {
+            ranges.append(AddressRange(pos, end - pos));
+            break;
+        }
+        if (it.key() > pos)
+            ranges.append(AddressRange(pos, it.key() - pos));
+        pos = std::max(pos, it.key() + it.value().length());
+        ++it;
+    }
+    return ranges;
+}
+
+void DisassemblyCache::clear()
+{
+    mEntries.clear();
+}
+
+void DisassemblyCache::insert(const QString &key, const QStringList &lines)
+{
+    Entry entry;
+    entry.key = key;
+    entry.start = 0;
+    entry.end = 0;
+    foreach (const QString& line, lines) {
+        bool ok;
+        qulonglong address = lineAddress(line, ok);
+        if (!ok)
+            continue;
+        if (entry.end == 0 || address < entry.start)
+            entry.start = address;
+        if (address >= entry.end)
+            entry.end = address + MaxInstructionLength;
+    }
+    if (entry.end == 0)
+        return;
+    entry.lines = lines;
+    for (int i=mEntries.count()-1;i>=0;i--) {
+        const Entry& old = mEntries[i];
+        if (old.key == key && old.start < entry.end && entry.start < old.end)
+            mEntries.removeAt(i);
+    }
+    mEntries.append(entry);
+    while (mEntries.count() > MaxEntries)
+        mEntries.removeFirst();
+}
+
+bool DisassemblyCache::find(const QString &key, qulonglong address, QStringList &lines) const
+{
+    foreach (const Entry& entry, mEntries) {
+        if (entry.key != key || address < entry.start || address >= entry.end)
+            continue;
+        // the end is only an upper bound, the address must start one of the instructions
+        bool found = false;
+        QStringList result;
+        foreach (const QString& line, entry.lines) {
+            bool ok;
+            qulonglong lineAddr = lineAddress(line, ok);
+            if (ok) {
+                found = found || (lineAddr == address);
+                result.append((lineAddr == address ? "=> " : "   ") + line.mid(3));
+            } else
+                result.append(line);
+        }
+        if (!found)
+            continue;
+        lines = result;
+        return true;
+    }
+    return false;
+}
+
+void DisassemblyCache::invalidate(qulonglong address, qulonglong size)
+{
+    qulonglong end = address + std::max(size, 1ULL);
+    for (int i=mEntries.count()-1;i>=0;i--) {
+        if (mEntries[i].start < end && address < mEntries[i].end)
+            mEntries.removeAt(i);
+    }
+}
+
+qulonglong DisassemblyCache::lineAddress(const QString &line, bool &ok)
+{
+    ok = false;
+    if (!line.startsWith("   0x") && !line.startsWith("=> 0x"))
+        return 0;
+    int end = 5;
+    while (end < line.length() && line[end].isLetterOrNumber())
+        end++;
+    return line.mid(3, end - 3).toULongLong(&ok, 16);
+}
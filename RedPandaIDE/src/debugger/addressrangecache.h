@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef ADDRESSRANGECACHE_H
+#define ADDRESSRANGECACHE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+
+using AddressRange = QPair<qulonglong, int>; // start address and size
+
+/**
+ * @brief Raw bytes of the inferior read while it's stopped.
+ *
+ * Bytes are kept in non-overlapping chunks keyed by their start address,
+ * so only the ranges not read yet need to be fetched from the debugger.
+ * It must be cleared when the inferior resumes or memory is written.
+ */
+class MemoryCache
+{
+public:
+    void clear();
+    bool isEmpty() const;
+    /**
+     * @brief add bytes read at the address, newer bytes replace the cached ones
+     */
+    void insert(qulonglong address, const QByteArray& bytes);
+    /**
+     * @brief the cached bytes starting at the address
+     * @return at most size bytes, shorter if the range is not fully cached
+     */
+    QByteArray read(qulonglong address, int size) const;
+    /**
+     * @brief ranges in [address, address+size) that are not cached
+     */
+    QList<AddressRange> missingRanges(qulonglong address, int size) const;
+private:
+    QMap<qulonglong, QByteArray> mChunks;
+};
+
+/**
+ * @brief Disassembled functions, keyed by the address range they cover.
+ *
+ * Code doesn't change when the inferior resumes, so a function is
+ * disassembled only once while stepping in it or selecting its frames.
+ */
+class DisassemblyCache
+{
+public:
+    void clear();
+    /**
+     * @brief cache the disassembly of a function
+     * @param key the options used to disassemble it (flavor, source lines...)
+     */
+    void insert(const QString& key, const QStringList& lines);
+    /**
+     * @brief find the function with an instruction starting at the address
+     *
+     * The instruction at the address is marked with "=>" in the result.
+     */
+    bool find(const QString& key, qulonglong address, QStringList& lines) const;
+    /**
+     * @brief remove functions overlapping [address, address+size) (when it's written)
+     */
+    void invalidate(qulonglong address, qulonglong size);
+    /**
+     * @brief address of an instruction line, like "=> 0x0000555555555189 <+4>:\tmov ..."
+     */
+    static qulonglong lineAddress(const QString& line, bool& ok);
+private:
+    struct Entry {
+        QString key;
+        qulonglong start;
+        qulonglong end; // upper bound of the end of the last instruction
+        QStringList lines;
+    };
+    static constexpr int MaxEntries = 32;
+    // gdb doesn't print instruction lengths, assume the longest (x86) one for the last
+    static constexpr qulonglong MaxInstructionLength = 15;
+    QList<Entry> mEntries; // most recently inserted last
+};
+
+#endif // ADDRESSRANGECACHE_H
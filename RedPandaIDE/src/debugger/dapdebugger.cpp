@@ -1,14 +1,464 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
 #include "dapdebugger.h"
 #include "../utils.h"
-#include "dapprotocol.h"
 #include "../systemconsts.h"
+#include "../settings.h"
 
+#include <QEventLoop>
 #include <QFileInfo>
+#include <QRegularExpression>
+
+static qulonglong parseAddress(const QString& s, bool &ok)
+{
+    // a value may be followed by what it points to, like 0x404000 "abc"
+    return s.trimmed().section(' ', 0, 0).toULongLong(&ok, 0);
+}
+
+static QString addressReference(qulonglong address)
+{
+    return QString("0x%1").arg(address, 0, 16);
+}
 
 DAPDebuggerClient::DAPDebuggerClient(Debugger *debugger, QObject *parent):
     DebuggerClient{debugger, parent}
 {
+    mProcess = std::make_shared<QProcess>();
+    mStop = false;
+    mIsLLDB = false;
+    mConfigured = false;
+    mThreadId = 1;
+    mFrameId = -1;
+    mCurrentLine = -1;
+    mCurrentAddress = 0;
+    mStopAtMain = false;
+    mNextVarId = 1;
+    mMemoryViewAddress = 0;
+    mMemoryViewSize = 0;
+}
+
+PDAPCommand DAPDebuggerClient::postRequest(const QString &command, const QJsonObject &arguments, DebugCommandSource source)
+{
+    PDAPCommand cmd = createCommand(command, arguments, DAPCommandPurpose::Other, source);
+    enqueueCommand(cmd);
+    return cmd;
+}
+
+void DAPDebuggerClient::postConsoleCommand(const QString &command, DebugCommandSource source)
+{
+    // the user may change anything in the console
+    if (source == DebugCommandSource::Console)
+        invalidateMemoryCache();
+    QMutexLocker locker(&mCmdQueueMutex);
+    QJsonObject args;
+    args["expression"] = command;
+    args["context"] = "repl";
+    if (mFrameId >= 0)
+        args["frameId"] = mFrameId;
+    enqueueCommand(createCommand("evaluate", args, DAPCommandPurpose::Console, source));
+}
+
+void DAPDebuggerClient::stopDebug()
+{
+    mStop = true;
+    emit wakeUpRequested();
+}
+
+bool DAPDebuggerClient::commandRunning() const
+{
+    // requests are sent at once, so the ones waiting for responses count too
+    QMutexLocker locker(&mCmdQueueMutex);
+    return mSession.hasPendingRequests();
+}
+
+DebuggerType DAPDebuggerClient::clientType()
+{
+    return DebuggerType::DAP;
+}
+
+void DAPDebuggerClient::initialize(const QString &inferior, bool /*hasSymbols*/)
+{
+    QJsonObject args;
+    args["clientID"] = "redpanda-cpp";
+    args["clientName"] = "Red Panda C++";
+    args["adapterID"] = mIsLLDB ? "lldb-dap" : "gdb";
+    args["pathFormat"] = "path";
+    args["linesStartAt1"] = true;
+    args["columnsStartAt1"] = true;
+    args["supportsVariableType"] = true;
+    args["supportsVariablePaging"] = true;
+    args["supportsMemoryReferences"] = true;
+    postRequest("initialize", args);
+
+    // the adapter's stdout is the protocol channel, so the inferior is run
+    // by the debug server, with its own console.
+    QJsonObject attachArgs;
+    attachArgs["program"] = inferior;
+    attachArgs["cwd"] = extractFileDir(inferior);
+    if (mIsLLDB) {
+        attachArgs["gdb-remote-hostname"] = "localhost";
+        attachArgs["gdb-remote-port"] = pSettings->debugger().GDBServerPort();
+    } else {
+        attachArgs["target"] = QString("localhost:%1").arg(pSettings->debugger().GDBServerPort());
+    }
+    postRequest("attach", attachArgs);
+}
+
+void DAPDebuggerClient::runInferior(bool hasBreakpoints)
+{
+    if (!hasBreakpoints) {
+        // there are no temporary breakpoints in DAP, it's removed when hit
+        mStopAtMain = true;
+        QJsonObject mainBreakpoint;
+        mainBreakpoint["name"] = "main";
+        QJsonObject args;
+        args["breakpoints"] = QJsonArray{mainBreakpoint};
+        postRequest("setFunctionBreakpoints", args);
+    }
+    postRequest("configurationDone", QJsonObject());
+}
+
+void DAPDebuggerClient::stepOver()
+{
+    postRequest("next", threadArguments());
+}
+
+void DAPDebuggerClient::stepInto()
+{
+    postRequest("stepIn", threadArguments());
+}
+
+void DAPDebuggerClient::stepOut()
+{
+    postRequest("stepOut", threadArguments());
+}
+
+void DAPDebuggerClient::runTo(const QString &filename, int line)
+{
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        // a breakpoint removed when the inferior is stopped again
+        mRunToBreakpoint = std::make_shared<Breakpoint>();
+        mRunToBreakpoint->filename = filename;
+        mRunToBreakpoint->line = line - 1;
+        mRunToBreakpoint->number = -1;
+    }
+    sendBreakpoints(filename);
+    resume();
+}
+
+void DAPDebuggerClient::resume()
+{
+    postRequest("continue", threadArguments());
+}
+
+void DAPDebuggerClient::stepOverInstruction()
+{
+    QJsonObject args = threadArguments();
+    args["granularity"] = "instruction";
+    postRequest("next", args);
+}
+
+void DAPDebuggerClient::stepIntoInstruction()
+{
+    QJsonObject args = threadArguments();
+    args["granularity"] = "instruction";
+    postRequest("stepIn", args);
+}
+
+void DAPDebuggerClient::interrupt()
+{
+    postRequest("pause", threadArguments());
+}
+
+void DAPDebuggerClient::refreshStackVariables()
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (mFrameId < 0)
+        return;
+    QJsonObject args;
+    args["frameId"] = mFrameId;
+    enqueueCommand(createCommand("scopes", args, DAPCommandPurpose::Locals));
+}
+
+void DAPDebuggerClient::readMemory(const QString &startAddress, int rows, int cols)
+{
+    int size = rows * cols;
+    bool ok;
+    qulonglong address = startAddress.toULongLong(&ok, 0);
+    QMutexLocker locker(&mMemoryMutex);
+    mMemoryViewSize = size;
+    mMemoryViewReads.clear();
+    if (!ok || address == 0) {
+        // an expression, the memory view starts where it's evaluated to
+        mMemoryViewAddress = 0;
+        QMutexLocker cmdLocker(&mCmdQueueMutex);
+        QJsonObject args;
+        args["expression"] = startAddress;
+        args["context"] = "watch";
+        if (mFrameId >= 0)
+            args["frameId"] = mFrameId;
+        PDAPCommand cmd = createCommand("evaluate", args, DAPCommandPurpose::MemoryView);
+        mMemoryViewReads.insert(cmd.get());
+        enqueueCommand(cmd);
+        return;
+    }
+    mMemoryViewAddress = address;
+    if (readMemoryRanges(address))
+        return;
+    QByteArray memory = mMemoryCache.read(address, size);
+    locker.unlock();
+    emit memoryUpdated(address, memory);
+}
+
+void DAPDebuggerClient::writeMemory(qulonglong address, unsigned char data)
+{
+    invalidateMemoryCache();
+    QJsonObject args;
+    args["memoryReference"] = addressReference(address);
+    args["data"] = QString::fromLatin1(QByteArray(1, static_cast<char>(data)).toBase64());
+    postRequest("writeMemory", args);
+}
+
+void DAPDebuggerClient::addBreakpoint(PBreakpoint breakpoint)
+{
+    if (!breakpoint)
+        return;
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        mBreakpoints[breakpoint->filename].append(breakpoint);
+    }
+    sendBreakpoints(breakpoint->filename);
+}
+
+void DAPDebuggerClient::removeBreakpoint(PBreakpoint breakpoint)
+{
+    if (!breakpoint)
+        return;
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        if (!mBreakpoints.contains(breakpoint->filename))
+            return;
+        QList<PBreakpoint>& breakpoints = mBreakpoints[breakpoint->filename];
+        for (int i = breakpoints.count() - 1; i >= 0; i--) {
+            if (breakpoints[i] == breakpoint || breakpoints[i]->line == breakpoint->line)
+                breakpoints.removeAt(i);
+        }
+    }
+    sendBreakpoints(breakpoint->filename);
+}
+
+void DAPDebuggerClient::addWatchpoint(const QString &watchExp)
+{
+    if (watchExp.isEmpty())
+        return;
+    QMutexLocker locker(&mCmdQueueMutex);
+    QJsonObject args;
+    args["name"] = watchExp;
+    if (mFrameId >= 0)
+        args["frameId"] = mFrameId;
+    enqueueCommand(createCommand("dataBreakpointInfo", args));
+}
+
+void DAPDebuggerClient::setBreakpointCondition(PBreakpoint breakpoint)
+{
+    Q_ASSERT(breakpoint!=nullptr);
+    // all breakpoints of the file are set again, with the new condition
+    sendBreakpoints(breakpoint->filename);
+}
+
+void DAPDebuggerClient::addWatch(const QString &expression)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    QJsonObject args;
+    args["expression"] = expression;
+    args["context"] = "watch";
+    if (mFrameId >= 0)
+        args["frameId"] = mFrameId;
+    PDAPCommand cmd = createCommand("evaluate", args, DAPCommandPurpose::CreateVar);
+    cmd->target = expression;
+    enqueueCommand(cmd);
+}
+
+void DAPDebuggerClient::removeWatch(PWatchVar watchVar)
+{
+    // nothing is created in the adapter
+    QMutexLocker locker(&mCmdQueueMutex);
+    QString name = watchVar->name;
+    mWatchNames.removeAll(name);
+    QString childPrefix = name + ".";
+    for (auto it = mVars.begin(); it != mVars.end();) {
+        if (it.key() == name || it.key().startsWith(childPrefix))
+            it = mVars.erase(it);
+        else
+            ++it;
+    }
+}
+
+void DAPDebuggerClient::writeWatchVar(const QString &varName, const QString &value)
+{
+    invalidateMemoryCache();
+    QMutexLocker locker(&mCmdQueueMutex);
+    QString expression = mVars.value(varName).expression;
+    if (expression.isEmpty())
+        return;
+    QJsonObject args;
+    args["expression"] = QString("%1 = %2").arg(expression, value);
+    args["context"] = "watch";
+    if (mFrameId >= 0)
+        args["frameId"] = mFrameId;
+    enqueueCommand(createCommand("evaluate", args));
+}
+
+void DAPDebuggerClient::refreshWatch(PWatchVar var)
+{
+    Q_ASSERT(var!=nullptr);
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (!mVars.contains(var->name))
+        return;
+    QJsonObject args;
+    args["expression"] = mVars.value(var->name).expression;
+    args["context"] = "watch";
+    if (mFrameId >= 0)
+        args["frameId"] = mFrameId;
+    PDAPCommand cmd = createCommand("evaluate", args, DAPCommandPurpose::UpdateVar);
+    cmd->target = var->name;
+    enqueueCommand(cmd);
+}
+
+void DAPDebuggerClient::refreshWatch()
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    // all evaluated at the same time
+    foreach (const QString& name, mWatchNames) {
+        QJsonObject args;
+        args["expression"] = mVars.value(name).expression;
+        args["context"] = "watch";
+        if (mFrameId >= 0)
+            args["frameId"] = mFrameId;
+        PDAPCommand cmd = createCommand("evaluate", args, DAPCommandPurpose::UpdateVar);
+        cmd->target = name;
+        enqueueCommand(cmd);
+    }
+}
+
+void DAPDebuggerClient::fetchWatchVarChildren(const QString &varName, int from, int count)
+{
+    listVarChildren(varName, from, count, false);
+}
+
+void DAPDebuggerClient::evalExpression(const QString &expression)
+{
+    // it may have side effects
+    invalidateMemoryCache();
+    QMutexLocker locker(&mCmdQueueMutex);
+    QJsonObject args;
+    args["expression"] = expression;
+    args["context"] = "watch";
+    if (mFrameId >= 0)
+        args["frameId"] = mFrameId;
+    enqueueCommand(createCommand("evaluate", args, DAPCommandPurpose::Evaluation));
+}
+
+void DAPDebuggerClient::selectFrame(PTrace trace)
+{
+    if (!trace)
+        return;
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (trace->level < 0 || trace->level >= mFrameIds.count())
+        return;
+    mFrameId = mFrameIds[trace->level];
+    bool ok;
+    mCurrentAddress = parseAddress(trace->address, ok);
+    if (!ok)
+        mCurrentAddress = 0;
+    mCurrentFile = trace->filename;
+    mCurrentLine = trace->line + 1;
+    mCurrentFunc = trace->funcname;
+}
+
+void DAPDebuggerClient::refreshFrame()
+{
+    // frames are fetched when the inferior is stopped, see handleStackTrace()
+}
+
+void DAPDebuggerClient::refreshRegisters()
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (mFrameId < 0)
+        return;
+    QJsonObject args;
+    args["frameId"] = mFrameId;
+    enqueueCommand(createCommand("scopes", args, DAPCommandPurpose::Registers));
+}
+
+void DAPDebuggerClient::disassembleCurrentFrame(bool blendMode)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (mCurrentAddress == 0)
+        return;
+    // instructions around the current one, instead of the whole function
+    QJsonObject args;
+    args["memoryReference"] = addressReference(mCurrentAddress);
+    args["instructionOffset"] = -DisassemblyLinesBefore;
+    args["instructionCount"] = DisassemblyLines;
+    args["resolveSymbols"] = true;
+    enqueueCommand(createCommand("disassemble", args,
+                                 blendMode ? DAPCommandPurpose::BlendedDisassembly
+                                           : DAPCommandPurpose::Disassembly));
+}
+
+void DAPDebuggerClient::setDisassemblyLanguage(bool isIntel)
+{
+    QString flavor = isIntel ? "intel" : "att";
+    if (mIsLLDB)
+        postConsoleCommand("`settings set target.x86-disassembly-flavor " + flavor, DebugCommandSource::Other);
+    else
+        postConsoleCommand("set disassembly-flavor " + flavor, DebugCommandSource::Other);
+}
 
+void DAPDebuggerClient::skipDirectoriesInSymbolSearch(const QStringList &lst)
+{
+    // lldb has no equivalent
+    if (mIsLLDB)
+        return;
+    foreach(const QString &dirName, lst) {
+        postConsoleCommand(QString("skip -gfi \"%1/%2\"").arg(dirName,"*.*"),
+                           DebugCommandSource::Other);
+    }
+}
+
+void DAPDebuggerClient::addSymbolSearchDirectories(const QStringList &lst)
+{
+    // lldb uses the full paths in the debug infos
+    if (mIsLLDB)
+        return;
+    foreach(const QString &dirName, lst) {
+        postConsoleCommand(QString("directory \"%1\"").arg(dirName),
+                           DebugCommandSource::Other);
+    }
+}
+
+void DAPDebuggerClient::skipStandardLibraryFunctions()
+{
+    // lldb avoids stepping into std:: by default (target.process.thread.step-avoid-regexp)
+    if (mIsLLDB)
+        return;
+    postConsoleCommand("skip -rfu ^std::", DebugCommandSource::Other);
 }
 
 void DAPDebuggerClient::run()
@@ -18,8 +468,11 @@ void DAPDebuggerClient::run()
     mInferiorRunning = false;
     mProcessExited = false;
     QString cmd = debuggerPath();
-//    QString arguments = "--annotate=2";
-    QStringList arguments{"--interpret=mi", "--silent"};
+    // lldb-dap (or lldb-vscode) talks DAP by default
+    mIsLLDB = extractFileName(cmd).startsWith("lldb");
+    QStringList arguments;
+    if (!mIsLLDB)
+        arguments = QStringList{"--interpreter=dap", "--quiet"};
     QString workingDir = QFileInfo(debuggerPath()).path();
 
     mProcess = std::make_shared<QProcess>();
@@ -28,6 +481,8 @@ void DAPDebuggerClient::run()
     });
     mProcess->setProgram(cmd);
     mProcess->setArguments(arguments);
+    // stderr is not a part of the protocol
+    mProcess->setProcessChannelMode(QProcess::SeparateChannels);
 
     QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
     QString path = env.value("PATH");
@@ -46,48 +501,814 @@ void DAPDebuggerClient::run()
 
     mProcess->setWorkingDirectory(workingDir);
 
+    // the client thread sleeps in the event loop until the adapter writes something,
+    // a request is posted or the debugging is stopped
+    QEventLoop loop;
     connect(mProcess.get(), &QProcess::errorOccurred,
-                    [&](){
-                        errorOccured= true;
-                    });
-    QByteArray buffer;
-    QByteArray readed;
+            &loop, [&](){
+        errorOccured= true;
+        loop.quit();
+    });
+    connect(mProcess.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            &loop, &QEventLoop::quit);
+    connect(mProcess.get(), &QProcess::readyReadStandardOutput,
+            &loop, [this](){
+        receiveOutput();
+    });
+    connect(mProcess.get(), &QProcess::readyReadStandardError,
+            &loop, [this](){
+        mProcess->readAllStandardError();
+    });
+    // always queued, so requests posted while processing are sent after it
+    connect(this, &DAPDebuggerClient::wakeUpRequested,
+            &loop, [this, &loop](){
+        if (mStop) {
+            quitDebugger();
+            loop.quit();
+        } else {
+            runNextCmd();
+        }
+    }, Qt::QueuedConnection);
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        mSession.reset();
+    }
+    mConfigured = false;
 
     mProcess->start();
     mProcess->waitForStarted(5000);
     mStartSemaphore.release(1);
-    while (true) {
-        mProcess->waitForFinished(1);
-        if (mProcess->state()!=QProcess::Running) {
-            break;
+    if (mStop) {
+        quitDebugger();
+    } else if (!errorOccured && mProcess->state()==QProcess::Running) {
+        // send requests posted before the loop is running
+        runNextCmd();
+        loop.exec();
+    }
+    if (errorOccured) {
+        emit processFailed(mProcess->error());
+    }
+}
+
+bool DAPDebuggerClient::isResumingRequest(const QString &command)
+{
+    return command == "continue"
+            || command == "next"
+            || command == "stepIn"
+            || command == "stepOut";
+}
+
+PDAPCommand DAPDebuggerClient::createCommand(const QString &command, const QJsonObject &arguments,
+                                             DAPCommandPurpose purpose, DebugCommandSource source)
+{
+    PDAPCommand cmd = std::make_shared<DAPCommand>();
+    cmd->command = command;
+    cmd->arguments = arguments;
+    cmd->source = source;
+    cmd->purpose = purpose;
+    cmd->from = 0;
+    cmd->count = 0;
+    return cmd;
+}
+
+void DAPDebuggerClient::enqueueCommand(const PDAPCommand &cmd)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    mSession.enqueue(cmd);
+    emit wakeUpRequested();
+}
+
+void DAPDebuggerClient::runNextCmd()
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    // requests are sent without waiting for the responses of the previous ones
+    typedef QPair<qint64, PDAPCommand> SeqCommand;
+    foreach (const SeqCommand& request, mSession.takeSendable()) {
+        sendCommand(request.first, request.second);
+    }
+}
+
+void DAPDebuggerClient::sendCommand(qint64 seq, const PDAPCommand &cmd)
+{
+    mCmdRunning = true;
+    if (cmd->source!=DebugCommandSource::HeartBeat)
+        emit cmdStarted();
+    QByteArray message = createDAPRequestMessage(seq, cmd->command, cmd->arguments);
+    if (mProcess->write(message)<0) {
+        emit writeToDebugFailed();
+    }
+}
+
+void DAPDebuggerClient::receiveOutput()
+{
+    QList<QByteArray> contentParts;
+    QStringList headerErrors;
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        mSession.receive(mProcess->readAllStandardOutput());
+        // the broken header is skipped, go on with the next message
+        contentParts = mSession.takeMessages(headerErrors);
+    }
+    if (contentParts.isEmpty() && headerErrors.isEmpty())
+        return;
+
+    emit parseStarted();
+
+    mConsoleOutput.clear();
+    mFullOutput.clear();
+    mConsoleOutput.append(headerErrors);
+
+    mSignalReceived = false;
+    mUpdateCPUInfo = false;
+    mReceivedSFWarning = false;
+    foreach (const QByteArray& contentPart, contentParts) {
+        if (pSettings->debugger().showDetailLog())
+            mFullOutput.append(QString::fromUtf8(contentPart));
+        processMessage(contentPart);
+    }
+
+    emit parseFinished();
+    runNextCmd();
+}
+
+void DAPDebuggerClient::quitDebugger()
+{
+    if (mProcess->state()!=QProcess::Running)
+        return;
+    // the remaining output is not wanted
+    mProcess->blockSignals(true);
+    mProcess->readAll();
+    QJsonObject args;
+    args["terminateDebuggee"] = true;
+    qint64 seq;
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        seq = mSession.takeSeq();
+    }
+    mProcess->write(createDAPRequestMessage(seq, "disconnect", args));
+    mProcess->waitForBytesWritten(50);
+    if (!mProcess->waitForFinished(100)) {
+        mProcess->terminate();
+        mProcess->kill();
+    }
+}
+
+void DAPDebuggerClient::processMessage(const QByteArray &contentPart)
+{
+    PDAPProtocolMessage message;
+    try {
+        message = parseDAPMessage(contentPart);
+    } catch (const DAPMessageError& e) {
+        mConsoleOutput.append(e.reason());
+        return;
+    }
+    if (!message)
+        return;
+    if (message->type == "event") {
+        processEvent(*std::static_pointer_cast<DAPEvent>(message));
+    } else if (message->type == "response") {
+        const DAPResponse& response = *std::static_pointer_cast<DAPResponse>(message);
+        PDAPCommand cmd;
+        {
+            QMutexLocker locker(&mCmdQueueMutex);
+            cmd = mSession.takeRequest(response.request_seq);
         }
-        if (mStop) {
-            mProcess->terminate();
-            mProcess->kill();
-            break;
+        if (!cmd)
+            return;
+        processResponse(cmd, response);
+        if (mProcessExited)
+            return;
+        QMutexLocker locker(&mCmdQueueMutex);
+        mCmdRunning = mSession.hasRunningRequests();
+        if (cmd->source!=DebugCommandSource::HeartBeat) {
+            bool userCmdRunning = false;
+            foreach (const PDAPCommand& runningCmd, mSession.runningRequests()) {
+                if (runningCmd->source!=DebugCommandSource::HeartBeat)
+                    userCmdRunning = true;
+            }
+            if (!userCmdRunning)
+                emit cmdFinished();
         }
-        if (errorOccured)
+    } else if (message->type == "request") {
+        // reverse requests (runInTerminal, startDebugging) are not supported
+        const DAPRequest& request = *std::static_pointer_cast<DAPRequest>(message);
+        QMutexLocker locker(&mCmdQueueMutex);
+        mProcess->write(createDAPResponseMessage(mSession.takeSeq(), request.seq, false,
+                                                 request.command, "not supported", QJsonObject()));
+    }
+}
+
+void DAPDebuggerClient::processResponse(const PDAPCommand &cmd, const DAPResponse &response)
+{
+    if (!response.success) {
+        switch (cmd->purpose) {
+        case DAPCommandPurpose::Locals:
+            handleLocals(cmd, QJsonArray());
+            break;
+        case DAPCommandPurpose::Registers:
+            handleRegisters(cmd, QJsonArray());
+            break;
+        case DAPCommandPurpose::UpdateVar:
+            handleUpdateVar(cmd, QJsonObject(), false);
+            break;
+        case DAPCommandPurpose::ListVarChildren:
+            emit prepareVarChildren(cmd->target, 0, false, cmd->from);
+            break;
+        case DAPCommandPurpose::MemoryView:
+            handleMemoryViewAddress(cmd, QJsonObject(), false);
+            break;
+        case DAPCommandPurpose::Memory:
+            memoryReadFinished(cmd.get());
             break;
-        readed = mProcess->readAll();
-        buffer += readed;
-
-        // if (readed.endsWith("\n")&& outputTerminated(buffer)) {
-        //     processDebugOutput(buffer);
-        //     buffer.clear();
-        //     mCmdRunning = false;
-        //     runNextCmd();
-        // } else if (!mCmdRunning && readed.isEmpty()){
-        //     runNextCmd();
-        // } else if (readed.isEmpty()){
-        //     msleep(1);
-        // }
+        default:
+            break;
+        }
+        if (!response.message.isEmpty())
+            mConsoleOutput.append(response.message);
+        return;
     }
-    if (errorOccured) {
-        emit processFailed(mProcess->error());
+    if (isResumingRequest(cmd->command)) {
+        handleContinued();
+        return;
+    }
+    if (cmd->command == "configurationDone") {
+        mConfigured = true;
+        // gdb doesn't resume the inferior stopped by the debug server
+        if (!mIsLLDB)
+            resume();
+        return;
+    }
+    if (cmd->command == "setBreakpoints") {
+        handleBreakpoints(cmd, response.body["breakpoints"].toArray());
+        return;
+    }
+    if (cmd->command == "dataBreakpointInfo") {
+        QJsonValue dataId = response.body["dataId"];
+        if (dataId.isString()) {
+            QMutexLocker locker(&mCmdQueueMutex);
+            mDataBreakpoints.append(dataId.toString());
+            QJsonArray breakpoints;
+            foreach (const QString& id, mDataBreakpoints) {
+                QJsonObject breakpoint;
+                breakpoint["dataId"] = id;
+                breakpoint["accessType"] = "write";
+                breakpoints.append(breakpoint);
+            }
+            QJsonObject args;
+            args["breakpoints"] = breakpoints;
+            enqueueCommand(createCommand("setDataBreakpoints", args));
+        } else {
+            mConsoleOutput.append(response.body["description"].toString());
+        }
+        return;
+    }
+    switch (cmd->purpose) {
+    case DAPCommandPurpose::Console:
+        if (cmd->source == DebugCommandSource::Console)
+            mConsoleOutput.append(textToLines(response.body["result"].toString()));
+        break;
+    case DAPCommandPurpose::StopLocation:
+        handleStackTrace(response.body["stackFrames"].toArray());
+        break;
+    case DAPCommandPurpose::Locals:
+    case DAPCommandPurpose::Registers:
+        if (cmd->command == "scopes")
+            handleScopes(cmd, response.body["scopes"].toArray());
+        else if (cmd->purpose == DAPCommandPurpose::Locals)
+            handleLocals(cmd, response.body["variables"].toArray());
+        else
+            handleRegisters(cmd, response.body["variables"].toArray());
+        break;
+    case DAPCommandPurpose::CreateVar:
+        handleCreateVar(cmd, response.body);
+        break;
+    case DAPCommandPurpose::UpdateVar:
+        handleUpdateVar(cmd, response.body, true);
+        break;
+    case DAPCommandPurpose::ListVarChildren:
+    case DAPCommandPurpose::UpdateVarChildren:
+        handleVarChildren(cmd, response.body["variables"].toArray());
+        break;
+    case DAPCommandPurpose::Evaluation:
+        emit evalUpdated(response.body["result"].toString());
+        break;
+    case DAPCommandPurpose::MemoryView:
+        handleMemoryViewAddress(cmd, response.body, true);
+        break;
+    case DAPCommandPurpose::Memory:
+        handleReadMemory(cmd, response.body);
+        break;
+    case DAPCommandPurpose::Disassembly:
+    case DAPCommandPurpose::BlendedDisassembly:
+        handleDisassembly(response.body["instructions"].toArray(),
+                          cmd->purpose == DAPCommandPurpose::BlendedDisassembly);
+        break;
+    default:
+        break;
     }
 }
 
-DebuggerType DAPDebuggerClient::clientType()
+void DAPDebuggerClient::processEvent(const DAPEvent &event)
 {
-    return DebuggerType::DAP;
+    if (event.event == "initialized") {
+        // configurations (breakpoints etc.) can be sent now
+        QMutexLocker locker(&mCmdQueueMutex);
+        mSession.setInitialized();
+    } else if (event.event == "stopped") {
+        handleStopped(event.body);
+    } else if (event.event == "continued") {
+        handleContinued();
+    } else if (event.event == "exited" || event.event == "terminated") {
+        //inferior exited, the adapter should terminate too
+        mProcessExited = true;
+    } else if (event.event == "output") {
+        QString category = event.body["category"].toString();
+        if (category != "telemetry")
+            mConsoleOutput.append(textToLines(event.body["output"].toString()));
+    }
+}
+
+void DAPDebuggerClient::handleStopped(const QJsonObject &body)
+{
+    mInferiorRunning = false;
+    if (body.contains("threadId"))
+        mThreadId = static_cast<qint64>(body["threadId"].toDouble());
+    // stopped by the debug server, it's resumed after the configuration
+    if (!mConfigured)
+        return;
+    QString reason = body["reason"].toString();
+    if (reason == "exception" || reason == "signal") {
+        mSignalReceived = true;
+        QString description = body["description"].toString();
+        QString text = body["text"].toString();
+        QRegularExpressionMatch match = QRegularExpression("SIG[A-Z]+").match(description + " " + text);
+        mSignalName = match.hasMatch() ? match.captured() : description;
+        mSignalMeaning = text.isEmpty() ? description : text;
+    }
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        if (mStopAtMain) {
+            mStopAtMain = false;
+            QJsonObject args;
+            args["breakpoints"] = QJsonArray();
+            enqueueCommand(createCommand("setFunctionBreakpoints", args));
+        }
+    }
+    PBreakpoint runToBreakpoint;
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        runToBreakpoint = mRunToBreakpoint;
+        mRunToBreakpoint.reset();
+    }
+    if (runToBreakpoint)
+        sendBreakpoints(runToBreakpoint->filename);
+    // the stop is reported when the location is known
+    QJsonObject args;
+    args["threadId"] = mThreadId;
+    args["startFrame"] = 0;
+    args["levels"] = StackPageSize;
+    enqueueCommand(createCommand("stackTrace", args, DAPCommandPurpose::StopLocation));
+}
+
+void DAPDebuggerClient::handleContinued()
+{
+    if (mInferiorRunning)
+        return;
+    mInferiorRunning = true;
+    invalidateMemoryCache();
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        // frames and variablesReferences are invalid now
+        mFrameIds.clear();
+        mFrameId = -1;
+        mCurrentAddress = 0;
+        mCurrentFile.clear();
+        mCurrentLine = -1;
+        mCurrentFunc.clear();
+    }
+    emit inferiorContinued();
+}
+
+void DAPDebuggerClient::handleStackTrace(const QJsonArray &frames)
+{
+    QList<PTrace> traces;
+    QList<qint64> frameIds;
+    for (int i = 0; i < frames.count(); i++) {
+        QJsonObject frame = frames[i].toObject();
+        PTrace trace = std::make_shared<Trace>();
+        trace->funcname = frame["name"].toString();
+        trace->filename = sourcePath(frame["source"].toObject());
+        trace->line = frame["line"].toInt() - 1;
+        trace->level = i;
+        trace->address = frame["instructionPointerReference"].toString();
+        traces.append(trace);
+        frameIds.append(static_cast<qint64>(frame["id"].toDouble()));
+    }
+    debugger()->backtraceModel()->setTraces(traces);
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        mFrameIds = frameIds;
+        mFrameId = -1;
+        mCurrentAddress = 0;
+        mCurrentFile.clear();
+        mCurrentLine = -1;
+        mCurrentFunc.clear();
+        if (!traces.isEmpty()) {
+            mFrameId = frameIds.front();
+            bool ok;
+            mCurrentAddress = parseAddress(traces.front()->address, ok);
+            if (!ok)
+                mCurrentAddress = 0;
+            mCurrentFile = traces.front()->filename;
+            mCurrentLine = traces.front()->line + 1;
+            mCurrentFunc = traces.front()->funcname;
+        }
+    }
+    mUpdateCPUInfo = true;
+    emit inferiorStopped(mCurrentFile, mCurrentLine-1);
+}
+
+void DAPDebuggerClient::handleScopes(const PDAPCommand &cmd, const QJsonArray &scopes)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (cmd->purpose == DAPCommandPurpose::Locals) {
+        // the previous refresh is outdated
+        mLocalReads.clear();
+        mScopeLocals.clear();
+    } else {
+        mRegisterReads.clear();
+        mRegisterNames.clear();
+        mRegisterValues.clear();
+    }
+    for (int i = 0; i < scopes.count(); i++) {
+        QJsonObject scope = scopes[i].toObject();
+        bool isRegisters = isDAPRegisterScope(scope);
+        if (cmd->purpose == DAPCommandPurpose::Locals) {
+            if (isRegisters || scope["expensive"].toBool())
+                continue;
+        } else if (!isRegisters) {
+            continue;
+        }
+        QJsonObject args;
+        args["variablesReference"] = scope["variablesReference"];
+        PDAPCommand varsCmd = createCommand("variables", args, cmd->purpose);
+        varsCmd->from = i;
+        if (cmd->purpose == DAPCommandPurpose::Locals)
+            mLocalReads.insert(varsCmd.get());
+        else
+            mRegisterReads.insert(varsCmd.get());
+        enqueueCommand(varsCmd);
+    }
+    if (cmd->purpose == DAPCommandPurpose::Locals && mLocalReads.isEmpty()) {
+        mLocals.clear();
+        emit localsUpdated(mLocals);
+    }
+}
+
+void DAPDebuggerClient::handleLocals(const PDAPCommand &cmd, const QJsonArray &variables)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (!mLocalReads.remove(cmd.get()))
+        return;
+    QStringList lines;
+    foreach (const QJsonValue& value, variables) {
+        QJsonObject var = value.toObject();
+        lines.append(QString("%1 = %2").arg(var["name"].toString(), var["value"].toString()));
+    }
+    mScopeLocals.insert(cmd->from, lines);
+    if (!mLocalReads.isEmpty())
+        return;
+    // in the order of the scopes
+    mLocals.clear();
+    foreach (const QStringList& scopeLines, mScopeLocals) {
+        mLocals.append(scopeLines);
+    }
+    emit localsUpdated(mLocals);
+}
+
+void DAPDebuggerClient::handleRegisters(const PDAPCommand &cmd, const QJsonArray &variables)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (!mRegisterReads.remove(cmd.get()))
+        return;
+    foreach (const QJsonValue& value, variables) {
+        QJsonObject var = value.toObject();
+        qint64 reference = static_cast<qint64>(var["variablesReference"].toDouble());
+        bool ok;
+        var["value"].toString().toULongLong(&ok, 0);
+        if (reference > 0 && !ok) {
+            // registers are grouped by lldb
+            QJsonObject args;
+            args["variablesReference"] = reference;
+            PDAPCommand groupCmd = createCommand("variables", args, DAPCommandPurpose::Registers);
+            mRegisterReads.insert(groupCmd.get());
+            enqueueCommand(groupCmd);
+            continue;
+        }
+        mRegisterNames.append(var["name"].toString());
+        mRegisterValues.insert(mRegisterNames.count() - 1, var["value"].toString());
+    }
+    if (!mRegisterReads.isEmpty())
+        return;
+    emit registerNamesUpdated(mRegisterNames);
+    emit registerValuesUpdated(mRegisterValues);
+}
+
+void DAPDebuggerClient::handleBreakpoints(const PDAPCommand &cmd, const QJsonArray &breakpoints)
+{
+    QJsonArray sourceBreakpoints = cmd->arguments["breakpoints"].toArray();
+    // in the same order as they are set
+    for (int i = 0; i < breakpoints.count() && i < sourceBreakpoints.count(); i++) {
+        QJsonObject breakpoint = breakpoints[i].toObject();
+        if (!breakpoint.contains("id"))
+            continue;
+        int line = breakpoint.contains("line") ? breakpoint["line"].toInt()
+                                               : sourceBreakpoints[i].toObject()["line"].toInt();
+        emit breakpointInfoGetted(cmd->target, line - 1, breakpoint["id"].toInt());
+    }
+}
+
+void DAPDebuggerClient::handleCreateVar(const PDAPCommand &cmd, const QJsonObject &body)
+{
+    VarInfo info;
+    info.expression = cmd->target;
+    info.reference = static_cast<qint64>(body["variablesReference"].toDouble());
+    info.namedCount = body["namedVariables"].toInt();
+    info.indexedCount = body["indexedVariables"].toInt();
+    info.listedCount = 0;
+    QString name;
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        name = QString("var%1").arg(mNextVarId++);
+        mVars.insert(name, info);
+        mWatchNames.append(name);
+    }
+    int numChild = childCount(body);
+    // the count of children is not always known before they are listed
+    bool hasMore = info.reference > 0 && numChild == 0;
+    emit varCreated(cmd->target, name, numChild,
+                    body["result"].toString(), body["type"].toString(), hasMore);
+}
+
+void DAPDebuggerClient::handleUpdateVar(const PDAPCommand &cmd, const QJsonObject &body, bool ok)
+{
+    QString name = cmd->target;
+    if (!ok) {
+        emit varValueUpdated(name, QString(), "false", false, QString(), -1, false);
+        return;
+    }
+    int listedCount;
+    qint64 reference = static_cast<qint64>(body["variablesReference"].toDouble());
+    {
+        QMutexLocker locker(&mCmdQueueMutex);
+        if (!mVars.contains(name))
+            return;
+        VarInfo& info = mVars[name];
+        info.reference = reference;
+        info.namedCount = body["namedVariables"].toInt();
+        info.indexedCount = body["indexedVariables"].toInt();
+        listedCount = info.listedCount;
+    }
+    int numChild = childCount(body);
+    emit varValueUpdated(name, body["result"].toString(), "true", true, body["type"].toString(),
+                         numChild > 0 ? numChild : -1, reference > 0 && numChild == 0);
+    // expanded children are updated with the new reference
+    if (listedCount > 0)
+        listVarChildren(name, 0, listedCount, true);
+}
+
+void DAPDebuggerClient::handleVarChildren(const PDAPCommand &cmd, const QJsonArray &variables)
+{
+    QString parentName = cmd->target;
+    bool refreshing = cmd->purpose == DAPCommandPurpose::UpdateVarChildren;
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (!mVars.contains(parentName))
+        return;
+    VarInfo& parent = mVars[parentName];
+    int total = parent.indexedCount > 0 ? parent.indexedCount : parent.namedCount;
+    if (!refreshing) {
+        bool hasMore = hasMoreDAPVariables(total, cmd->from, static_cast<int>(variables.count()), cmd->count);
+        parent.listedCount = std::max(parent.listedCount, cmd->from + static_cast<int>(variables.count()));
+        emit prepareVarChildren(parentName, variables.count(), hasMore, cmd->from);
+    }
+    for (int i = 0; i < variables.count(); i++) {
+        QJsonObject var = variables[i].toObject();
+        // children are named by their positions, so they are found again after refreshing
+        QString name = QString("%1.%2").arg(parentName).arg(cmd->from + i);
+        qint64 reference = static_cast<qint64>(var["variablesReference"].toDouble());
+        int numChild = childCount(var);
+        bool hasMore = reference > 0 && numChild == 0;
+        if (!refreshing) {
+            VarInfo info;
+            info.expression = var["evaluateName"].toString();
+            info.reference = reference;
+            info.namedCount = var["namedVariables"].toInt();
+            info.indexedCount = var["indexedVariables"].toInt();
+            info.listedCount = 0;
+            mVars.insert(name, info);
+            emit addVarChild(parentName, name, var["name"].toString(), numChild,
+                             var["value"].toString(), var["type"].toString(), hasMore);
+            continue;
+        }
+        if (!mVars.contains(name))
+            continue;
+        VarInfo& info = mVars[name];
+        info.reference = reference;
+        info.namedCount = var["namedVariables"].toInt();
+        info.indexedCount = var["indexedVariables"].toInt();
+        emit varValueUpdated(name, var["value"].toString(), "true", true, var["type"].toString(),
+                             numChild > 0 ? numChild : -1, hasMore);
+        if (info.listedCount > 0)
+            listVarChildren(name, 0, info.listedCount, true);
+    }
+}
+
+void DAPDebuggerClient::handleReadMemory(const PDAPCommand &cmd, const QJsonObject &body)
+{
+    {
+        QMutexLocker locker(&mMemoryMutex);
+        bool ok;
+        qulonglong address = parseAddress(body["address"].toString(), ok);
+        QByteArray data = QByteArray::fromBase64(body["data"].toString().toLatin1());
+        // unreadable bytes are not included
+        if (ok && !data.isEmpty())
+            mMemoryCache.insert(address, data);
+    }
+    memoryReadFinished(cmd.get());
+}
+
+void DAPDebuggerClient::handleMemoryViewAddress(const PDAPCommand &cmd, const QJsonObject &body, bool ok)
+{
+    qulonglong address = 0;
+    if (ok) {
+        // for pointers, it's the address they point to
+        QString reference = body["memoryReference"].toString();
+        address = parseAddress(reference.isEmpty() ? body["result"].toString() : reference, ok);
+    }
+    QByteArray memory;
+    {
+        QMutexLocker locker(&mMemoryMutex);
+        if (!mMemoryViewReads.remove(cmd.get()))
+            return;
+        if (!ok || address == 0)
+            return;
+        mMemoryViewAddress = address;
+        if (readMemoryRanges(address))
+            return;
+        memory = mMemoryCache.read(address, mMemoryViewSize);
+    }
+    if (!memory.isEmpty())
+        emit memoryUpdated(address, memory);
+}
+
+void DAPDebuggerClient::handleDisassembly(const QJsonArray &instructions, bool blendMode)
+{
+    QStringList lines;
+    QString lastFile;
+    int lastLine = -1;
+    foreach (const QJsonValue& value, instructions) {
+        QJsonObject instruction = value.toObject();
+        if (instruction["presentationHint"].toString() == "invalid")
+            continue;
+        if (blendMode && instruction.contains("line")) {
+            QString filename = sourcePath(instruction["location"].toObject());
+            if (filename.isEmpty())
+                filename = lastFile;
+            int line = instruction["line"].toInt();
+            if ((line != lastLine || filename != lastFile) && !filename.isEmpty()) {
+                if (!mFileCache.contains(filename))
+                    mFileCache.insert(filename, readFileToLines(filename));
+                const QStringList& contents = mFileCache[filename];
+                if (line >= 1 && line <= contents.count())
+                    lines.append(QString("%1\t%2").arg(line).arg(contents[line-1]));
+                lastFile = filename;
+                lastLine = line;
+            }
+        }
+        QString address = instruction["address"].toString();
+        bool ok;
+        qulonglong addressValue = parseAddress(address, ok);
+        QString prefix = (ok && addressValue == mCurrentAddress) ? "=> " : "   ";
+        QString symbol = instruction["symbol"].toString();
+        if (symbol.isEmpty())
+            lines.append(QString("%1%2:\t%3").arg(prefix, address, instruction["instruction"].toString()));
+        else
+            lines.append(QString("%1%2 <%3>:\t%4").arg(prefix, address, symbol,
+                                                      instruction["instruction"].toString()));
+    }
+    emit disassemblyUpdate(mCurrentFile, mCurrentFunc, lines);
+}
+
+void DAPDebuggerClient::memoryReadFinished(const DAPCommand *cmd)
+{
+    qulonglong address;
+    QByteArray memory;
+    {
+        QMutexLocker locker(&mMemoryMutex);
+        if (!mMemoryViewReads.remove(cmd) || !mMemoryViewReads.isEmpty())
+            return;
+        address = mMemoryViewAddress;
+        if (address == 0)
+            return;
+        memory = mMemoryCache.read(address, mMemoryViewSize);
+    }
+    // unreadable bytes are not shown
+    if (!memory.isEmpty())
+        emit memoryUpdated(address, memory);
+}
+
+bool DAPDebuggerClient::readMemoryRanges(qulonglong address)
+{
+    // only read what's not cached, page by page
+    QList<AddressRange> ranges = mMemoryCache.missingRanges(address, mMemoryViewSize);
+    foreach (const AddressRange& range, ranges) {
+        for (int offset = 0; offset < range.second; offset += MemoryPageSize) {
+            QJsonObject args;
+            args["memoryReference"] = addressReference(range.first + offset);
+            args["count"] = std::min(MemoryPageSize, range.second - offset);
+            PDAPCommand cmd = createCommand("readMemory", args, DAPCommandPurpose::Memory);
+            mMemoryViewReads.insert(cmd.get());
+            enqueueCommand(cmd);
+        }
+    }
+    return !ranges.isEmpty();
+}
+
+void DAPDebuggerClient::invalidateMemoryCache()
+{
+    QMutexLocker locker(&mMemoryMutex);
+    mMemoryCache.clear();
+}
+
+void DAPDebuggerClient::listVarChildren(const QString &varName, int from, int count, bool refreshing)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    VarInfo info = mVars.value(varName, VarInfo{QString(), 0, 0, 0, 0});
+    if (info.reference <= 0) {
+        if (!refreshing)
+            emit prepareVarChildren(varName, 0, false, from);
+        return;
+    }
+    QJsonObject args = createDAPVariablesArguments(info.reference, info.indexedCount, from, count);
+    PDAPCommand cmd = createCommand("variables", args,
+                                    refreshing ? DAPCommandPurpose::UpdateVarChildren
+                                               : DAPCommandPurpose::ListVarChildren);
+    cmd->target = varName;
+    cmd->from = from;
+    cmd->count = count;
+    enqueueCommand(cmd);
+}
+
+void DAPDebuggerClient::sendBreakpoints(const QString &filename)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    // setBreakpoints replaces all breakpoints of the file
+    QList<PBreakpoint> breakpoints = mBreakpoints.value(filename);
+    if (mRunToBreakpoint && mRunToBreakpoint->filename == filename)
+        breakpoints.append(mRunToBreakpoint);
+    if (breakpoints.isEmpty())
+        mBreakpoints.remove(filename);
+    QJsonArray sourceBreakpoints;
+    foreach (const PBreakpoint& breakpoint, breakpoints) {
+        QJsonObject sourceBreakpoint;
+        sourceBreakpoint["line"] = breakpoint->line + 1;
+        if (!breakpoint->condition.isEmpty())
+            sourceBreakpoint["condition"] = breakpoint->condition;
+        sourceBreakpoints.append(sourceBreakpoint);
+    }
+    QJsonObject args;
+    args["source"] = sourceArguments(filename);
+    args["breakpoints"] = sourceBreakpoints;
+    PDAPCommand cmd = createCommand("setBreakpoints", args);
+    cmd->target = filename;
+    enqueueCommand(cmd);
+}
+
+QJsonObject DAPDebuggerClient::sourceArguments(const QString &filename) const
+{
+    QJsonObject source;
+    source["name"] = extractFileName(filename);
+    source["path"] = filename;
+    return source;
+}
+
+QJsonObject DAPDebuggerClient::threadArguments() const
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    QJsonObject args;
+    args["threadId"] = mThreadId;
+    return args;
+}
+
+QString DAPDebuggerClient::sourcePath(const QJsonObject &source)
+{
+    QString path = source["path"].toString();
+    if (path.isEmpty())
+        return path;
+    return QFileInfo(path).absoluteFilePath();
+}
+
+int DAPDebuggerClient::childCount(const QJsonObject &var)
+{
+    return var["namedVariables"].toInt() + var["indexedVariables"].toInt();
 }
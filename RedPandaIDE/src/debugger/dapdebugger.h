@@ -18,26 +18,213 @@
 #define DAP_DEBUGGER_H
 
 #include "debugger.h"
+#include "addressrangecache.h"
+#include "dapsession.h"
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QProcess>
+#include <QSet>
 
+// what the response of a request is used for
+enum class DAPCommandPurpose {
+    Other,
+    Console,
+    StopLocation, // the stack of the stopped thread
+    Locals,
+    Registers,
+    CreateVar,
+    UpdateVar,
+    ListVarChildren,
+    UpdateVarChildren,
+    Evaluation,
+    MemoryView, // the address of the memory view
+    Memory,
+    Disassembly,
+    BlendedDisassembly
+};
+
+struct DAPCommand {
+    QString command;
+    QJsonObject arguments;
+    DebugCommandSource source;
+    DAPCommandPurpose purpose;
+    // the var, the expression or the source file the request is for
+    QString target;
+    // the first child requested, or the index of the scope
+    int from;
+    int count;
+};
+
+using PDAPCommand = std::shared_ptr<DAPCommand>;
+
+/**
+ * @brief A debugger client talking the Debug Adapter Protocol
+ *
+ * Works with gdb's native adapter (gdb 14 or later, "gdb -i dap") and lldb-dap
+ * (lldb-vscode in older llvm releases).
+ *
+ * Requests are sent as soon as they are posted, without waiting for the
+ * responses of the previous ones. The responses are matched to the requests
+ * by their sequence numbers.
+ *
+ * Children of vars are listed lazily by their variablesReference, page by page.
+ */
 class DAPDebuggerClient : public DebuggerClient {
     Q_OBJECT
 public:
     explicit DAPDebuggerClient(Debugger* debugger, QObject *parent = nullptr);
+    DAPDebuggerClient(const DAPDebuggerClient&) = delete;
+    DAPDebuggerClient& operator=(const DAPDebuggerClient&) = delete;
 
-
-    // QThread interface
-protected:
-    void run() override;
+    PDAPCommand postRequest(const QString& command, const QJsonObject& arguments,
+                            DebugCommandSource source = DebugCommandSource::Other);
+    /**
+     * @brief run a command in the adapter's debug console (gdb/lldb commands)
+     */
+    void postConsoleCommand(const QString& command,
+                            DebugCommandSource source = DebugCommandSource::Console);
 
     // DebuggerClient interface
 public:
+    void stopDebug() override;
+    bool commandRunning() const override;
     DebuggerType clientType() override;
 
+    void initialize(const QString& inferior, bool hasSymbols) override;
+    void runInferior(bool hasBreakpoints) override;
+
+    void stepOver() override;
+    void stepInto() override;
+    void stepOut() override;
+    void runTo(const QString& filename, int line) override;
+    void resume() override;
+    void stepOverInstruction() override;
+    void stepIntoInstruction() override;
+    void interrupt() override;
+
+    void refreshStackVariables() override;
+
+    void readMemory(const QString& startAddress, int rows, int cols) override;
+    void writeMemory(qulonglong address, unsigned char data) override;
+
+    void addBreakpoint(PBreakpoint breakpoint) override;
+    void removeBreakpoint(PBreakpoint breakpoint) override;
+    void addWatchpoint(const QString& watchExp) override;
+    void setBreakpointCondition(PBreakpoint breakpoint) override;
+
+    void addWatch(const QString& expression) override;
+    void removeWatch(PWatchVar watchVar) override;
+    void writeWatchVar(const QString& varName, const QString& value) override;
+    void refreshWatch(PWatchVar var) override;
+    void refreshWatch() override;
+    void fetchWatchVarChildren(const QString& varName, int from, int count) override;
+
+    void evalExpression(const QString& expression) override;
+
+    void selectFrame(PTrace trace) override;
+    void refreshFrame() override;
+    void refreshRegisters() override;
+    void disassembleCurrentFrame(bool blendMode) override;
+    void setDisassemblyLanguage(bool isIntel) override;
+
+    void skipDirectoriesInSymbolSearch(const QStringList& lst) override;
+    void addSymbolSearchDirectories(const QStringList& lst) override;
+    void skipStandardLibraryFunctions() override;
+
+    // QThread interface
+protected:
+    void run() override;
+signals:
+    void wakeUpRequested();
 private:
-    void initializeRequest();
+    struct VarInfo {
+        QString expression; // evaluateName, used to refresh and assign it
+        qint64 reference; // variablesReference, only valid when the inferior is stopped
+        int namedCount;
+        int indexedCount;
+        int listedCount; // children fetched by the watch view
+    };
+
+    static bool isResumingRequest(const QString& command);
+    PDAPCommand createCommand(const QString& command, const QJsonObject& arguments,
+                              DAPCommandPurpose purpose = DAPCommandPurpose::Other,
+                              DebugCommandSource source = DebugCommandSource::Other);
+    void enqueueCommand(const PDAPCommand& cmd);
+    void runNextCmd();
+    void sendCommand(qint64 seq, const PDAPCommand& cmd);
+    void receiveOutput();
+    void quitDebugger();
+    void processMessage(const QByteArray& contentPart);
+    void processResponse(const PDAPCommand& cmd, const DAPResponse& response);
+    void processEvent(const DAPEvent& event);
+    void handleStopped(const QJsonObject& body);
+    void handleContinued();
+    void handleStackTrace(const QJsonArray& frames);
+    void handleScopes(const PDAPCommand& cmd, const QJsonArray& scopes);
+    void handleLocals(const PDAPCommand& cmd, const QJsonArray& variables);
+    void handleRegisters(const PDAPCommand& cmd, const QJsonArray& variables);
+    void handleBreakpoints(const PDAPCommand& cmd, const QJsonArray& breakpoints);
+    void handleCreateVar(const PDAPCommand& cmd, const QJsonObject& body);
+    void handleUpdateVar(const PDAPCommand& cmd, const QJsonObject& body, bool ok);
+    void handleVarChildren(const PDAPCommand& cmd, const QJsonArray& variables);
+    void handleReadMemory(const PDAPCommand& cmd, const QJsonObject& body);
+    void handleMemoryViewAddress(const PDAPCommand& cmd, const QJsonObject& body, bool ok);
+    void handleDisassembly(const QJsonArray& instructions, bool blendMode);
+    void memoryReadFinished(const DAPCommand* cmd);
+    // returns false if all of them are cached
+    bool readMemoryRanges(qulonglong address);
+    void invalidateMemoryCache();
+    void listVarChildren(const QString& varName, int from, int count, bool refreshing);
+    void sendBreakpoints(const QString& filename);
+    QJsonObject sourceArguments(const QString& filename) const;
+    QJsonObject threadArguments() const;
+    static QString sourcePath(const QJsonObject& source);
+    static int childCount(const QJsonObject& var);
 private:
-    std::shared_ptr<QProcess> mProcess;
     bool mStop;
+    bool mIsLLDB;
+    std::shared_ptr<QProcess> mProcess;
+    DAPSession<PDAPCommand> mSession;
+    bool mConfigured; // configurationDone is sent
+
+    qint64 mThreadId;
+    QList<qint64> mFrameIds; // by frame levels
+    qint64 mFrameId; // the selected frame
+    int mCurrentLine;
+    qulonglong mCurrentAddress;
+    QString mCurrentFunc;
+    QString mCurrentFile;
+    QMap<QString, QStringList> mFileCache; // sources shown in blended disassembly
+
+    // breakpoints are set file by file
+    QMap<QString, QList<PBreakpoint>> mBreakpoints;
+    PBreakpoint mRunToBreakpoint;
+    QStringList mDataBreakpoints;
+    bool mStopAtMain;
+
+    // watch vars and their children, by the names given to the watch model
+    QHash<QString, VarInfo> mVars;
+    QStringList mWatchNames; // top level watch vars
+    int mNextVarId;
+
+    QStringList mLocals;
+    QMap<int, QStringList> mScopeLocals; // by the index of the scope
+    QSet<const DAPCommand*> mLocalReads; // variables requests not responded yet
+    QStringList mRegisterNames;
+    QHash<int, QString> mRegisterValues;
+    QSet<const DAPCommand*> mRegisterReads;
+
+    // memory cache and view are also used by the main thread
+    QMutex mMemoryMutex;
+    MemoryCache mMemoryCache;
+    qulonglong mMemoryViewAddress; // 0 if the expression is not evaluated yet
+    int mMemoryViewSize;
+    // reads the memory view is waiting for
+    QSet<const DAPCommand*> mMemoryViewReads;
+    static constexpr int MemoryPageSize = 1024;
+    static constexpr int StackPageSize = 100;
+    static constexpr int DisassemblyLinesBefore = 32;
+    static constexpr int DisassemblyLines = 96;
 };
 
 #endif
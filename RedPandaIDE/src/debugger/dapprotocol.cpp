@@ -15,13 +15,13 @@ static QJsonObject createDAPMessageObj(qint64 seq, const QString& type) {
     return obj;
 }
 
-static QString jsonToDAPMessageString(const QJsonObject &jsonObj)
+static QByteArray jsonToDAPMessage(const QJsonObject &jsonObj)
 {
     QJsonDocument doc;
     doc.setObject(jsonObj);
-    QString contentPart = doc.toJson(QJsonDocument::JsonFormat::Indented);
-    QString message = QString("Content-Length: %1\r\n").arg(contentPart.length())+contentPart;
-    return message;
+    QByteArray contentPart = doc.toJson(QJsonDocument::JsonFormat::Compact);
+    // the length is in bytes, not in characters
+    return "Content-Length: " + QByteArray::number(contentPart.length()) + "\r\n\r\n" + contentPart;
 }
 
 static QJsonObject contentPartToDAPMessageObj(const QByteArray &contentPart) {
@@ -70,17 +70,17 @@ static QJsonObject parseJsonObjObjectProperty(const QJsonObject& obj, const QStr
 }
 
 
-QString createDAPRequestMessage(qint64 seq, const QString &command, const QJsonObject &arguments)
+QByteArray createDAPRequestMessage(qint64 seq, const QString &command, const QJsonObject &arguments)
 {
     QJsonObject obj = createDAPMessageObj(seq, "request");
     obj["command"]=command;
     if (!arguments.isEmpty()) {
         obj["arguments"] = arguments;
     }
-    return jsonToDAPMessageString(obj);
+    return jsonToDAPMessage(obj);
 }
 
-QString createDAPResponseMessage(qint64 seq, qint64 request_seq, bool success, const QString &command, const QString &message, const QJsonObject &body)
+QByteArray createDAPResponseMessage(qint64 seq, qint64 request_seq, bool success, const QString &command, const QString &message, const QJsonObject &body)
 {
     QJsonObject obj = createDAPMessageObj(seq, "response");
     obj["request_seq"]=request_seq;
@@ -90,22 +90,54 @@ QString createDAPResponseMessage(qint64 seq, qint64 request_seq, bool success, c
         obj["message"]=message;
     if (!body.isEmpty())
         obj["body"]=body;
-    return jsonToDAPMessageString(obj);
+    return jsonToDAPMessage(obj);
 }
 
-QString createDAPEventMessage(qint64 seq, const QString &event, const QJsonObject &body)
+QByteArray createDAPEventMessage(qint64 seq, const QString &event, const QJsonObject &body)
 {
     QJsonObject obj = createDAPMessageObj(seq, "event");
     obj["event"] = event;
     if (!body.isEmpty())
         obj["body"] = body;
-    return jsonToDAPMessageString(obj);
+    return jsonToDAPMessage(obj);
 }
 
-std::shared_ptr<DAPProtocolMessage> parseDAPMessage(const QByteArray &contentPart)
+bool takeDAPMessage(QByteArray &buffer, QByteArray &contentPart)
+{
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0)
+        return false;
+    int contentLength = -1;
+    QList<QByteArray> headers = buffer.left(headerEnd).split('\n');
+    foreach (const QByteArray& header, headers) {
+        int pos = header.indexOf(':');
+        if (pos < 0)
+            continue;
+        if (header.left(pos).trimmed() == "Content-Length") {
+            bool ok;
+            contentLength = header.mid(pos + 1).trimmed().toInt(&ok);
+            if (!ok)
+                contentLength = -1;
+        }
+    }
+    if (contentLength < 0) {
+        QByteArray header = buffer.left(headerEnd);
+        // skip the broken header, or we will be stuck on it
+        buffer.remove(0, headerEnd + 4);
+        throw DAPMessageError(QObject::tr("The message header don't have a valid 'Content-Length' field: %1")
+                              .arg(QString::fromUtf8(header)));
+    }
+    int contentStart = headerEnd + 4;
+    if (buffer.length() - contentStart < contentLength)
+        return false;
+    contentPart = buffer.mid(contentStart, contentLength);
+    buffer.remove(0, contentStart + contentLength);
+    return true;
+}
+
+PDAPProtocolMessage parseDAPMessage(const QByteArray &contentPart)
 {
     QJsonObject obj = contentPartToDAPMessageObj(contentPart);
-    DAPRequest req;
     qint64 seq = parseJsonObjNumberProperty(obj, "seq");
     QString type = parseJsonObjStringProperty(obj, "type");
     if (type == "request") {
@@ -133,5 +165,5 @@ std::shared_ptr<DAPProtocolMessage> parseDAPMessage(const QByteArray &contentPar
         response->body = obj["body"].toObject();
         return response;
     }
-    return std::shared_ptr<DAPProtocolMessage>();
+    return PDAPProtocolMessage();
 }
@@ -50,16 +50,27 @@ struct DAPResponse: public DAPProtocolMessage {
     QJsonObject body;
 };
 
-QString createDAPRequestMessage(
+using PDAPProtocolMessage = std::shared_ptr<DAPProtocolMessage>;
+
+// the created messages are framed ("Content-Length: n\r\n\r\n" + utf-8 json)
+QByteArray createDAPRequestMessage(
         qint64 seq, const QString &command, const QJsonObject& arguments);
 
-QString createDAPResponseMessage(
+QByteArray createDAPResponseMessage(
         qint64 seq, qint64 request_seq, bool success,
         const QString& command, const QString& message, const QJsonObject& body);
 
-QString createDAPEventMessage(
+QByteArray createDAPEventMessage(
         qint64 seq, const QString& event, const QJsonObject& body);
 
-std::shared_ptr<DAPProtocolMessage> parseDAPMessage(const QByteArray& contentPart);
+/**
+ * @brief take the content part of the first complete message in the buffer
+ *
+ * The message is removed from the buffer.
+ * @return false if the message is not completely received
+ */
+bool takeDAPMessage(QByteArray& buffer, QByteArray& contentPart);
+
+PDAPProtocolMessage parseDAPMessage(const QByteArray& contentPart);
 
 #endif
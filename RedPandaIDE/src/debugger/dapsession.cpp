@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "dapsession.h"
+#include <algorithm>
+
+bool isDAPStartupRequest(const QString &command)
+{
+    return command == "initialize"
+            || command == "launch"
+            || command == "attach";
+}
+
+bool isDAPRegisterScope(const QJsonObject &scope)
+{
+    return scope["presentationHint"].toString() == "registers"
+            || scope["name"].toString().contains("Register");
+}
+
+QJsonObject createDAPVariablesArguments(qint64 variablesReference, int indexedCount, int from, int count)
+{
+    QJsonObject args;
+    args["variablesReference"] = variablesReference;
+    if (indexedCount > 0) {
+        // elements of large arrays are listed page by page
+        int remaining = indexedCount - from;
+        args["filter"] = "indexed";
+        args["start"] = from;
+        args["count"] = count > 0 ? std::min(count, remaining) : remaining;
+    } else if (count > 0) {
+        args["start"] = from;
+        args["count"] = count;
+    }
+    return args;
+}
+
+bool hasMoreDAPVariables(int total, int from, int listed, int requested)
+{
+    if (total > 0)
+        return from + listed < total;
+    // a full page may be followed by more
+    return requested > 0 && listed == requested;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef DAP_SESSION_H
+#define DAP_SESSION_H
+
+#include "dapprotocol.h"
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QPair>
+#include <QQueue>
+#include <QStringList>
+
+// the request can be sent before the "initialized" event
+bool isDAPStartupRequest(const QString& command);
+
+// registers are listed in a scope of their own
+bool isDAPRegisterScope(const QJsonObject& scope);
+
+/**
+ * @brief arguments of the "variables" request listing the children of a var
+ *
+ * Elements of arrays (indexed children) are listed page by page.
+ * @param count 0 to list all of them
+ */
+QJsonObject createDAPVariablesArguments(qint64 variablesReference, int indexedCount,
+                                        int from, int count);
+
+/**
+ * @brief if there are children after the listed ones
+ * @param total the count reported by the adapter, 0 if unknown
+ */
+bool hasMoreDAPVariables(int total, int from, int listed, int requested);
+
+/**
+ * @brief The request bookkeeping of a DAP client.
+ *
+ * Requests are queued until the adapter is ready for them, numbered when
+ * they are sent, and matched with their responses by the sequence numbers.
+ * The output of the adapter is collected here until the messages are complete.
+ *
+ * It's not thread safe, the client guards it with its command queue mutex.
+ */
+template <typename Command>
+class DAPSession
+{
+public:
+    DAPSession():
+        mNextSeq{1},
+        mInitialized{false}
+    {
+    }
+
+    /**
+     * @brief start a new session, the queued requests are kept
+     */
+    void reset() {
+        mReceiveBuffer.clear();
+        mRunningRequests.clear();
+        mNextSeq = 1;
+        mInitialized = false;
+    }
+
+    void enqueue(const Command& cmd) {
+        mQueue.enqueue(cmd);
+    }
+
+    /**
+     * @brief take the requests that can be sent now, with their sequence numbers
+     *
+     * They are waiting for responses after that.
+     */
+    QList<QPair<qint64, Command>> takeSendable() {
+        QList<QPair<qint64, Command>> result;
+        while (!mQueue.isEmpty()) {
+            if (!mInitialized && !isDAPStartupRequest(mQueue.head()->command))
+                break;
+            qint64 seq = mNextSeq++;
+            mRunningRequests.insert(seq, mQueue.head());
+            result.append(qMakePair(seq, mQueue.dequeue()));
+        }
+        return result;
+    }
+
+    /**
+     * @brief the request the response is for, or nullptr if it's unknown
+     */
+    Command takeRequest(qint64 requestSeq) {
+        return mRunningRequests.take(requestSeq);
+    }
+
+    // for messages not waiting for responses
+    qint64 takeSeq() {
+        return mNextSeq++;
+    }
+
+    QList<Command> runningRequests() const {
+        return mRunningRequests.values();
+    }
+
+    bool hasRunningRequests() const {
+        return !mRunningRequests.isEmpty();
+    }
+
+    // queued or not responded yet
+    bool hasPendingRequests() const {
+        return !mQueue.isEmpty() || !mRunningRequests.isEmpty();
+    }
+
+    // configurations (breakpoints etc.) can be sent after the "initialized" event
+    void setInitialized() {
+        mInitialized = true;
+    }
+
+    bool initialized() const {
+        return mInitialized;
+    }
+
+    void receive(const QByteArray& output) {
+        mReceiveBuffer += output;
+    }
+
+    /**
+     * @brief take the content parts of the complete messages received
+     * @param errors broken headers, they are skipped
+     */
+    QList<QByteArray> takeMessages(QStringList& errors) {
+        QList<QByteArray> contentParts;
+        while (true) {
+            try {
+                QByteArray contentPart;
+                if (!takeDAPMessage(mReceiveBuffer, contentPart))
+                    break;
+                contentParts.append(contentPart);
+            } catch (const DAPMessageError& e) {
+                errors.append(e.reason());
+            }
+        }
+        return contentParts;
+    }
+private:
+    QByteArray mReceiveBuffer; // incomplete message from the adapter
+    QQueue<Command> mQueue;
+    // sent requests waiting for responses, by their sequence numbers
+    QMap<qint64, Command> mRunningRequests;
+    qint64 mNextSeq;
+    bool mInitialized; // the "initialized" event is received
+};
+
+#endif
@@ -16,6 +16,7 @@
  */
 #include "debugger.h"
 #include "gdbmidebugger.h"
+#include "dapdebugger.h"
 #include "../utils.h"
 #include "../utils/pe.h"
 #include "../utils/parsearg.h"
@@ -104,10 +105,15 @@ bool Debugger::startClient(int compilerSetIndex,
     setDebugInfosUsingUTF8(compilerSet->isCompilerUsingUTF8());
     if (compilerSet->debugger().endsWith(LLDB_MI_PROGRAM))
         setDebuggerType(DebuggerType::LLDB_MI);
+    else if (compilerSet->debugger().endsWith(LLDB_DAP_PROGRAM)
+             || compilerSet->debugger().endsWith(LLDB_VSCODE_PROGRAM)
+             || pSettings->debugger().useDebugAdapter())
+        setDebuggerType(DebuggerType::DAP);
     else
         setDebuggerType(DebuggerType::GDB);
     // force to lldb-server if using lldb-mi, which creates new console but does not bind inferior’s stdio to the new console on Windows.
-    setUseDebugServer(pSettings->debugger().useGDBServer() || mDebuggerType == DebuggerType::LLDB_MI);
+    // debug adapters use their stdio for the protocol, so the inferior always runs in the debug server.
+    setUseDebugServer(pSettings->debugger().useGDBServer() || mDebuggerType != DebuggerType::GDB);
     QString debuggerPath = compilerSet->debugger();
     //QFile debuggerProgram(debuggerPath);
 //    if (!isTextAllAscii(debuggerPath)) {
@@ -155,13 +161,18 @@ bool Debugger::startClient(int compilerSetIndex,
         mTarget = new DebugTarget(inferior,compilerSet->debugServer(),pSettings->debugger().GDBServerPort(),params);
         if (pSettings->executor().redirectInput())
             mTarget->setInputFile(pSettings->executor().inputFilename());
+        // lldb-dap attaches to the running inferior, lldb-mi launches it by itself
+        mTarget->setLaunchInferior(mDebuggerType == DebuggerType::DAP);
         mTarget->addBinDirs(binDirs);
         mTarget->addBinDir(pSettings->dirs().appDir());
         mTarget->start();
         mTarget->waitStart();
     }
     //delete when thread finished
-    mClient = new GDBMIDebuggerClient(this, debuggerType());
+    if (mDebuggerType == DebuggerType::DAP)
+        mClient = new DAPDebuggerClient(this);
+    else
+        mClient = new GDBMIDebuggerClient(this, debuggerType());
     mClient->addBinDirs(binDirs);
     mClient->addBinDir(pSettings->dirs().appDir());
     mClient->setDebuggerPath(debuggerPath);
@@ -389,6 +400,11 @@ void Debugger::runClientCommand(const QString &command, const QString &params, D
     QMutexLocker locker{&mClientMutex};
     if (!mClient)
         return;
+    if (mClient->clientType()==DebuggerType::DAP) {
+        DAPDebuggerClient* dapClient = dynamic_cast<DAPDebuggerClient*>(mClient);
+        dapClient->postConsoleCommand(params.isEmpty() ? command : command + " " + params, source);
+        return;
+    }
     if (mClient->clientType()!=DebuggerType::GDB
             && mClient->clientType()!=DebuggerType::LLDB_MI)
         return;
@@ -614,11 +630,12 @@ void Debugger::refreshWatchVars()
     }
 }
 
-void Debugger::fetchVarChildren(const QString &varName)
+void Debugger::fetchVarChildren(const QString &varName, int from)
 {
     QMutexLocker locker{&mClientMutex};
     if (mClient) {
-        mClient->fetchWatchVarChildren(varName);
+        // large arrays and containers are listed page by page
+        mClient->fetchWatchVarChildren(varName, from, pSettings->debugger().arrayElements());
     }
 }
 
@@ -634,7 +651,7 @@ void Debugger::setUseDebugServer(bool newUseDebugServer)
 
 bool Debugger::supportDisassemlyBlendMode()
 {
-    return mDebuggerType == DebuggerType::GDB;
+    return mDebuggerType != DebuggerType::LLDB_MI;
 }
 
 bool Debugger::debugInfosUsingUTF8() const
@@ -1025,10 +1042,10 @@ void Debugger::setWatchVarValue(const QString &name, const QString &value)
     refreshAll();
 }
 
-void Debugger::updateMemory(const QStringList &value)
+void Debugger::updateMemory(qulonglong address, const QByteArray &memory)
 {
-    mMemoryModel->updateMemory(value);
-    emit memoryExamineReady(value);
+    mMemoryModel->updateMemory(address, memory, pSettings->debugger().memoryViewColumns());
+    emit memoryExamineReady(address, memory);
 }
 
 void Debugger::updateEval(const QString &value)
@@ -1163,7 +1180,8 @@ DebugTarget::DebugTarget(
     mPort(port),
     mStop(false),
     mStartSemaphore(0),
-    mErrorOccured(false)
+    mErrorOccured(false),
+    mLaunchInferior(false)
 {
 }
 
@@ -1177,6 +1195,11 @@ void DebugTarget::stopDebug()
     mStop = true;
 }
 
+void DebugTarget::setLaunchInferior(bool launchInferior)
+{
+    mLaunchInferior = launchInferior;
+}
+
 void DebugTarget::waitStart()
 {
     mStartSemaphore.acquire(1);
@@ -1204,7 +1227,15 @@ void DebugTarget::run()
 
     //find first available port
     QStringList execArgs;
-    if (mGDBServer.endsWith(LLDB_SERVER_PROGRAM))
+    if (mGDBServer.endsWith(LLDB_SERVER_PROGRAM) && mLaunchInferior)
+        execArgs = QStringList{
+            mGDBServer,
+            "gdbserver",
+            QString("localhost:%1").arg(mPort),
+            "--",
+            mInferior,
+        } + mArguments;
+    else if (mGDBServer.endsWith(LLDB_SERVER_PROGRAM))
         execArgs = QStringList{
             mGDBServer,
             "gdbserver",
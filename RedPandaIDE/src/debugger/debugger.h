@@ -162,7 +162,7 @@ public:
     bool supportDisassemlyBlendMode();
 signals:
     void evalValueReady(const QString& s);
-    void memoryExamineReady(const QStringList& s);
+    void memoryExamineReady(qulonglong address, const QByteArray& memory);
     void localsReady(const QStringList& s);
     void debugFinished();
 public slots:
@@ -182,14 +182,14 @@ private slots:
     void syncFinishedParsing();
     void setMemoryData(qulonglong address, unsigned char data);
     void setWatchVarValue(const QString& name, const QString& value);
-    void updateMemory(const QStringList& value);
+    void updateMemory(qulonglong address, const QByteArray& memory);
     void updateEval(const QString& value);
     void updateDisassembly(const QString& file, const QString& func,const QStringList& value);
     void onChangeDebugConsoleLastline(const QString& text);
     void cleanUp();
     void updateRegisterNames(const QStringList& registerNames);
     void updateRegisterValues(const QHash<int,QString>& values);
-    void fetchVarChildren(const QString& varName);
+    void fetchVarChildren(const QString& varName, int from);
 private:
     //bool mCommandChanged;
     std::shared_ptr<BreakpointModel> mBreakpointModel;
@@ -220,6 +220,8 @@ public:
                          const QStringList& arguments,
                          QObject *parent = nullptr);
     void setInputFile(const QString& inputFile);
+    // lldb-server starts the inferior only if it's told to
+    void setLaunchInferior(bool launchInferior);
     void stopDebug();
     void waitStart();
     const QStringList &binDirs() const;
@@ -237,6 +239,7 @@ private:
     bool mErrorOccured;
     QString mInputFile;
     QStringList mBinDirs;
+    bool mLaunchInferior;
 
     // QThread interface
 protected:
@@ -308,7 +311,11 @@ public:
     virtual void writeWatchVar(const QString& varName, const QString& value) = 0;
     virtual void refreshWatch(PWatchVar var) = 0;
     virtual void refreshWatch() = 0;
-    virtual void fetchWatchVarChildren(const QString& varName) = 0;
+    /**
+     * @brief list the children of a var
+     * @param count the max number of children to list, 0 for all
+     */
+    virtual void fetchWatchVarChildren(const QString& varName, int from, int count) = 0;
 
     virtual void evalExpression(const QString& expression) = 0;
 
@@ -338,7 +345,7 @@ signals:
     void inferiorStopped(const QString& filename, int line);
     void localsUpdated(const QStringList& localsValue);
     void evalUpdated(const QString& value);
-    void memoryUpdated(const QStringList& memoryValues);
+    void memoryUpdated(qulonglong address, const QByteArray& memory);
     void disassemblyUpdate(const QString& filename, const QString& funcName, const QStringList& result);
     void registerNamesUpdated(const QStringList& registerNames);
     void registerValuesUpdated(const QHash<int,QString>& values);
@@ -348,7 +355,7 @@ signals:
                     const QString& value,
                     const QString& type,
                     bool hasMore);
-    void prepareVarChildren(const QString& parentName,int numChild, bool hasMore);
+    void prepareVarChildren(const QString& parentName,int numChild, bool hasMore, int from);
     void addVarChild(const QString& parentName, const QString& name,
                      const QString& exp, int numChild,
                      const QString& value, const QString& type,
@@ -617,6 +617,7 @@ void WatchModel::resetAllVarInfos()
         var->hasMore = false;
         var->type.clear();
         var->children.clear();
+        var->fetchingChildren = false;
     }
     mVarIndex.clear();
     endResetModel();
@@ -639,17 +640,19 @@ void WatchModel::updateVarInfo(const QString &expression, const QString &name, i
     emit dataChanged(idx,createIndex(idx.row(),2,var.get()));
 }
 
-void WatchModel::prepareVarChildren(const QString &parentName, int numChild, bool hasMore)
+void WatchModel::prepareVarChildren(const QString &parentName, int numChild, bool hasMore, int from)
 {
     PWatchVar var = mVarIndex.value(parentName,PWatchVar());
     if (var) {
-        var->numChild = numChild;
-        var->hasMore = hasMore;
-        if (var->children.count()>0) {
+        var->fetchingChildren = false;
+        if (from==0 && var->children.count()>0) {
             beginRemoveRows(index(var),0,var->children.count()-1);
             var->children.clear();
             endRemoveRows();
         }
+        // numChild is the count of this page, the total is kept
+        var->numChild = std::max(var->numChild, from + numChild);
+        var->hasMore = hasMore;
     }
 }
 
@@ -691,12 +694,18 @@ void WatchModel::updateVarValue(const QString &name, const QString &val, const Q
     QModelIndex idx = index(var);
     bool oldHasMore = var->hasMore;
     var->hasMore = hasMore;
-    if (newNumChildren>=0
-            && var->numChild!=newNumChildren) {
+    // children are fetched again only if they have been expanded
+    if (!var->children.isEmpty() && !var->fetchingChildren) {
+        if (newNumChildren>=0
+                && var->numChild!=newNumChildren) {
+            var->numChild = newNumChildren;
+            var->fetchingChildren = true;
+            emit fetchChildren(var->name, 0);
+        } else  if (!oldHasMore && hasMore) {
+            fetchMoreChildren(idx);
+        }
+    } else if (newNumChildren>=0) {
         var->numChild = newNumChildren;
-        fetchMore(idx);
-    } else  if (!oldHasMore && hasMore) {
-        fetchMore(idx);
     }
     emit dataChanged(idx,createIndex(idx.row(),2,var.get()));
 }
@@ -704,13 +713,32 @@ void WatchModel::updateVarValue(const QString &name, const QString &val, const Q
 void WatchModel::updateAllHasMoreVars()
 {
     foreach (const PWatchVar& var, mVarIndex.values()) {
-        if (var->hasMore) {
+        if (var->hasMore && !var->children.isEmpty()) {
             QModelIndex idx = index(var);
-            fetchMore(idx);
+            fetchMoreChildren(idx);
         }
     }
 }
 
+bool WatchModel::hasMoreChildren(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return false;
+    WatchVar* item = static_cast<WatchVar*>(index.internalPointer());
+    return !item->fetchingChildren
+            && !item->children.isEmpty()
+            && (item->numChild>item->children.count() || item->hasMore);
+}
+
+void WatchModel::fetchMoreChildren(const QModelIndex &index)
+{
+    if (!hasMoreChildren(index))
+        return;
+    WatchVar* item = static_cast<WatchVar*>(index.internalPointer());
+    item->fetchingChildren = true;
+    emit fetchChildren(item->name, item->children.count());
+}
+
 bool WatchModel::isForProject() const
 {
     return mIsForProject;
@@ -741,6 +769,7 @@ void WatchModel::clearAllVarInfos()
         var->hasMore = false;
         var->type.clear();
         var->children.clear();
+        var->fetchingChildren = false;
     }
     mVarIndex.clear();
     endResetModel();
@@ -901,9 +930,10 @@ void WatchModel::fetchMore(const QModelIndex &parent)
         return;
     }
     WatchVar* item = static_cast<WatchVar*>(parent.internalPointer());
-    item->hasMore = false;
-    item->numChild = item->children.count();
-    emit fetchChildren(item->name);
+    if (!canFetchMore(parent))
+        return;
+    item->fetchingChildren = true;
+    emit fetchChildren(item->name, 0);
 }
 
 bool WatchModel::canFetchMore(const QModelIndex &parent) const
@@ -912,7 +942,11 @@ bool WatchModel::canFetchMore(const QModelIndex &parent) const
         return false;
     }
     WatchVar* item = static_cast<WatchVar*>(parent.internalPointer());
-    return item->numChild>item->children.count() || item->hasMore;
+    // the view fetches the first page when the var is expanded,
+    // the rest are fetched on request (see fetchMoreChildren())
+    return !item->fetchingChildren
+            && item->children.isEmpty()
+            && (item->numChild>0 || item->hasMore);
 }
 
 bool WatchModel::hasChildren(const QModelIndex &parent) const
@@ -1177,39 +1211,22 @@ MemoryModel::MemoryModel(int dataPerLine, QObject *parent):
 {
 }
 
-void MemoryModel::updateMemory(const QStringList &value)
+void MemoryModel::updateMemory(qulonglong address, const QByteArray &memory, int dataPerLine)
 {
-    int maxDataPerLine=-1;
-    QRegularExpression delimiter("(\\s+)");
+    if (dataPerLine<=0)
+        dataPerLine = mDataPerLine;
     QList<PMemoryLine> newModel;
-    for (int i=0;i<value.length();i++) {
-        QString line = value[i].trimmed();
-        QStringList dataLst = line.split(delimiter,Qt::SkipEmptyParts);
+    for (int i=0;i<memory.length();i+=dataPerLine) {
         PMemoryLine memoryLine = std::make_shared<MemoryLine>();
-        memoryLine->startAddress = -1;
-        if (dataLst.length()>0) {
-            bool isOk;
-            memoryLine->startAddress = stringToHex(dataLst[0],isOk);
-            if (isOk)  {
-                if (dataLst.length()-1>maxDataPerLine)
-                     maxDataPerLine = dataLst.length()-1;
-                for (int j=1;j<dataLst.length();j++) {
-                    qulonglong data = stringToHex(dataLst[j],isOk);
-                    if (isOk)
-                        memoryLine->datas.append((unsigned char)data);
-                    else
-                        memoryLine->datas.append(0);
-                }
-            } else {
-                memoryLine->startAddress=0;
-            }
-
-        }
+        memoryLine->startAddress = address + i;
+        int count = std::min(dataPerLine, (int)memory.length()-i);
+        for (int j=0;j<count;j++)
+            memoryLine->datas.append((unsigned char)memory[i+j]);
         newModel.append(memoryLine);
     }
     if (newModel.count()>0 && newModel.count()== mLines.count() &&
             newModel[0]->startAddress == mLines[0]->startAddress &&
-            maxDataPerLine==mDataPerLine) {
+            dataPerLine==mDataPerLine) {
         for (int i=0;i<newModel.count();i++) {
             PMemoryLine newLine = newModel[i];
             PMemoryLine oldLine = mLines[i];
@@ -1225,8 +1242,7 @@ void MemoryModel::updateMemory(const QStringList &value)
                          createIndex(mLines.count()-1,mDataPerLine-1));
     } else {
         beginResetModel();
-        if (maxDataPerLine>0)
-            mDataPerLine=maxDataPerLine;
+        mDataPerLine=dataPerLine;
         mLines = newModel;
         endResetModel();
     }
@@ -1235,7 +1251,7 @@ void MemoryModel::updateMemory(const QStringList &value)
     } else {
         mStartAddress = 0;
     }
- }
+}
 
 int MemoryModel::rowCount(const QModelIndex &/*parent*/) const
 {
@@ -45,6 +45,7 @@ struct WatchVar {
     QList<PWatchVar> children;
     std::weak_ptr<WatchVar> parent; //use raw point to prevent circular-reference
     qint64 timestamp;
+    bool fetchingChildren = false; // waiting for a page of children
 };
 
 enum class BreakpointType {
@@ -195,7 +196,7 @@ public  slots:
                     const QString& value,
                     const QString& type,
                     bool hasMore);
-    void prepareVarChildren(const QString& parentName, int numChild, bool hasMore);
+    void prepareVarChildren(const QString& parentName, int numChild, bool hasMore, int from);
     void addVarChild(const QString& parentName, const QString& name,
                      const QString& exp, int numChild,
                      const QString& value, const QString& type,
@@ -205,8 +206,15 @@ public  slots:
                          const QString& newType, int newNumChildren,
                          bool hasMore);
     void updateAllHasMoreVars();
+    /**
+     * @brief check if more children can be fetched for an expanded var
+     *
+     * Only the first page of children is fetched when a var is expanded.
+     */
+    bool hasMoreChildren(const QModelIndex& index) const;
+    void fetchMoreChildren(const QModelIndex& index);
 signals:
-    void fetchChildren(const QString& name);
+    void fetchChildren(const QString& name, int from);
 private:
     bool isForProject() const;
     void setIsForProject(bool newIsForProject);
@@ -247,7 +255,7 @@ class MemoryModel: public QAbstractTableModel{
 public:
     explicit MemoryModel(int dataPerLine,QObject* parent=nullptr);
 
-    void updateMemory(const QStringList& value);
+    void updateMemory(qulonglong address, const QByteArray& memory, int dataPerLine);
     qulonglong startAddress() const;
     void reset();
     // QAbstractItemModel interface
@@ -21,6 +21,7 @@
 #include "../systemconsts.h"
 #include "../settings.h"
 
+#include <QEventLoop>
 #include <QFileInfo>
 
 
@@ -35,12 +36,18 @@ GDBMIDebuggerClient::GDBMIDebuggerClient(
 {
     mProcess = std::make_shared<QProcess>();
     mAsyncUpdated = false;
+    mNextToken = 1;
+    mMemoryViewAddress = 0;
+    mMemoryViewSize = 0;
     registerInferiorStoppedCommand("-stack-list-frames","");
 }
 
-void GDBMIDebuggerClient::postCommand(const QString &command, const QString &params,
+PGDBMICommand GDBMIDebuggerClient::postCommand(const QString &command, const QString &params,
                                DebugCommandSource source)
 {
+    // the user may change anything in the console
+    if (source == DebugCommandSource::Console)
+        invalidateMemoryCache();
     QMutexLocker locker(&mCmdQueueMutex);
     PGDBMICommand pCmd;
     if (source == DebugCommandSource::Console) {
@@ -48,7 +55,8 @@ void GDBMIDebuggerClient::postCommand(const QString &command, const QString &par
             if (mLastConsoleCmd) {
                 pCmd = mLastConsoleCmd;
                 mCmdQueue.enqueue(pCmd);
-                return;
+                emit wakeUpRequested();
+                return pCmd;
             }
         }
     }
@@ -59,9 +67,8 @@ void GDBMIDebuggerClient::postCommand(const QString &command, const QString &par
     pCmd->params = params;
     pCmd->source = source;
     mCmdQueue.enqueue(pCmd);
-
-//    if (!mCmdRunning)
-    //        runNextCmd();
+    emit wakeUpRequested();
+    return pCmd;
 }
 
 void GDBMIDebuggerClient::registerInferiorStoppedCommand(const QString &command, const QString &params)
@@ -77,6 +84,7 @@ void GDBMIDebuggerClient::registerInferiorStoppedCommand(const QString &command,
 void GDBMIDebuggerClient::stopDebug()
 {
     mStop = true;
+    emit wakeUpRequested();
 }
 
 DebuggerType GDBMIDebuggerClient::clientType()
@@ -120,79 +128,187 @@ void GDBMIDebuggerClient::run()
 
     mProcess->setWorkingDirectory(workingDir);
 
+    // the client thread sleeps in the event loop until gdb writes something,
+    // a command is posted or the debugging is stopped
+    QEventLoop loop;
     connect(mProcess.get(), &QProcess::errorOccurred,
-                    [&](){
-                        errorOccured= true;
-                    });
-    QByteArray buffer;
-    QByteArray readed;
+            &loop, [&](){
+        errorOccured= true;
+        loop.quit();
+    });
+    connect(mProcess.get(), QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            &loop, &QEventLoop::quit);
+    connect(mProcess.get(), &QProcess::readyRead,
+            &loop, [this](){
+        receiveOutput();
+    });
+    // always queued, so commands posted while parsing are sent after it
+    connect(this, &GDBMIDebuggerClient::wakeUpRequested,
+            &loop, [this, &loop](){
+        if (mStop) {
+            quitDebugger();
+            loop.quit();
+        } else {
+            runNextCmd();
+        }
+    }, Qt::QueuedConnection);
+    mReceiveBuffer.clear();
+    mRunningCmds.clear();
+    mNextToken = 1;
 
     mProcess->start();
     mProcess->waitForStarted(5000);
     mStartSemaphore.release(1);
-    while (true) {
-        mProcess->waitForFinished(1);
-        if (mProcess->state()!=QProcess::Running) {
-            break;
-        }
-        if (mStop) {
-            mProcess->readAll();
-            mProcess->write("-gdb-exit\n");
-            msleep(50);
-            mProcess->readAll();
-            msleep(50);
-            mProcess->terminate();
-            mProcess->kill();
-            break;
-        }
-        if (errorOccured)
-            break;
-        readed = mProcess->readAll();
-        buffer += readed;
-
-        if (readed.endsWith("\n")) {
-            processDebugOutput(buffer);
-            buffer.clear();
-            // mCmdRunning = false;
-            // runNextCmd();
-        } else if (!mCmdRunning && readed.isEmpty()){
-            runNextCmd();
-        } else if (readed.isEmpty()){
-            msleep(1);
-        }
+    if (mStop) {
+        quitDebugger();
+    } else if (!errorOccured && mProcess->state()==QProcess::Running) {
+        // send commands posted before the loop is running
+        runNextCmd();
+        loop.exec();
     }
     if (errorOccured) {
         emit processFailed(mProcess->error());
     }
 }
+
+void GDBMIDebuggerClient::receiveOutput()
+{
+    mReceiveBuffer += mProcess->readAll();
+    // only complete lines are parsed
+    int pos = mReceiveBuffer.lastIndexOf('\n');
+    if (pos < 0)
+        return;
+    QByteArray output = mReceiveBuffer.left(pos + 1);
+    mReceiveBuffer.remove(0, pos + 1);
+    processDebugOutput(output);
+    runNextCmd();
+}
+
+void GDBMIDebuggerClient::quitDebugger()
+{
+    if (mProcess->state()!=QProcess::Running)
+        return;
+    // the remaining output is not wanted
+    mProcess->blockSignals(true);
+    mProcess->readAll();
+    mProcess->write("-gdb-exit\n");
+    mProcess->waitForBytesWritten(50);
+    if (!mProcess->waitForFinished(100)) {
+        mProcess->terminate();
+        mProcess->kill();
+    }
+}
+
 void GDBMIDebuggerClient::runNextCmd()
 {
     QMutexLocker locker(&mCmdQueueMutex);
 
-    if (mCurrentCmd) {
-        DebugCommandSource commandSource = mCurrentCmd->source;
-        mCurrentCmd=nullptr;
-        if (commandSource!=DebugCommandSource::HeartBeat)
-            emit cmdFinished();
-    }
     if (mCmdQueue.isEmpty()) {
-        if (debugger()->useDebugServer() && mInferiorRunning && !mAsyncUpdated) {
+        if (mRunningCmds.isEmpty() && debugger()->useDebugServer() && mInferiorRunning && !mAsyncUpdated) {
             mAsyncUpdated = true;
             //We must force refresh the running state response from the lldb-server....
             QTimer::singleShot(500,this,&GDBMIDebuggerClient::asyncUpdate);
         }
         return;
     }
+    // queries are sent without waiting for the results of the previous ones,
+    // their results are matched by tokens.
+    while (!mCmdQueue.isEmpty()) {
+        if (!mRunningCmds.isEmpty()) {
+            if (mRunningCmds.count() >= MaxPipelinedCmds
+                    || !canPipeline(mCmdQueue.head())
+                    || !canPipeline(mRunningCmds.first()))
+                break;
+        }
+        PGDBMICommand cmd = mCmdQueue.dequeue();
+        if (disassembleFromCache(cmd))
+            continue;
+        sendCommand(cmd);
+    }
+}
+
+bool GDBMIDebuggerClient::canPipeline(const PGDBMICommand &cmd) const
+{
+    // commands that only read the state of the stopped inferior.
+    // cli commands are not pipelined, their results are in the console output.
+    static const QSet<QString> queryCommands{
+        "-stack-list-frames",
+        "-stack-list-variables",
+        "-stack-info-frame",
+        "-stack-info-depth",
+        "-var-create",
+        "-var-update",
+        "-var-list-children",
+        "-var-evaluate-expression",
+        "-data-evaluate-expression",
+        "-data-read-memory",
+        "-data-list-register-names",
+        "-data-list-register-values",
+        "-data-disassemble",
+        "-gdb-show",
+    };
+    // lldb-mi is not known to handle it well
+    return clientType() == DebuggerType::GDB
+            && cmd->source != DebugCommandSource::Console
+            && queryCommands.contains(cmd->command);
+}
+
+bool GDBMIDebuggerClient::disassembleFromCache(const PGDBMICommand &cmd)
+{
+    // lldb uses other formats
+    if (cmd->command != "disas"
+            || cmd->source == DebugCommandSource::Console
+            || clientType() != DebuggerType::GDB
+            || mCurrentAddress == 0)
+        return false;
+    // all the previous commands are finished, so mCurrentAddress is up to date
+    QStringList lines;
+    if (!mDisassemblyCache.find(disassemblyCacheKey(cmd.get()), mCurrentAddress, lines))
+        return false;
+    emit disassemblyUpdate(mCurrentFile, mCurrentFunc, lines);
+    return true;
+}
 
-    PGDBMICommand pCmd = mCmdQueue.dequeue();
+QString GDBMIDebuggerClient::disassemblyCacheKey(const GDBMICommand *cmd) const
+{
+    return mDisassemblyFlavor + " " + cmd->params;
+}
+
+PGDBMICommand GDBMIDebuggerClient::takeRunningCmd(int token)
+{
+    QMutexLocker locker(&mCmdQueueMutex);
+    if (token >= 0 && mRunningCmds.contains(token))
+        return mRunningCmds.take(token);
+    // result without a known token, it's for the oldest one
+    if (!mRunningCmds.isEmpty())
+        return mRunningCmds.take(mRunningCmds.firstKey());
+    return PGDBMICommand();
+}
+
+void GDBMIDebuggerClient::sendCommand(const PGDBMICommand &pCmd)
+{
+    int token = mNextToken++;
+    mRunningCmds.insert(token, pCmd);
     mCmdRunning = true;
-    mCurrentCmd = pCmd;
     if (pCmd->source!=DebugCommandSource::HeartBeat)
         emit cmdStarted();
 
+    if (pCmd->command == "-gdb-set" && pCmd->params.startsWith("disassembly-flavor")) {
+        mDisassemblyFlavor = pCmd->params;
+    } else if (pCmd->command == "-data-write-memory-bytes") {
+        bool ok;
+        qulonglong address = pCmd->params.section(' ',0,0).toULongLong(&ok, 0);
+        // the contents are hex digits, two per byte
+        QString contents = pCmd->params.section(' ',1,1).remove('"');
+        if (ok)
+            mDisassemblyCache.invalidate(address, contents.length() / 2);
+    } else if (pCmd->source == DebugCommandSource::Console) {
+        mDisassemblyCache.clear();
+    }
+
     QByteArray s;
     QByteArray params;
-    s=pCmd->command.toLocal8Bit();
+    s=QByteArray::number(token) + pCmd->command.toLocal8Bit();
     if (!pCmd->params.isEmpty()) {
         params = pCmd->params.toLocal8Bit();
     }
@@ -215,8 +331,7 @@ void GDBMIDebuggerClient::runNextCmd()
         else
             params = " - @ "+params;
     } else if (pCmd->command == "-var-list-children") {
-        //hack for list variable children,to easy remember var expression
-        params = " --all-values \"" + params+'\"';
+        params = " --all-values " + params;
     }
     s+=" "+params;
     s+= "\n";
@@ -381,19 +496,41 @@ void GDBMIDebuggerClient::handleStack(const QList<GDBMIResultParser::ParseValue>
 
 void GDBMIDebuggerClient::handleLocalVariables(const QList<GDBMIResultParser::ParseValue> &variables)
 {
-    QStringList locals;
+    mLocals.clear();
+    mLocalEvaluations.clear();
     foreach (const GDBMIResultParser::ParseValue& varValue, variables) {
         GDBMIResultParser::ParseObject varObject = varValue.object();
         QString name = QString(varObject["name"].value());
-        QString value = QString(varObject["value"].value());
-        locals.append(
-                    QString("%1 = %2")
-                    .arg(
-                        name,
-                        value
-                ));
+        if (varObject["value"].isValid()) {
+            QString value = QString(varObject["value"].value());
+            mLocals.append(
+                        QString("%1 = %2")
+                        .arg(
+                            name,
+                            value
+                    ));
+        } else {
+            // values of arrays, structs and classes are not listed by --simple-values,
+            // the first ones are evaluated one by one (limited by "print elements")
+            mLocals.append(QString("%1 = {...}").arg(name));
+            if (mLocalEvaluations.count() < MaxEvaluatedLocals) {
+                PGDBMICommand cmd = postCommand("-data-evaluate-expression", name);
+                mLocalEvaluations.insert(cmd.get(), mLocals.count()-1);
+            }
+        }
     }
-    emit localsUpdated(locals);
+    emit localsUpdated(mLocals);
+}
+
+void GDBMIDebuggerClient::handleLocalValue(const GDBMICommand *cmd, const QString &value, bool ok)
+{
+    if (!mLocalEvaluations.contains(cmd))
+        return;
+    int index = mLocalEvaluations.take(cmd);
+    if (ok)
+        mLocals[index] = QString("%1 = %2").arg(cmd->params, value);
+    if (mLocalEvaluations.isEmpty())
+        emit localsUpdated(mLocals);
 }
 
 void GDBMIDebuggerClient::handleEvaluation(const QString &value)
@@ -403,52 +540,68 @@ void GDBMIDebuggerClient::handleEvaluation(const QString &value)
 
 void GDBMIDebuggerClient::handleMemory(const QList<GDBMIResultParser::ParseValue> &rows)
 {
-    QStringList memory;
+    QByteArray memory;
+    qulonglong startAddr = 0;
     foreach (const GDBMIResultParser::ParseValue& row, rows) {
         GDBMIResultParser::ParseObject rowObject = row.object();
+        if (memory.isEmpty()) {
+            bool ok;
+            startAddr = rowObject["addr"].hexValue(ok);
+        }
         QList<GDBMIResultParser::ParseValue> data = rowObject["data"].array();
-        QStringList values;
         foreach (const GDBMIResultParser::ParseValue& val, data) {
-            values.append(val.value());
+            bool ok;
+            memory.append((char)val.hexValue(ok));
         }
-        memory.append(QString("%1 %2")
-                            .arg(rowObject["addr"].value(),values.join(" ")));
     }
-    emit memoryUpdated(memory);
+    if (!memory.isEmpty())
+        emit memoryUpdated(startAddr, memory);
 }
 
 void GDBMIDebuggerClient::handleMemoryBytes(const QList<GDBMIResultParser::ParseValue> &rows)
 {
-    QStringList memory;
-    foreach (const GDBMIResultParser::ParseValue& row, rows) {
-        GDBMIResultParser::ParseObject rowObject = row.object();
-        bool ok;
-        qulonglong startAddr = rowObject["begin"].value().toLongLong(&ok, 16);
-        qulonglong endAddr = rowObject["end"].value().toLongLong(&ok, 16);
-        qulonglong offset = rowObject["offset"].value().toLongLong(&ok, 16);
-        startAddr += offset;
-        QByteArray contents = rowObject["contents"].value();
-        qulonglong addr = startAddr;
-        QStringList values;
-        int cols = pSettings->debugger().memoryViewColumns();
-        while (addr<endAddr) {
-            values.append("0x"+contents.mid((addr-startAddr)*2,2));
-            if ((addr-startAddr+1)%cols == 0) {
-                memory.append(QString("%1 %2").arg(
-                                  QString("0x%1").arg(addr - cols + 1 ,0,16),
-                                  values.join(" ")));
-                values.clear();
-            }
-            addr++;
-        }
-        if (!values.isEmpty()) {
-            memory.append(QString("%1 %2").arg(
-                              QString("0x%1").arg(addr - values.length() + 1 ,0,16),
-                              values.join(" ")));
-            values.clear();
+    {
+        QMutexLocker locker(&mMemoryMutex);
+        foreach (const GDBMIResultParser::ParseValue& row, rows) {
+            GDBMIResultParser::ParseObject rowObject = row.object();
+            bool ok;
+            qulonglong startAddr = rowObject["begin"].hexValue(ok);
+            if (!ok)
+                continue;
+            qulonglong offset = rowObject["offset"].hexValue(ok);
+            if (ok)
+                startAddr += offset;
+            // the memory view of an expression starts where it's evaluated to
+            if (mMemoryViewAddress == 0 && mMemoryViewReads.contains(mCurrentCmd.get()))
+                mMemoryViewAddress = startAddr;
+            mMemoryCache.insert(startAddr, QByteArray::fromHex(rowObject["contents"].value()));
         }
     }
-    emit memoryUpdated(memory);
+    memoryReadFinished(mCurrentCmd.get());
+}
+
+void GDBMIDebuggerClient::memoryReadFinished(const GDBMICommand *cmd)
+{
+    qulonglong address;
+    QByteArray memory;
+    {
+        QMutexLocker locker(&mMemoryMutex);
+        if (!mMemoryViewReads.remove(cmd) || !mMemoryViewReads.isEmpty())
+            return;
+        address = mMemoryViewAddress;
+        if (address == 0)
+            return;
+        memory = mMemoryCache.read(address, mMemoryViewSize);
+    }
+    // unreadable bytes are not shown
+    if (!memory.isEmpty())
+        emit memoryUpdated(address, memory);
+}
+
+void GDBMIDebuggerClient::invalidateMemoryCache()
+{
+    QMutexLocker locker(&mMemoryMutex);
+    mMemoryCache.clear();
 }
 
 void GDBMIDebuggerClient::handleRegisterNames(const QList<GDBMIResultParser::ParseValue> &names)
@@ -488,11 +641,13 @@ void GDBMIDebuggerClient::handleListVarChildren(const GDBMIResultParser::ParseOb
 {
     if (!mCurrentCmd)
         return;
-    QString parentName = mCurrentCmd->params;
+    QString parentName;
+    int from;
+    parseVarChildrenParams(mCurrentCmd->params, parentName, from);
     int parentNumChild = multiVars["numchild"].intValue(0);
     QList<GDBMIResultParser::ParseValue> children = multiVars["children"].array();
     bool hasMore = multiVars["has_more"].value()!="0";
-    emit prepareVarChildren(parentName,parentNumChild,hasMore);
+    emit prepareVarChildren(parentName,parentNumChild,hasMore,from);
     foreach(const GDBMIResultParser::ParseValue& child, children) {
         GDBMIResultParser::ParseObject childObj = child.object();
         QString name = childObj["name"].value();
@@ -670,12 +825,11 @@ void GDBMIDebuggerClient::processLogOutput(const QByteArray &line)
 
 void GDBMIDebuggerClient::processResult(const QByteArray &result)
 {
-    GDBMIResultParser parser;
     GDBMIResultType resultType;
     GDBMIResultParser::ParseObject multiValues;
     if (!mCurrentCmd)
         return;
-    bool parseOk = parser.parse(result, mCurrentCmd->command, resultType,multiValues);
+    bool parseOk = mResultParser.parse(result, mCurrentCmd->command, resultType,multiValues);
     if (!parseOk)
         return;
     switch(resultType) {
@@ -695,7 +849,10 @@ void GDBMIDebuggerClient::processResult(const QByteArray &result)
         handleLocalVariables(multiValues["variables"].array());
         break;
     case GDBMIResultType::Evaluation:
-        handleEvaluation(multiValues["value"].value());
+        if (mLocalEvaluations.contains(mCurrentCmd.get()))
+            handleLocalValue(mCurrentCmd.get(), multiValues["value"].value(), true);
+        else
+            handleEvaluation(multiValues["value"].value());
         break;
     case GDBMIResultType::Memory:
         handleMemory(multiValues["memory"].array());
@@ -730,11 +887,11 @@ void GDBMIDebuggerClient::processExecAsyncRecord(const QByteArray &line)
 {
     QByteArray result;
     GDBMIResultParser::ParseObject multiValues;
-    GDBMIResultParser parser;
-    if (!parser.parseAsyncResult(line,result,multiValues))
+    if (!mResultParser.parseAsyncResult(line,result,multiValues))
         return;
     if (result == "running") {
         mInferiorRunning = true;
+        invalidateMemoryCache();
         mCurrentAddress=0;
         mCurrentFile.clear();
         mCurrentLine=-1;
@@ -809,11 +966,24 @@ void GDBMIDebuggerClient::processError(const QByteArray &errorLine)
     }
 }
 
-void GDBMIDebuggerClient::processResultRecord(const QByteArray &line)
+void GDBMIDebuggerClient::processResultRecord(const QByteArray &line, int token)
 {
-    auto action = finally([this]() {
+    PGDBMICommand cmd = takeRunningCmd(token);
+    mCurrentCmd = cmd;
+    auto action = finally([this, cmd]() {
+        mCurrentCmd = nullptr;
         if (!mProcessExited) {
-            mCmdRunning = false;
+            QMutexLocker locker(&mCmdQueueMutex);
+            mCmdRunning = !mRunningCmds.isEmpty();
+            if (cmd && cmd->source!=DebugCommandSource::HeartBeat) {
+                bool userCmdRunning = false;
+                foreach (const PGDBMICommand& runningCmd, mRunningCmds) {
+                    if (runningCmd->source!=DebugCommandSource::HeartBeat)
+                        userCmdRunning = true;
+                }
+                if (!userCmdRunning)
+                    emit cmdFinished();
+            }
             runNextCmd();
         }
     });
@@ -823,6 +993,10 @@ void GDBMIDebuggerClient::processResultRecord(const QByteArray &line)
         return;
     }
     if (line.startsWith("^error")) {
+        if (cmd) {
+            handleLocalValue(cmd.get(), QString(), false);
+            memoryReadFinished(cmd.get());
+        }
         processError(line);
         return;
     }
@@ -833,7 +1007,7 @@ void GDBMIDebuggerClient::processResultRecord(const QByteArray &line)
         }
         int pos = line.indexOf(',');
         if (pos>=0) {
-            QByteArray result = line.mid(pos+1);
+            QByteArray result = QByteArray::fromRawData(line.constData()+pos+1, line.length()-pos-1);
             processResult(result);
         } else if (mCurrentCmd && !(mCurrentCmd->command.startsWith('-'))) {
             if (mCurrentCmd->command == "disas" && mCurrentCmd->source != DebugCommandSource::Console) {
@@ -876,6 +1050,8 @@ void GDBMIDebuggerClient::processResultRecord(const QByteArray &line)
                     disOutput=newOutput;
                 }
                 mConsoleOutput.clear();
+                if (clientType() == DebuggerType::GDB)
+                    mDisassemblyCache.insert(disassemblyCacheKey(mCurrentCmd.get()), disOutput);
                 emit disassemblyUpdate(mCurrentFile,mCurrentFunc, disOutput);
             }
         }
@@ -900,13 +1076,22 @@ void GDBMIDebuggerClient::processDebugOutput(const QByteArray& debugOutput)
     mSignalReceived = false;
     mUpdateCPUInfo = false;
     mReceivedSFWarning = false;
-    QList<QByteArray> lines = splitByteArrayToLines(debugOutput);
-
-    for (int i=0;i<lines.count();i++) {
-         QByteArray line = lines[i];
+    const char* p = debugOutput.constData();
+    const char* end = p + debugOutput.length();
+    while (p<end) {
+         const char* lineStart = p;
+         while (p<end && *p!='\r' && *p!='\n')
+             p++;
+         // lines (and the parse results) are views into debugOutput
+         QByteArray line = QByteArray::fromRawData(lineStart, p-lineStart);
+         if (p<end && *p=='\r')
+             p++;
+         if (p<end && *p=='\n')
+             p++;
          if (pSettings->debugger().showDetailLog())
             mFullOutput.append(line);
-         line = removeToken(line);
+         int token;
+         line = removeToken(line, token);
          if (line.isEmpty()) {
              continue;
          }
@@ -920,13 +1105,17 @@ void GDBMIDebuggerClient::processDebugOutput(const QByteArray& debugOutput)
              processLogOutput(line);
              break;
          case '^': // result record
-             processResultRecord(line);
+             processResultRecord(line, token);
              break;
          case '*': // exec async output
              processExecAsyncRecord(line);
              break;
          case '+': // status async output
+             break;
          case '=': // notify async output
+             // its code may be replaced by another library
+             if (line.startsWith("=library-unloaded"))
+                 mDisassemblyCache.clear();
              break;
          case '(': // Prompt (gdb)
 //             if (line.startsWith("(gdb)"))
@@ -940,9 +1129,10 @@ void GDBMIDebuggerClient::processDebugOutput(const QByteArray& debugOutput)
 }
 
 
-QByteArray GDBMIDebuggerClient::removeToken(const QByteArray &line) const
+QByteArray GDBMIDebuggerClient::removeToken(const QByteArray &line, int &token) const
 {
     int p=0;
+    token = -1;
     while (p<line.length()) {
         QChar ch=line[p];
         if (ch<'0' || ch>'9') {
@@ -950,8 +1140,13 @@ QByteArray GDBMIDebuggerClient::removeToken(const QByteArray &line) const
         }
         p++;
     }
-    if (p<line.length())
-        return line.mid(p);
+    if (p<line.length()) {
+        if (p>0) {
+            token = line.left(p).toInt();
+            return QByteArray::fromRawData(line.constData()+p, line.length()-p);
+        }
+        return line;
+    }
     return line;
 }
 
@@ -1076,7 +1271,8 @@ void GDBMIDebuggerClient::interrupt()
 
 void GDBMIDebuggerClient::refreshStackVariables()
 {
-    postCommand("-stack-list-variables", "--all-values");
+    // values of compound types are evaluated later, see handleLocalVariables()
+    postCommand("-stack-list-variables", "--simple-values");
 }
 
 void GDBMIDebuggerClient::readMemory(const QString& startAddress, int rows, int cols)
@@ -1085,13 +1281,41 @@ void GDBMIDebuggerClient::readMemory(const QString& startAddress, int rows, int
     //             .arg(startAddress)
     //             .arg(rows)
     //             .arg(cols));
-    postCommand("-data-read-memory-bytes",QString("%1 %2")
-                .arg(startAddress)
-                .arg(rows * cols));
+    int size = rows * cols;
+    bool ok;
+    qulonglong address = startAddress.toULongLong(&ok, 0);
+    QMutexLocker locker(&mMemoryMutex);
+    mMemoryViewSize = size;
+    mMemoryViewReads.clear();
+    if (!ok || address == 0) {
+        // an expression, it's evaluated by gdb
+        mMemoryViewAddress = 0;
+        PGDBMICommand cmd = postCommand("-data-read-memory-bytes",QString("%1 %2")
+                                        .arg(startAddress)
+                                        .arg(size));
+        mMemoryViewReads.insert(cmd.get());
+        return;
+    }
+    mMemoryViewAddress = address;
+    // only read what's not cached
+    QList<AddressRange> ranges = mMemoryCache.missingRanges(address, size);
+    if (ranges.isEmpty()) {
+        QByteArray memory = mMemoryCache.read(address, size);
+        locker.unlock();
+        emit memoryUpdated(address, memory);
+        return;
+    }
+    foreach (const AddressRange& range, ranges) {
+        PGDBMICommand cmd = postCommand("-data-read-memory-bytes",QString("0x%1 %2")
+                                        .arg(range.first,0,16)
+                                        .arg(range.second));
+        mMemoryViewReads.insert(cmd.get());
+    }
 }
 
 void GDBMIDebuggerClient::writeMemory(qulonglong address, unsigned char data)
 {
+    invalidateMemoryCache();
     postCommand("-data-write-memory-bytes", QString("%1 \"%2\"").arg(address).arg(data,2,16,QChar('0')));
 }
 
@@ -1155,6 +1379,7 @@ void GDBMIDebuggerClient::removeWatch(PWatchVar watchVar)
 
 void GDBMIDebuggerClient::writeWatchVar(const QString &varName, const QString &value)
 {
+    invalidateMemoryCache();
     postCommand("-var-assign",QString("%1 %2").arg(varName, value));
 }
 
@@ -1176,13 +1401,29 @@ void GDBMIDebuggerClient::refreshWatch()
     postCommand("-var-update"," --all-values *");
 }
 
-void GDBMIDebuggerClient::fetchWatchVarChildren(const QString& varName)
+void GDBMIDebuggerClient::fetchWatchVarChildren(const QString& varName, int from, int count)
+{
+    // the name is quoted, so it can be found by parseVarChildrenParams()
+    if (count>0)
+        postCommand("-var-list-children", QString("\"%1\" %2 %3").arg(varName).arg(from).arg(from+count));
+    else
+        postCommand("-var-list-children", QString("\"%1\"").arg(varName));
+}
+
+void GDBMIDebuggerClient::parseVarChildrenParams(const QString &params, QString &varName, int &from)
 {
-    postCommand("-var-list-children", varName);
+    int pos = params.lastIndexOf('"');
+    varName = params.mid(1, pos-1);
+    from = 0;
+    QStringList range = params.mid(pos+1).split(' ', Qt::SkipEmptyParts);
+    if (range.count()==2)
+        from = range[0].toInt();
 }
 
 void GDBMIDebuggerClient::evalExpression(const QString &expression)
 {
+    // it may have side effects
+    invalidateMemoryCache();
     QString escaped;
     foreach(const QChar& ch, expression) {
         if (ch.unicode()<32) {
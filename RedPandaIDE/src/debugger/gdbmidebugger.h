@@ -18,6 +18,7 @@
 #define GDBMI_DEBUGGER_H
 
 #include "debugger.h"
+#include "addressrangecache.h"
 #include <QProcess>
 #include <QByteArray>
 #include <QList>
@@ -44,7 +45,7 @@ public:
 
     // DebuggerClient interface
 public:
-    void postCommand(const QString &command, const QString &params, DebugCommandSource source = DebugCommandSource::Other);
+    PGDBMICommand postCommand(const QString &command, const QString &params, DebugCommandSource source = DebugCommandSource::Other);
 
     void stopDebug() override;
     DebuggerType clientType() override;
@@ -78,7 +79,7 @@ public:
     void writeWatchVar(const QString& varName, const QString& value) override;
     void refreshWatch(PWatchVar var) override;
     void refreshWatch() override;
-    void fetchWatchVarChildren(const QString& varName) override;
+    void fetchWatchVarChildren(const QString& varName, int from, int count) override;
 
     void evalExpression(const QString& expression) override;
 
@@ -96,7 +97,16 @@ public:
 protected:
     void run() override;
     void runNextCmd();
+    void sendCommand(const PGDBMICommand& pCmd);
+    bool canPipeline(const PGDBMICommand& cmd) const;
+    PGDBMICommand takeRunningCmd(int token);
+    bool disassembleFromCache(const PGDBMICommand& cmd);
+    QString disassemblyCacheKey(const GDBMICommand* cmd) const;
+signals:
+    void wakeUpRequested();
 private:
+    void receiveOutput();
+    void quitDebugger();
     QStringList tokenize(const QString& s) const;
     //bool outputTerminated(const QByteArray& text) const;
     void handleBreakpoint(const GDBMIResultParser::ParseObject& breakpoint);
@@ -104,9 +114,13 @@ private:
     void handleFrame(const GDBMIResultParser::ParseValue &frame);
     void handleStack(const QList<GDBMIResultParser::ParseValue> & stack);
     void handleLocalVariables(const QList<GDBMIResultParser::ParseValue> & variables);
+    void handleLocalValue(const GDBMICommand* cmd, const QString& value, bool ok);
+    static void parseVarChildrenParams(const QString& params, QString& varName, int& from);
     void handleEvaluation(const QString& value);
     void handleMemory(const QList<GDBMIResultParser::ParseValue> & rows);
     void handleMemoryBytes(const QList<GDBMIResultParser::ParseValue> & rows);
+    void memoryReadFinished(const GDBMICommand* cmd);
+    void invalidateMemoryCache();
     void handleRegisterNames(const QList<GDBMIResultParser::ParseValue> & names);
     void handleRegisterValue(const QList<GDBMIResultParser::ParseValue> & values, bool hexValue);
     void handleListVarChildren(const GDBMIResultParser::ParseObject& multiVars);
@@ -117,9 +131,9 @@ private:
     void processResult(const QByteArray& result);
     void processExecAsyncRecord(const QByteArray& line);
     void processError(const QByteArray& errorLine);
-    void processResultRecord(const QByteArray& line);
+    void processResultRecord(const QByteArray& line, int token);
     void processDebugOutput(const QByteArray& debugOutput);
-    QByteArray removeToken(const QByteArray& line) const;
+    QByteArray removeToken(const QByteArray& line, int& token) const;
     void runInferiorStoppedHook();
     void clearCmdQueue();
     void registerInferiorStoppedCommand(const QString &command, const QString &params);
@@ -128,6 +142,8 @@ private slots:
 private:
     bool mStop;
     std::shared_ptr<QProcess> mProcess;
+    QByteArray mReceiveBuffer; // incomplete line from gdb
+    GDBMIResultParser mResultParser; // reused for each record
     QMap<QString,QStringList> mFileCache;
     int mCurrentLine;
     qulonglong mCurrentAddress;
@@ -139,10 +155,29 @@ private:
     static const QRegularExpression REGdbSourceLine;
 
     QQueue<PGDBMICommand> mCmdQueue;
-    PGDBMICommand mCurrentCmd;
+    // sent commands waiting for results, by their tokens
+    QMap<int, PGDBMICommand> mRunningCmds;
+    int mNextToken;
+    static constexpr int MaxPipelinedCmds = 8;
+    PGDBMICommand mCurrentCmd; // the command whose result is being processed
+    QStringList mLocals;
+    // evaluations of compound locals, to their lines in mLocals
+    QHash<const GDBMICommand*, int> mLocalEvaluations;
+    // the locals panel can't expand values, only the first ones are evaluated
+    static constexpr int MaxEvaluatedLocals = 32;
     PGDBMICommand mLastConsoleCmd;
     QList<PGDBMICommand> mInferiorStoppedHookCommands;
 
+    // memory cache and view are also used by the main thread
+    QMutex mMemoryMutex;
+    MemoryCache mMemoryCache;
+    qulonglong mMemoryViewAddress; // 0 if not known until the result arrives
+    int mMemoryViewSize;
+    // reads the memory view is waiting for
+    QSet<const GDBMICommand*> mMemoryViewReads;
+    DisassemblyCache mDisassemblyCache;
+    QString mDisassemblyFlavor;
+
     DebuggerType mClientType;
 };
 
@@ -19,73 +19,140 @@
 #include <QFileInfo>
 #include <QList>
 #include <QDebug>
+#include <cstring>
 #include <qt_utils/utils.h>
 
 
-GDBMIResultParser::GDBMIResultParser()
+GDBMIResultParser::GDBMIResultParser():
+    mNodeBlockIndex{-1},
+    mNodesUsed{NodeBlockSize},
+    mStringBlockIndex{-1},
+    mStringUsed{StringBlockSize},
+    mEnd{nullptr}
 {
-    mResultTypes.insert("-break-insert",GDBMIResultType::Breakpoint);
-    //mResultTypes.insert("BreakpointTable",GDBMIResultType::BreakpointTable);
-    mResultTypes.insert("-stack-list-frames",GDBMIResultType::FrameStack);
-    mResultTypes.insert("-stack-list-variables", GDBMIResultType::LocalVariables);
-    //mResultTypes.insert("frame",GDBMIResultType::Frame);
-    mResultTypes.insert("-data-disassemble",GDBMIResultType::Disassembly);
-    mResultTypes.insert("-data-evaluate-expression",GDBMIResultType::Evaluation);
-//    mResultTypes.insert("register-names",GDBMIResultType::RegisterNames);
-//    mResultTypes.insert("register-values",GDBMIResultType::RegisterValues);
-    mResultTypes.insert("-data-read-memory",GDBMIResultType::Memory);
-    mResultTypes.insert("-data-read-memory-bytes",GDBMIResultType::MemoryBytes);
-    mResultTypes.insert("-data-list-register-names",GDBMIResultType::RegisterNames);
-    mResultTypes.insert("-data-list-register-values",GDBMIResultType::RegisterValues);
-    mResultTypes.insert("-var-create",GDBMIResultType::CreateVar);
-    mResultTypes.insert("-var-list-children",GDBMIResultType::ListVarChildren);
-    mResultTypes.insert("-var-update",GDBMIResultType::UpdateVarValue);
-    mResultTypes.insert("-stack-info-frame",GDBMIResultType::Frame);
+}
+
+const QHash<QString, GDBMIResultType> &GDBMIResultParser::resultTypes()
+{
+    static const QHash<QString, GDBMIResultType> types{
+        {"-break-insert",GDBMIResultType::Breakpoint},
+        //{"BreakpointTable",GDBMIResultType::BreakpointTable},
+        {"-stack-list-frames",GDBMIResultType::FrameStack},
+        {"-stack-list-variables", GDBMIResultType::LocalVariables},
+        //{"frame",GDBMIResultType::Frame},
+        {"-data-disassemble",GDBMIResultType::Disassembly},
+        {"-data-evaluate-expression",GDBMIResultType::Evaluation},
+        {"-data-read-memory",GDBMIResultType::Memory},
+        {"-data-read-memory-bytes",GDBMIResultType::MemoryBytes},
+        {"-data-list-register-names",GDBMIResultType::RegisterNames},
+        {"-data-list-register-values",GDBMIResultType::RegisterValues},
+        {"-var-create",GDBMIResultType::CreateVar},
+        {"-var-list-children",GDBMIResultType::ListVarChildren},
+        {"-var-update",GDBMIResultType::UpdateVarValue},
+        {"-stack-info-frame",GDBMIResultType::Frame},
+    };
+    return types;
 }
 
 bool GDBMIResultParser::parse(const QByteArray &record, const QString& command, GDBMIResultType &type, ParseObject& multiValues)
 {
-    const char* p = record.data();
-    bool result = parseMultiValues(p,multiValues);
-    if (!result)
+    auto it = resultTypes().constFind(command);
+    if (it == resultTypes().constEnd())
         return false;
-//    if (*p!=0)
-//        return false;
-    if (!mResultTypes.contains(command))
+    reset(record);
+    Node* root = newNode(nullptr);
+    root->type = ParseValueType::Object;
+    if (!parseMultiValues(record.constData(),root))
         return false;
-    type = mResultTypes[command];
+    multiValues = ParseObject(root);
+    type = it.value();
     return true;
 }
 
 bool GDBMIResultParser::parseAsyncResult(const QByteArray &record, QByteArray &result, ParseObject &multiValue)
 {
-    const char* p =record.data();
-    if (*p!='*')
+    reset(record);
+    const char* p =record.constData();
+    if (p==mEnd || *p!='*')
         return false;
     p++;
     const char* start=p;
-    while (*p && *p!=',')
+    while (p<mEnd && *p!=',')
         p++;
-    result = QByteArray(start,p-start);
-    if (*p==0)
+    result = QByteArray::fromRawData(start,p-start);
+    Node* root = newNode(nullptr);
+    root->type = ParseValueType::Object;
+    multiValue = ParseObject(root);
+    if (p==mEnd)
         return true;
     p++;
-    return parseMultiValues(p,multiValue);
+    return parseMultiValues(p,root);
 }
 
-bool GDBMIResultParser::parseMultiValues(const char* p, ParseObject &multiValue)
+void GDBMIResultParser::reset(const QByteArray &record)
 {
-    while (*p) {
-        QByteArray propName;
-        ParseValue propValue;
-        bool result = parseNameAndValue(p,propName,propValue);
-        if (result) {
-            multiValue[propName]=propValue;
-        } else {
+    mNodeBlockIndex = -1;
+    mNodesUsed = NodeBlockSize;
+    mStringBlockIndex = -1;
+    mStringUsed = StringBlockSize;
+    mLargeStrings.clear();
+    mEnd = record.constData()+record.length();
+}
+
+GDBMIResultParser::Node *GDBMIResultParser::newNode(Node *parent)
+{
+    if (mNodesUsed == NodeBlockSize) {
+        mNodeBlockIndex++;
+        if (mNodeBlockIndex == (int)mNodeBlocks.size())
+            mNodeBlocks.emplace_back(new Node[NodeBlockSize]);
+        mNodesUsed = 0;
+    }
+    Node* node = &mNodeBlocks[mNodeBlockIndex][mNodesUsed++];
+    node->type = ParseValueType::NotAssigned;
+    node->nameLength = 0;
+    node->dataLength = 0;
+    node->childCount = 0;
+    node->name = nullptr;
+    node->data = nullptr;
+    node->firstChild = nullptr;
+    node->lastChild = nullptr;
+    node->next = nullptr;
+    if (parent) {
+        if (parent->lastChild)
+            parent->lastChild->next = node;
+        else
+            parent->firstChild = node;
+        parent->lastChild = node;
+        parent->childCount++;
+    }
+    return node;
+}
+
+char *GDBMIResultParser::newString(int size)
+{
+    if (size > StringBlockSize / 4) {
+        mLargeStrings.emplace_back(new char[size]);
+        return mLargeStrings.back().get();
+    }
+    if (mStringUsed + size > StringBlockSize) {
+        mStringBlockIndex++;
+        if (mStringBlockIndex == (int)mStringBlocks.size())
+            mStringBlocks.emplace_back(new char[StringBlockSize]);
+        mStringUsed = 0;
+    }
+    char* s = mStringBlocks[mStringBlockIndex].get() + mStringUsed;
+    mStringUsed += size;
+    return s;
+}
+
+bool GDBMIResultParser::parseMultiValues(const char* p, Node* parent)
+{
+    while (p<mEnd) {
+        Node* propNode = newNode(parent);
+        if (!parseNameAndValue(p,propNode))
             return false;
-        }
         skipSpaces(p);
-        if (*p==0)
+        if (p==mEnd)
             break;
         if (*p!=',')
             return false;
@@ -95,46 +162,40 @@ bool GDBMIResultParser::parseMultiValues(const char* p, ParseObject &multiValue)
     return true;
 }
 
-bool GDBMIResultParser::parseNameAndValue(const char *&p, QByteArray &name, ParseValue &value)
+bool GDBMIResultParser::parseNameAndValue(const char *&p, Node* node)
 {
     skipSpaces(p);
     const char* nameStart =p;
-    while (*p!=0 && isNameChar(*p)) {
+    while (p<mEnd && isNameChar(*p)) {
         p++;
     }
-    if (*p==0)
+    if (p==mEnd)
         return false;
-    name = QByteArray(nameStart,p-nameStart);
+    node->name = nameStart;
+    node->nameLength = p-nameStart;
     skipSpaces(p);
-    if (*p!='=')
+    if (p==mEnd || *p!='=')
         return false;
     p++;
-    return parseValue(p,value);
+    return parseValue(p,node);
 }
 
-bool GDBMIResultParser::parseValue(const char *&p, ParseValue &value)
+bool GDBMIResultParser::parseValue(const char *&p, Node* node)
 {
     skipSpaces(p);
+    if (p==mEnd)
+        return false;
     bool result;
     switch (*p) {
-    case '{': {
-        ParseObject obj;
-        result = parseObject(p,obj);
-        value = obj;
+    case '{':
+        result = parseObject(p,node);
         break;
-    }
-    case '[': {
-        QList<ParseValue> array;
-        result = parseArray(p,array);
-        value = array;
+    case '[':
+        result = parseArray(p,node);
         break;
-    }
-    case '"': {
-        QByteArray s;
-        result = parseStringValue(p,s);
-        value = s;
+    case '"':
+        result = parseStringValue(p,node);
         break;
-    }
     default:
         return false;
     }
@@ -144,61 +205,66 @@ bool GDBMIResultParser::parseValue(const char *&p, ParseValue &value)
     return true;
 }
 
-bool GDBMIResultParser::parseStringValue(const char *&p, QByteArray& stringValue)
+bool GDBMIResultParser::parseStringValue(const char *&p, Node* node)
 {
     if (*p!='"')
         return false;
     p++;
-    stringValue.clear();
-    while (*p!=0) {
-        if (*p == '"') {
-            break;
-        } else if (*p=='\\' && *(p+1)!=0) {
+    const char* start = p;
+    bool escaped = false;
+    while (p<mEnd && *p!='"') {
+        if (*p=='\\' && p+1<mEnd) {
+            escaped = true;
             p++;
-            switch (*p) {
-            case '\'':
-                stringValue+=0x27;
-                p++;
-                break;
-            case '"':
-                stringValue+=0x22;
-                p++;
-                break;
-            case '?':
-                stringValue+=0x3f;
-                p++;
-                break;
-            case '\\':
-                stringValue+=0x5c;
-                p++;
-                break;
+        }
+        p++;
+    }
+    if (p==mEnd)
+        return false;
+    const char* stringEnd = p;
+    p++; //skip '"'
+    node->type = ParseValueType::Value;
+    if (!escaped) {
+        // the common case, just point into the record
+        node->data = start;
+        node->dataLength = stringEnd - start;
+        return true;
+    }
+    // unescaped string is never longer than the escaped one
+    char* stringValue = newString(stringEnd - start);
+    char* s = stringValue;
+    const char* q = start;
+    while (q<stringEnd) {
+        if (*q=='\\' && q+1<stringEnd) {
+            q++;
+            switch (*q) {
             case 'a':
-                stringValue+=0x07;
-                p++;
+                *s++=0x07;
+                q++;
                 break;
             case 'b':
-                stringValue+=0x08;
-                p++;
+                *s++=0x08;
+                q++;
                 break;
             case 'f':
-                stringValue+=0x0c;
-                p++;
+                *s++=0x0c;
+                q++;
                 break;
             case 'n':
-                stringValue+=0x0a;
-                p++;
+                *s++=0x0a;
+                q++;
                 break;
             case 'r':
-                stringValue+=0x0d;
-                p++;
+                *s++=0x0d;
+                q++;
                 break;
             case 't':
-                stringValue+=0x09;
-                p++;
+                *s++=0x09;
+                q++;
                 break;
             case 'v':
-                stringValue+=0x0b;
-                p++;
+                *s++=0x0b;
+                q++;
                 break;
             case '0':
             case '1':
@@ -209,49 +275,43 @@ bool GDBMIResultParser::parseStringValue(const char *&p, QByteArray& stringValue
             case '6':
             case '7':
             {
-                int i=0;
-                for (i=0;i<3;i++) {
-                    if (*(p+i)<'0' || *(p+i)>'7')
-                        break;
+                int ch=0;
+                for (int i=0;i<3 && q<stringEnd && *q>='0' && *q<='7';i++) {
+                    ch = ch*8 + (*q-'0');
+                    q++;
                 }
-                QByteArray numStr(p,i);
-                bool ok;
-                char ch = numStr.toInt(&ok,8);
-                stringValue.append(ch);
-                p+=i;
+                *s++=(char)ch;
                 break;
             }
+            default:
+                // '\'', '"', '?', '\\' and unknown escapes
+                *s++=*q;
+                q++;
             }
         } else {
-            stringValue+=*p;
-            p++;
+            *s++=*q;
+            q++;
         }
     }
-    if (*p=='"') {
-        p++; //skip '"'
-        return true;
-    }
-    return false;
+    node->data = stringValue;
+    node->dataLength = s - stringValue;
+    return true;
 }
 
-bool GDBMIResultParser::parseObject(const char *&p, ParseObject &obj)
+bool GDBMIResultParser::parseObject(const char *&p, Node* node)
 {
     if (*p!='{')
         return false;
     p++;
+    node->type = ParseValueType::Object;
 
-    if (*p!='}') {
-        while (*p!=0) {
-            QByteArray propName;
-            ParseValue propValue;
-            bool result = parseNameAndValue(p,propName,propValue);
-            if (result) {
-                obj[propName]=propValue;
-            } else {
+    if (p<mEnd && *p!='}') {
+        while (p<mEnd) {
+            Node* propNode = newNode(node);
+            if (!parseNameAndValue(p,propNode))
                 return false;
-            }
             skipSpaces(p);
-            if (*p=='}')
+            if (p==mEnd || *p=='}')
                 break;
             if (*p!=',') {
                 return false;
@@ -260,41 +320,35 @@ bool GDBMIResultParser::parseObject(const char *&p, ParseObject &obj)
             skipSpaces(p);
         }
     }
-    if (*p=='}') {
+    if (p<mEnd && *p=='}') {
         p++; //skip '}'
         return true;
     }
     return false;
 }
 
-bool GDBMIResultParser::parseArray(const char *&p, QList<GDBMIResultParser::ParseValue> &array)
+bool GDBMIResultParser::parseArray(const char *&p, Node* node)
 {
     if (*p!='[')
         return false;
     p++;
-    if (*p!=']') {
-        while (*p!=0) {
+    node->type = ParseValueType::Array;
+    if (p<mEnd && *p!=']') {
+        while (p<mEnd) {
             skipSpaces(p);
+            if (p==mEnd)
+                return false;
+            Node* elementNode = newNode(node);
             if (*p=='{' || *p=='"' || *p=='[') {
-                ParseValue val;
-                bool result = parseValue(p,val);
-                if (result) {
-                    array.append(val);
-                } else {
+                if (!parseValue(p,elementNode))
                     return false;
-                }
             } else {
-                QByteArray name;
-                ParseValue val;
-                bool result = parseNameAndValue(p,name,val);
-                if (result) {
-                    array.append(val);
-                } else {
+                // name of the element is ignored
+                if (!parseNameAndValue(p,elementNode))
                     return false;
-                }
             }
-            skipSpaces(p);            
-            if (*p==']')
+            skipSpaces(p);
+            if (p==mEnd || *p==']')
                 break;
             if (*p!=',')
                 return false;
@@ -302,7 +356,7 @@ bool GDBMIResultParser::parseArray(const char *&p, QList<GDBMIResultParser::Pars
             skipSpaces(p);
         }
     }
-    if (*p==']') {
+    if (p<mEnd && *p==']') {
         p++; //skip ']'
         return true;
     }
@@ -334,30 +388,40 @@ bool GDBMIResultParser::isSpaceChar(char ch)
 
 void GDBMIResultParser::skipSpaces(const char *&p)
 {
-    while (*p!=0 && isSpaceChar(*p))
+    while (p<mEnd && isSpaceChar(*p))
         p++;
 }
 
-const QByteArray &GDBMIResultParser::ParseValue::value() const
+QByteArray GDBMIResultParser::ParseValue::value() const
 {
-    return mValue;
+    if (!mNode || mNode->type != ParseValueType::Value)
+        return QByteArray();
+    return QByteArray::fromRawData(mNode->data, mNode->dataLength);
 }
 
-const QList<::GDBMIResultParser::ParseValue> &GDBMIResultParser::ParseValue::array() const
+QList<GDBMIResultParser::ParseValue> GDBMIResultParser::ParseValue::array() const
 {
-    return mArray;
+    QList<ParseValue> result;
+    if (!mNode || mNode->type != ParseValueType::Array)
+        return result;
+    result.reserve(mNode->childCount);
+    for (const Node* child = mNode->firstChild; child; child = child->next)
+        result.append(ParseValue(child));
+    return result;
 }
 
-const GDBMIResultParser::ParseObject &GDBMIResultParser::ParseValue::object() const
+GDBMIResultParser::ParseObject GDBMIResultParser::ParseValue::object() const
 {
-    return mObject;
+    if (!mNode || mNode->type != ParseValueType::Object)
+        return ParseObject();
+    return ParseObject(mNode);
 }
 
 qlonglong GDBMIResultParser::ParseValue::intValue(int defaultValue) const
 {
     //Q_ASSERT(mType == ParseValueType::Value);
     bool ok;
-    qlonglong value = QString(mValue).toLongLong(&ok);
+    qlonglong value = this->value().toLongLong(&ok);
     if (ok)
         return value;
     else
@@ -367,7 +431,7 @@ qlonglong GDBMIResultParser::ParseValue::intValue(int defaultValue) const
 qulonglong GDBMIResultParser::ParseValue::hexValue(bool &ok) const
 {
     //Q_ASSERT(mType == ParseValueType::Value);
-    qulonglong value = QString(mValue).toULongLong(&ok,16);
+    qulonglong value = this->value().toULongLong(&ok,16);
     return value;
 }
 
@@ -397,116 +461,66 @@ static QString parseUtf8PathValue(QByteArray value)
 QString GDBMIResultParser::ParseValue::pathValue() const
 {
     //Q_ASSERT(mType == ParseValueType::Value);
-    QString result = parsePathValue(mValue);
+    QByteArray value = this->value();
+    QString result = parsePathValue(value);
     if (!fileExists(result))
-        result = parseUtf8PathValue(mValue);
+        result = parseUtf8PathValue(value);
     return result;
 }
 
 GDBMIResultParser::ParseValueType GDBMIResultParser::ParseValue::type() const
 {
-    return mType;
+    return mNode ? mNode->type : ParseValueType::NotAssigned;
 }
 
 bool GDBMIResultParser::ParseValue::isValid() const
 {
-    return mType!=ParseValueType::NotAssigned;
+    return type()!=ParseValueType::NotAssigned;
 }
 
 GDBMIResultParser::ParseValue::ParseValue():
-    mType(ParseValueType::NotAssigned) {
-
-}
-
-GDBMIResultParser::ParseValue::ParseValue(const QByteArray &value):
-    mValue(value),
-    mType(ParseValueType::Value)
+    mNode{nullptr}
 {
-}
 
-GDBMIResultParser::ParseValue::ParseValue(const ParseObject &object):
-    mObject(object),
-    mType(ParseValueType::Object)
-{
 }
 
-GDBMIResultParser::ParseValue::ParseValue(const QList<ParseValue> &array):
-    mArray(array),
-    mType(ParseValueType::Array)
+GDBMIResultParser::ParseValue::ParseValue(const Node *node):
+    mNode{node}
 {
 }
 
-GDBMIResultParser::ParseValue::ParseValue(const ParseValue &value):
-    mValue(value.mValue),
-    mArray(value.mArray),
-    mObject(value.mObject),
-    mType(value.mType)
+GDBMIResultParser::ParseObject::ParseObject():
+    mNode{nullptr}
 {
-}
 
-GDBMIResultParser::ParseValue &GDBMIResultParser::ParseValue::operator=(const GDBMIResultParser::ParseValue &value)
-{
-    mType = value.mType;
-    mValue = value.mValue;
-    mArray = value.mArray;
-    mObject = value.mObject;
-    return *this;
 }
 
-GDBMIResultParser::ParseValue &GDBMIResultParser::ParseValue::operator=(const QByteArray &value)
+GDBMIResultParser::ParseObject::ParseObject(const Node *node):
+    mNode{node}
 {
-    Q_ASSERT(mType == ParseValueType::NotAssigned);
-    mType = ParseValueType::Value;
-    mValue = value;
-    return *this;
-}
 
-GDBMIResultParser::ParseValue &GDBMIResultParser::ParseValue::operator=(const ParseObject& object)
-{
-    Q_ASSERT(mType == ParseValueType::NotAssigned);
-    mType = ParseValueType::Object;
-    mObject = object;
-    return *this;
 }
 
-GDBMIResultParser::ParseValue &GDBMIResultParser::ParseValue::operator=(const QList<ParseValue>& array)
+GDBMIResultParser::ParseValue GDBMIResultParser::ParseObject::operator[](const char *name) const
 {
-    Q_ASSERT(mType == ParseValueType::NotAssigned);
-    mType = ParseValueType::Array;
-    mArray = array;
-    return *this;
-}
-
-
-GDBMIResultParser::ParseObject::ParseObject()
-{
-
-}
-
-GDBMIResultParser::ParseObject::ParseObject(const ParseObject &object):
-    mProps(object.mProps)
-{
-
+    return find(name, strlen(name));
 }
 
 GDBMIResultParser::ParseValue GDBMIResultParser::ParseObject::operator[](const QByteArray &name) const
 {
-    if (mProps.contains(name)) {
-        ParseValue value(mProps[name]);
-        return value;
-    }
-    return ParseValue();
+    return find(name.constData(), name.length());
 }
 
-GDBMIResultParser::ParseObject &GDBMIResultParser::ParseObject::operator=(const ParseObject &object)
+GDBMIResultParser::ParseValue GDBMIResultParser::ParseObject::find(const char *name, int nameLength) const
 {
-    mProps = object.mProps;
-    return *this;
-}
-
-GDBMIResultParser::ParseValue &GDBMIResultParser::ParseObject::operator[](const QByteArray &name) {
-    if (!mProps.contains(name))
-        mProps[name]=ParseValue();
-    return mProps[name];
+    if (!mNode)
+        return ParseValue();
+    // tuples are small, and the last one wins if the name is duplicated
+    const Node* found = nullptr;
+    for (const Node* child = mNode->firstChild; child; child = child->next) {
+        if (child->nameLength == nameLength
+                && memcmp(child->name, name, nameLength) == 0)
+            found = child;
+    }
+    return ParseValue(found);
 }
-
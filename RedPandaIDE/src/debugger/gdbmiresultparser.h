@@ -21,6 +21,7 @@
 #include <QHash>
 #include <QList>
 #include <memory>
+#include <vector>
 
 
 enum class GDBMIResultType {
@@ -41,7 +42,15 @@ enum class GDBMIResultType {
     UpdateVarValue
 };
 
-
+/**
+ * @brief Parses the results of GDB/MI records.
+ *
+ * The value tree is stored in an arena owned by the parser, and strings
+ * without escapes are views into the parsed record. So ParseValue and
+ * ParseObject are only light handles: they (and the byte arrays they return)
+ * are valid until the parser is destroyed or parses the next record, and the
+ * record must not be changed or freed before that.
+ */
 class GDBMIResultParser
 {
 public:
@@ -52,64 +61,88 @@ public:
         NotAssigned
     };
 
+private:
+    struct Node {
+        ParseValueType type;
+        int nameLength;
+        int dataLength;
+        int childCount;
+        const char* name;
+        const char* data;
+        Node* firstChild;
+        Node* lastChild;
+        Node* next;
+    };
+
+public:
     class ParseValue;
 
     class ParseObject {
     public:
         explicit ParseObject();
-        ParseObject(const ParseObject& object);
+        ParseValue operator[](const char* name) const;
         ParseValue operator[](const QByteArray& name) const;
-        ParseValue& operator[](const QByteArray& name);
-        ParseObject& operator=(const ParseObject& object);
     private:
-        QHash<QByteArray, ParseValue> mProps;
+        explicit ParseObject(const Node* node);
+        ParseValue find(const char* name, int nameLength) const;
+    private:
+        const Node* mNode;
+        friend class GDBMIResultParser;
+        friend class ParseValue;
     };
 
     class ParseValue {
     public:
         explicit ParseValue();
-        explicit ParseValue(const QByteArray& value);
-        explicit ParseValue(const ParseObject &object);
-        explicit ParseValue(const QList<ParseValue>& array);
-        ParseValue(const ParseValue& value);
-        const QByteArray &value() const;
-        const QList<ParseValue> &array() const;
-        const ParseObject &object() const;
+        QByteArray value() const;
+        QList<ParseValue> array() const;
+        ParseObject object() const;
         qlonglong intValue(int defaultValue=-1) const;
         qulonglong hexValue(bool &ok) const;
 
         QString pathValue() const;
         ParseValueType type() const;
         bool isValid() const;
-        ParseValue& operator=(const QByteArray& value);
-        ParseValue& operator=(const ParseObject& object);
-        ParseValue& operator=(const QList<ParseValue>& array);
-        ParseValue& operator=(const ParseValue& value);
     private:
-        QByteArray mValue;
-        QList<ParseValue> mArray;
-        ParseObject mObject;
-        ParseValueType mType;
+        explicit ParseValue(const Node* node);
+    private:
+        const Node* mNode;
+        friend class GDBMIResultParser;
+        friend class ParseObject;
     };
 
-    using PParseValue = std::shared_ptr<ParseValue>;
-
 public:
     GDBMIResultParser();
+    GDBMIResultParser(const GDBMIResultParser&) = delete;
+    GDBMIResultParser& operator=(const GDBMIResultParser&) = delete;
     bool parse(const QByteArray& record, const QString& command, GDBMIResultType& type, ParseObject& multiValues);
     bool parseAsyncResult(const QByteArray& record, QByteArray& result, ParseObject& multiValue);
 private:
-    bool parseMultiValues(const char*p, ParseObject& multiValue);
-    bool parseNameAndValue(const char *&p,QByteArray& name, ParseValue& value);
-    bool parseValue(const char* &p, ParseValue& value);
-    bool parseStringValue(const char*&p, QByteArray& stringValue);
-    bool parseObject(const char*&p, ParseObject& obj);
-    bool parseArray(const char*&p, QList<ParseValue>& array);
+    void reset(const QByteArray& record);
+    Node* newNode(Node* parent);
+    char* newString(int size);
+    bool parseMultiValues(const char*p, Node* parent);
+    bool parseNameAndValue(const char *&p, Node* node);
+    bool parseValue(const char* &p, Node* node);
+    bool parseStringValue(const char*&p, Node* node);
+    bool parseObject(const char*&p, Node* node);
+    bool parseArray(const char*&p, Node* node);
     void skipSpaces(const char* &p);
     bool isNameChar(char ch);
     bool isSpaceChar(char ch);
+    static const QHash<QString, GDBMIResultType>& resultTypes();
 private:
-    QHash<QString, GDBMIResultType> mResultTypes;
+    static constexpr int NodeBlockSize = 512;
+    static constexpr int StringBlockSize = 16384;
+    // blocks are kept when parsing the next record
+    std::vector<std::unique_ptr<Node[]>> mNodeBlocks;
+    int mNodeBlockIndex;
+    int mNodesUsed; // in the current node block
+    std::vector<std::unique_ptr<char[]>> mStringBlocks;
+    int mStringBlockIndex;
+    int mStringUsed; // in the current string block
+    std::vector<std::unique_ptr<char[]>> mLargeStrings;
+    const char* mEnd;
 };
 
 #endif // GDBMIRESULTPARSER_H
@@ -32,6 +32,7 @@
 #include <QScrollBar>
 #include <QScreen>
 #include <memory>
+#include <limits>
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QDebug>
@@ -2166,6 +2167,18 @@ QStringList Editor::getOwnerExpressionAndMemberAtPositionForCompletion(
 
 QStringList Editor::getExpressionAtPosition(
         const QSynedit::CharPos &pos)
+{
+    return getExpressionAtPosition(
+                pos, lineCount(),
+                [this](QSynedit::Syntaxer *syntaxer, int line){
+        startParseLine(syntaxer, line);
+    });
+}
+
+QStringList Editor::getExpressionAtPosition(
+        const QSynedit::CharPos &pos,
+        int lineCount,
+        const StartParseLineFunc &startParseLine)
 {
     QStringList result;
     int line = pos.line;
@@ -2173,8 +2186,14 @@ QStringList Editor::getExpressionAtPosition(
     int symbolMatchingLevel = 0;
     LastSymbolType lastSymbolType=LastSymbolType::None;
     QSynedit::CppSyntaxer syntaxer;
+    auto isIdentStartChar = [&syntaxer](const QChar& ch) {
+        return syntaxer.isIdentStartChar(ch);
+    };
+    auto isIdentChar = [&syntaxer](const QChar& ch) {
+        return syntaxer.isIdentChar(ch);
+    };
     while (true) {
-        if (line>=lineCount() || line<0)
+        if (line>=lineCount || line<0)
             break;
         QStringList tokens;
         startParseLine(&syntaxer, line);
@@ -2388,8 +2407,8 @@ QStringList Editor::getExpressionAtPosition(
         }
 
         line--;
-        if (line>=0)
-            ch = document()->getLine(line).length()+1;
+        // all tokens of the previous lines are before the position
+        ch = std::numeric_limits<int>::max();
     }
     return result;
 }
@@ -3379,12 +3398,11 @@ void Editor::showCompletion(const QString& preWord,bool autoComplete, CodeComple
     mCompletionPopup->setKeypressedCallback([this](QKeyEvent *event)->bool{
         return onCompletionKeyPressed(event);
     });
+    // the list is built in background, so a single result may only be known later
+    mCompletionPopup->setAutoInsertCallback([this](){
+        completionInsert(mCodeCompletionSettings->appendFunc());
+    });
     mCompletionPopup->setParser(mParser);
-    if (mParser) {
-        mCompletionPopup->setCurrentScope(
-                    mParser->findScopeStatement(mFilename, caretY())
-                    );
-    }
     if (mFunctionTooltip) mFunctionTooltip->hide();
     //mCompletionPopup->show();
 
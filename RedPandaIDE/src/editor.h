@@ -63,6 +63,7 @@ using EvalTipReadyCallback = std::function<void (Editor *)>;
 using GetCompilerTypeForEditorFunc = std::function<CompilerType (const Editor *)>;
 using GetReformatterFunc = std::function<std::unique_ptr<BaseReformatter>(Editor *)>;
 using GetCppParserFunc = std::function<PCppParser (Editor *)>;
+using StartParseLineFunc = std::function<void (QSynedit::Syntaxer *syntaxer, int line)>;
 
 class Editor : public QSynedit::QSynEdit
 {
@@ -237,6 +238,19 @@ public:
     QString getWordForCompletionSearch(const QSynedit::CharPos& pos,bool permitTilde);
     QStringList getExpressionAtPosition(
             const QSynedit::CharPos& pos);
+    /**
+     * @brief get the expression at the position, without an editor
+     *
+     * Can be used outside the GUI thread.
+     * @param pos the position
+     * @param lineCount line count of the document
+     * @param startParseLine prepares the syntaxer to parse the given line
+     * @return the expression
+     */
+    static QStringList getExpressionAtPosition(
+            const QSynedit::CharPos& pos,
+            int lineCount,
+            const StartParseLineFunc& startParseLine);
     void resetBookmarks(BookmarkModel *model);
 
     const PCppParser &parser() const;
@@ -0,0 +1,337 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "headerindexmanager.h"
+#include "settings/dirsettings.h"
+#include "systemconsts.h"
+#include <qt_utils/utils.h>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+HeaderIndexBuilder::HeaderIndexBuilder(
+        const QString &compilerSetName,
+        const QStringList &includeDirs,
+        const QString &cacheFilename,
+        QObject *parent):
+    QThread{parent},
+    mCompilerSetName{compilerSetName},
+    mIncludeDirs{includeDirs},
+    mCacheFilename{cacheFilename},
+    mCancelled{false}
+{
+}
+
+void HeaderIndexBuilder::cancel()
+{
+    mCancelled = true;
+}
+
+bool HeaderIndexBuilder::isCancelled() const
+{
+    return mCancelled;
+}
+
+const QString &HeaderIndexBuilder::compilerSetName() const
+{
+    return mCompilerSetName;
+}
+
+HeaderDirListings HeaderIndexBuilder::takeListings()
+{
+    QMutexLocker locker(&mListingsMutex);
+    HeaderDirListings listings = mListings;
+    mListings.clear();
+    return listings;
+}
+
+void HeaderIndexBuilder::run()
+{
+    HeaderDirListings cachedListings;
+    loadCache(cachedListings);
+    if (isCancelled())
+        return;
+    // the persisted index can be used while we are checking it
+    if (!cachedListings.isEmpty())
+        publishListings(cachedListings);
+
+    HeaderDirListings listings;
+    QList<QPair<QString,int>> dirs;
+    foreach (const QString& dir, mIncludeDirs) {
+        dirs.append(QPair<QString,int>(QDir::cleanPath(QDir(dir).absolutePath()), 0));
+    }
+    while (!dirs.isEmpty()) {
+        if (isCancelled())
+            return;
+        QPair<QString,int> dir = dirs.takeFirst();
+        const QString& path = dir.first;
+        if (listings.contains(path))
+            continue;
+        QFileInfo info(path);
+        if (!info.isDir())
+            continue;
+        PHeaderDirListing listing = cachedListings.value(path);
+        // entries of a directory are unchanged if it's not modified
+        if (!listing || listing->lastModified != info.lastModified().toMSecsSinceEpoch()) {
+            listing = HeaderIndexManager::listDir(path);
+            if (!listing)
+                continue;
+        }
+        listings.insert(path, listing);
+        if (dir.second >= MaxDepth)
+            continue;
+        foreach (const HeaderIndexEntry& entry, listing->entries) {
+            if (!entry.isFolder)
+                continue;
+            QString subDirPath = path + "/" + entry.name;
+            if (QFileInfo(subDirPath).isSymLink())
+                continue;
+            dirs.append(QPair<QString,int>(subDirPath, dir.second+1));
+        }
+    }
+    publishListings(listings);
+    saveCache(listings);
+}
+
+void HeaderIndexBuilder::loadCache(HeaderDirListings &listings)
+{
+    QFile file(mCacheFilename);
+    if (!file.open(QFile::ReadOnly))
+        return;
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError)
+        return;
+    QJsonObject root = doc.object();
+    if (root["compilerSet"].toString() != mCompilerSetName)
+        return;
+    foreach (const QJsonValue& value, root["dirs"].toArray()) {
+        QJsonObject obj = value.toObject();
+        PHeaderDirListing listing = std::make_shared<HeaderDirListing>();
+        listing->lastModified = static_cast<qint64>(obj["modified"].toDouble());
+        foreach (const QJsonValue& name, obj["folders"].toArray()) {
+            listing->entries.append(HeaderIndexEntry{name.toString(), true});
+        }
+        foreach (const QJsonValue& name, obj["headers"].toArray()) {
+            listing->entries.append(HeaderIndexEntry{name.toString(), false});
+        }
+        std::sort(listing->entries.begin(), listing->entries.end(),
+                  [](const HeaderIndexEntry& e1, const HeaderIndexEntry& e2) {
+            return e1.name < e2.name;
+        });
+        listings.insert(obj["path"].toString(), listing);
+    }
+}
+
+void HeaderIndexBuilder::saveCache(const HeaderDirListings &listings)
+{
+    QJsonArray dirs;
+    for (auto it = listings.begin(); it != listings.end(); ++it) {
+        QJsonArray folders;
+        QJsonArray headers;
+        foreach (const HeaderIndexEntry& entry, it.value()->entries) {
+            if (entry.isFolder)
+                folders.append(entry.name);
+            else
+                headers.append(entry.name);
+        }
+        QJsonObject obj;
+        obj["path"] = it.key();
+        obj["modified"] = static_cast<double>(it.value()->lastModified);
+        obj["folders"] = folders;
+        obj["headers"] = headers;
+        dirs.append(obj);
+    }
+    QJsonObject root;
+    root["compilerSet"] = mCompilerSetName;
+    root["dirs"] = dirs;
+    // it's only a cache, so failures are ignored
+    QFile file(mCacheFilename);
+    if (file.open(QFile::WriteOnly | QFile::Truncate))
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+void HeaderIndexBuilder::publishListings(const HeaderDirListings &listings)
+{
+    {
+        QMutexLocker locker(&mListingsMutex);
+        mListings = listings;
+    }
+    emit listingsReady();
+}
+
+HeaderIndexManager::HeaderIndexManager(DirSettings *dirSettings, QObject *parent):
+    QObject{parent},
+    mDirSettings{dirSettings}
+{
+    Q_ASSERT(dirSettings!=nullptr);
+    connect(&mWatcher, &QFileSystemWatcher::directoryChanged,
+            this, &HeaderIndexManager::onDirectoryChanged);
+}
+
+HeaderIndexManager::~HeaderIndexManager()
+{
+    if (mBuilder) {
+        mBuilder->cancel();
+        mBuilder->wait();
+        delete mBuilder;
+    }
+}
+
+void HeaderIndexManager::indexCompilerSet(const QString &compilerSetName, const QStringList &includeDirs)
+{
+    if (mIndexedCompilerSets.contains(compilerSetName))
+        return;
+    mIndexedCompilerSets.insert(compilerSetName);
+    mPendingCompilerSets.append(QPair<QString,QStringList>(compilerSetName, includeDirs));
+    startNextBuilder();
+}
+
+QList<HeaderIndexEntry> HeaderIndexManager::findEntries(
+        const QString &dirPath,
+        const QString &prefix,
+        Qt::CaseSensitivity caseSensitivity)
+{
+    QString path = QDir::cleanPath(QDir(dirPath).absolutePath());
+    PHeaderDirListing listing = mListings.value(path);
+    // entries of a dir that is not watched are unchanged if it's not modified
+    if (listing && !mWatchedDirs.contains(path)
+            && listing->lastModified != QFileInfo(path).lastModified().toMSecsSinceEpoch())
+        listing.reset();
+    if (!listing) {
+        listing = listDir(path);
+        if (!listing) {
+            mListings.remove(path);
+            return QList<HeaderIndexEntry>();
+        }
+        watchDir(path);
+        mListings.insert(path, listing);
+    }
+    if (prefix.isEmpty())
+        return listing->entries;
+    QList<HeaderIndexEntry> result;
+    if (caseSensitivity == Qt::CaseSensitive) {
+        auto it = std::lower_bound(listing->entries.begin(), listing->entries.end(), prefix,
+                                   [](const HeaderIndexEntry& entry, const QString& s) {
+            return entry.name < s;
+        });
+        while (it != listing->entries.end() && it->name.startsWith(prefix)) {
+            result.append(*it);
+            ++it;
+        }
+    } else {
+        foreach (const HeaderIndexEntry& entry, listing->entries) {
+            if (entry.name.startsWith(prefix, Qt::CaseInsensitive))
+                result.append(entry);
+        }
+    }
+    return result;
+}
+
+PHeaderDirListing HeaderIndexManager::listDir(const QString &dirPath)
+{
+    QDir dir(dirPath);
+    if (!dir.exists())
+        return PHeaderDirListing();
+    PHeaderDirListing listing = std::make_shared<HeaderDirListing>();
+    listing->lastModified = QFileInfo(dirPath).lastModified().toMSecsSinceEpoch();
+    foreach (const QFileInfo& fileInfo, dir.entryInfoList()) {
+        if (fileInfo.fileName().startsWith("."))
+            continue;
+        if (fileInfo.isDir()) {
+            listing->entries.append(HeaderIndexEntry{fileInfo.fileName(), true});
+            continue;
+        }
+        QString suffix = fileInfo.suffix().toLower();
+        if (suffix == "h" || suffix == "hpp" || suffix == "") {
+            listing->entries.append(HeaderIndexEntry{fileInfo.fileName(), false});
+        }
+    }
+    std::sort(listing->entries.begin(), listing->entries.end(),
+              [](const HeaderIndexEntry& e1, const HeaderIndexEntry& e2) {
+        return e1.name < e2.name;
+    });
+    return listing;
+}
+
+void HeaderIndexManager::onDirectoryChanged(const QString &path)
+{
+    // listed again when queried
+    mListings.remove(path);
+    // the watcher stops watching removed dirs
+    if (!mWatcher.directories().contains(path))
+        mWatchedDirs.remove(path);
+}
+
+void HeaderIndexManager::watchDir(const QString &path)
+{
+    if (mWatchedDirs.contains(path) || mWatchedDirs.count() >= MaxWatchedDirs)
+        return;
+    if (mWatcher.addPath(path))
+        mWatchedDirs.insert(path);
+}
+
+QString HeaderIndexManager::cacheFilename(const QString &compilerSetName) const
+{
+    QByteArray hash = QCryptographicHash::hash(compilerSetName.toUtf8(),
+                                               QCryptographicHash::Md5).toHex();
+    return includeTrailingPathDelimiter(mDirSettings->config())
+            + QString(DEV_HEADER_INDEX_FILE).arg(QString::fromLatin1(hash));
+}
+
+void HeaderIndexManager::startNextBuilder()
+{
+    if (mBuilder || mPendingCompilerSets.isEmpty())
+        return;
+    QPair<QString,QStringList> compilerSet = mPendingCompilerSets.takeFirst();
+    // headers are often installed into the include dirs themselves
+    foreach (const QString& dir, compilerSet.second) {
+        watchDir(QDir::cleanPath(QDir(dir).absolutePath()));
+    }
+    HeaderIndexBuilder *builder = new HeaderIndexBuilder(
+                compilerSet.first,
+                compilerSet.second,
+                cacheFilename(compilerSet.first));
+    connect(builder, &HeaderIndexBuilder::listingsReady,
+            this, [this, builder](){
+        mergeListings(builder->takeListings());
+    });
+    connect(builder, &QThread::finished,
+            this, [this](){
+        mBuilder = nullptr;
+        startNextBuilder();
+    });
+    connect(builder, &QThread::finished,
+            builder, &QObject::deleteLater);
+    mBuilder = builder;
+    builder->start(QThread::LowPriority);
+}
+
+void HeaderIndexManager::mergeListings(const HeaderDirListings &listings)
+{
+    // watched dirs are kept up to date by the watcher, unless the listing is older
+    for (auto it = listings.begin(); it != listings.end(); ++it) {
+        PHeaderDirListing listing = mListings.value(it.key());
+        if (!listing || !mWatchedDirs.contains(it.key())
+                || listing->lastModified < it.value()->lastModified)
+            mListings.insert(it.key(), it.value());
+    }
+}
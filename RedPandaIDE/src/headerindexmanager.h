@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HEADERINDEXMANAGER_H
+#define HEADERINDEXMANAGER_H
+
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QHash>
+#include <QSet>
+#include <QPointer>
+#include <QFileSystemWatcher>
+#include <memory>
+
+struct HeaderIndexEntry {
+    QString name;
+    bool isFolder;
+};
+
+// headers and sub folders in a directory
+struct HeaderDirListing {
+    qint64 lastModified; // msecs since epoch
+    QList<HeaderIndexEntry> entries; // sorted by name
+};
+
+using PHeaderDirListing = std::shared_ptr<HeaderDirListing>;
+using HeaderDirListings = QHash<QString, PHeaderDirListing>;
+
+/**
+ * @brief Builds the header index of a compiler set's include dirs.
+ *
+ * The persisted index is loaded first. Then the include dirs are walked,
+ * and only directories modified since last time are listed again.
+ */
+class HeaderIndexBuilder : public QThread
+{
+    Q_OBJECT
+public:
+    explicit HeaderIndexBuilder(const QString& compilerSetName,
+                                const QStringList& includeDirs,
+                                const QString& cacheFilename,
+                                QObject *parent = nullptr);
+    void cancel();
+    bool isCancelled() const;
+    const QString &compilerSetName() const;
+    HeaderDirListings takeListings();
+signals:
+    void listingsReady();
+protected:
+    void run() override;
+private:
+    static constexpr int MaxDepth = 8;
+    void loadCache(HeaderDirListings& listings);
+    void saveCache(const HeaderDirListings& listings);
+    void publishListings(const HeaderDirListings& listings);
+private:
+    QString mCompilerSetName;
+    QStringList mIncludeDirs;
+    QString mCacheFilename;
+    QAtomicInt mCancelled;
+    QMutex mListingsMutex;
+    HeaderDirListings mListings;
+};
+
+class DirSettings;
+/**
+ * @brief Cached listings of include directories, used by #include completion.
+ *
+ * Include dirs of compiler sets are indexed in background and persisted.
+ * Other directories (project include dirs, dir of the current file) are listed
+ * when first queried. Listings are refreshed when the file system watcher reports
+ * changes; dirs beyond the watcher's limit are checked by their modification time.
+ */
+class HeaderIndexManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit HeaderIndexManager(DirSettings *dirSettings, QObject *parent = nullptr);
+    ~HeaderIndexManager();
+    /**
+     * @brief index include dirs of the compiler set in background
+     *
+     * Does nothing if the compiler set is already indexed in this session.
+     */
+    void indexCompilerSet(const QString& compilerSetName, const QStringList& includeDirs);
+    /**
+     * @brief find headers and sub folders in the directory
+     * @param dirPath the directory
+     * @param prefix only entries whose name start with it are returned
+     * @param caseSensitivity used when matching the prefix
+     * @return the entries, sorted by name
+     */
+    QList<HeaderIndexEntry> findEntries(const QString& dirPath,
+                                        const QString& prefix,
+                                        Qt::CaseSensitivity caseSensitivity);
+
+    static PHeaderDirListing listDir(const QString& dirPath);
+private slots:
+    void onDirectoryChanged(const QString& path);
+private:
+    QString cacheFilename(const QString& compilerSetName) const;
+    void watchDir(const QString& path);
+    void startNextBuilder();
+    void mergeListings(const HeaderDirListings& listings);
+private:
+    static constexpr int MaxWatchedDirs = 500;
+    DirSettings *mDirSettings;
+    HeaderDirListings mListings;
+    QSet<QString> mIndexedCompilerSets;
+    QList<QPair<QString, QStringList>> mPendingCompilerSets;
+    QPointer<HeaderIndexBuilder> mBuilder;
+    QFileSystemWatcher mWatcher;
+    QSet<QString> mWatchedDirs;
+};
+
+#endif // HEADERINDEXMANAGER_H
@@ -143,8 +143,11 @@ bool sendFilesToInstance() {
         QBuffer buffer;
         buffer.open(QBuffer::ReadWrite);
         QDataStream out(&buffer);
-        QStringList filesToOpen = qApp->arguments();
-        filesToOpen.pop_front();
+        QStringList filesToOpen;
+        foreach (const QString& argument, qApp->arguments().mid(1)) {
+            if (!StartupTrace::isOption(argument))
+                filesToOpen.append(argument);
+        }
         out<<filesToOpen;
         int size = buffer.size();
         if (sharedMemory.create(size)) {
@@ -263,6 +266,7 @@ int main(int argc, char *argv[])
 #if QT_VERSION_MAJOR < 6
     app.setAttribute(Qt::AA_UseHighDpiPixmaps);
 #endif
+    StartupTrace::start(app.arguments());
     QDir startupDir = QDir::current();
     ExternalResource resource;
 
@@ -339,17 +343,24 @@ int main(int argc, char *argv[])
     qRegisterMetaType<POJProblem>("POJProblem");
     qRegisterMetaType<PCompileIssue>("PCompileIssue");
     qRegisterMetaType<PCompileIssue>("PCompileIssue&");
+    qRegisterMetaType<CompileIssueList>("CompileIssueList");
+    qRegisterMetaType<PBuildTimingReport>("PBuildTimingReport");
     qRegisterMetaType<QVector<int>>("QVector<int>");
     qRegisterMetaType<QHash<int,QString>>("QHash<int,QString>");
 
-    initParser();
+    {
+        StartupTrace::Span span("initParser");
+        initParser();
+    }
 
     try {
 
         SystemConsts systemConsts;
         pSystemConsts = &systemConsts;
+        StartupTrace::Span charsetSpan("CharsetInfoManager");
         CharsetInfoManager charsetInfoManager(language);
         pCharsetInfoManager=&charsetInfoManager;
+        charsetSpan.end();
 
         //We must use smarter point here, to manually control it's lifetime:
         // when restore default settings, it must be destoyed before we remove all setting files.
@@ -357,10 +368,14 @@ int main(int argc, char *argv[])
         //load settings
         pSettings = settings.get();
         if (firstRun) {
+            StartupTrace::Span span("find compiler sets");
             pSettings->compilerSets().findSets(true);
             pSettings->compilerSets().saveSets();
         }
-        pSettings->load();
+        {
+            StartupTrace::Span span("Settings::load");
+            pSettings->load();
+        }
         if (firstRun) {
             //set theme
             ChooseThemeDialog themeDialog;
@@ -398,6 +413,7 @@ int main(int argc, char *argv[])
         AutolinkManager autolinkManager;
         pAutolinkManager = &autolinkManager;
         try {
+            StartupTrace::Span span("AutolinkManager::load");
             pAutolinkManager->load();
         } catch (FileError e) {
             QMessageBox::critical(nullptr,
@@ -410,37 +426,58 @@ int main(int argc, char *argv[])
 
         QDir::setCurrent(pSettings->environment().defaultOpenFolder());
 
+        StartupTrace::Span mainWindowSpan("MainWindow");
         MainWindow mainWindow;
         pMainWindow = &mainWindow;
+        mainWindowSpan.end();
         if (mainWindow.screen())
             setScreenDPI(mainWindow.screen()->logicalDotsPerInch());
 
-        mainWindow.show();
-
-        QStringList filesToOpen = app.arguments();
-        filesToOpen.pop_front();
-        if (!filesToOpen.isEmpty()) {
-            QStringList absoluteFiles;
-            //convert all relative path to absolute path
-            foreach (const QString& path, filesToOpen) {
-                QFileInfo info{path};
-                if (info.isAbsolute()) {
-                    absoluteFiles.append(path);
-                } else {
-                    absoluteFiles.append(startupDir.absoluteFilePath(path));
-                }
-            }
-            mainWindow.openFiles(absoluteFiles);
-        } else {
-            if (pSettings->editor().autoLoadLastFiles())
-                mainWindow.loadLastOpens();
+        {
+            StartupTrace::Span span("MainWindow::show");
+            mainWindow.show();
         }
-        if (mainWindow.editorManager()->pageCount()==0 && !mainWindow.project()) {
-            mainWindow.newEditor();
+
+        QStringList filesToOpen;
+        foreach (const QString& argument, app.arguments().mid(1)) {
+            if (!StartupTrace::isOption(argument))
+                filesToOpen.append(argument);
         }
+        // open files after the main window is painted, so it shows up earlier
+        QTimer::singleShot(0, &mainWindow, [&mainWindow, &lockFile, filesToOpen, startupDir](){
+            try {
+                StartupTrace::Span span("open files");
+                if (!filesToOpen.isEmpty()) {
+                    QStringList absoluteFiles;
+                    //convert all relative path to absolute path
+                    foreach (const QString& path, filesToOpen) {
+                        QFileInfo info{path};
+                        if (info.isAbsolute()) {
+                            absoluteFiles.append(path);
+                        } else {
+                            absoluteFiles.append(startupDir.absoluteFilePath(path));
+                        }
+                    }
+                    mainWindow.openFiles(absoluteFiles);
+                } else {
+                    if (pSettings->editor().autoLoadLastFiles())
+                        mainWindow.loadLastOpens();
+                }
+                if (mainWindow.editorManager()->pageCount()==0 && !mainWindow.project()) {
+                    mainWindow.newEditor();
+                }
 
-        //reset default open folder
-        mainWindow.setFilesViewRoot(pSettings->environment().currentFolder());
+                //reset default open folder
+                mainWindow.setFilesViewRoot(pSettings->environment().currentFolder());
+            } catch (BaseError e) {
+                QMessageBox::critical(nullptr,QApplication::tr("Error"),e.reason());
+            }
+            // other instances wait for the lock before sending their files to this one
+            if (lockFile.isLocked()) {
+                lockFile.unlock();
+            }
+            StartupTrace::finish(includeTrailingPathDelimiter(pSettings->dirs().config()) + STARTUP_TRACE_FILE);
+        });
 
 #ifdef Q_OS_WIN
         WindowLogoutEventFilter filter;
@@ -450,10 +487,6 @@ int main(int argc, char *argv[])
         BlockWheelEventFiler *blockWheelFilter=new BlockWheelEventFiler(&app);
         app.installEventFilter(blockWheelFilter);
 
-        if (lockFile.isLocked()) {
-            lockFile.unlock();
-        }
-
         int retCode = app.exec();
         if (mainWindow.shouldRemoveAllSettings()) {
             QString configDir = pSettings->dirs().config();
@@ -33,6 +33,7 @@
 #include <QFontDatabase>
 #include <QLibraryInfo>
 #include <QComboBox>
+#include <QTimer>
 #include "common.h"
 #include "colorscheme.h"
 #include "iconsmanager.h"
@@ -44,6 +45,7 @@
 #include "thememanager.h"
 #include "utils/font.h"
 #include "problems/ojproblemset.h"
+#include "startuptrace.h"
 
 #ifdef Q_OS_WIN
 #include <QTemporaryFile>
@@ -69,6 +69,7 @@
 #include "shortcutmanager.h"
 #include "colorscheme.h"
 #include "thememanager.h"
+#include "startuptrace.h"
 #include "widgets/darkfusionstyle.h"
 #include "widgets/lightfusionstyle.h"
 #include "problems/problemcasevalidator.h"
@@ -95,10 +96,12 @@
 #include "visithistorymanager.h"
 #include "widgets/projectalreadyopendialog.h"
 #include "widgets/searchdialog.h"
+#include "widgets/buildtimingdialog.h"
 
 
 #include "settingsdialog/settingsdialog.h"
 #include "compiler/compilermanager.h"
+#include "compiler/jsondiagnostics.h"
 #include <qsynedit/document.h>
 #include "cpprefacter.h"
 
@@ -184,8 +187,12 @@ MainWindow::MainWindow(QWidget *parent)
                this, &MainWindow::onEditorClosed);
     mProject = nullptr;
 
+    StartupTrace::Span colorManagerSpan("ColorManager");
     mColorManager = std::make_unique<ColorManager>(&pSettings->dirs());
+    colorManagerSpan.end();
+    StartupTrace::Span iconsManagerSpan("IconsManager");
     mIconsManager = std::make_unique<IconsManager>(&pSettings->dirs(), pSettings->environment().language());
+    iconsManagerSpan.end();
     mFileSystemModelIconProvider = std::make_unique<CustomFileIconProvider>(mIconsManager.get());
     //delete in the destructor
     mProjectProxyModel = new ProjectModelSortFilterProxy();
@@ -317,6 +324,11 @@ MainWindow::MainWindow(QWidget *parent)
                          e.reason());
     }
 
+    mHeaderIndexManager = new HeaderIndexManager{&pSettings->dirs(), this};
+    PCompilerSet defaultCompilerSet = pSettings->compilerSets().defaultSet();
+    if (defaultCompilerSet)
+        indexCompilerSetHeaders(mHeaderIndexManager, defaultCompilerSet);
+
     mCodeSnippetManager = new CodeSnippetsManager{&pSettings->dirs(), this};
     try {
         mCodeSnippetManager->load();
@@ -363,6 +375,14 @@ MainWindow::MainWindow(QWidget *parent)
     delete m;
     connect(mSearchResultModel->treeModel(), &QAbstractItemModel::modelReset,
             ui->searchView,&QTreeView::expandAll);
+    //results of find occurences are added in background
+    connect(mSearchResultModel->treeModel(), &QAbstractItemModel::rowsInserted,
+            ui->searchView, [this](const QModelIndex &parent, int first, int last){
+        if (parent.isValid())
+            return;
+        for (int i=first;i<=last;i++)
+            ui->searchView->expand(mSearchResultModel->treeModel()->index(i,0));
+    });
     ui->replacePanel->setVisible(false);
     ui->tabProblem->setEnabled(false);
 
@@ -427,7 +447,14 @@ MainWindow::MainWindow(QWidget *parent)
     connect(mFileSystemModel, &QFileSystemModel::fileRenamed,
             this, &MainWindow::onFileRenamedInFileSystemModel);
     mFileSystemModel->setReadOnly(false);
-    mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
+    mFileSystemModel->setIconProvider(mFileSystemModelIconProvider->get());
+#ifdef ENABLE_VCS
+    // the status is read in background, icons are reloaded when it's ready
+    connect(mFileSystemModelIconProvider->VCSRepository(), &GitRepository::statusUpdated,
+            this, [this](){
+        mFileSystemModel->setIconProvider(mFileSystemModelIconProvider->get());
+    });
+#endif
 
     mFileSystemModel->setNameFilters(pSystemConsts->defaultFileNameFilters());
     mFileSystemModel->setNameFilterDisables(true);
@@ -466,6 +493,7 @@ MainWindow::MainWindow(QWidget *parent)
     mCompletionPopup->setShowEditorCaretFunc(std::bind(&EditorManager::showActiveEditorCaret,mEditorManager));
     mHeaderCompletionPopup = new HeaderCompletionPopup(mColorManager.get(), this);
     mHeaderCompletionPopup->setShowEditorCaretFunc(std::bind(&EditorManager::showActiveEditorCaret,mEditorManager));
+    mHeaderCompletionPopup->setHeaderIndexManager(mHeaderIndexManager);
     mFunctionTip = new FunctionTooltipWidget(this);
 
     mClassBrowserModel->setColors(mStatementColors);
@@ -1073,6 +1101,7 @@ void MainWindow::applySettings()
     ThemeManager themeManager;
     PAppTheme appTheme;
     try {
+        StartupTrace::Span span("load theme");
         appTheme = themeManager.theme(pSettings->environment().theme());
     } catch (FileError e) {
         QMessageBox::critical(this,
@@ -1283,15 +1312,13 @@ void MainWindow::onFileSaved(const QString &path, bool inProject)
         if (index.isValid()) {
             if (!inProject) {
                 if ( (isCFile(path) || isHFile(path))
-                        &&  !mFileSystemModelIconProvider.VCSRepository()->isFileInRepository(path)) {
+                        &&  !mFileSystemModelIconProvider->VCSRepository()->isFileInRepository(path)) {
                     QString output;
-                    mFileSystemModelIconProvider.VCSRepository()->add(extractRelativePath(mFileSystemModelIconProvider.VCSRepository()->folder(),path),output);
+                    mFileSystemModelIconProvider->VCSRepository()->add(extractRelativePath(mFileSystemModelIconProvider->VCSRepository()->folder(),path),output);
                 }
             }
-//            qDebug()<<"update icon provider";
-            mFileSystemModelIconProvider.update();
-            mFileSystemModel->setIconProvider(&mFileSystemModelIconProvider);
-            ui->treeFiles->update(index);
+            // icons are reloaded when the status is updated
+            mFileSystemModelIconProvider->update();
         }
     }
 #else
@@ -2321,12 +2348,8 @@ void MainWindow::checkSyntaxInBack(Editor *e)
             && !isC_CPPHeaderFile(fileType)
             )
         return;
-    if (mCompilerManager->backgroundSyntaxChecking())
-        return;
     if (mCompilerManager->compiling())
         return;
-    if (mCheckSyntaxInBack)
-        return;
 
     if (mCompileIssuesState==CompileIssuesState::ProjectCompilationResultFilled
             || mCompileIssuesState==CompileIssuesState::ProjectCompiling) {
@@ -2336,19 +2359,20 @@ void MainWindow::checkSyntaxInBack(Editor *e)
         }
     }
 
-    mCheckSyntaxInBack=true;
-    clearIssues();
     CompileTarget target =getCompileTarget();
     if (target ==CompileTarget::Project) {
         int index = mProject->options().compilerSet;
         PCompilerSet set = pSettings->compilerSets().getSet(index);
         if (!set || !CompilerInfoManager::supportSyntaxCheck(set->compilerType()))
             return;
+        // a running check is followed by this one
+        mCheckSyntaxInBack=true;
         mCompilerManager->checkSyntax(e->filename(), e->fileEncoding(), e->text(), mProject);
     } else {
         PCompilerSet set = pSettings->compilerSets().defaultSet();
         if (!set || !CompilerInfoManager::supportSyntaxCheck(set->compilerType()))
             return;
+        mCheckSyntaxInBack=true;
         mCompilerManager->checkSyntax(e->filename(),e->fileEncoding(),e->text(), nullptr);
     }
 }
@@ -3159,6 +3183,19 @@ void MainWindow::createCustomActions()
     connect(mTableIssuesClearAction,&QAction::triggered,
             this, &MainWindow::onTableIssuesClear);
 
+    mTableIssuesApplyFixItAction = createAction(
+                tr("Apply fix-it"),
+                ui->tableIssues);
+    connect(mTableIssuesApplyFixItAction,&QAction::triggered,
+            this, &MainWindow::onTableIssuesApplyFixIt);
+
+    //watch view
+    mWatchViewFetchMoreChildrenAction = createAction(
+                tr("Show More Elements"),
+                ui->watchView);
+    connect(mWatchViewFetchMoreChildrenAction,&QAction::triggered,
+            this, &MainWindow::onWatchViewFetchMoreChildren);
+
     //search
     mSearchViewClearAction = createAction(
                 tr("Remove this search"),
@@ -4022,12 +4059,25 @@ void MainWindow::onWatchViewContextMenu(const QPoint &pos)
     menu.addAction(ui->actionRemove_Watch);
     menu.addAction(ui->actionRemove_All_Watches);
     menu.addAction(ui->actionModify_Watch);
+    menu.addSeparator();
+    mWatchViewFetchMoreChildrenAction->setEnabled(
+                mDebugger->watchModel()->hasMoreChildren(ui->watchView->currentIndex()));
+    menu.addAction(mWatchViewFetchMoreChildrenAction);
     menu.exec(ui->watchView->mapToGlobal(pos));
 }
 
+void MainWindow::onWatchViewFetchMoreChildren()
+{
+    mDebugger->watchModel()->fetchMoreChildren(ui->watchView->currentIndex());
+}
+
 void MainWindow::onTableIssuesContextMenu(const QPoint &pos)
 {
     QMenu menu(this);
+    PCompileIssue issue = ui->tableIssues->issue(ui->tableIssues->selectionModel()->currentIndex());
+    mTableIssuesApplyFixItAction->setEnabled(issue && !issue->fixIts.isEmpty());
+    menu.addAction(mTableIssuesApplyFixItAction);
+    menu.addSeparator();
     menu.addAction(mTableIssuesCopyAction);
     menu.addAction(mTableIssuesCopyAllAction);
     menu.addSeparator();
@@ -4136,7 +4186,7 @@ void MainWindow::onProjectViewContextMenu(const QPoint &pos)
 
 #ifdef ENABLE_VCS
     if (pSettings->vcs().gitOk() && hasRepository) {
-        mProject->model()->iconProvider()->update();
+        // the status is read in background, use the latest one
         vcsMenu.setTitle(tr("Version Control"));
         if (ui->projectView->selectionModel()->hasSelection()) {
             bool shouldAdd = true;
@@ -4297,15 +4347,15 @@ void MainWindow::onFilesViewContextMenu(const QPoint &pos)
 
 #ifdef ENABLE_VCS
     if (pSettings->vcs().gitOk() && hasRepository) {
-        mFileSystemModelIconProvider.update();
+        // the status is read in background, use the latest one
         vcsMenu.setTitle(tr("Version Control"));
         if (ui->treeFiles->selectionModel()->hasSelection()) {
             bool shouldAdd = true;
             foreach (const QModelIndex& index, ui->treeFiles->selectionModel()->selectedRows()) {
-                if (mFileSystemModelIconProvider.VCSRepository()->isFileInRepository(
+                if (mFileSystemModelIconProvider->VCSRepository()->isFileInRepository(
                             mFileSystemModel->fileInfo(index)
                             ) &&
-                        ! mFileSystemModelIconProvider.VCSRepository()->isFileConflicting(
+                        ! mFileSystemModelIconProvider->VCSRepository()->isFileConflicting(
                             mFileSystemModel->fileInfo(index)
                             )
                         ) {
@@ -4323,8 +4373,8 @@ void MainWindow::onFilesViewContextMenu(const QPoint &pos)
         vcsMenu.addAction(ui->actionGit_Commit);
         vcsMenu.addAction(ui->actionGit_Restore);
 
-        bool canBranch = !mFileSystemModelIconProvider.VCSRepository()->hasChangedFiles()
-                && !mFileSystemModelIconProvider.VCSRepository()->hasStagedFiles();
+        bool canBranch = !mFileSystemModelIconProvider->VCSRepository()->hasChangedFiles()
+                && !mFileSystemModelIconProvider->VCSRepository()->hasStagedFiles();
         ui->actionGit_Branch->setEnabled(canBranch);
         ui->actionGit_Merge->setEnabled(canBranch);
         ui->actionGit_Log->setEnabled(true);
@@ -5258,6 +5308,39 @@ void MainWindow::onTableIssuesCopy()
     }
 }
 
+void MainWindow::onTableIssuesApplyFixIt()
+{
+    QModelIndex index = ui->tableIssues->selectionModel()->currentIndex();
+    PCompileIssue issue = ui->tableIssues->issue(index);
+    if (!issue || issue->fixIts.isEmpty())
+        return;
+    Editor * editor = openFile(issue->filename);
+    if (editor == nullptr)
+        return;
+    QVector<CompileIssueFixIt> fixIts = issue->fixIts;
+    // apply from the last one, so positions of the others are unchanged
+    std::sort(fixIts.begin(), fixIts.end(),
+              [](const CompileIssueFixIt& f1, const CompileIssueFixIt& f2) {
+        if (f1.line != f2.line)
+            return f1.line > f2.line;
+        return f1.column > f2.column;
+    });
+    editor->beginEditing();
+    foreach (const CompileIssueFixIt& fixIt, fixIts) {
+        if (fixIt.line < 0 || fixIt.endLine >= editor->lineCount())
+            continue;
+        QSynedit::CharPos begin{byteColumnToCharColumn(editor->lineText(fixIt.line), fixIt.column),
+                    fixIt.line};
+        QSynedit::CharPos end{byteColumnToCharColumn(editor->lineText(fixIt.endLine), fixIt.endColumn),
+                    fixIt.endLine};
+        editor->setSelBeginEnd(begin, end);
+        editor->setSelText(fixIt.text);
+    }
+    editor->endEditing();
+    // the positions are out of date
+    issue->fixIts.clear();
+}
+
 void MainWindow::onSearchResultsModelCurrentIndexChanged()
 {
     if (ui->cbSearchHistory->currentIndex()!=mSearchResultModel->currentIndex())
@@ -5973,6 +6056,7 @@ void MainWindow::showEvent(QShowEvent *)
         return;
     //lazy initialize
     mFullInitialized = true;
+    StartupTrace::Span span("MainWindow::showEvent");
     applySettings();
     const UISettings& settings = pSettings->ui();
     ui->tabMessages->setCurrentIndex(settings.bottomPanelIndex());
@@ -6096,16 +6180,23 @@ void MainWindow::logToolsOutput(const QString& msg)
     ui->txtToolsOutput->ensureCursorVisible();
 }
 
-void MainWindow::onCompileIssue(PCompileIssue issue)
+void MainWindow::onCompileIssues(const CompileIssueList& issues)
 {
-    if (issue->filename.isEmpty())
-        return;
-    if (issue->filename.contains("*"))
-        return;
-    ui->tableIssues->addIssue(issue);
+    CompileIssueList validIssues;
+    validIssues.reserve(issues.count());
+    foreach (const PCompileIssue& issue, issues) {
+        if (issue->filename.isEmpty())
+            continue;
+        if (issue->filename.contains("*"))
+            continue;
+        validIssues.append(issue);
+    }
+    ui->tableIssues->addIssues(validIssues);
 
-    if (issue->type == CompileIssueType::Error || issue->type ==
-            CompileIssueType::Warning) {
+    foreach (const PCompileIssue& issue, validIssues) {
+        if (issue->type != CompileIssueType::Error && issue->type !=
+                CompileIssueType::Warning)
+            continue;
         Editor* e = mEditorManager->getOpenedEditor(issue->filename);
         if (e!=nullptr && (issue->line>=0)) {
             int line = issue->line;
@@ -6113,7 +6204,7 @@ void MainWindow::onCompileIssue(PCompileIssue issue)
 #ifdef QT_DEBUG
                 qDebug()<<issue->line<<issue->description;
 #endif
-                return;
+                continue;
             }
             int col = std::min(issue->column,e->lineText(line).length());
             if (col < 0)
@@ -6145,6 +6236,8 @@ void MainWindow::onProjectCompileStarted()
 
 void MainWindow::onSyntaxCheckStarted()
 {
+    // issues of the previous check are replaced
+    clearIssues();
     mCompileIssuesState = CompileIssuesState::SyntaxChecking;
 }
 
@@ -6334,6 +6427,17 @@ void MainWindow::onCompileErrorOccured(const QString& reason)
     QMessageBox::critical(this,tr("Compile Failed"),reason);
 }
 
+void MainWindow::onBuildTimingReady(PBuildTimingReport report)
+{
+    if (!mBuildTimingDialog) {
+        mBuildTimingDialog = new BuildTimingDialog(this);
+        mBuildTimingDialog->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    mBuildTimingDialog->setReport(report);
+    mBuildTimingDialog->show();
+    mBuildTimingDialog->raise();
+}
+
 void MainWindow::onRunErrorOccured(const QString& reason)
 {
     mCompilerManager->stopRun();
@@ -7641,6 +7745,11 @@ SymbolUsageManager *MainWindow::symbolUsageManager() const
     return mSymbolUsageManager;
 }
 
+HeaderIndexManager *MainWindow::headerIndexManager() const
+{
+    return mHeaderIndexManager;
+}
+
 void MainWindow::showHideInfosTab(QWidget *widget, bool show)
 {
     int idx = findTabIndex(ui->tabExplorer,widget);
@@ -8167,6 +8276,10 @@ void MainWindow::setupSlotsForProject()
             this, &MainWindow::onProjectUnitRemoved);
     connect(mProject.get(), &Project::unitRenamed,
             this, &MainWindow::onProjectUnitRenamed);
+#ifdef ENABLE_VCS
+    connect(mProject->model()->iconProvider()->VCSRepository(), &GitRepository::statusUpdated,
+            this, &MainWindow::updateVCSActions);
+#endif
 }
 
 void MainWindow::onProjectUnitAdded(const QString &filename)
@@ -8349,20 +8462,19 @@ void MainWindow::updateVCSActions()
     bool hasRepository = false;
     bool shouldEnable = false;
     bool canBranch = false;
+    // called again when the status read in background is updated
     if (ui->projectView->isVisible() && mProject) {
-        mProject->model()->iconProvider()->update();
         QString branch;
         hasRepository = mProject->model()->iconProvider()->VCSRepository()->hasRepository(branch);
         shouldEnable = true;
         canBranch = !mProject->model()->iconProvider()->VCSRepository()->hasChangedFiles()
                 && !mProject->model()->iconProvider()->VCSRepository()->hasStagedFiles();
     } else if (ui->treeFiles->isVisible()) {
-        mFileSystemModelIconProvider.update();
         QString branch;
-        hasRepository = mFileSystemModelIconProvider.VCSRepository()->hasRepository(branch);
+        hasRepository = mFileSystemModelIconProvider->VCSRepository()->hasRepository(branch);
         shouldEnable = true;
-        canBranch =!mFileSystemModelIconProvider.VCSRepository()->hasChangedFiles()
-                && !mFileSystemModelIconProvider.VCSRepository()->hasStagedFiles();
+        canBranch =!mFileSystemModelIconProvider->VCSRepository()->hasChangedFiles()
+                && !mFileSystemModelIconProvider->VCSRepository()->hasStagedFiles();
     }
 
     ui->actionGit_Remotes->setEnabled(hasRepository && shouldEnable);
@@ -8535,7 +8647,7 @@ void MainWindow::showSearchReplacePanel(bool show)
 void MainWindow::setFilesViewRoot(const QString &path, bool setOpenFolder)
 {
     mFileSystemModelIconProvider->setRootFolder(path);
-    mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
+    mFileSystemModel->setIconProvider(mFileSystemModelIconProvider->get());
     mFileSystemModel->setRootPath(path);
     ui->treeFiles->setRootIndex(mFileSystemModel->index(path));
     pSettings->environment().setCurrentFolder(path);
@@ -8626,7 +8738,7 @@ void MainWindow::updateProblemCaseOutput(POJProblemCase problemCase)
         } else
             return;
         if (diffLine < problemCase->outputLineCounts) {
-            ui->txtProblemCaseOutput->highlightLine(diffLine, mErrorColor);
+            ui->txtProblemCaseOutput->highlightLine(diffLine, mErrorColor, problemCase->firstDiffColumn);
         } else {
             ui->txtProblemCaseOutput->moveCursor(QTextCursor::MoveOperation::End);
             ui->txtProblemCaseOutput->moveCursor(QTextCursor::MoveOperation::StartOfLine);
@@ -9628,8 +9740,8 @@ void MainWindow::on_actionGit_Create_Repository_triggered()
         if (pos>=0) {
             ui->cbFilesPath->setItemIcon(pos, mIconsManager->getIcon(IconsManager::FILESYSTEM_GIT));
         }
-        mFileSystemModelIconProvider.setRootFolder(pSettings->environment().currentFolder());
-        mFileSystemModel->setIconProvider(&mFileSystemModelIconProvider);
+        mFileSystemModelIconProvider->setRootFolder(pSettings->environment().currentFolder());
+        mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
         //update project view
         if (mProject && mProject->folder() == mFileSystemModel->rootPath()) {
             mProject->addUnit(includeTrailingPathDelimiter(mProject->folder())+".gitignore", mProject->rootNode());
@@ -9658,8 +9770,8 @@ void MainWindow::on_actionGit_Create_Repository_triggered()
             if (pos>=0) {
                 ui->cbFilesPath->setItemIcon(pos, mIconsManager->getIcon(IconsManager::FILESYSTEM_GIT));
             }
-            mFileSystemModelIconProvider.update();
-            mFileSystemModel->setIconProvider(&mFileSystemModelIconProvider);
+            mFileSystemModelIconProvider->update();
+            mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
         }
     }
 }
@@ -9676,8 +9788,8 @@ void MainWindow::on_actionGit_Add_Files_triggered()
             vcsManager.add(info.absolutePath(),info.fileName(),output);
         }
         //update icons in files view
-        mFileSystemModelIconProvider.update();
-        mFileSystemModel->setIconProvider(&mFileSystemModelIconProvider);
+        mFileSystemModelIconProvider->update();
+        mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
     } else if (ui->projectView->isVisible() && mProject) {
         GitManager vcsManager;
         QModelIndexList indices = ui->projectView->selectionModel()->selectedRows();
@@ -9698,8 +9810,8 @@ void MainWindow::on_actionGit_Add_Files_triggered()
     }
 
     //update icons in files view too
-    mFileSystemModelIconProvider.update();
-    mFileSystemModel->setIconProvider(&mFileSystemModelIconProvider);
+    mFileSystemModelIconProvider->update();
+    mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
 }
 
 
@@ -9751,8 +9863,8 @@ void MainWindow::on_actionGit_Commit_triggered()
             mProject->model()->refreshIcons();
         }
         //update files view
-        mFileSystemModelIconProvider.update();
-        mFileSystemModel->setIconProvider(&mFileSystemModelIconProvider);
+        mFileSystemModelIconProvider->update();
+        mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
     }
     if (!output.isEmpty()) {
         InfoMessageBox infoBox;
@@ -9780,8 +9892,8 @@ void MainWindow::on_actionGit_Restore_triggered()
             mProject->model()->refreshIcons();
         }
         //update files view
-        mFileSystemModelIconProvider.update();
-        mFileSystemModel->setIconProvider(&mFileSystemModelIconProvider);
+        mFileSystemModelIconProvider->update();
+        mFileSystemModel->setIconProvider(mFileSystemModelIconProvider.get());
     }
     if (!output.isEmpty()) {
         InfoMessageBox infoBox;
@@ -22,6 +22,7 @@
 #include <QTimer>
 #include <QFileSystemModel>
 #include <QElapsedTimer>
+#include <QPointer>
 #include <QSortFilterProxyModel>
 #include "common.h"
 #include "widgets/searchresultview.h"
@@ -31,6 +32,7 @@
 #include "widgets/functiontooltipwidget.h"
 #include "caretlist.h"
 #include "symbolusagemanager.h"
+#include "headerindexmanager.h"
 #include "codesnippetsmanager.h"
 #include "todoparser.h"
 #include "toolsmanager.h"
@@ -42,6 +44,7 @@
 #include "problems/competitivecompenionhandler.h"
 #include "utils/parsemacros.h"
 #include "utils/file.h"
+#include "compiler/buildtiming.h"
 
 
 QT_BEGIN_NAMESPACE
@@ -69,6 +72,7 @@ class CPUDialog;
 class QPlainTextEdit;
 class SearchInFileDialog;
 class SearchDialog;
+class BuildTimingDialog;
 class Project;
 struct ProjectModelNode;
 class ProjectUnit;
@@ -206,6 +210,8 @@ public:
 
     SymbolUsageManager *symbolUsageManager() const;
 
+    HeaderIndexManager *headerIndexManager() const;
+
     CodeSnippetsManager *codeSnippetManager() const;
 
     const PTodoParser &todoParser() const;
@@ -235,7 +241,7 @@ public:
 
 public slots:
     void logToolsOutput(const QString& msg);
-    void onCompileIssue(PCompileIssue issue);
+    void onCompileIssues(const CompileIssueList& issues);
     void clearToolsOutput();
     void clearTodos();
     void onCompileStarted();
@@ -243,6 +249,7 @@ public slots:
     void onSyntaxCheckStarted();
     void onCompileFinished(QString filename, bool isCheckSyntax);
     void onCompileErrorOccured(const QString& reason);
+    void onBuildTimingReady(PBuildTimingReport report);
     void onRunErrorOccured(const QString& reason);
     void onRunFinished();
     void onRunPausingForFinish();
@@ -442,6 +449,8 @@ private slots:
     void onTableIssuesClear();
     void onTableIssuesCopyAll();
     void onTableIssuesCopy();
+    void onTableIssuesApplyFixIt();
+    void onWatchViewFetchMoreChildren();
 
     void onSearchResultsModelCurrentIndexChanged();
 
@@ -921,6 +930,7 @@ private:
     CPUDialog *mCPUDialog;
     SearchInFileDialog *mSearchInFilesDialog;
     SearchDialog *mSearchDialog;
+    QPointer<BuildTimingDialog> mBuildTimingDialog;
     bool mQuitting;
     bool mOpeningFiles;
     bool mOpeningProject;
@@ -947,6 +957,7 @@ private:
     ClassBrowserModel *mClassBrowserModel;
     std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > > mStatementColors;
     SymbolUsageManager *mSymbolUsageManager;
+    HeaderIndexManager *mHeaderIndexManager;
     CodeSnippetsManager *mCodeSnippetManager;
     PTodoParser mTodoParser;
     ToolsManager *mToolsManager;
@@ -984,6 +995,10 @@ private:
     QAction * mTableIssuesCopyAction;
     QAction * mTableIssuesCopyAllAction;
     QAction * mTableIssuesClearAction;
+    QAction * mTableIssuesApplyFixItAction;
+
+    //actions for watch view
+    QAction * mWatchViewFetchMoreChildrenAction;
 
     //actions for search result view
     QAction * mSearchViewClearAction;
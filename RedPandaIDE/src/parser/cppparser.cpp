@@ -65,6 +65,8 @@ CppParser::CppParser() : QObject{nullptr},
     //mSkipList;
     mSharedByFiles = false;
     mLockCount = 0;
+    mFrozenFileListParse = false;
+    mFrozenFileListUpdateView = false;
     mIsSystemHeader = false;
     mIsHeader = false;
     mIsProjectFile = false;
@@ -920,6 +922,28 @@ QSet<QString> CppParser::getFileUsings(const QString &filename) const
     return internalGetFileUsings(filename);
 }
 
+bool CppParser::findReferenceLines(const QString &fileName, const QString &identifier, QList<int> &lines) const
+{
+    QMutexLocker locker(&mMutex);
+    lines.clear();
+    PParsedFileInfo fileInfo = mPreprocessor.findFileInfo(fileName);
+    if (!fileInfo || !fileInfo->referencesRecorded())
+        return false;
+    QSet<int> lineSet = fileInfo->referenceLines(identifier);
+    lines = QList<int>(lineSet.begin(), lineSet.end());
+    std::sort(lines.begin(), lines.end());
+    return true;
+}
+
+bool CppParser::findStatementReferenceLines(const QString &fileName, const PStatement &statement, QList<int> &lines) const
+{
+    if (!statement || statement->kind == StatementKind::Preprocessor) {
+        lines.clear();
+        return false;
+    }
+    return findReferenceLines(fileName, statement->command, lines);
+}
+
 QSet<QString> CppParser::internalGetFileUsings(const QString &filename) const
 {
     QSet<QString> result;
@@ -995,7 +1019,11 @@ void CppParser::invalidateFile(const QString &fileName)
         return;
     {
         QMutexLocker locker(&mMutex);
-        if (mParsing || mLockCount>0)
+        if (mLockCount>0 && !mParsing) {
+            mFrozenInvalidations.insert(fileName);
+            return;
+        }
+        if (mParsing)
             return;
         updateSerialId();
         mParsing = true;
@@ -1046,7 +1074,8 @@ bool CppParser::parseFile(const QString &fileName, bool inProject,
         return false;
     {
         QMutexLocker locker(&mMutex);
-        if (mParsing) {
+        // run it after the current parsing ends, or the parser is unfrozen
+        if (mParsing || mLockCount>0) {
             mLastParseFileCommand = std::make_unique<ParseFileCommand>();
             mLastParseFileCommand->fileName = fileName;
             mLastParseFileCommand->inProject = inProject;
@@ -1055,8 +1084,6 @@ bool CppParser::parseFile(const QString &fileName, bool inProject,
             mLastParseFileCommand->updateView = updateView;
             return false;
         }
-        if (mLockCount>0)
-            return false;
         mParsing = true;
         updateSerialId();
         if (updateView)
@@ -1114,7 +1141,12 @@ void CppParser::parseFileList(bool updateView)
         return;
     {
         QMutexLocker locker(&mMutex);
-        if (mParsing || mLockCount>0)
+        if (mLockCount>0 && !mParsing) {
+            mFrozenFileListParse = true;
+            mFrozenFileListUpdateView = mFrozenFileListUpdateView || updateView;
+            return;
+        }
+        if (mParsing)
             return;
         updateSerialId();
         mParsing = true;
@@ -1242,6 +1274,49 @@ void CppParser::unFreeze()
 {
     QMutexLocker locker(&mMutex);
     mLockCount--;
+    if (mLockCount == 0
+            && (mLastParseFileCommand || mFrozenFileListParse || !mFrozenInvalidations.isEmpty())) {
+        // unFreeze() may be called from worker threads
+        QMetaObject::invokeMethod(this, [this](){
+            runFrozenRequests();
+        }, Qt::QueuedConnection);
+    }
+}
+
+void CppParser::runFrozenRequests()
+{
+    PCppParser parser = weak_from_this().lock();
+    if (!parser)
+        return;
+    QSet<QString> filesToInvalidate;
+    bool parseFileList;
+    bool fileListUpdateView;
+    {
+        QMutexLocker locker(&mMutex);
+        // frozen again, they will be run by the next unFreeze()
+        if (mLockCount>0)
+            return;
+        filesToInvalidate = mFrozenInvalidations;
+        mFrozenInvalidations.clear();
+        parseFileList = mFrozenFileListParse;
+        fileListUpdateView = mFrozenFileListUpdateView;
+        mFrozenFileListParse = false;
+        mFrozenFileListUpdateView = false;
+    }
+    foreach (const QString& fileName, filesToInvalidate) {
+        invalidateFile(fileName);
+    }
+    if (parseFileList)
+        parseFileListNonBlocking(parser, fileListUpdateView);
+    PParseFileCommand command = retrievePendingParseFileCommand();
+    if (command) {
+        parseFileNonBlocking(parser,
+                             command->fileName,
+                             command->inProject,
+                             command->contextFilename,
+                             command->onlyIfNotParsed,
+                             command->updateView);
+    }
 }
 
 bool CppParser::fileScanned(const QString &fileName) const
@@ -4644,6 +4719,8 @@ void CppParser::internalParse(const QString &fileName)
     if (!mStopForReset)
         mTokenizer.dumpTokens(QString(DebugLogFolder+"/tokens-%1.txt").arg(extractFileName(fileName)));
 #endif
+    // must be done before handling statements, which may modify tokens
+    recordReferences();
 #ifdef QT_DEBUG
         mLastIndex = -1;
 #endif
@@ -4670,6 +4747,66 @@ void CppParser::internalParse(const QString &fileName)
     internalClear();
 }
 
+void CppParser::recordReferences()
+{
+    // collected first, Find Usages and Rename read them under the lock
+    QList<PParsedFileInfo> fileInfos;
+    QHash<QString, QHash<QString, QSet<int>>> references;
+    QString currentFile; // empty if references in it are not recorded
+    for (int i=0;i<mTokenizer.tokenCount();i++) {
+        const QString& text = mTokenizer[i]->text;
+        if (text.startsWith('#')) {
+            // format: #include fullfilename:line
+            QString s = text.mid(1).trimmed();
+            if (!s.startsWith("include"))
+                continue;
+            s = s.mid(QString("include").length());
+            int delimPos = s.lastIndexOf(':');
+            if (delimPos<0)
+                continue;
+            QString fileName = s.mid(0,delimPos).trimmed();
+            PParsedFileInfo fileInfo = mPreprocessor.findFileInfo(fileName);
+            // we don't find usages in system headers
+            if (fileInfo && isSystemHeaderFile(fileInfo->fileName()))
+                fileInfo = nullptr;
+            currentFile.clear();
+            if (fileInfo) {
+                currentFile = fileInfo->fileName();
+                if (!references.contains(currentFile)) {
+                    fileInfos.append(fileInfo);
+                    references.insert(currentFile, QHash<QString, QSet<int>>());
+                }
+            }
+            continue;
+        }
+        if (currentFile.isEmpty())
+            continue;
+        // token may be qualified (like std::string)
+        int j=0;
+        while (j<text.length()) {
+            if (isIdentifierStartChar(text[j])) {
+                int start = j;
+                while (j<text.length() && isIdentifierChar(text[j]))
+                    j++;
+                QString word = text.mid(start,j-start);
+                if (!mCppKeywords.contains(word))
+                    references[currentFile][word].insert(mTokenizer[i]->line);
+            } else if (isIdentifierChar(text[j])) {
+                //skip numbers
+                while (j<text.length() && isIdentifierChar(text[j]))
+                    j++;
+            } else {
+                j++;
+            }
+        }
+    }
+    QMutexLocker locker(&mMutex);
+    foreach (const PParsedFileInfo& info, fileInfos) {
+        info->addReferences(references.value(info->fileName()));
+        info->setReferencesRecorded(true);
+    }
+}
+
 void CppParser::inheritClassStatement(const PStatement& derived, bool isStruct,
                                       const PStatement& base, StatementAccessibility access)
 {
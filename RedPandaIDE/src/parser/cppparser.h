@@ -28,7 +28,7 @@
 class CppParser;
 using PCppParser = std::shared_ptr<CppParser>;
 
-class CppParser : public QObject
+class CppParser : public QObject, public std::enable_shared_from_this<CppParser>
 {
     Q_OBJECT
 public:
@@ -107,12 +107,31 @@ public:
                                     const PStatement& currentClass) const;
     PStatement findTypeDef(const PStatement& statement,
                           const QString& fileName) const;
-    bool freeze();  // Freeze/Lock (stop reparse while searching)
-    bool freeze(const QString& serialId);  // Freeze/Lock (stop reparse while searching)
+    // Freeze/Lock (stop reparse while searching).
+    // Parse and invalidate requests made while frozen are run after unFreeze().
+    bool freeze();
+    bool freeze(const QString& serialId);
     QStringList getClassesList() const;
     QStringList getFileDirectIncludes(const QString& filename) const;
     QSet<QString> getIncludedFiles(const QString& filename) const;
     QSet<QString> getFileUsings(const QString& filename) const;
+    /**
+     * @brief Find the lines where the identifier appears in the file (recorded while parsing)
+     * @param fileName
+     * @param identifier
+     * @param lines sorted line numbers
+     * @return false if no reference is recorded for the file (not parsed yet or system header)
+     */
+    bool findReferenceLines(const QString& fileName, const QString& identifier, QList<int>& lines) const;
+    /**
+     * @brief Find the lines where the statement may be referenced in the file
+     *
+     * References are recorded from macro-expanded tokens, so macro names never show up
+     * in the index. For preprocessor statements this returns false and the caller
+     * should search every line.
+     * @return false if the lines are not known
+     */
+    bool findStatementReferenceLines(const QString& fileName, const PStatement& statement, QList<int>& lines) const;
 
     QString getHeaderFileName(const QString& relativeTo, const QString& headerName, bool fromNext=false) const;
 
@@ -206,6 +225,7 @@ private:
                    );
     void parseFileList(bool updateView = true);
     PParseFileCommand retrievePendingParseFileCommand();
+    void runFrozenRequests();
 
     PStatement addInheritedStatement(
             const PStatement& derived,
@@ -568,6 +588,7 @@ private:
     void handleLabel();
     void skipRequires(int maxIndex);
     void internalParse(const QString& fileName);
+    void recordReferences();
 //    function FindMacroDefine(const Command: AnsiString): PStatement;
     void inheritClassStatement(
             const PStatement& derived,
@@ -770,6 +791,10 @@ private:
     QSet<QString> mCppTypeKeywords;
 
     PParseFileCommand mLastParseFileCommand;
+    // requests dropped while the parser is frozen
+    QSet<QString> mFrozenInvalidations;
+    bool mFrozenFileListParse;
+    bool mFrozenFileListUpdateView;
 
     friend class CppFileListParserThread;
     friend class CppFileParserThread;
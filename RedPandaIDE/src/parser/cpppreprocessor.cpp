@@ -496,9 +496,10 @@ void CppPreprocessor::handleIncludeNext(const QString &tokens)
     handleInclude(tokens,true);
 }
 
-QString CppPreprocessor::expandMacros(QString text, bool handleBuffer, const QSet<QString> macrosToBeIgnored)
+QString CppPreprocessor::expandMacros(QString text, bool handleBuffer, const QSet<QString>& macrosToBeIgnored)
 {
     QString newLine;
+    newLine.reserve(text.length());
     ContentType currentType = ContentType::Other;
     int lenLine = text.length();
     int prevI = 0;
@@ -506,13 +507,15 @@ QString CppPreprocessor::expandMacros(QString text, bool handleBuffer, const QSe
     int wordStart = 0;
     QString word;
     QString delimiter;
-    QMultiHash<int,QString> tempIngoreMacros; // endLine, name
+    QMultiHash<int,QString> hideSet; // end position of the rescanned text, macro name
     bool lastWordNotProcessed = false;;
     while (i<lenLine) {
         QChar ch;
         if (!lastWordNotProcessed) {
-            for(int t=prevI;t<i;t++)
-                tempIngoreMacros.remove(t);
+            if (!hideSet.isEmpty()) {
+                for(int t=prevI;t<i;t++)
+                    hideSet.remove(t);
+            }
             prevI = i;
             ch=text[i];
         } else {
@@ -533,25 +536,22 @@ QString CppPreprocessor::expandMacros(QString text, bool handleBuffer, const QSe
             }
             if (!word.isEmpty()) {
                 QSet<QString> macrosUsed;
-                QSet<QString> ignores=macrosToBeIgnored;
-                foreach(const QString& name, tempIngoreMacros)
-                    ignores.insert(name);
-                QString newWord = expandMacro(text,word,i, handleBuffer,ignores,macrosUsed);
+                QString newWord = expandMacro(text,word,i, handleBuffer,macrosToBeIgnored,hideSet,macrosUsed);
                 if (!macrosUsed.isEmpty()) {
                     //adjust ignore macro list
-                    QMultiHash<int,QString> tempMacros2 = tempIngoreMacros;
-                    tempIngoreMacros.clear();
+                    QMultiHash<int,QString> tempMacros2 = hideSet;
+                    hideSet.clear();
                     int diff = newWord.length()-word.length();
                     foreach(int idx, tempMacros2.uniqueKeys()) {
                         QList<QString> names = tempMacros2.values(idx);
                         foreach(const QString& name, names)
-                            tempIngoreMacros.insert(idx+diff,name);
+                            hideSet.insert(idx+diff,name);
                     }
                     //rescan (see ISO/IEC 9899:1999 6.10.3.4 Rescanning and futher replacement)
                     foreach(const QString& name, macrosUsed) {
-                        tempIngoreMacros.insert(wordStart+newWord.length(), name);
+                        hideSet.insert(wordStart+newWord.length(), name);
                     }
-                    text = text.left(wordStart)+newWord+text.mid(i);
+                    text.replace(wordStart, i-wordStart, newWord);
                     i = wordStart;
                     lenLine = text.length();
                     word = "";
@@ -635,16 +635,25 @@ QString CppPreprocessor::expandMacros(QString text, bool handleBuffer, const QSe
     return newLine;
 }
 
-QString CppPreprocessor::expandMacro(QString &text, const QString &word, int &i, bool handleBuffer, const QSet<QString> &macrosToBeIgnored, QSet<QString> &macrosUsed){
-    if (macrosToBeIgnored.contains(word)) {
+QString CppPreprocessor::expandMacro(QString &text, const QString &word, int &i, bool handleBuffer,
+                                     const QSet<QString> &macrosToBeIgnored,
+                                     const QMultiHash<int,QString> &hideSet,
+                                     QSet<QString> &macrosUsed){
+    // most words are not macros, so look it up before checking the ignore sets
+    PDefine define = getDefine(word);
+    if (!define)
+        return word;
+    if (macrosToBeIgnored.contains(word))
         return word;
+    foreach(const QString& name, hideSet) {
+        if (name == word)
+            return word;
     }
     int lenLine = text.length();
-    PDefine define = getDefine(word);
-    if (define && define->args=="" ) {
+    if (define->args=="" ) {
         macrosUsed.insert(word);
         return define->value;
-    } else if (define && (define->args!="")) {
+    } else {
         int oldI = i;
         int oldIndex = mIndex;
         //skip spaces;
@@ -700,7 +709,10 @@ QString CppPreprocessor::expandMacro(QString &text, const QString &word, int &i,
             if (level==0) {
                 argEnd = i-2;
                 QString args = text.mid(argStart,argEnd-argStart+1).trimmed();
-                QString formattedValue = expandFunctionLikeMacro(define,args,macrosToBeIgnored);
+                QSet<QString> ignores=macrosToBeIgnored;
+                foreach(const QString& name, hideSet)
+                    ignores.insert(name);
+                QString formattedValue = expandFunctionLikeMacro(define,args,ignores);
                 macrosUsed.insert(word);
                 return formattedValue;
             }
@@ -943,6 +955,13 @@ void CppPreprocessor::parseArgs(PDefine define)
     QList<PDefineArgToken> tokens = tokenizeValue(define->value);
 
     QString formatStr = "";
+    auto appendText = [&define, &formatStr](const QString& text) {
+        formatStr += text;
+        if (!define->bodyParts.isEmpty() && define->bodyParts.last().argIndex<0)
+            define->bodyParts.last().text += text;
+        else
+            define->bodyParts.append(DefineBodyPart{text, -1, false});
+    };
     DefineArgTokenType lastTokenType=DefineArgTokenType::Other;
     int index;
     foreach (const PDefineArgToken& token, tokens) {
@@ -958,6 +977,7 @@ void CppPreprocessor::parseArgs(PDefine define)
                 define->argUsed[index] = true;
                 if (lastTokenType == DefineArgTokenType::Sharp) {
                     formatStr+= "\"%"+QString("%1").arg(index+1)+"\"";
+                    define->bodyParts.append(DefineBodyPart{QString(), index, true});
                     define->argNotExpand[index] = true;
                     break;
                 } else {
@@ -967,17 +987,18 @@ void CppPreprocessor::parseArgs(PDefine define)
                             define->argNotExpand[index-1] = true;
                     }
                     formatStr+= "%"+QString("%1").arg(index+1);
+                    define->bodyParts.append(DefineBodyPart{QString(), index, false});
                     break;
                 }
             }
-            formatStr += token->value;
+            appendText(token->value);
             break;
         case DefineArgTokenType::DSharp:
         case DefineArgTokenType::Sharp:
             break;
         case DefineArgTokenType::Space:
         case DefineArgTokenType::Symbol:
-            formatStr+=token->value;
+            appendText(token->value);
             break;
         default:
             break;
@@ -1438,92 +1459,97 @@ bool CppPreprocessor::skipParenthesis(const QString &line, int &index, int step)
 
 QString CppPreprocessor::expandFunctionLikeMacro(PDefine define, const QString &args, const QSet<QString> &macrosToBeIgnored)
 {
-    // Replace function by this string
-    QString result = define->formatValue;
-//    if (args.startsWith('(') && args.endsWith(')')) {
-//        qDebug()<<define->name<<args;
-//        args = args.mid(1,args.length()-2);
-//    }
-
-    if (define->argUsed.length()==0) {
-        result = define->formatValue;
-    } else {
-        QStringList argValues;
-        int i=0;
-        bool inString = false;
-        bool inChar = false;
-        int lastSplit=0;
-        int level=0;
-        while (i<args.length()) {
-            switch(args[i].unicode()) {
-            case '\\':
-                if (inString || inChar)
-                    i++;
+    if (define->argUsed.length()==0)
+        return define->formatValue;
+    QStringList argValues;
+    int i=0;
+    bool inString = false;
+    bool inChar = false;
+    int lastSplit=0;
+    int level=0;
+    while (i<args.length()) {
+        switch(args[i].unicode()) {
+        case '\\':
+            if (inString || inChar)
+                i++;
+        break;
+        case '(':
+        case '{':
+            if (!inString && !inChar)
+                level++;
             break;
-            case '(':
-            case '{':
-                if (!inString && !inChar)
-                    level++;
-                break;
-            case ')':
-            case '}':
-                if (!inString && !inChar)
-                    level--;
-                break;
-            case '"':
-                if (!inChar)
-                    inString = !inString;
+        case ')':
+        case '}':
+            if (!inString && !inChar)
+                level--;
             break;
-            case '\'':
-                if (!inString)
-                    inChar = !inChar;
-                break;
-            case ',':
-                if (!inString && !inChar && level == 0) {
-                    argValues.append(args.mid(lastSplit,i-lastSplit));
-                    lastSplit=i+1;
-                }
+        case '"':
+            if (!inChar)
+                inString = !inString;
+        break;
+        case '\'':
+            if (!inString)
+                inChar = !inChar;
             break;
+        case ',':
+            if (!inString && !inChar && level == 0) {
+                argValues.append(args.mid(lastSplit,i-lastSplit));
+                lastSplit=i+1;
             }
-            i++;
+        break;
         }
-        argValues.append(args.mid(lastSplit,i-lastSplit));
+        i++;
+    }
+    argValues.append(args.mid(lastSplit,i-lastSplit));
 #ifdef QT_DEBUG
-        if (
-                (define->varArgIndex==-1 && argValues.length() != define->argUsed.length())
-                || (define->varArgIndex!=-1 && argValues.length() < define->argUsed.length()-1)
-                ) {
-            qDebug()<<"*** Expand Macro error ***";
-            qDebug()<<"Macro: "<<define->name<<define->args;
-            qDebug()<<"Actual param: "<<args;
-            qDebug()<<"Params splitted: "<<argValues;
-            qDebug()<<"**********";
-        }
+    if (
+            (define->varArgIndex==-1 && argValues.length() != define->argUsed.length())
+            || (define->varArgIndex!=-1 && argValues.length() < define->argUsed.length()-1)
+            ) {
+        qDebug()<<"*** Expand Macro error ***";
+        qDebug()<<"Macro: "<<define->name<<define->args;
+        qDebug()<<"Actual param: "<<args;
+        qDebug()<<"Params splitted: "<<argValues;
+        qDebug()<<"**********";
+    }
 #endif
-        if (argValues.length() >= define->argUsed.length()
-                && argValues.length()>0) {
-            QStringList varArgs;
-            for (int i=0;i<argValues.length();i++) {
-                QString argValue = argValues[i];
-                if (define->varArgIndex != -1
-                     && i >= define->varArgIndex ) {
-                    if (!define->argNotExpand[define->varArgIndex])
-                        argValue = expandMacros(argValue,false,macrosToBeIgnored);
-                    varArgs.append(argValue.trimmed());
-                } else if (i<define->argUsed.length()
-                            && define->argUsed[i]) {                    
-                    if (!define->argNotExpand[i])
-                        argValue = expandMacros(argValue,false,macrosToBeIgnored);
-                    result=result.arg(argValue.trimmed());
-                }
-            }
-            if (!varArgs.isEmpty() && define->varArgIndex != -1) {
-                result=result.arg(varArgs.join(","));
-            }
+    if (argValues.length() < define->argUsed.length()) {
+        // can't be expanded
+        return define->formatValue;
+    }
+    QStringList values;
+    QStringList varArgs;
+    values.reserve(define->argUsed.length());
+    for (int i=0;i<argValues.length();i++) {
+        QString argValue = argValues[i];
+        if (define->varArgIndex != -1
+             && i >= define->varArgIndex ) {
+            if (!define->argNotExpand[define->varArgIndex])
+                argValue = expandMacros(argValue,false,macrosToBeIgnored);
+            varArgs.append(argValue.trimmed());
+        } else if (i<define->argUsed.length()) {
+            if (define->argUsed[i] && !define->argNotExpand[i])
+                argValue = expandMacros(argValue,false,macrosToBeIgnored);
+            values.append(argValue.trimmed());
+        }
+    }
+    if (define->varArgIndex != -1)
+        values.append(varArgs.join(","));
+
+    // fill the pre-tokenized body in one pass
+    QString result;
+    result.reserve(define->value.length()+args.length());
+    foreach (const DefineBodyPart& part, define->bodyParts) {
+        if (part.argIndex<0) {
+            result += part.text;
+        } else if (part.stringify) {
+            result += '"';
+            result += values[part.argIndex];
+            result += '"';
+        } else {
+            result += values[part.argIndex];
         }
     }
-    result.replace("%%","%");
-
     return result;
 }
 
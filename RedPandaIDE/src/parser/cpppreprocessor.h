@@ -152,8 +152,22 @@ private:
     QString getNextPreprocessor();
 
     QString expandMacros(QString text, bool handleBuffer);
-    QString expandMacros(QString text, bool handleBuffer, const QSet<QString> macrosToBeIgnored);
-    QString expandMacro(QString &text, const QString &word, int &i, bool handleBuffer, const QSet<QString> &macrosToBeIgnored, QSet<QString> &macrosUsed);
+    QString expandMacros(QString text, bool handleBuffer, const QSet<QString>& macrosToBeIgnored);
+    /**
+     * @brief expand the macro named by word
+     * @param text the text being expanded
+     * @param word the macro name
+     * @param i position after the word
+     * @param handleBuffer if args of the macro can be in the following lines of the buffer
+     * @param macrosToBeIgnored macros that can't be expanded in the whole text
+     * @param hideSet macros that can't be expanded in the rescanned text, keyed by the end of the text
+     * @param macrosUsed macros used by the expansion
+     * @return the expanded text, or word if it's not expanded
+     */
+    QString expandMacro(QString &text, const QString &word, int &i, bool handleBuffer,
+                        const QSet<QString> &macrosToBeIgnored,
+                        const QMultiHash<int,QString> &hideSet,
+                        QSet<QString> &macrosUsed);
 
     void handleDefine(const QString& tokens);
     void handleUndefine(const QString& tokens);
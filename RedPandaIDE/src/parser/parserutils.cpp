@@ -752,6 +752,13 @@ bool isTypeKind(StatementKind kind)
     }
 }
 
+void ParsedFileInfo::addReferences(const QHash<QString, QSet<int> > &references)
+{
+    for (auto it=references.begin();it!=references.end();++it) {
+        mReferences[it.key()].unite(it.value());
+    }
+}
+
 bool ParsedFileInfo::isLineVisible(int line) const
 {
     int lastI=-1;
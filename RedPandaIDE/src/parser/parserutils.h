@@ -16,6 +16,7 @@
  */
 #ifndef PARSER_UTILS_H
 #define PARSER_UTILS_H
+#include <QHash>
 #include <QMap>
 #include <QObject>
 #include <QSet>
@@ -49,6 +50,13 @@ struct CodeSnippet {
 using PCodeSnippet = std::shared_ptr<CodeSnippet>;
 
 // preprocess/ macro define
+// part of a function-like macro's body, tokenized when the macro is defined
+struct DefineBodyPart {
+    QString text; // literal text, empty if it's an argument
+    int argIndex; // index of the argument, or -1 if it's a literal text
+    bool stringify; // the argument is preceded by '#'
+};
+
 struct Define {
     QString name;
     QString args;
@@ -59,6 +67,7 @@ struct Define {
     QList<bool> argNotExpand;
     int varArgIndex;
     QString formatValue; // format template to format values
+    QList<DefineBodyPart> bodyParts; // pre-tokenized value, used to expand the macro
 };
 
 using PDefine = std::shared_ptr<Define>;
@@ -328,7 +337,7 @@ using PClassInheritanceInfo = std::shared_ptr<ClassInheritanceInfo>;
 
 class ParsedFileInfo {
 public:
-    ParsedFileInfo(const QString& fileName): mFileName {fileName} { }
+    ParsedFileInfo(const QString& fileName): mFileName {fileName}, mReferencesRecorded{false} { }
     ParsedFileInfo(const ParsedFileInfo&)=delete;
     ParsedFileInfo& operator=(const ParsedFileInfo&)=delete;
     void insertBranch(int level, bool branchTrue) { mBranches.insert(level, branchTrue); }
@@ -345,6 +354,8 @@ public:
     void addUsing(const QString &usingSymbol) { mUsings.insert(usingSymbol); }
     void addHandledInheritances(std::weak_ptr<ClassInheritanceInfo> classInheritanceInfo) { mHandledInheritances.append(classInheritanceInfo); }
     void clearHandledInheritances() { mHandledInheritances.clear(); }
+    void setReferencesRecorded(bool recorded) { mReferencesRecorded = recorded; }
+    void addReferences(const QHash<QString, QSet<int>> &references);
 
     QString fileName() const { return mFileName; }
     const StatementMap& statements() const { return mStatements; }
@@ -352,6 +363,8 @@ public:
     const QStringList& directIncludes() const { return mDirectIncludes; }
     const QSet<QString>& includes() const { return mIncludes; }
     const QList<std::weak_ptr<ClassInheritanceInfo> >& handledInheritances() const { return mHandledInheritances; }
+    bool referencesRecorded() const { return mReferencesRecorded; }
+    QSet<int> referenceLines(const QString &identifier) const { return mReferences.value(identifier); }
 
 private:
     QString mFileName;
@@ -362,6 +375,8 @@ private:
     CppScopes mScopes; // int is start line of the statement scope
     QMap<int,bool> mBranches;
     QList<std::weak_ptr<ClassInheritanceInfo>> mHandledInheritances;
+    bool mReferencesRecorded; // false for system headers and files not parsed
+    QHash<QString, QSet<int>> mReferences; // identifier -> lines where it appears
 };
 
 using PParsedFileInfo = std::shared_ptr<ParsedFileInfo>;
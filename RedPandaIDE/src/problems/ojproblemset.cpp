@@ -22,7 +22,8 @@ OJProblemCase::OJProblemCase(QObject *parent):
     QObject{parent},
     mModified{false},
     testState{ProblemCaseTestState::NotTested},
-    firstDiffLine{-1}
+    firstDiffLine{-1},
+    firstDiffColumn{-1}
 {
     QUuid uid = QUuid::createUuid();
     mId = uid.toString();
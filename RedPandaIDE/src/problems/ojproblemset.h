@@ -78,6 +78,7 @@ public:
     int outputLineCounts; // no persistence;
     int expectedLineCounts; // no persistence;
     int firstDiffLine; // no persistence
+    int firstDiffColumn; // no persistence, in the output line
 };
 
 using POJProblemCase = std::shared_ptr<OJProblemCase>;
@@ -15,6 +15,57 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "problemcasevalidator.h"
+#include <QFile>
+
+namespace {
+/**
+ * @brief Iterates the lines of a byte buffer without copying them.
+ *
+ * Lines are broken like QTextStream::readLine(), by "\n", "\r\n" or "\r",
+ * and a trailing line break doesn't start a new line.
+ */
+class LineReader {
+public:
+    LineReader(const char* begin, const char* end):
+        mPos{begin},
+        mEnd{end},
+        mLineCount{0} {}
+    bool next(const char*& lineBegin, const char*& lineEnd) {
+        if (mPos >= mEnd)
+            return false;
+        lineBegin = mPos;
+        while (mPos < mEnd && *mPos != '\n' && *mPos != '\r')
+            mPos++;
+        lineEnd = mPos;
+        if (mPos < mEnd) {
+            if (*mPos == '\r' && mPos + 1 < mEnd && mPos[1] == '\n')
+                mPos++;
+            mPos++;
+        }
+        mLineCount++;
+        return true;
+    }
+    int lineCount() const { return mLineCount; }
+private:
+    const char* mPos;
+    const char* mEnd;
+    int mLineCount;
+};
+
+inline bool isSpaceChar(char ch) {
+    return ch == ' ' || ch == '\t' || ch == '\v' || ch == '\f';
+}
+
+// files saved by some editors start with an UTF-8 BOM
+inline const char* skipUtf8Bom(const char* begin, const char* end) {
+    if (end - begin >= 3
+            && static_cast<unsigned char>(begin[0]) == 0xEF
+            && static_cast<unsigned char>(begin[1]) == 0xBB
+            && static_cast<unsigned char>(begin[2]) == 0xBF)
+        return begin + 3;
+    return begin;
+}
+}
 
 ProblemCaseValidator::ProblemCaseValidator()
 {
@@ -25,85 +76,149 @@ bool ProblemCaseValidator::validate(POJProblemCase problemCase, ProblemCaseValid
 {
     if (!problemCase)
         return false;
-    QStringList output = textToLines(problemCase->output);
-    QStringList expected;
-    if (fileExists(problemCase->expectedOutputFileName()))
-        expected = readFileToLines(problemCase->expectedOutputFileName());
-    else
-        expected = textToLines(problemCase->expected());
-    problemCase->outputLineCounts = output.count();
-    problemCase->expectedLineCounts = expected.count();
-    if (expected.count() > 5000) {
-        if (output.count()<expected.count()) {
-            problemCase->firstDiffLine=output.count();
-            return false;
-        }  else if (output.count()>expected.count()) {
-            problemCase->firstDiffLine=expected.count();
-            return false;
+    problemCase->firstDiffLine = -1;
+    problemCase->firstDiffColumn = -1;
+    QByteArray expectedContent;
+    const char* expected = nullptr;
+    qint64 expectedSize = 0;
+    QFile expectedFile(problemCase->expectedOutputFileName());
+    if (fileExists(problemCase->expectedOutputFileName())) {
+        if (expectedFile.open(QFile::ReadOnly) && expectedFile.size() > 0) {
+            expectedSize = expectedFile.size();
+            expected = reinterpret_cast<const char*>(expectedFile.map(0, expectedSize));
+            if (!expected) {
+                expectedContent = expectedFile.readAll();
+                expected = expectedContent.constData();
+                expectedSize = expectedContent.size();
+            }
+        }
+    } else {
+        expectedContent = problemCase->expected().toUtf8();
+        expected = expectedContent.constData();
+        expectedSize = expectedContent.size();
+    }
+    const char* expectedEnd = expected + expectedSize;
+    expected = skipUtf8Bom(expected, expectedEnd);
+
+    // the output is decoded from the local encoding by the runner,
+    // so it can be compared with an expected file in that encoding
+    bool utf8 = isValidUtf8(expected, expectedEnd);
+    QByteArray output = utf8 ? problemCase->output.toUtf8()
+                             : TextEncoder::encoderForSystem().encodeUnchecked(problemCase->output);
+
+    const char* outputEnd = output.constData() + output.size();
+    LineReader outputReader(skipUtf8Bom(output.constData(), outputEnd), outputEnd);
+    LineReader expectedReader(expected, expectedEnd);
+    const char* outputLine;
+    const char* outputLineEnd;
+    const char* expectedLine;
+    const char* expectedLineEnd;
+    while (true) {
+        bool hasOutputLine = outputReader.next(outputLine, outputLineEnd);
+        bool hasExpectedLine = expectedReader.next(expectedLine, expectedLineEnd);
+        if (!hasOutputLine && !hasExpectedLine)
+            break;
+        if (!hasOutputLine || !hasExpectedLine) {
+            problemCase->firstDiffLine = std::min(outputReader.lineCount(), expectedReader.lineCount());
+            problemCase->firstDiffColumn = 0;
+            break;
+        }
+        int column = compareLines(outputLine, outputLineEnd, expectedLine, expectedLineEnd, type);
+        if (column >= 0) {
+            problemCase->firstDiffLine = outputReader.lineCount() - 1;
+            QByteArray prefix = QByteArray::fromRawData(outputLine, column);
+            problemCase->firstDiffColumn = utf8 ? QString::fromUtf8(prefix).length()
+                                                : TextDecoder::decoderForSystem().decodeUnchecked(prefix).length();
+            break;
         }
     }
-    int count=std::min(output.count(), expected.count());
+    // only count the rest
+    while (outputReader.next(outputLine, outputLineEnd));
+    while (expectedReader.next(expectedLine, expectedLineEnd));
+    problemCase->outputLineCounts = outputReader.lineCount();
+    problemCase->expectedLineCounts = expectedReader.lineCount();
+    return problemCase->firstDiffLine == -1;
+}
+
+int ProblemCaseValidator::compareLines(const char *line1, const char *line1End, const char *line2, const char *line2End, ProblemCaseValidateType type)
+{
+    const char* p1 = line1;
+    const char* p2 = line2;
     switch(type) {
     case ProblemCaseValidateType::Exact:
-        for (int i=0;i<count;i++) {
-            if (output[i]!=expected[i]) {
-                problemCase->firstDiffLine = i;
-                return false;
-            }
+        while (p1 < line1End && p2 < line2End && *p1 == *p2) {
+            p1++;
+            p2++;
         }
-        break;
+        if (p1 == line1End && p2 == line2End)
+            return -1;
+        return p1 - line1;
     case ProblemCaseValidateType::IgnoreLeadingTrailingSpaces:
-        for (int i=0;i<count;i++) {
-            if (output[i].trimmed()!=expected[i].trimmed()) {
-                problemCase->firstDiffLine = i;
-                return false;
-            }
+        while (p1 < line1End && isSpaceChar(*p1))
+            p1++;
+        while (p2 < line2End && isSpaceChar(*p2))
+            p2++;
+        while (line1End > p1 && isSpaceChar(line1End[-1]))
+            line1End--;
+        while (line2End > p2 && isSpaceChar(line2End[-1]))
+            line2End--;
+        while (p1 < line1End && p2 < line2End && *p1 == *p2) {
+            p1++;
+            p2++;
         }
-        break;
+        if (p1 == line1End && p2 == line2End)
+            return -1;
+        return p1 - line1;
     case ProblemCaseValidateType::IgnoreSpaces:
-        for (int i=0;i<count;i++) {
-            if (!equalIgnoringSpaces(output[i],expected[i])) {
-                problemCase->firstDiffLine = i;
-                return false;
+        // compare word by word
+        while (true) {
+            while (p1 < line1End && isSpaceChar(*p1))
+                p1++;
+            while (p2 < line2End && isSpaceChar(*p2))
+                p2++;
+            if (p1 == line1End && p2 == line2End)
+                return -1;
+            const char* word1 = p1;
+            while (p1 < line1End && p2 < line2End
+                   && !isSpaceChar(*p1) && *p1 == *p2) {
+                p1++;
+                p2++;
             }
+            bool word1Ended = (p1 == line1End || isSpaceChar(*p1));
+            bool word2Ended = (p2 == line2End || isSpaceChar(*p2));
+            if (!word1Ended || !word2Ended)
+                return word1 - line1;
         }
-        break;
     }
-    if (output.count()<expected.count()) {
-        problemCase->firstDiffLine=output.count();
-        return false;
-    }  else if (output.count()>expected.count()) {
-        problemCase->firstDiffLine=expected.count();
-        return false;
-    }
-    return true;
+    return -1;
 }
 
-bool ProblemCaseValidator::equalIgnoringSpaces(const QString &s1, const QString &s2)
+bool ProblemCaseValidator::isValidUtf8(const char *p, const char *end)
 {
-    QStringList strList1=split(s1);
-    QStringList strList2=split(s2);
-    return (strList1==strList2);
-}
-
-QStringList ProblemCaseValidator::split(const QString &s)
-{
-    QStringList result;
-    const QChar* p = getNullTerminatedStringData(s);
-    const QChar* start = p;
-    while (p->unicode()!=0) {
-        if (p->isSpace()) {
-            if (!start->isSpace()) {
-                result.append(QString(start,p-start));
-            }
-            start = p;
-        } else if (start->isSpace()) {
-            start = p;
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(p);
+    const unsigned char* e = reinterpret_cast<const unsigned char*>(end);
+    while (s < e) {
+        unsigned char ch = *s;
+        int count;
+        if (ch < 0x80) {
+            s++;
+            continue;
+        } else if ((ch & 0xE0) == 0xC0) {
+            count = 1;
+        } else if ((ch & 0xF0) == 0xE0) {
+            count = 2;
+        } else if ((ch & 0xF8) == 0xF0) {
+            count = 3;
+        } else {
+            return false;
         }
-        p++;
-    }
-    if (!start->isSpace()) {
-        result.append(QString(start,p-start));
+        if (e - s <= count)
+            return false;
+        for (int i = 1; i <= count; i++) {
+            if ((s[i] & 0xC0) != 0x80)
+                return false;
+        }
+        s += count + 1;
     }
-    return result;
+    return true;
 }
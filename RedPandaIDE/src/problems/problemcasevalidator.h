@@ -20,14 +20,26 @@
 #include "ojproblemset.h"
 #include "../utils.h"
 
+/**
+ * @brief Compares the output of a problem case with the expected output.
+ *
+ * Both sides are walked as byte streams, line by line, so huge outputs
+ * are never split into line lists. The expected output file is memory mapped.
+ */
 class ProblemCaseValidator
 {
 public:
     ProblemCaseValidator();
     bool validate(POJProblemCase problemCase, ProblemCaseValidateType type);
 private:
-    bool equalIgnoringSpaces(const QString& s1, const QString& s2);
-    QStringList split(const QString& s);
+    /**
+     * @brief compare two lines
+     * @return the offset of the first difference in line1, or -1 if they are equal
+     */
+    int compareLines(const char* line1, const char* line1End,
+                     const char* line2, const char* line2End,
+                     ProblemCaseValidateType type);
+    static bool isValidUtf8(const char* p, const char* end);
 };
 
 #endif // PROBLEMCASEVALIDATOR_H
@@ -1213,6 +1213,8 @@ void Project::saveOptions()
     ini.SetLongValue("Project","ClassBrowserType", (int)mOptions.classBrowserType);
     ini.SetBoolValue("Project","AllowParallelBuilding",mOptions.allowParallelBuilding);
     ini.SetLongValue("Project","ParellelBuildingJobs",mOptions.parellelBuildingJobs);
+    ini.SetBoolValue("Project","ReportBuildTiming",mOptions.reportBuildTiming);
+    ini.SetBoolValue("Project","WriteBuildTrace",mOptions.writeBuildTrace);
 
 
     //for Red Panda Dev C++ 6 compatibility
@@ -2102,6 +2104,8 @@ void Project::loadOptions(SimpleIni& ini)
 
         mOptions.allowParallelBuilding = ini.GetBoolValue("Project","AllowParallelBuilding");
         mOptions.parellelBuildingJobs = ini.GetLongValue("Project","ParellelBuildingJobs");
+        mOptions.reportBuildTiming = ini.GetBoolValue("Project","ReportBuildTiming");
+        mOptions.writeBuildTrace = ini.GetBoolValue("Project","WriteBuildTrace");
 
 
         mOptions.versionInfo.major = ini.GetLongValue("VersionInfo", "Major", 0);
@@ -2497,6 +2501,18 @@ ProjectModel::ProjectModel(IconsManager * iconsManager, Project *project):
     //delete in the destructor
     mIconsManager = iconsManager;
     mIconProvider = std::make_unique<CustomFileIconProvider>(iconsManager);
+#ifdef ENABLE_VCS
+    // the status is read in background
+    connect(mIconProvider->VCSRepository(), &GitRepository::statusUpdated,
+            this, [this](){
+        if (mUpdateCount>0 || !mProject->rootNode())
+            return;
+        QModelIndex rootIndex = getNodeIndex(mProject->rootNode().get());
+        // the branch is shown in the root node's text
+        emit dataChanged(rootIndex, rootIndex);
+        refreshNodeIconRecursive(mProject->rootNode());
+    });
+#endif
 }
 
 void ProjectModel::beginUpdate()
@@ -57,4 +57,6 @@ ProjectOptions::ProjectOptions()
     execEncoding = ENCODING_SYSTEM_DEFAULT;
     allowParallelBuilding=false;
     parellelBuildingJobs=0;
+    reportBuildTiming=false;
+    writeBuildTrace=false;
 }
@@ -101,5 +101,7 @@ struct ProjectOptions{
     ProjectClassBrowserType classBrowserType;
     bool allowParallelBuilding;
     int parellelBuildingJobs;
+    bool reportBuildTiming;
+    bool writeBuildTrace;
 };
 #endif // PROJECTOPTIONS_H
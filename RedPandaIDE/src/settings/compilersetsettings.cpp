@@ -18,6 +18,7 @@
 #include "../utils.h"
 #include "../settings.h"
 #include "../systemconsts.h"
+#include "../compiler/compilerprobecache.h"
 #include "../utils/escape.h"
 #include "../utils/os.h"
 #include "../utils/parsearg.h"
@@ -28,6 +29,10 @@
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QCoreApplication>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
 #include "src/addon/luaexecutor.h"
 #include "src/addon/luaruntime.h"
 
@@ -89,6 +94,8 @@ CompilerSet::CompilerSet():
     mStaticLink{false},
     mPersistInAutoFind{false},
     mForceEnglishOutput{false},
+    mUseCompilerCache{false},
+    mUseJsonDiagnostics{false},
     mPreprocessingSuffix{DEFAULT_PREPROCESSING_SUFFIX},
     mCompilationProperSuffix{DEFAULT_COMPILATION_SUFFIX},
     mAssemblingSuffix{DEFAULT_ASSEMBLING_SUFFIX},
@@ -112,6 +119,8 @@ CompilerSet::CompilerSet(const QString& compilerFolder, const QString& c_prog):
     mStaticLink{true},
     mPersistInAutoFind{false},
     mForceEnglishOutput{false},
+    mUseCompilerCache{false},
+    mUseJsonDiagnostics{false},
     mPreprocessingSuffix{DEFAULT_PREPROCESSING_SUFFIX},
     mCompilationProperSuffix{DEFAULT_COMPILATION_SUFFIX},
     mAssemblingSuffix{DEFAULT_ASSEMBLING_SUFFIX},
@@ -186,6 +195,8 @@ CompilerSet::CompilerSet(const CompilerSet &set):
     mStaticLink{set.mStaticLink},
     mPersistInAutoFind{set.mPersistInAutoFind},
     mForceEnglishOutput{set.mForceEnglishOutput},
+    mUseCompilerCache{set.mUseCompilerCache},
+    mUseJsonDiagnostics{set.mUseJsonDiagnostics},
 
     mPreprocessingSuffix{set.mPreprocessingSuffix},
     mCompilationProperSuffix{set.mCompilationProperSuffix},
@@ -240,6 +251,8 @@ CompilerSet::CompilerSet(const QJsonObject &set) :
     mStaticLink{set["staticLink"].toBool()},
     mPersistInAutoFind{false},
     mForceEnglishOutput{false},
+    mUseCompilerCache{false},
+    mUseJsonDiagnostics{false},
 
     mPreprocessingSuffix{set["preprocessingSuffix"].toString()},
     mCompilationProperSuffix{set["compilationProperSuffix"].toString()},
@@ -1338,20 +1351,27 @@ void CompilerSet::setIniOptions(const QByteArray &value)
 
 static QByteArray getCompilerOutput(const QString &binDir, const QString &binFile, const QStringList &arguments)
 {
+    QString compiler = getFilePath(binDir, binFile);
+    QByteArray cached;
+    if (CompilerProbeCache::instance().find(compiler, arguments, cached))
+        return cached;
     QProcessEnvironment env;
     env.insert("LANGUAGE","");
     env.insert("LC_ALL", "C");
     QString path = binDir;
     env.insert("PATH",path);
     auto [result, _, errorMessage] = runAndGetOutput(
-                getFilePath(binDir, binFile),
+                compiler,
                 binDir,
                 arguments,
                 QByteArray(),
                 false,
                 false,
                 env);
-    return result.trimmed();
+    result = result.trimmed();
+    if (errorMessage.isEmpty())
+        CompilerProbeCache::instance().insert(compiler, arguments, result);
+    return result;
 }
 
 bool CompilerSet::forceEnglishOutput() const
@@ -1364,6 +1384,50 @@ void CompilerSet::setForceEnglishOutput(bool newForceEnglishOutput)
     mForceEnglishOutput = newForceEnglishOutput;
 }
 
+bool CompilerSet::useCompilerCache() const
+{
+    return mUseCompilerCache;
+}
+
+void CompilerSet::setUseCompilerCache(bool newUseCompilerCache)
+{
+    mUseCompilerCache = newUseCompilerCache;
+}
+
+QString CompilerSet::compilerCacheProgram() const
+{
+    if (!mUseCompilerCache)
+        return QString();
+    if (mCompilerType != CompilerType::GCC && mCompilerType != CompilerType::Clang)
+        return QString();
+    foreach (const QString& name, QStringList({"ccache", "sccache"})) {
+        QString path = QStandardPaths::findExecutable(name, mBinDirs);
+        if (path.isEmpty())
+            path = QStandardPaths::findExecutable(name);
+        if (!path.isEmpty())
+            return path;
+    }
+    return QString();
+}
+
+bool CompilerSet::useJsonDiagnostics() const
+{
+    return mUseJsonDiagnostics;
+}
+
+void CompilerSet::setUseJsonDiagnostics(bool newUseJsonDiagnostics)
+{
+    mUseJsonDiagnostics = newUseJsonDiagnostics;
+}
+
+bool CompilerSet::supportJsonDiagnostics() const
+{
+    // -fdiagnostics-format=json is added in gcc 9
+    if (mCompilerType != CompilerType::GCC)
+        return false;
+    return mVersion.section('.', 0, 0).toInt() >= 9;
+}
+
 bool CompilerSet::persistInAutoFind() const
 {
     return mPersistInAutoFind;
@@ -1600,20 +1664,19 @@ CompilerSets::CompilerSets(SettingsPersistor *persistor, DirSettings *dirSetting
     Q_ASSERT(mDirSettings!=nullptr);
     Q_ASSERT(mPersistor!=nullptr);
     prepareCompatibleIndex();
+    CompilerProbeCache::instance().setFilename(
+                includeTrailingPathDelimiter(mDirSettings->config()) + DEV_COMPILER_PROBE_CACHE_FILE);
 }
 
-PCompilerSet CompilerSets::addSet()
+CompilerSets::~CompilerSets()
 {
-    PCompilerSet p=std::make_shared<CompilerSet>();
-    mList.push_back(p);
-    return p;
+    // keep the defines probed for the parser
+    CompilerProbeCache::instance().save();
 }
 
-PCompilerSet CompilerSets::addSet(const QString &folder, const QString& c_prog)
+PCompilerSet CompilerSets::addSet()
 {
-    PCompilerSet p=std::make_shared<CompilerSet>(folder,c_prog);
-    if (c_prog==GCC_PROGRAM && p->compilerType()==CompilerType::Clang)
-        return PCompilerSet();
+    PCompilerSet p=std::make_shared<CompilerSet>();
     mList.push_back(p);
     return p;
 }
@@ -1698,13 +1761,29 @@ bool elfToolchainHasDynamicLibc(const QString &folder, const QString &c_prog)
 }
 
 bool CompilerSets::addSets(const QString &folder, const QString& c_prog) {
+    if (containsSets(folder, c_prog))
+        return false;
+    return addSets(folder, c_prog, std::make_shared<CompilerSet>(folder,c_prog));
+}
+
+bool CompilerSets::containsSets(const QString &folder, const QString &c_prog) const
+{
     for (const PCompilerSet& set:mList) {
         if (set->binDirs().contains(folder) && extractFileName(set->CCompiler())==c_prog)
-            return false;
+            return true;
     }
+    return false;
+}
+
+bool CompilerSets::addSets(const QString &folder, const QString &c_prog, const PCompilerSet &baseSet)
+{
+    if (containsSets(folder, c_prog))
+        return false;
+    if (c_prog==GCC_PROGRAM && baseSet->compilerType()==CompilerType::Clang)
+        return false;
     // Default, release profile
-    PCompilerSet baseSet = addSet(folder,c_prog);
-    if (!baseSet || baseSet->name().isEmpty())
+    mList.push_back(baseSet);
+    if (baseSet->name().isEmpty())
         return false;
     QString sanitizerType;
 #if ENABLE_SDCC
@@ -1881,19 +1960,12 @@ void CompilerSets::findSets(bool showProgress)
             libexecBins.append(binPath);
     }
     pathList = libexecBins + pathList;
-    QProgressDialog progressDlg{
-                QObject::tr("Searching for compilers..."),
-                QObject::tr("Abort"),
-                0,
-                1,
-                };
-    if (showProgress) {
-        progressDlg.setMinimumDuration(500);
-        progressDlg.setWindowModality(Qt::WindowModal);
-        progressDlg.setLabelText(QObject::tr("Searching..."));
-        progressDlg.setMaximum(pathList.count());
-        progressDlg.show();
-    }
+
+    struct Candidate {
+        QString folder;
+        QString program;
+    };
+    QList<Candidate> candidates;
     QString folder, canonicalFolder;
     for (int i=pathList.count()-1;i>=0;i--) {
         folder = QDir(pathList[i]).absolutePath();
@@ -1908,18 +1980,67 @@ void CompilerSets::findSets(bool showProgress)
         //   /opt/gcc-13 -> /opt/gcc-13.1.0
         // after upgrade:
         //   /opt/gcc-13 -> /opt/gcc-13.2.0
-        addSets(folder);
-        if (showProgress) {
-            int idx = pathList.count()-i;
+        if (fileExists(folder, GCC_PROGRAM))
+            candidates.append({folder, GCC_PROGRAM});
+        if (fileExists(folder, CLANG_PROGRAM))
+            candidates.append({folder, CLANG_PROGRAM});
+#ifdef ENABLE_SDCC
+        if (fileExists(folder, SDCC_PROGRAM))
+            candidates.append({folder, SDCC_PROGRAM});
+#endif
+    }
+
+    // Probing a compiler runs it several times, so compilers are probed in parallel.
+    // The sets are added in the searching order afterwards.
+    std::vector<PCompilerSet> probedSets(candidates.count());
+    std::atomic<int> probedCount{0};
+    // it's lazily created and not thread safe
+    CompilerInfoManager::getInstance();
+    QThreadPool pool;
+    pool.setMaxThreadCount(QThread::idealThreadCount());
+    for (int i=0;i<candidates.count();i++) {
+        pool.start(QRunnable::create([&candidates, &probedSets, &probedCount, i](){
+            const Candidate& candidate = candidates[i];
+            PCompilerSet set = std::make_shared<CompilerSet>(candidate.folder, candidate.program);
+            // outputs are cached, so addSets() won't run these probes again
+            if (set->target() == "x86_64")
+                set->x86MultilibList(candidate.folder, candidate.program);
+            if (set->dumpMachine().contains("-linux-"))
+                elfToolchainHasDynamicLibc(candidate.folder, candidate.program);
+            probedSets[i] = set;
+            probedCount++;
+        }));
+    }
+    QProgressDialog progressDlg{
+                QObject::tr("Searching for compilers..."),
+                QObject::tr("Abort"),
+                0,
+                1,
+                };
+    if (showProgress) {
+        progressDlg.setMinimumDuration(500);
+        progressDlg.setWindowModality(Qt::WindowModal);
+        progressDlg.setLabelText(QObject::tr("Searching..."));
+        progressDlg.setMaximum(std::max(1, (int)candidates.count()));
+        progressDlg.show();
+        while (!pool.waitForDone(50)) {
+            int idx = probedCount;
             progressDlg.setValue(idx);
-            progressDlg.setLabelText(QObject::tr("Searching %1/%2").arg(idx).arg(pathList.count()));
+            progressDlg.setLabelText(QObject::tr("Searching %1/%2").arg(idx).arg(candidates.count()));
             QCoreApplication::processEvents();
-            if (progressDlg.wasCanceled())
-                break;
+            if (progressDlg.wasCanceled()) {
+                // drop the compilers not probed yet
+                pool.clear();
+            }
         }
-    }
-    if (showProgress)
         progressDlg.hide();
+    }
+    pool.waitForDone();
+    for (int i=0;i<candidates.count();i++) {
+        if (probedSets[i])
+            addSets(candidates[i].folder, candidates[i].program, probedSets[i]);
+    }
+    CompilerProbeCache::instance().save();
 #ifdef ENABLE_LUA_ADDON
     if (
         // note that array index starts from 1 in Lua
@@ -2164,6 +2285,8 @@ void CompilerSets::saveSet(int index)
     mPersistor->saveValue("ExecCharset", pSet->execCharset());
     mPersistor->saveValue("PersistInAutoFind", pSet->persistInAutoFind());
     mPersistor->saveValue("forceEnglishOutput", pSet->forceEnglishOutput());
+    mPersistor->saveValue("useCompilerCache", pSet->useCompilerCache());
+    mPersistor->saveValue("useJsonDiagnostics", pSet->useJsonDiagnostics());
 
     mPersistor->saveValue("preprocessingSuffix", pSet->preprocessingSuffix());
     mPersistor->saveValue("compilationProperSuffix", pSet->compilationProperSuffix());
@@ -2264,6 +2387,8 @@ PCompilerSet CompilerSets::loadSet(int index)
     pSet->setPersistInAutoFind(mPersistor->value("PersistInAutoFind", false).toBool());
     bool forceEnglishOutput=QLocale::system().name().startsWith("zh")?false:true;
     pSet->setForceEnglishOutput(mPersistor->value("forceEnglishOutput", forceEnglishOutput).toBool());
+    pSet->setUseCompilerCache(mPersistor->value("useCompilerCache", false).toBool());
+    pSet->setUseJsonDiagnostics(mPersistor->value("useJsonDiagnostics", false).toBool());
 
     pSet->setExecCharset(mPersistor->value("ExecCharset", ENCODING_SYSTEM_DEFAULT).toString());
     if (pSet->execCharset().isEmpty()) {
@@ -164,6 +164,18 @@ public:
     bool forceEnglishOutput() const;
     void setForceEnglishOutput(bool newForceEnglishOutput);
 
+    bool useCompilerCache() const;
+    void setUseCompilerCache(bool newUseCompilerCache);
+    /**
+     * @brief ccache or sccache found in bin dirs or PATH
+     * @return empty if not used or not found
+     */
+    QString compilerCacheProgram() const;
+
+    bool useJsonDiagnostics() const;
+    void setUseJsonDiagnostics(bool newUseJsonDiagnostics);
+    bool supportJsonDiagnostics() const;
+
 private:
     void setGCCProperties(const QString& binDir, const QString& c_prog);
     void setDirectories(const QString& binDir);
@@ -213,6 +225,8 @@ private:
     bool mStaticLink;
     bool mPersistInAutoFind;
     bool mForceEnglishOutput;
+    bool mUseCompilerCache;
+    bool mUseJsonDiagnostics;
 
     QString mPreprocessingSuffix;
     QString mCompilationProperSuffix;
@@ -245,6 +259,7 @@ typedef std::vector<PCompilerSet> CompilerSetList;
 class CompilerSets {
 public:
     explicit CompilerSets(SettingsPersistor* settings, DirSettings *dirSettings);
+    ~CompilerSets();
     PCompilerSet addSet();
     PCompilerSet addSet(const PCompilerSet &pSet);
     bool addSets(const QString& folder);
@@ -266,8 +281,10 @@ public:
     static QString getKeyFromCompilerCompatibleIndex(int idx);
     static bool isTarget64Bit(const QString &target);
 private:
-    PCompilerSet addSet(const QString& folder, const QString& c_prog);
     PCompilerSet addSet(const QJsonObject &set);
+    bool containsSets(const QString& folder, const QString& c_prog) const;
+    // add the sets of a compiler that is already probed
+    bool addSets(const QString& folder, const QString& c_prog, const PCompilerSet& baseSet);
     void savePath(const QString& name, const QString& path);
     void savePathList(const QString& name, const QStringList& pathList);
 
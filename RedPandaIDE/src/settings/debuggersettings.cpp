@@ -173,6 +173,16 @@ void DebuggerSettings::setCharacters(int newCharacters)
     mCharacters = newCharacters;
 }
 
+bool DebuggerSettings::useDebugAdapter() const
+{
+    return mUseDebugAdapter;
+}
+
+void DebuggerSettings::setUseDebugAdapter(bool newUseDebugAdapter)
+{
+    mUseDebugAdapter = newUseDebugAdapter;
+}
+
 bool DebuggerSettings::useIntelStyle() const
 {
     return mUseIntelStyle;
@@ -223,6 +233,7 @@ void DebuggerSettings::doSave()
     saveValue("memory_view_columns",mMemoryViewColumns);
     saveValue("array_elements",mArrayElements);
     saveValue("string_characters",mCharacters);
+    saveValue("use_debug_adapter",mUseDebugAdapter);
 }
 
 void DebuggerSettings::doLoad()
@@ -249,4 +260,5 @@ void DebuggerSettings::doLoad()
     mMemoryViewColumns = intValue("memory_view_columns",16);
     mArrayElements = intValue("array_elements",100);
     mCharacters = intValue("string_characters",300);
+    mUseDebugAdapter = boolValue("use_debug_adapter",false);
 }
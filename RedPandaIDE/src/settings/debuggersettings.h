@@ -74,6 +74,9 @@ public:
     int characters() const;
     void setCharacters(int newCharacters);
 
+    bool useDebugAdapter() const;
+    void setUseDebugAdapter(bool newUseDebugAdapter);
+
 private:
     bool mEnableDebugConsole;
     bool mShowDetailLog;
@@ -93,6 +96,7 @@ private:
     int mMemoryViewColumns;
     int mArrayElements;
     int mCharacters;
+    bool mUseDebugAdapter;
 
     // _Base interface
 protected:
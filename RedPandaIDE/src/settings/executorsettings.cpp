@@ -16,6 +16,7 @@
  */
 #include "executorsettings.h"
 #include "../utils/font.h"
+#include <QThread>
 
 ExecutorSettings::ExecutorSettings(SettingsPersistor *persistor):
     BaseSettings{persistor, SETTING_EXECUTOR}
@@ -250,6 +251,7 @@ void ExecutorSettings::doSave()
     remove("case_timeout");
     saveValue("enable_case_limit", mEnableCaseLimit);
     saveValue("case_max_input_file_size",mMaxCaseInputFileSize);
+    saveValue("case_parallel_jobs",mCaseParallelJobs);
 }
 
 bool ExecutorSettings::pauseConsole() const
@@ -295,4 +297,16 @@ void ExecutorSettings::doLoad()
     mEnableCaseLimit = boolValue("enable_case_limit", true);
 
     mMaxCaseInputFileSize = uintValue("case_max_input_file_size", 4); //4mb
+    // leave a core for the IDE
+    mCaseParallelJobs = intValue("case_parallel_jobs", std::max(1, QThread::idealThreadCount()-1));
+}
+
+int ExecutorSettings::caseParallelJobs() const
+{
+    return mCaseParallelJobs;
+}
+
+void ExecutorSettings::setCaseParallelJobs(int newCaseParallelJobs)
+{
+    mCaseParallelJobs = newCaseParallelJobs;
 }
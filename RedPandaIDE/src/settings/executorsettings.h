@@ -84,6 +84,9 @@ public:
     qint64 maxCaseInputFileSize() const;
     void setMaxCaseInputFileSize(qint64 newMaxCaseInputFileSize);
 
+    int caseParallelJobs() const;
+    void setCaseParallelJobs(int newCaseParallelJobs);
+
 private:
     // general
     bool mPauseConsole;
@@ -110,6 +113,7 @@ private:
     qulonglong mCaseTimeout; //ms
     qulonglong mCaseMemoryLimit; //kb
     qint64 mMaxCaseInputFileSize; // mb
+    int mCaseParallelJobs; // cases run at the same time
 
 protected:
     void doSave() override;
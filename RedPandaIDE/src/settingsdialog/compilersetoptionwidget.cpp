@@ -93,6 +93,14 @@ static void loadCompilerSetSettings(PCompilerSet pSet, Ui::CompilerSetOptionWidg
     ui->chkStaticLink->setEnabled(supportStaticLink);
     ui->chkStaticLink->setVisible(supportStaticLink);
 
+    bool supportCompilerCache = pSet->compilerType() == CompilerType::GCC
+            || pSet->compilerType() == CompilerType::Clang;
+    ui->chkUseCompilerCache->setEnabled(supportCompilerCache);
+    ui->chkUseCompilerCache->setVisible(supportCompilerCache);
+
+    ui->chkUseJsonDiagnostics->setEnabled(pSet->supportJsonDiagnostics());
+    ui->chkUseJsonDiagnostics->setVisible(pSet->supportJsonDiagnostics());
+
     ui->chkUseCustomCompilerParams->setChecked(pSet->useCustomCompileParams());
     ui->txtCustomCompileParams->setPlainText(pSet->customCompileParams());
     ui->txtCustomCompileParams->setEnabled(pSet->useCustomCompileParams());
@@ -103,6 +111,8 @@ static void loadCompilerSetSettings(PCompilerSet pSet, Ui::CompilerSetOptionWidg
     ui->chkStaticLink->setChecked(pSet->staticLink());
     ui->chkPersistInAutoFind->setChecked(pSet->persistInAutoFind());
     ui->chkForceEnglishOutput->setChecked(pSet->forceEnglishOutput());
+    ui->chkUseCompilerCache->setChecked(pSet->useCompilerCache());
+    ui->chkUseJsonDiagnostics->setChecked(pSet->useJsonDiagnostics());
     //rest tabs in the options widget
 
     ui->optionTabs->resetUI(pSet,pSet->compileOptions());
@@ -257,6 +267,8 @@ void CompilerSetOptionWidget::saveCurrentCompilerSet()
     pSet->setStaticLink(ui->chkStaticLink->isChecked());
     pSet->setPersistInAutoFind(ui->chkPersistInAutoFind->isChecked());
     pSet->setForceEnglishOutput(ui->chkForceEnglishOutput->isChecked());
+    pSet->setUseCompilerCache(ui->chkUseCompilerCache->isChecked());
+    pSet->setUseJsonDiagnostics(ui->chkUseJsonDiagnostics->isChecked());
 
 
     pSet->setCCompiler(ui->txtCCompiler->text().trimmed());
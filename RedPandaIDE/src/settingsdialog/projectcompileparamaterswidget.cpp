@@ -56,6 +56,8 @@ void ProjectCompileParamatersWidget::doLoad()
     ui->txtResource->setPlainText(pMainWindow->project()->options().resourceCmd);
     ui->grpAllowParallelBuilding->setChecked(pMainWindow->project()->options().allowParallelBuilding);
     ui->spinParallelJobs->setValue(pMainWindow->project()->options().parellelBuildingJobs);
+    ui->grpReportBuildTiming->setChecked(pMainWindow->project()->options().reportBuildTiming);
+    ui->chkWriteBuildTrace->setChecked(pMainWindow->project()->options().writeBuildTrace);
 }
 
 void ProjectCompileParamatersWidget::doSave()
@@ -66,6 +68,8 @@ void ProjectCompileParamatersWidget::doSave()
     pMainWindow->project()->options().resourceCmd = ui->txtResource->toPlainText();
     pMainWindow->project()->options().allowParallelBuilding = ui->grpAllowParallelBuilding->isChecked();
     pMainWindow->project()->options().parellelBuildingJobs = ui->spinParallelJobs->value();
+    pMainWindow->project()->options().reportBuildTiming = ui->grpReportBuildTiming->isChecked();
+    pMainWindow->project()->options().writeBuildTrace = ui->chkWriteBuildTrace->isChecked();
     pMainWindow->project()->saveOptions();
 }
 
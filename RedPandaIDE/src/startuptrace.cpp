@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "startuptrace.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <stdio.h>
+
+static bool traceEnabled = false;
+static QString traceFilename;
+static QElapsedTimer traceTimer;
+static QList<StartupTraceEvent> traceEvents;
+
+static qint64 elapsedUsecs()
+{
+    return traceTimer.nsecsElapsed() / 1000;
+}
+
+StartupTrace::Span::Span(const QString &name):
+    mName{name},
+    mStart{traceEnabled ? elapsedUsecs() : 0},
+    mEnded{false}
+{
+}
+
+StartupTrace::Span::~Span()
+{
+    end();
+}
+
+void StartupTrace::Span::end()
+{
+    if (mEnded)
+        return;
+    mEnded = true;
+    if (!traceEnabled)
+        return;
+    StartupTraceEvent event;
+    event.name = mName;
+    event.start = mStart;
+    event.duration = elapsedUsecs() - mStart;
+    traceEvents.append(event);
+}
+
+void StartupTrace::start(const QStringList &arguments)
+{
+    foreach (const QString& argument, arguments) {
+        if (!isOption(argument))
+            continue;
+        traceEnabled = true;
+        // --startup-trace=filename
+        traceFilename = argument.mid(QString(STARTUP_TRACE_OPTION).length() + 1);
+        // the current dir is changed to the default open folder later
+        if (!traceFilename.isEmpty())
+            traceFilename = QDir::current().absoluteFilePath(traceFilename);
+        traceEvents.clear();
+        traceTimer.start();
+    }
+}
+
+bool StartupTrace::isEnabled()
+{
+    return traceEnabled;
+}
+
+bool StartupTrace::isOption(const QString &argument)
+{
+    return argument == STARTUP_TRACE_OPTION
+            || argument.startsWith(STARTUP_TRACE_OPTION "=");
+}
+
+bool StartupTrace::finish(const QString &defaultFilename)
+{
+    if (!traceEnabled)
+        return false;
+    traceEnabled = false;
+    QString filename = traceFilename.isEmpty() ? defaultFilename : traceFilename;
+    bool result = writeChromeTrace(traceEvents, filename);
+    // the trace is asked for on the command line, so the error goes there too
+    if (!result)
+        fprintf(stderr, "Can't save startup trace to %s\n", QFile::encodeName(filename).constData());
+    traceEvents.clear();
+    return result;
+}
+
+bool StartupTrace::writeChromeTrace(const QList<StartupTraceEvent> &events, const QString &filename)
+{
+    QJsonArray eventArray;
+    foreach (const StartupTraceEvent& event, events) {
+        QJsonObject obj;
+        obj["name"] = event.name;
+        obj["cat"] = "startup";
+        obj["ph"] = "X";
+        // in microseconds
+        obj["ts"] = static_cast<double>(event.start);
+        obj["dur"] = static_cast<double>(event.duration);
+        obj["pid"] = 1;
+        obj["tid"] = 1;
+        eventArray.append(obj);
+    }
+    QJsonObject root;
+    root["traceEvents"] = eventArray;
+    root["displayTimeUnit"] = "ms";
+    QFile file(filename);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Indented)) >= 0;
+}
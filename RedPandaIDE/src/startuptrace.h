@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QList>
+#include <QString>
+
+#define STARTUP_TRACE_OPTION "--startup-trace"
+
+struct StartupTraceEvent {
+    QString name;
+    qint64 start; // usecs since the tracing started
+    qint64 duration; // usecs
+};
+
+/**
+ * @brief Records how long each subsystem takes to start up.
+ *
+ * It's enabled by the --startup-trace[=filename] command line option. Spans
+ * are only recorded in the main thread, and nested spans are shown inside the
+ * enclosing ones in the trace.
+ */
+class StartupTrace
+{
+public:
+    /**
+     * @brief records the time spent in the current scope
+     */
+    class Span {
+    public:
+        explicit Span(const QString& name);
+        Span(const Span&) = delete;
+        Span& operator=(const Span&) = delete;
+        ~Span();
+        // end the span before the scope ends
+        void end();
+    private:
+        QString mName;
+        qint64 mStart;
+        bool mEnded;
+    };
+
+    /**
+     * @brief start tracing if the option is in the arguments
+     *
+     * A relative filename is resolved against the current dir at the time of the call.
+     */
+    static void start(const QStringList& arguments);
+    static bool isEnabled();
+    static bool isOption(const QString& argument);
+    /**
+     * @brief stop tracing and save the spans
+     * @param defaultFilename used if no filename is given in the option
+     */
+    static bool finish(const QString& defaultFilename);
+
+    /**
+     * @brief save the spans in the Chrome trace event format
+     *
+     * The result can be opened in chrome://tracing or Perfetto.
+     */
+    static bool writeChromeTrace(const QList<StartupTraceEvent>& events, const QString& filename);
+};
+
+#endif // STARTUPTRACE_H
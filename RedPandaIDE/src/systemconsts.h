@@ -35,6 +35,8 @@
 #define CLANG_CPP_PROGRAM   "clang++.exe"
 #define LLDB_MI_PROGRAM   "lldb-mi.exe"
 #define LLDB_SERVER_PROGRAM   "lldb-server.exe"
+#define LLDB_DAP_PROGRAM   "lldb-dap.exe"
+#define LLDB_VSCODE_PROGRAM   "lldb-vscode.exe"
 #define SDCC_PROGRAM   "sdcc.exe"
 #define PACKIHX_PROGRAM   "packihx.exe"
 #define MAKEBIN_PROGRAM   "makebin.exe"
@@ -67,6 +69,8 @@
 #define CLANG_CPP_PROGRAM   "clang++"
 #define LLDB_MI_PROGRAM   "lldb-mi"
 #define LLDB_SERVER_PROGRAM   "lldb-server"
+#define LLDB_DAP_PROGRAM   "lldb-dap"
+#define LLDB_VSCODE_PROGRAM   "lldb-vscode"
 #define SDCC_PROGRAM   "sdcc"
 #define PACKIHX_PROGRAM   "packihx"
 #define MAKEBIN_PROGRAM   "makebin"
@@ -80,6 +84,7 @@
 #define RES_EXT "res"
 #define H_EXT "h"
 #define OBJ_EXT "o"
+#define DEP_EXT "d"
 #define LST_EXT "lst"
 #define DEF_EXT "def"
 #define LIB_EXT "a"
@@ -100,6 +105,13 @@
 #define DEV_DEBUGGER_FILE "debugger.json"
 #define DEV_HISTORY_FILE "history.json"
 #define DEV_PROBLEM_SET_FILE "problemset.json"
+#define DEV_HEADER_INDEX_FILE "headerindex-%1.json"
+#define DEV_COMPILE_CACHE_DIR "compilecache"
+#define DEV_COMPILE_CACHE_INDEX_FILE "index.json"
+#define DEV_COMPILER_PROBE_CACHE_FILE "compilerprobes.json"
+#define DEV_SYNTAX_CHECK_PCH_DIR "syntaxcheckpch"
+#define BUILD_TRACE_FILE "build-trace.json"
+#define STARTUP_TRACE_FILE "startup-trace.json"
 
 
 #ifdef Q_OS_WIN
@@ -56,6 +56,7 @@ void resetCppParser(std::shared_ptr<CppParser> parser, int compilerSetIndex)
         foreach  (const QString& file,compilerSet->defaultCIncludeDirs()) {
             parser->addIncludePath(file);
         }
+        indexCompilerSetHeaders(pMainWindow->headerIndexManager(), compilerSet);
         // Set defines
         foreach (const QString &define, compilerSet->defines(parser->language()==ParserLanguage::CPlusPlus)) {
             parser->addHardDefineByLine(define);
@@ -94,3 +95,17 @@ void resetCppParser(std::shared_ptr<CppParser> parser, int compilerSetIndex)
                             pMainWindow,
                             &MainWindow::onParseFinished);
 }
+
+void indexCompilerSetHeaders(HeaderIndexManager *headerIndexManager, std::shared_ptr<CompilerSet> compilerSet)
+{
+    if (!headerIndexManager || !compilerSet)
+        return;
+    // both C and C++ parsers of the compiler set share the index
+    QStringList includeDirs;
+    includeDirs.append(compilerSet->CppIncludeDirs());
+    includeDirs.append(compilerSet->CIncludeDirs());
+    includeDirs.append(compilerSet->defaultCppIncludeDirs());
+    includeDirs.append(compilerSet->defaultCIncludeDirs());
+    includeDirs.removeDuplicates();
+    headerIndexManager->indexCompilerSet(compilerSet->name(), includeDirs);
+}
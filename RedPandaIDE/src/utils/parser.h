@@ -19,6 +19,9 @@
 #include <memory>
 
 class CppParser;
+class CompilerSet;
+class HeaderIndexManager;
 void resetCppParser(std::shared_ptr<CppParser> parser, int compilerSetIndex=-1);
+void indexCompilerSetHeaders(HeaderIndexManager *headerIndexManager, std::shared_ptr<CompilerSet> compilerSet);
 
 #endif // UTILS_PARSER_H
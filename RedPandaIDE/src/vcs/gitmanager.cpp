@@ -576,6 +576,21 @@ bool GitManager::isValid()
     return pSettings->vcs().gitOk();
 }
 
+QProcessEnvironment GitManager::gitEnvironment()
+{
+    QProcessEnvironment env;
+#ifdef Q_OS_WIN
+    env.insert("PATH",pSettings->dirs().appDir());
+    env.insert("GIT_ASKPASS",includeTrailingPathDelimiter(pSettings->dirs().appDir())+"redpanda-win-git-askpass.exe");
+#else // Unix
+    env.insert(QProcessEnvironment::systemEnvironment());
+    env.insert("LC_ALL", "C");
+    env.insert("LANGUAGE","");
+    env.insert("GIT_ASKPASS",includeTrailingPathDelimiter(pSettings->dirs().appLibexecDir())+"redpanda-git-askpass");
+#endif
+    return env;
+}
+
 QString GitManager::runGit(const QString& workingFolder, const QStringList &args)
 {
     if (!isValid())
@@ -589,16 +604,7 @@ QString GitManager::runGit(const QString& workingFolder, const QStringList &args
                             args.join("\" \"")));
 //    qDebug()<<"---------";
 //    qDebug()<<args;
-    QProcessEnvironment env;
-#ifdef Q_OS_WIN
-    env.insert("PATH",pSettings->dirs().appDir());
-    env.insert("GIT_ASKPASS",includeTrailingPathDelimiter(pSettings->dirs().appDir())+"redpanda-win-git-askpass.exe");
-#else // Unix
-    env.insert(QProcessEnvironment::systemEnvironment());
-    env.insert("LC_ALL", "C");
-    env.insert("LANGUAGE","");
-    env.insert("GIT_ASKPASS",includeTrailingPathDelimiter(pSettings->dirs().appLibexecDir())+"redpanda-git-askpass");
-#endif
+    QProcessEnvironment env = gitEnvironment();
     QString output = runAndGetOutput(
                 fileInfo.absoluteFilePath(),
                 workingFolder,
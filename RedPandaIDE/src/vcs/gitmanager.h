@@ -94,6 +94,8 @@ public:
     bool reset(const QString& folder, const QString& commit, GitResetStrategy strategy, QString& output);
 
     bool isValid();
+    // the environment git runs in
+    static QProcessEnvironment gitEnvironment();
 
 signals:
     void gitCmdRunning(const QString& gitCmd);
@@ -1,18 +1,119 @@
 #include "gitrepository.h"
 #include "gitmanager.h"
+#include "../settings.h"
 
 #include <QDir>
+#include <QFile>
+
+GitStatusReader::GitStatusReader(const QString &gitPath,
+                                 const QProcessEnvironment &env,
+                                 const QString &folder,
+                                 const QString &gitDir,
+                                 PGitStatus previous,
+                                 QObject *parent):
+    QThread{parent},
+    mGitPath{gitPath},
+    mEnv{env},
+    mFolder{folder},
+    mGitDir{gitDir},
+    mPrevious{previous}
+{
+}
+
+PGitStatus GitStatusReader::takeStatus()
+{
+    QMutexLocker locker(&mStatusMutex);
+    PGitStatus status = mStatus;
+    mStatus.reset();
+    return status;
+}
+
+const QString &GitStatusReader::folder() const
+{
+    return mFolder;
+}
+
+PGitStatus GitStatusReader::readStatus(const QString &gitPath,
+                                       const QProcessEnvironment &env,
+                                       const QString &folder,
+                                       const QString &gitDir,
+                                       const PGitStatus &previous)
+{
+    PGitStatus status = std::make_shared<GitStatus>();
+    if (gitPath.isEmpty() || folder.isEmpty())
+        return status;
+    // stamp the index before reading it, so a change made meanwhile is not missed
+    QFileInfo indexInfo(QDir(gitDir).filePath("index"));
+    if (!gitDir.isEmpty() && indexInfo.exists()) {
+        status->indexSize = indexInfo.size();
+        status->indexModified = indexInfo.lastModified().toMSecsSinceEpoch();
+    }
+    // --no-optional-locks: don't refresh the index, or the watcher will be triggered again
+    QStringList args{
+        "--no-optional-locks",
+        "status",
+        "--porcelain=v2",
+        "-z",
+        "--branch",
+        "--untracked-files=no",
+        "--ignored=no"
+    };
+    ProcessOutput statusOutput = runAndGetOutput(gitPath, folder, args, QByteArray(), true, false, env);
+    parseGitStatus(statusOutput.standardOutput, folder, *status);
+    if (!status->inRepository)
+        return status;
+    if (previous && previous->inRepository
+            && status->indexSize >= 0
+            && previous->indexSize == status->indexSize
+            && previous->indexModified == status->indexModified) {
+        // tracked files only change with the index
+        status->files = previous->files;
+        return status;
+    }
+    ProcessOutput filesOutput = runAndGetOutput(gitPath, folder, QStringList{"ls-files", "-z"},
+                                                QByteArray(), true, false, env);
+    QDir dir(folder);
+    foreach (const QByteArray& path, filesOutput.standardOutput.split('\0')) {
+        if (!path.isEmpty())
+            status->files.insert(cleanPath(dir.absoluteFilePath(QString::fromUtf8(path))));
+    }
+    return status;
+}
+
+void GitStatusReader::run()
+{
+    PGitStatus status = readStatus(mGitPath, mEnv, mFolder, mGitDir, mPrevious);
+    {
+        QMutexLocker locker(&mStatusMutex);
+        mStatus = status;
+    }
+    emit statusReady();
+}
 
 GitRepository::GitRepository(const QString& folder, QObject *parent)
     : QObject{parent},
-      mInRepository(false)
+      mStatus{std::make_shared<GitStatus>()},
+      mUpdatePending{false}
 {
     mManager = new GitManager();
+    // changes to the index come in bursts
+    mUpdateTimer.setSingleShot(true);
+    mUpdateTimer.setInterval(UpdateDelay);
+    connect(&mUpdateTimer, &QTimer::timeout,
+            this, &GitRepository::update);
+    connect(&mWatcher, &QFileSystemWatcher::fileChanged,
+            this, &GitRepository::onGitDirChanged);
+    connect(&mWatcher, &QFileSystemWatcher::directoryChanged,
+            this, &GitRepository::onGitDirChanged);
     setFolder(folder);
 }
 
 GitRepository::~GitRepository()
 {
+    if (mReader) {
+        mReader->disconnect(this);
+        mReader->wait();
+    }
     delete mManager;
 }
 
@@ -28,8 +129,8 @@ void GitRepository::createRepository()
 
 bool GitRepository::hasRepository(QString& currentBranch)
 {
-    currentBranch = mBranch;
-    return  mInRepository;
+    currentBranch = mStatus->branch;
+    return mStatus->inRepository;
 }
 
 bool GitRepository::add(const QString &path, QString& output)
@@ -54,9 +155,13 @@ bool GitRepository::restore(const QString &path, QString& output)
 
 QSet<QString> GitRepository::listFiles(bool refresh)
 {
-    if (refresh)
-        update();
-    return mFilesInRepositories;
+    if (refresh && mManager->isValid() && !mFolder.isEmpty()) {
+        mStatus = GitStatusReader::readStatus(pSettings->vcs().gitPath(),
+                                              GitManager::gitEnvironment(),
+                                              mRealFolder, mGitDir, mStatus);
+        emit statusUpdated();
+    }
+    return mStatus->files;
 }
 
 bool GitRepository::clone(const QString &url, QString& output)
@@ -81,29 +186,26 @@ void GitRepository::setFolder(const QString &newFolder)
         mRealFolder = mManager->rootFolder(mFolder);
     else
         mRealFolder = newFolder;
+    mGitDir = findGitDir(mRealFolder);
+    mStatus = std::make_shared<GitStatus>();
+    watchGitDir();
     update();
 }
 
 void GitRepository::update()
 {
+    mUpdateTimer.stop();
     if (!mManager->isValid() || mFolder.isEmpty()) {
-        mInRepository = false;
-        mBranch = "";
-        mFilesInRepositories.clear();
-        mChangedFiles.clear();
-        mStagedFiles.clear();
-        mConflicts.clear();
-    } else {
-        mInRepository = mManager->hasRepository(mRealFolder,mBranch);
-        convertFilesListToSet(mManager->listFiles(mRealFolder),mFilesInRepositories);
-        convertFilesListToSet(mManager->listChangedFiles(mRealFolder),mChangedFiles);
-        convertFilesListToSet(mManager->listStagedFiles(mRealFolder),mStagedFiles);
-        convertFilesListToSet(mManager->listConflicts(mRealFolder),mConflicts);
-//        qDebug()<<"update"<<mRealFolder<<mBranch;
-//        qDebug()<<mFilesInRepositories;
-//        qDebug()<<mChangedFiles;
-//        qDebug()<<mStagedFiles;
+        mStatus = std::make_shared<GitStatus>();
+        emit statusUpdated();
+        return;
+    }
+    // read again when the running one is done
+    if (mReader) {
+        mUpdatePending = true;
+        return;
     }
+    startReader();
 }
 
 const QString &GitRepository::realFolder() const
@@ -111,12 +213,83 @@ const QString &GitRepository::realFolder() const
     return mRealFolder;
 }
 
-void GitRepository::convertFilesListToSet(const QStringList &filesList, QSet<QString> &set)
+void GitRepository::onGitDirChanged()
+{
+    // the index is replaced by renaming, and the watcher stops watching the old file
+    watchGitDir();
+    mUpdateTimer.start();
+}
+
+QString GitRepository::findGitDir(const QString &rootFolder)
+{
+    if (rootFolder.isEmpty())
+        return QString();
+    QDir dir(rootFolder);
+    QFileInfo info(dir.filePath(".git"));
+    if (info.isDir())
+        return info.absoluteFilePath();
+    if (!info.isFile())
+        return QString();
+    // "gitdir: <path>" in work trees and submodules
+    QFile file(info.absoluteFilePath());
+    if (!file.open(QFile::ReadOnly))
+        return QString();
+    QString line = QString::fromUtf8(file.readLine()).trimmed();
+    if (!line.startsWith("gitdir:"))
+        return QString();
+    return cleanPath(dir.absoluteFilePath(line.mid(QString("gitdir:").length()).trimmed()));
+}
+
+void GitRepository::startReader()
 {
-    set.clear();
-    QDir dir(mRealFolder);
-    foreach (const QString& s, filesList) {
-        set.insert(cleanPath(dir.absoluteFilePath(s)));
+    mUpdatePending = false;
+    GitStatusReader* reader = new GitStatusReader(pSettings->vcs().gitPath(),
+                                                  GitManager::gitEnvironment(),
+                                                  mRealFolder,
+                                                  mGitDir,
+                                                  mStatus);
+    connect(reader, &GitStatusReader::statusReady,
+            this, [this, reader](){
+        onStatusReady(reader);
+    });
+    connect(reader, &QThread::finished,
+            reader, &QObject::deleteLater);
+    mReader = reader;
+    reader->start();
+}
+
+void GitRepository::onStatusReady(GitStatusReader *reader)
+{
+    PGitStatus status = reader->takeStatus();
+    if (mReader == reader)
+        mReader.clear();
+    // it's for the previous folder
+    if (status && reader->folder() == mRealFolder) {
+        mStatus = status;
+        emit statusUpdated();
+    }
+    if (mUpdatePending)
+        startReader();
+}
+
+void GitRepository::watchGitDir()
+{
+    QStringList paths;
+    if (!mGitDir.isEmpty()) {
+        QDir dir(mGitDir);
+        // the directory is changed when the index is created or replaced
+        paths.append(mGitDir);
+        paths.append(dir.filePath("index"));
+        paths.append(dir.filePath("HEAD"));
+    }
+    QStringList watched = mWatcher.files() + mWatcher.directories();
+    foreach (const QString& path, watched) {
+        if (!paths.contains(path))
+            mWatcher.removePath(path);
+    }
+    foreach (const QString& path, paths) {
+        if (!watched.contains(path) && QFileInfo::exists(path))
+            mWatcher.addPath(path);
     }
 }
 
@@ -2,11 +2,59 @@
 #define GITREPOSITORY_H
 
 #include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QMutex>
 #include <QObject>
+#include <QPointer>
+#include <QProcessEnvironment>
 #include <QSet>
+#include <QThread>
+#include <QTimer>
 #include <memory>
 #include "gitutils.h"
 
+/**
+ * @brief Reads the status of a work tree in background.
+ *
+ * Changed, staged and conflicting files are read by a single
+ * "git status --porcelain=v2 -z". The tracked files are listed again only
+ * if the index is modified since the previous status.
+ */
+class GitStatusReader : public QThread
+{
+    Q_OBJECT
+public:
+    explicit GitStatusReader(const QString& gitPath,
+                             const QProcessEnvironment& env,
+                             const QString& folder,
+                             const QString& gitDir,
+                             PGitStatus previous,
+                             QObject *parent = nullptr);
+    PGitStatus takeStatus();
+    const QString &folder() const;
+    /**
+     * @brief read the status in the current thread
+     * @param previous its tracked files are reused if the index is not changed
+     */
+    static PGitStatus readStatus(const QString& gitPath,
+                                 const QProcessEnvironment& env,
+                                 const QString& folder,
+                                 const QString& gitDir,
+                                 const PGitStatus& previous);
+signals:
+    void statusReady();
+protected:
+    void run() override;
+private:
+    QString mGitPath;
+    QProcessEnvironment mEnv;
+    QString mFolder;
+    QString mGitDir;
+    PGitStatus mPrevious;
+    QMutex mStatusMutex;
+    PGitStatus mStatus;
+};
+
 class GitManager;
 class GitRepository : public QObject
 {
@@ -24,34 +72,34 @@ public:
         return isFileInRepository(fileInfo.absoluteFilePath());
     }
     bool isFileInRepository(const QString& filePath) {
-        return mFilesInRepositories.contains(filePath);
+        return mStatus->files.contains(filePath);
     }
     bool isFileStaged(const QFileInfo& fileInfo) {
         return isFileStaged(fileInfo.absoluteFilePath());
     }
     bool isFileStaged(const QString& filePath) {
-        return mStagedFiles.contains(filePath);
+        return mStatus->stagedFiles.contains(filePath);
     }
     bool hasStagedFiles() {
-        return !mStagedFiles.isEmpty();
+        return !mStatus->stagedFiles.isEmpty();
     }
     bool isFileChanged(const QFileInfo& fileInfo) {
         return isFileChanged(fileInfo.absoluteFilePath());
     }
     bool isFileChanged(const QString& filePath) {
-        return mChangedFiles.contains(filePath);
+        return mStatus->changedFiles.contains(filePath);
     }
     bool hasChangedFiles() {
-        return !mChangedFiles.isEmpty();
+        return !mStatus->changedFiles.isEmpty();
     }
     bool isFileConflicting(const QFileInfo& fileInfo) {
         return isFileConflicting(fileInfo.absoluteFilePath());
     }
     bool isFileConflicting(const QString& filePath) {
-        return mConflicts.contains(filePath);
+        return mStatus->conflicts.contains(filePath);
     }
     bool hasConflicts(){
-        return !mConflicts.isEmpty();
+        return !mStatus->conflicts.isEmpty();
     }
 
     bool add(const QString& path, QString& output);
@@ -66,23 +114,36 @@ public:
 
 
     void setFolder(const QString &newFolder);
+    /**
+     * @brief read the status again in background
+     *
+     * statusUpdated() is emitted when it's done.
+     */
     void update();
 
     const QString &realFolder() const;
 
 signals:
+    void statusUpdated();
+private slots:
+    void onGitDirChanged();
 private:
+    static QString findGitDir(const QString& rootFolder);
+    void startReader();
+    void onStatusReady(GitStatusReader* reader);
+    void watchGitDir();
+private:
+    static constexpr int UpdateDelay = 300; // msecs
     QString mRealFolder;
     QString mFolder;
-    bool mInRepository;
-    QString mBranch;
+    QString mGitDir;
     GitManager* mManager;
-    QSet<QString> mFilesInRepositories;
-    QSet<QString> mChangedFiles;
-    QSet<QString> mStagedFiles;
-    QSet<QString> mConflicts;
-private:
-    void convertFilesListToSet(const QStringList& filesList,QSet<QString>& set);
+    // replaced as a whole when a new status is read
+    PGitStatus mStatus;
+    QPointer<GitStatusReader> mReader;
+    bool mUpdatePending;
+    QFileSystemWatcher mWatcher;
+    QTimer mUpdateTimer;
 };
 
 #endif // GITREPOSITORY_H
@@ -1,2 +1,61 @@
 #include "gitutils.h"
 
+#include <QDir>
+#include <qt_utils/utils.h>
+
+void parseGitStatus(const QByteArray &output, const QString &folder, GitStatus &status)
+{
+    // entries are separated by NULs, paths are not quoted
+    QList<QByteArray> entries = output.split('\0');
+    QDir dir(folder);
+    for (int i = 0; i < entries.count(); i++) {
+        const QByteArray& entry = entries[i];
+        if (entry.isEmpty())
+            continue;
+        char kind = entry[0];
+        if (kind == '#') {
+            // the branch headers are always printed for a work tree
+            if (entry.startsWith("# branch.oid "))
+                status.inRepository = true;
+            else if (entry.startsWith("# branch.head "))
+                status.branch = QString::fromUtf8(entry.mid(QByteArray("# branch.head ").length()));
+            continue;
+        }
+        // fields before the path
+        int fieldCount;
+        switch (kind) {
+        case '1': // changed
+            fieldCount = 8;
+            break;
+        case '2': // renamed or copied, followed by the original path
+            fieldCount = 9;
+            break;
+        case 'u': // unmerged
+            fieldCount = 10;
+            break;
+        default:
+            continue;
+        }
+        int pos = 0;
+        for (int j = 0; j < fieldCount && pos >= 0; j++) {
+            pos = entry.indexOf(' ', pos);
+            if (pos >= 0)
+                pos++;
+        }
+        if (kind == '2')
+            i++;
+        if (pos < 0 || entry.length() < 4)
+            continue;
+        QString path = cleanPath(dir.absoluteFilePath(QString::fromUtf8(entry.mid(pos))));
+        if (kind == 'u') {
+            status.conflicts.insert(path);
+            status.changedFiles.insert(path);
+            continue;
+        }
+        // XY: status in the index and in the work tree, '.' if unmodified
+        if (entry[2] != '.')
+            status.stagedFiles.insert(path);
+        if (entry[3] != '.')
+            status.changedFiles.insert(path);
+    }
+}
@@ -2,6 +2,7 @@
 #define GITUTILS_H
 
 #include <QDateTime>
+#include <QSet>
 #include <QString>
 #include <memory>
 
@@ -45,4 +46,25 @@ struct GitCommitInfo {
 
 using PGitCommitInfo = std::shared_ptr<GitCommitInfo>;
 
+// a snapshot of the work tree, paths are absolute
+struct GitStatus {
+    bool inRepository = false;
+    QString branch;
+    QSet<QString> files; // tracked files
+    QSet<QString> changedFiles; // changed but not staged
+    QSet<QString> stagedFiles;
+    QSet<QString> conflicts;
+    // size and modification time of the index when the tracked files are listed
+    qint64 indexSize = -1;
+    qint64 indexModified = -1;
+};
+
+using PGitStatus = std::shared_ptr<GitStatus>;
+
+/**
+ * @brief parse the output of "git status --porcelain=v2 -z --branch"
+ * @param folder paths in the output are relative to it
+ */
+void parseGitStatus(const QByteArray& output, const QString& folder, GitStatus& status);
+
 #endif // GITUTILS_H
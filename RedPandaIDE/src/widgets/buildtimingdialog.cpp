@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "buildtimingdialog.h"
+#include "ui_buildtimingdialog.h"
+
+#include <QHeaderView>
+
+static QTableWidgetItem* createSecondsItem(qint64 msecs)
+{
+    // numbers are sorted by value, not as text
+    QTableWidgetItem* item = new QTableWidgetItem();
+    item->setData(Qt::DisplayRole, msecs / 1000.0);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+BuildTimingDialog::BuildTimingDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::BuildTimingDialog)
+{
+    ui->setupUi(this);
+    ui->tblTargets->setColumnCount(4);
+    ui->tblTargets->setHorizontalHeaderLabels({
+        tr("Target"), tr("Kind"), tr("Start (secs)"), tr("Time (secs)")});
+    ui->tblTargets->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    ui->tblHeaders->setColumnCount(3);
+    ui->tblHeaders->setHorizontalHeaderLabels({
+        tr("Header"), tr("Units Including It"), tr("Time of These Units (secs)")});
+    ui->tblHeaders->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+}
+
+BuildTimingDialog::~BuildTimingDialog()
+{
+    delete ui;
+}
+
+void BuildTimingDialog::setReport(const PBuildTimingReport &report)
+{
+    ui->lblSummary->setText(tr("%1 targets built in %2 secs.")
+                            .arg(report->entries.count())
+                            .arg(report->totalTime / 1000.0));
+
+    ui->tblTargets->setSortingEnabled(false);
+    ui->tblTargets->setRowCount(report->entries.count());
+    for (int i = 0; i < report->entries.count(); i++) {
+        const BuildTimingEntry& entry = report->entries[i];
+        ui->tblTargets->setItem(i, 0, new QTableWidgetItem(entry.target));
+        ui->tblTargets->setItem(i, 1, new QTableWidgetItem(entry.isLink ? tr("Link") : tr("Compile")));
+        ui->tblTargets->setItem(i, 2, createSecondsItem(entry.start));
+        ui->tblTargets->setItem(i, 3, createSecondsItem(entry.duration));
+    }
+    ui->tblTargets->setSortingEnabled(true);
+    ui->tblTargets->sortByColumn(3, Qt::DescendingOrder);
+
+    ui->tblHeaders->setSortingEnabled(false);
+    ui->tblHeaders->setRowCount(report->headers.count());
+    for (int i = 0; i < report->headers.count(); i++) {
+        const BuildTimingHeader& header = report->headers[i];
+        ui->tblHeaders->setItem(i, 0, new QTableWidgetItem(header.filename));
+        QTableWidgetItem* countItem = new QTableWidgetItem();
+        countItem->setData(Qt::DisplayRole, header.unitCount);
+        countItem->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+        ui->tblHeaders->setItem(i, 1, countItem);
+        ui->tblHeaders->setItem(i, 2, createSecondsItem(header.totalDuration));
+    }
+    ui->tblHeaders->setSortingEnabled(true);
+    ui->tblHeaders->sortByColumn(2, Qt::DescendingOrder);
+}
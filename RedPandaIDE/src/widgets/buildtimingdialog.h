@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2020-2022 Roy Qu (royqh1979@gmail.com)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef BUILDTIMINGDIALOG_H
+#define BUILDTIMINGDIALOG_H
+
+#include <QDialog>
+#include "../compiler/buildtiming.h"
+
+namespace Ui {
+class BuildTimingDialog;
+}
+
+class BuildTimingDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit BuildTimingDialog(QWidget *parent = nullptr);
+    ~BuildTimingDialog();
+    void setReport(const PBuildTimingReport& report);
+
+private:
+    Ui::BuildTimingDialog *ui;
+};
+
+#endif // BUILDTIMINGDIALOG_H
@@ -32,6 +32,8 @@
 CodeCompletionPopup::CodeCompletionPopup(ColorManager *colorManager,IconsManager *iconsManager,QWidget *parent) :
     QWidget(parent),
     mListView(nullptr),
+    mBuilder(nullptr),
+    mAutoHideOnSingleResult(false),
     mMutex()
 {
     setWindowFlags(Qt::Popup);
@@ -63,6 +65,7 @@ CodeCompletionPopup::CodeCompletionPopup(ColorManager *colorManager,IconsManager
 
 CodeCompletionPopup::~CodeCompletionPopup()
 {
+    cancelBuilding();
     delete mListView;
     delete mModel;
 }
@@ -77,6 +80,11 @@ void CodeCompletionPopup::setShowEditorCaretFunc(const ShowEditorCaretFunc &newS
     mListView->setShowEditorCaretFunc(newShowEditorCaretFunc);
 }
 
+void CodeCompletionPopup::setAutoInsertCallback(const CompletionAutoInsertCallback &newAutoInsertCallback)
+{
+    mAutoInsertCallback = newAutoInsertCallback;
+}
+
 void CodeCompletionPopup::prepareSearch(
         const QString &preWord,
         const QStringList &ownerExpression,
@@ -90,47 +98,46 @@ void CodeCompletionPopup::prepareSearch(
     QMutexLocker locker(&mMutex);
     if (!isEnabled())
         return;
-    QCursor oldCursor = cursor();
-    setCursor(Qt::CursorShape::WaitCursor);
+    cancelBuilding();
+    mFullCompletionStatementList.clear();
+    mCompletionStatementList.clear();
 
     mMemberPhrase = memberExpression.join("");
     mMemberOperator = memberOperator;
-    switch(type) {
-    case CodeCompletionType::ComplexKeyword:
-        getCompletionListForComplexKeyword(preWord);
-        break;
-    case CodeCompletionType::Labels:
-        getCompletionListForLabels(filename,line);
-        break;
-    case CodeCompletionType::Types:
-        mIncludedFiles = mParser->getIncludedFiles(filename);
-        getCompletionListForTypes(preWord,filename,line);
-        break;
-    case CodeCompletionType::FunctionWithoutDefinition:
-        mIncludedFiles = mParser->getIncludedFiles(filename);
-        getCompletionForFunctionWithoutDefinition(preWord, ownerExpression,memberOperator,memberExpression, filename,line);
-        break;
-    case CodeCompletionType::Namespaces:
-        mIncludedFiles = mParser->getIncludedFiles(filename);
-        getCompletionListForNamespaces(preWord,filename,line);
-        break;
-    case CodeCompletionType::KeywordsOnly:
-        mIncludedFiles.clear();
-        getKeywordCompletionFor(customKeywords);
-        break;
-    case CodeCompletionType::Macros:
-        mIncludedFiles = mParser->getIncludedFiles(filename);
-        getMacroCompletionList(filename, line);
-        break;
-    case CodeCompletionType::LiteralOperators:
-        mIncludedFiles = mParser->getIncludedFiles(filename);
-        getCompletionListForLiteralOperators(filename,line);
-        break;
-    default:
-        mIncludedFiles = mParser->getIncludedFiles(filename);
-        getCompletionFor(ownerExpression,memberOperator,memberExpression, filename,line, customKeywords);
+
+    CodeCompletionListBuilder *builder = new CodeCompletionListBuilder(
+                mParser, type,
+                preWord, ownerExpression, memberOperator, memberExpression,
+                filename, line, customKeywords);
+    builder->setShowKeywords(mShowKeywords);
+    builder->setShowCodeSnippets(mShowCodeSnippets);
+    builder->setCodeSnippets(mCodeSnippets);
+
+    if (type == CodeCompletionType::ComplexKeyword
+            || type == CodeCompletionType::KeywordsOnly) {
+        //doesn't touch the parser, no need to go async
+        builder->build();
+        mFullCompletionStatementList = builder->takeFoundStatements();
+        delete builder;
+        return;
     }
-    setCursor(oldCursor);
+    if (!mParser) {
+        delete builder;
+        return;
+    }
+
+    mBuilder = builder;
+    connect(builder, &CodeCompletionListBuilder::statementsFound,
+            this, [this,builder](){
+        onStatementsFound(builder);
+    });
+    connect(builder, &QThread::finished,
+            this, [this,builder](){
+        onBuildFinished(builder);
+    });
+    connect(builder, &QThread::finished,
+            builder, &QObject::deleteLater);
+    builder->start();
 }
 
 bool CodeCompletionPopup::search(const QString &memberPhrase, bool autoHideOnSingleResult, const QString& schemeName)
@@ -138,6 +145,8 @@ bool CodeCompletionPopup::search(const QString &memberPhrase, bool autoHideOnSin
     QMutexLocker locker(&mMutex);
 
     mMemberPhrase = memberPhrase;
+    mAutoHideOnSingleResult = autoHideOnSingleResult;
+    mSchemeName = schemeName;
 
     if (!isEnabled()) {
         hide();
@@ -159,25 +168,14 @@ bool CodeCompletionPopup::search(const QString &memberPhrase, bool autoHideOnSin
     mModel->notifyUpdated();
     setCursor(oldCursor);
 
-    if (!mCompletionStatementList.isEmpty()) {
+    // While the list is still being built, show the popup even if nothing is found yet
+    if (!mCompletionStatementList.isEmpty() || mBuilder) {
         Q_ASSERT(!schemeName.isEmpty());
-        PColorSchemeItem item = mColorManager->getItem(schemeName, COLOR_SCHEME_ACTIVE_LINE);
-        if (item && item->background().isValid())
-            mDelegate->setCurrentSelectionColor(item->background());
-        else
-            mDelegate->setCurrentSelectionColor(palette().highlight().color());
-        item = mColorManager->getItem(schemeName, COLOR_SCHEME_TEXT);
-        if (item && item->foreground().isValid())
-            mDelegate->setNormalColor(item->foreground());
-        else
-            mDelegate->setNormalColor(palette().color(QPalette::Text));
-        item = mColorManager->getItem(schemeName, SYNS_AttrReserveWord_Type);
-        if (item && item->foreground().isValid())
-            mDelegate->setMatchedColor(item->foreground());
-        else
-            mDelegate->setMatchedColor(palette().color(QPalette::HighlightedText));
+        applyColors(schemeName);
         mListView->setCurrentIndex(mModel->index(0,0));
         show();
+        if (mBuilder)
+            return false;
         // if only one suggestion, and is exactly the symbol to search, hide the frame (the search is over)
         // if only one suggestion and auto hide , don't show the frame
         if(mCompletionStatementList.count() == 1)
@@ -208,123 +206,6 @@ PStatement CodeCompletionPopup::selectedStatement()
         return PStatement();
 }
 
-void CodeCompletionPopup::addChildren(const PStatement& scopeStatement,
-                                      const QString &fileName,
-                                      int line,
-                                      bool onlyTypes)
-{
-    if (scopeStatement && !isIncluded(scopeStatement->fileName)
-      && !isIncluded(scopeStatement->definitionFileName))
-        return;
-    const StatementMap& children = mParser->statementList().childrenStatements(scopeStatement);
-    if (children.isEmpty())
-        return;
-
-    if (onlyTypes) {
-        if (!scopeStatement) { //Global scope
-            for (const PStatement& childStatement: children) {
-                if (!isTypeKind(childStatement->kind))
-                    continue;
-                if (childStatement->fileName.isEmpty()) {
-                    // hard defines
-                    addStatement(childStatement,fileName,-1);
-                } else if (
-                           isIncluded(childStatement->fileName)
-                           || isIncluded(childStatement->definitionFileName)
-                           ) {
-                    //we must check if the statement is included by the file
-                    addStatement(childStatement,fileName,line);
-                }
-            }
-        } else {
-            for (const PStatement& childStatement: children) {
-                if (!isTypeKind(childStatement->kind))
-                    continue;
-                addStatement(childStatement,fileName,line);
-            }
-        }
-    } else {
-        if (!scopeStatement) { //Global scope
-            for (const PStatement& childStatement: children) {
-                if (childStatement->fileName.isEmpty()) {
-                    // hard defines
-                    addStatement(childStatement,fileName,-1);
-                } else if (
-                           isIncluded(childStatement->fileName)
-                           || isIncluded(childStatement->definitionFileName)
-                           ) {
-                    //we must check if the statement is included by the file
-                    addStatement(childStatement,fileName,line);
-                }
-            }
-        } else {
-            for (const PStatement& childStatement: children) {
-                addStatement(childStatement,fileName,line);
-            }
-        }
-
-    }
-}
-
-void CodeCompletionPopup::addFunctionWithoutDefinitionChildren(const PStatement& scopeStatement, const QString &fileName, int line)
-{
-    if (scopeStatement && !isIncluded(scopeStatement->fileName)
-      && !isIncluded(scopeStatement->definitionFileName))
-        return;
-    const StatementMap& children = mParser->statementList().childrenStatements(scopeStatement);
-    if (children.isEmpty())
-        return;
-
-    for (const PStatement& childStatement: children) {
-        if (childStatement->inSystemHeader())
-            continue;
-        if (childStatement->fileName.isEmpty()) {
-            // hard defines, do nothing
-            continue;
-        }
-        switch(childStatement->kind) {
-        case StatementKind::Constructor:
-        case StatementKind::Function:
-        case StatementKind::Destructor:
-            if (!childStatement->hasDefinition())
-                addStatement(childStatement,fileName,line);
-            break;
-        case StatementKind::Class:
-        case StatementKind::Namespace:
-            if (isIncluded(childStatement->fileName))
-                addStatement(childStatement,fileName,line);
-            break;
-        default:
-            break;
-        }
-    }
-}
-
-void CodeCompletionPopup::addStatement(const PStatement& statement, const QString &fileName, int line)
-{
-    if (mAddedStatements.contains(statement->command))
-        return;
-    if (statement->kind == StatementKind::Constructor
-            || statement->kind == StatementKind::Destructor
-            || statement->kind == StatementKind::Label
-            || statement->kind == StatementKind::Block
-            || statement->kind == StatementKind::Lambda
-            || (
-                statement->properties.testFlag(StatementProperty::OperatorOverloading)
-                && statement->kind != StatementKind::LiteralOperator
-                )
-            || statement->properties.testFlag(StatementProperty::DummyStatement)
-            )
-        return;
-    if ((line!=-1)
-            && (line < statement->line)
-            && (fileName == statement->fileName))
-        return;
-    mAddedStatements.insert(statement->command);
-    if (statement->kind == StatementKind::UserCodeSnippet || !statement->command.contains("<"))
-        mFullCompletionStatementList.append(statement);
-}
-
 static bool nameComparator(PStatement statement1,PStatement statement2) {
     return statement1->command < statement2->command;
 }
@@ -482,6 +363,85 @@ static bool sortByScopeWithUsageComparator(PStatement statement1,PStatement stat
         return nameComparator(statement1,statement2);
 }
 
+void CodeCompletionPopup::applyColors(const QString &schemeName)
+{
+    PColorSchemeItem item = mColorManager->getItem(schemeName, COLOR_SCHEME_ACTIVE_LINE);
+    if (item && item->background().isValid())
+        mDelegate->setCurrentSelectionColor(item->background());
+    else
+        mDelegate->setCurrentSelectionColor(palette().highlight().color());
+    item = mColorManager->getItem(schemeName, COLOR_SCHEME_TEXT);
+    if (item && item->foreground().isValid())
+        mDelegate->setNormalColor(item->foreground());
+    else
+        mDelegate->setNormalColor(palette().color(QPalette::Text));
+    item = mColorManager->getItem(schemeName, SYNS_AttrReserveWord_Type);
+    if (item && item->foreground().isValid())
+        mDelegate->setMatchedColor(item->foreground());
+    else
+        mDelegate->setMatchedColor(palette().color(QPalette::HighlightedText));
+}
+
+void CodeCompletionPopup::cancelBuilding()
+{
+    if (mBuilder) {
+        //the builder deletes itself when it's finished
+        mBuilder->cancel();
+        mBuilder = nullptr;
+    }
+}
+
+void CodeCompletionPopup::updateCompletionList()
+{
+    PStatement oldSelected = selectedStatement();
+    filterList(mMemberPhrase);
+    mModel->notifyUpdated();
+    int row = 0;
+    if (oldSelected) {
+        row = mCompletionStatementList.indexOf(oldSelected);
+        if (row<0)
+            row = 0;
+    }
+    mListView->setCurrentIndex(mModel->index(row,0));
+}
+
+void CodeCompletionPopup::onStatementsFound(CodeCompletionListBuilder *builder)
+{
+    QMutexLocker locker(&mMutex);
+    if (builder != mBuilder)
+        return;
+    StatementList statements = builder->takeFoundStatements();
+    if (statements.isEmpty())
+        return;
+    mFullCompletionStatementList.append(statements);
+    if (isVisible())
+        updateCompletionList();
+}
+
+void CodeCompletionPopup::onBuildFinished(CodeCompletionListBuilder *builder)
+{
+    QMutexLocker locker(&mMutex);
+    if (builder != mBuilder)
+        return;
+    mFullCompletionStatementList.append(builder->takeFoundStatements());
+    mBuilder = nullptr;
+    if (!isVisible())
+        return;
+    updateCompletionList();
+    if (mCompletionStatementList.isEmpty()) {
+        hide();
+        return;
+    }
+    if (mCompletionStatementList.count() == 1
+            && (mAutoHideOnSingleResult
+                || mMemberPhrase == mCompletionStatementList.front()->command)
+            && mAutoInsertCallback) {
+        //hide() (in the callback) resets mAutoInsertCallback
+        CompletionAutoInsertCallback callback = mAutoInsertCallback;
+        callback();
+    }
+}
+
 void CodeCompletionPopup::filterList(const QString &member)
 {
     QMutexLocker locker(&mMutex);
@@ -597,338 +557,773 @@ void CodeCompletionPopup::filterList(const QString &member)
     //    }
 }
 
-void CodeCompletionPopup::getKeywordCompletionFor(const QSet<QString> &customKeywords)
+SymbolUsageManager *CodeCompletionPopup::symbolUsageManager() const
 {
-    //add keywords
-    if (!customKeywords.isEmpty()) {
-        foreach (const QString& keyword,customKeywords) {
-            addKeyword(keyword);
-        }
-    }
+    return mSymbolUsageManager;
 }
 
-void CodeCompletionPopup::getMacroCompletionList(const QString &fileName, int line)
+void CodeCompletionPopup::setSymbolUsageManager(SymbolUsageManager *newSymbolUsageManager)
 {
-    const StatementMap& statementMap = mParser->statementList().childrenStatements(nullptr);
-    foreach(const PStatement& statement, statementMap.values()) {
-        if (statement->kind==StatementKind::Preprocessor)
-            addStatement(statement,fileName,line);
-    }
+    mSymbolUsageManager = newSymbolUsageManager;
 }
 
-void CodeCompletionPopup::getCompletionFor(
-        QStringList ownerExpression,
-        const QString& memberOperator,
-        const QStringList& memberExpression,
-        const QString &fileName,
-        int line,
-        const QSet<QString>& customKeywords)
+void CodeCompletionPopup::setHideSymbolsStartWithTwoUnderline(bool newHideSymbolsStartWithTwoUnderline)
 {
+    mHideSymbolsStartWithTwoUnderline = newHideSymbolsStartWithTwoUnderline;
+}
 
-    if (memberOperator.isEmpty() && ownerExpression.isEmpty() && memberExpression.isEmpty())
-        return;
+void CodeCompletionPopup::setLineHeightFactor(float factor)
+{
+    mDelegate->setLineHeightFactor(factor);
+}
 
-    bool isLambdaReturnType = (
-                memberOperator=="->"
-                && ownerExpression.startsWith("[")
-                && ownerExpression.endsWith(")"));
+bool CodeCompletionPopup::hideSymbolsStartWithTwoUnderline() const
+{
+    return mHideSymbolsStartWithTwoUnderline;
+}
 
-    if (memberOperator.isEmpty()) {
-        //C++ preprocessor directives
-        if (mMemberPhrase.startsWith('#')) {
-            if (mShowKeywords) {
-                foreach (const QString& keyword, CppDirectives) {
-                    addKeyword(keyword);
-                }
-            }
-            return;
-        }
+bool CodeCompletionPopup::hideSymbolsStartWithUnderline() const
+{
+    return mHideSymbolsStartWithUnderline;
+}
 
-        //docstring tags (javadoc style)
-        if (mMemberPhrase.startsWith('@')) {
-            if (mShowKeywords) {
-                foreach (const QString& keyword,JavadocTags) {
-                    addKeyword(keyword);
-                }
-            }
-            return;
-        }
+void CodeCompletionPopup::setHideSymbolsStartWithUnderline(bool newHideSymbolsStartWithUnderline)
+{
+    mHideSymbolsStartWithUnderline = newHideSymbolsStartWithUnderline;
+}
 
-        //the identifier to be completed is not a member of variable/class
-        if (mShowCodeSnippets) {
-            //add custom code templates
-            foreach (const PCodeSnippet& codeIn,mCodeSnippets) {
-                if (!codeIn->code.isEmpty()) {
-                    PStatement statement = std::make_shared<Statement>();
-                    statement->command = codeIn->prefix;
-                    statement->value = codeIn->code;
-                    statement->kind = StatementKind::UserCodeSnippet;
-                    statement->fullName = codeIn->prefix;
-                    statement->usageCount = 0;
-                    mFullCompletionStatementList.append(statement);
-                }
-            }
-        }
+const QString &CodeCompletionPopup::memberOperator() const
+{
+    return mMemberOperator;
+}
 
-        if (mShowKeywords) {
-            //add keywords
-            if (!customKeywords.isEmpty()) {
-                foreach (const QString& keyword,customKeywords) {
-                    addKeyword(keyword);
+const QList<PCodeSnippet> &CodeCompletionPopup::codeSnippets() const
+{
+    return mCodeSnippets;
+}
+
+void CodeCompletionPopup::setCodeSnippets(const QList<PCodeSnippet> &newCodeSnippets)
+{
+    mCodeSnippets = newCodeSnippets;
+}
+
+bool CodeCompletionPopup::building() const
+{
+    return mBuilder!=nullptr;
+}
+
+void CodeCompletionPopup::setColors(const std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > > &newColors)
+{
+    mColors = newColors;
+}
+
+const QString &CodeCompletionPopup::memberPhrase() const
+{
+    return mMemberPhrase;
+}
+
+const std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > >& CodeCompletionPopup::colors() const
+{
+    return mColors;
+}
+
+bool CodeCompletionPopup::sortByScope() const
+{
+    return mSortByScope;
+}
+
+void CodeCompletionPopup::setSortByScope(bool newSortByScope)
+{
+    mSortByScope = newSortByScope;
+}
+
+bool CodeCompletionPopup::ignoreCase() const
+{
+    return mIgnoreCase;
+}
+
+void CodeCompletionPopup::setIgnoreCase(bool newIgnoreCase)
+{
+    mIgnoreCase = newIgnoreCase;
+}
+
+bool CodeCompletionPopup::showCodeSnippets() const
+{
+    return mShowCodeSnippets;
+}
+
+void CodeCompletionPopup::setShowCodeSnippets(bool newShowCodeIns)
+{
+    mShowCodeSnippets = newShowCodeIns;
+}
+
+bool CodeCompletionPopup::showKeywords() const
+{
+    return mShowKeywords;
+}
+
+void CodeCompletionPopup::setShowKeywords(bool newShowKeywords)
+{
+    mShowKeywords = newShowKeywords;
+}
+
+bool CodeCompletionPopup::recordUsage() const
+{
+    return mRecordUsage;
+}
+
+void CodeCompletionPopup::setRecordUsage(bool newRecordUsage)
+{
+    mRecordUsage = newRecordUsage;
+}
+
+int CodeCompletionPopup::showCount() const
+{
+    return mShowCount;
+}
+
+void CodeCompletionPopup::setShowCount(int newShowCount)
+{
+    mShowCount = newShowCount;
+}
+
+const PCppParser &CodeCompletionPopup::parser() const
+{
+    return mParser;
+}
+
+void CodeCompletionPopup::setParser(const PCppParser &newParser)
+{
+    mParser = newParser;
+}
+
+void CodeCompletionPopup::hideEvent(QHideEvent *event)
+{
+    QMutexLocker locker(&mMutex);
+    mListView->setKeypressedCallback(nullptr);
+    mAutoInsertCallback = nullptr;
+    cancelBuilding();
+    mCompletionStatementList.clear();
+//    foreach (PStatement statement, mFullCompletionStatementList) {
+//        statement->matchPositions.clear();
+//    }
+    mFullCompletionStatementList.clear();
+    mParser = nullptr;
+    QWidget::hideEvent(event);
+}
+
+bool CodeCompletionPopup::event(QEvent *event)
+{
+    bool result = QWidget::event(event);
+    if (event->type() == QEvent::FontChange) {
+        if (mListView) {
+            mListView->setFont(font());
+            mDelegate->setFont(font());
+        }
+    }
+    return result;
+}
+
+CodeCompletionListBuilder::CodeCompletionListBuilder(
+        const PCppParser &parser,
+        CodeCompletionType type,
+        const QString &preWord,
+        const QStringList &ownerExpression,
+        const QString &memberOperator,
+        const QStringList &memberExpression,
+        const QString &fileName,
+        int line,
+        const QSet<QString> &customKeywords,
+        QObject *parent):
+    QThread{parent},
+    mParser{parser},
+    mType{type},
+    mPreWord{preWord},
+    mOwnerExpression{ownerExpression},
+    mMemberOperator{memberOperator},
+    mMemberExpression{memberExpression},
+    mMemberPhrase{memberExpression.join("")},
+    mFileName{fileName},
+    mLine{line},
+    mCustomKeywords{customKeywords},
+    mShowKeywords{true},
+    mShowCodeSnippets{true},
+    mCancelled{0}
+{
+}
+
+void CodeCompletionListBuilder::setShowKeywords(bool newShowKeywords)
+{
+    mShowKeywords = newShowKeywords;
+}
+
+void CodeCompletionListBuilder::setShowCodeSnippets(bool newShowCodeSnippets)
+{
+    mShowCodeSnippets = newShowCodeSnippets;
+}
+
+void CodeCompletionListBuilder::setCodeSnippets(const QList<PCodeSnippet> &newCodeSnippets)
+{
+    mCodeSnippets = newCodeSnippets;
+}
+
+void CodeCompletionListBuilder::build()
+{
+    switch(mType) {
+    case CodeCompletionType::ComplexKeyword:
+        getCompletionListForComplexKeyword(mPreWord);
+        break;
+    case CodeCompletionType::KeywordsOnly:
+        getKeywordCompletionFor(mCustomKeywords);
+        break;
+    default:
+    {
+        if (!mParser || !freezeParser())
+            break;
+        // frozen once for the whole list, so all phases see the same statements
+        auto action = finally([this]{
+            mParser->unFreeze();
+        });
+        mIncludedFiles = mParser->getIncludedFiles(mFileName);
+        // looked up here, the GUI thread would wait for the parser to finish
+        mCurrentScope = mParser->findScopeStatement(mFileName, mLine);
+        switch(mType) {
+        case CodeCompletionType::Labels:
+            getCompletionListForLabels(mFileName,mLine);
+            break;
+        case CodeCompletionType::Types:
+            getCompletionListForTypes(mPreWord,mFileName,mLine);
+            break;
+        case CodeCompletionType::FunctionWithoutDefinition:
+            getCompletionForFunctionWithoutDefinition(mPreWord, mOwnerExpression,mMemberOperator,mMemberExpression, mFileName,mLine);
+            break;
+        case CodeCompletionType::Namespaces:
+            getCompletionListForNamespaces(mPreWord,mFileName,mLine);
+            break;
+        case CodeCompletionType::Macros:
+            getMacroCompletionList(mFileName, mLine);
+            break;
+        case CodeCompletionType::LiteralOperators:
+            getCompletionListForLiteralOperators(mFileName,mLine);
+            break;
+        default:
+            getCompletionFor(mOwnerExpression,mMemberOperator,mMemberExpression, mFileName,mLine, mCustomKeywords);
+        }
+    }
+    }
+    flushFoundStatements();
+}
+
+void CodeCompletionListBuilder::cancel()
+{
+    mCancelled.storeRelease(1);
+}
+
+bool CodeCompletionListBuilder::isCancelled() const
+{
+    return mCancelled.loadAcquire()!=0;
+}
+
+StatementList CodeCompletionListBuilder::takeFoundStatements()
+{
+    QMutexLocker locker(&mFoundStatementsMutex);
+    StatementList result;
+    result.swap(mFoundStatements);
+    return result;
+}
+
+bool CodeCompletionListBuilder::freezeParser()
+{
+    // Wait (in the worker thread) until the parser finishes its current job,
+    // instead of giving up or blocking the GUI.
+    while (!mParser->freeze()) {
+        if (isCancelled() || !mParser->enabled())
+            return false;
+        msleep(20);
+    }
+    return true;
+}
+
+void CodeCompletionListBuilder::appendStatement(const PStatement &statement)
+{
+    mStatements.append(statement);
+    if (mStatements.count()>=200)
+        flushFoundStatements();
+}
+
+void CodeCompletionListBuilder::flushFoundStatements()
+{
+    if (mStatements.isEmpty() || isCancelled())
+        return;
+    {
+        QMutexLocker locker(&mFoundStatementsMutex);
+        mFoundStatements.append(mStatements);
+    }
+    mStatements.clear();
+    emit statementsFound();
+}
+
+void CodeCompletionListBuilder::run()
+{
+    build();
+}
+
+void CodeCompletionListBuilder::addChildren(const PStatement& scopeStatement,
+                                      const QString &fileName,
+                                      int line,
+                                      bool onlyTypes)
+{
+    if (isCancelled())
+        return;
+    if (scopeStatement && !isIncluded(scopeStatement->fileName)
+      && !isIncluded(scopeStatement->definitionFileName))
+        return;
+    const StatementMap& children = mParser->statementList().childrenStatements(scopeStatement);
+    if (children.isEmpty())
+        return;
+
+    if (onlyTypes) {
+        if (!scopeStatement) { //Global scope
+            for (const PStatement& childStatement: children) {
+                if (!isTypeKind(childStatement->kind))
+                    continue;
+                if (childStatement->fileName.isEmpty()) {
+                    // hard defines
+                    addStatement(childStatement,fileName,-1);
+                } else if (
+                           isIncluded(childStatement->fileName)
+                           || isIncluded(childStatement->definitionFileName)
+                           ) {
+                    //we must check if the statement is included by the file
+                    addStatement(childStatement,fileName,line);
                 }
             }
+        } else {
+            for (const PStatement& childStatement: children) {
+                if (!isTypeKind(childStatement->kind))
+                    continue;
+                addStatement(childStatement,fileName,line);
+            }
         }
-    } else if  (isLambdaReturnType) {
-            foreach (const QString& keyword,CppTypeKeywords) {
-                addKeyword(keyword);
+    } else {
+        if (!scopeStatement) { //Global scope
+            for (const PStatement& childStatement: children) {
+                if (childStatement->fileName.isEmpty()) {
+                    // hard defines
+                    addStatement(childStatement,fileName,-1);
+                } else if (
+                           isIncluded(childStatement->fileName)
+                           || isIncluded(childStatement->definitionFileName)
+                           ) {
+                    //we must check if the statement is included by the file
+                    addStatement(childStatement,fileName,line);
+                }
             }
+        } else {
+            for (const PStatement& childStatement: children) {
+                addStatement(childStatement,fileName,line);
+            }
+        }
+
     }
+}
 
-    if (!mParser || !mParser->enabled())
+void CodeCompletionListBuilder::addFunctionWithoutDefinitionChildren(const PStatement& scopeStatement, const QString &fileName, int line)
+{
+    if (isCancelled())
         return;
+    if (scopeStatement && !isIncluded(scopeStatement->fileName)
+      && !isIncluded(scopeStatement->definitionFileName))
+        return;
+    const StatementMap& children = mParser->statementList().childrenStatements(scopeStatement);
+    if (children.isEmpty())
+        return;
+
+    for (const PStatement& childStatement: children) {
+        if (childStatement->inSystemHeader())
+            continue;
+        if (childStatement->fileName.isEmpty()) {
+            // hard defines, do nothing
+            continue;
+        }
+        switch(childStatement->kind) {
+        case StatementKind::Constructor:
+        case StatementKind::Function:
+        case StatementKind::Destructor:
+            if (!childStatement->hasDefinition())
+                addStatement(childStatement,fileName,line);
+            break;
+        case StatementKind::Class:
+        case StatementKind::Namespace:
+            if (isIncluded(childStatement->fileName))
+                addStatement(childStatement,fileName,line);
+            break;
+        default:
+            break;
+        }
+    }
+}
 
-    if (!mParser->freeze())
+void CodeCompletionListBuilder::addStatement(const PStatement& statement, const QString &fileName, int line)
+{
+    if (isCancelled())
         return;
-    {
-        auto action = finally([this]{
-            mParser->unFreeze();
-        });
+    if (mAddedStatements.contains(statement->command))
+        return;
+    if (statement->kind == StatementKind::Constructor
+            || statement->kind == StatementKind::Destructor
+            || statement->kind == StatementKind::Label
+            || statement->kind == StatementKind::Block
+            || statement->kind == StatementKind::Lambda
+            || (
+                statement->properties.testFlag(StatementProperty::OperatorOverloading)
+                && statement->kind != StatementKind::LiteralOperator
+                )
+            || statement->properties.testFlag(StatementProperty::DummyStatement)
+            )
+        return;
+    if ((line!=-1)
+            && (line < statement->line)
+            && (fileName == statement->fileName))
+        return;
+    mAddedStatements.insert(statement->command);
+    if (statement->kind == StatementKind::UserCodeSnippet || !statement->command.contains("<"))
+        appendStatement(statement);
+}
 
-        if (memberOperator.isEmpty() || isLambdaReturnType) {
-            PStatement scopeStatement = mCurrentScope;
-            // repeat until reach global
-            while (scopeStatement) {
-                //add members of current scope that not added before
-                if (scopeStatement->kind == StatementKind::Namespace) {
-                    PStatementList namespaceStatementsList =
-                            mParser->findNamespace(scopeStatement->fullName);
-                    foreach (const PStatement& namespaceStatement,*namespaceStatementsList) {
-                        addChildren(namespaceStatement, fileName, line, isLambdaReturnType);
-                    }
-                } else if (scopeStatement->kind == StatementKind::Class) {
-                    addChildren(scopeStatement, fileName, -1, isLambdaReturnType);
-                } else {
-                    addChildren(scopeStatement, fileName, line, isLambdaReturnType);
+void CodeCompletionListBuilder::getKeywordCompletionFor(const QSet<QString> &customKeywords)
+{
+    //add keywords
+    if (!customKeywords.isEmpty()) {
+        foreach (const QString& keyword,customKeywords) {
+            addKeyword(keyword);
+        }
+    }
+}
+
+void CodeCompletionListBuilder::getMacroCompletionList(const QString &fileName, int line)
+{
+    if (!mParser->enabled())
+        return;
+
+    const StatementMap& statementMap = mParser->statementList().childrenStatements(nullptr);
+    foreach(const PStatement& statement, statementMap.values()) {
+        if (statement->kind==StatementKind::Preprocessor)
+            addStatement(statement,fileName,line);
+    }
+}
+
+void CodeCompletionListBuilder::getCompletionFor(
+        QStringList ownerExpression,
+        const QString& memberOperator,
+        const QStringList& memberExpression,
+        const QString &fileName,
+        int line,
+        const QSet<QString>& customKeywords)
+{
+
+    if (memberOperator.isEmpty() && ownerExpression.isEmpty() && memberExpression.isEmpty())
+        return;
+
+    bool isLambdaReturnType = (
+                memberOperator=="->"
+                && ownerExpression.startsWith("[")
+                && ownerExpression.endsWith(")"));
+
+    if (memberOperator.isEmpty()) {
+        //C++ preprocessor directives
+        if (mMemberPhrase.startsWith('#')) {
+            if (mShowKeywords) {
+                foreach (const QString& keyword, CppDirectives) {
+                    addKeyword(keyword);
                 }
+            }
+            return;
+        }
 
-                // add members of all usings (in current scope ) and not added before
-                foreach (const QString& namespaceName,scopeStatement->usingList) {
-                    PStatementList namespaceStatementsList =
-                            mParser->findNamespace(namespaceName);
-                    if (!namespaceStatementsList)
-                        continue;
-                    foreach (const PStatement& namespaceStatement,*namespaceStatementsList) {
-                        addChildren(namespaceStatement, fileName, line, isLambdaReturnType);
-                    }
+        //docstring tags (javadoc style)
+        if (mMemberPhrase.startsWith('@')) {
+            if (mShowKeywords) {
+                foreach (const QString& keyword,JavadocTags) {
+                    addKeyword(keyword);
                 }
-                if (scopeStatement->kind == StatementKind::Lambda) {
-                    foreach (const QString& phrase, scopeStatement->lambdaCaptures) {
-                        if (phrase=="&" || phrase == "=" || phrase =="this")
-                            continue;
-                        PStatement statement = mParser->findStatementOf(
-                            scopeStatement->fileName,
-                                phrase,scopeStatement->line);
-                        if (statement)
-                            addStatement(statement,scopeStatement->fileName, scopeStatement->line);
-                    }
-                    if (scopeStatement->lambdaCaptures.contains("&")
-                            || scopeStatement->lambdaCaptures.contains("=")) {
-                        scopeStatement = scopeStatement->parentScope.lock();
-                    } else if (scopeStatement->lambdaCaptures.contains("this")) {
-                        do {
-                            scopeStatement = scopeStatement->parentScope.lock();
-                        } while (scopeStatement && scopeStatement->kind!=StatementKind::Class
-                                 && scopeStatement->kind!=StatementKind::Namespace);
-                    } else {
-                        do {
-                            scopeStatement = scopeStatement->parentScope.lock();
-                        } while (scopeStatement && scopeStatement->kind!=StatementKind::Namespace);
-                    }
-                    continue;
+            }
+            return;
+        }
+
+        //the identifier to be completed is not a member of variable/class
+        if (mShowCodeSnippets) {
+            //add custom code templates
+            foreach (const PCodeSnippet& codeIn,mCodeSnippets) {
+                if (!codeIn->code.isEmpty()) {
+                    PStatement statement = std::make_shared<Statement>();
+                    statement->command = codeIn->prefix;
+                    statement->value = codeIn->code;
+                    statement->kind = StatementKind::UserCodeSnippet;
+                    statement->fullName = codeIn->prefix;
+                    statement->usageCount = 0;
+                    appendStatement(statement);
+                }
+            }
+        }
+
+        if (mShowKeywords) {
+            //add keywords
+            if (!customKeywords.isEmpty()) {
+                foreach (const QString& keyword,customKeywords) {
+                    addKeyword(keyword);
                 }
-                scopeStatement=scopeStatement->parentScope.lock();
             }
+        }
+    } else if  (isLambdaReturnType) {
+            foreach (const QString& keyword,CppTypeKeywords) {
+                addKeyword(keyword);
+            }
+    }
 
-            // add all global members and not added before
-            addChildren(nullptr, fileName, line, isLambdaReturnType);
+    if (!mParser || !mParser->enabled())
+        return;
+
+    if (memberOperator.isEmpty() || isLambdaReturnType) {
+        PStatement scopeStatement = mCurrentScope;
+        // repeat until reach global
+        while (scopeStatement) {
+            if (isCancelled())
+                return;
+            //add members of current scope that not added before
+            if (scopeStatement->kind == StatementKind::Namespace) {
+                PStatementList namespaceStatementsList =
+                        mParser->findNamespace(scopeStatement->fullName);
+                foreach (const PStatement& namespaceStatement,*namespaceStatementsList) {
+                    addChildren(namespaceStatement, fileName, line, isLambdaReturnType);
+                }
+            } else if (scopeStatement->kind == StatementKind::Class) {
+                addChildren(scopeStatement, fileName, -1, isLambdaReturnType);
+            } else {
+                addChildren(scopeStatement, fileName, line, isLambdaReturnType);
+            }
 
-            // add members of all fusings
-            mUsings = mParser->getFileUsings(fileName);
-            foreach (const QString& namespaceName, mUsings) {
+            // add members of all usings (in current scope ) and not added before
+            foreach (const QString& namespaceName,scopeStatement->usingList) {
                 PStatementList namespaceStatementsList =
                         mParser->findNamespace(namespaceName);
                 if (!namespaceStatementsList)
                     continue;
-                foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
+                foreach (const PStatement& namespaceStatement,*namespaceStatementsList) {
                     addChildren(namespaceStatement, fileName, line, isLambdaReturnType);
                 }
             }
-
-        } else {
-            //the identifier to be completed is a member of variable/class
-            if (memberOperator == "::" && ownerExpression.isEmpty()) {
-                // start with '::', we only find in global
-                // add all global members and not added before
-                addChildren(nullptr, fileName, line);
-                return;
+            if (scopeStatement->kind == StatementKind::Lambda) {
+                foreach (const QString& phrase, scopeStatement->lambdaCaptures) {
+                    if (phrase=="&" || phrase == "=" || phrase =="this")
+                        continue;
+                    PStatement statement = mParser->findStatementOf(
+                        scopeStatement->fileName,
+                            phrase,scopeStatement->line);
+                    if (statement)
+                        addStatement(statement,scopeStatement->fileName, scopeStatement->line);
+                }
+                if (scopeStatement->lambdaCaptures.contains("&")
+                        || scopeStatement->lambdaCaptures.contains("=")) {
+                    scopeStatement = scopeStatement->parentScope.lock();
+                } else if (scopeStatement->lambdaCaptures.contains("this")) {
+                    do {
+                        scopeStatement = scopeStatement->parentScope.lock();
+                    } while (scopeStatement && scopeStatement->kind!=StatementKind::Class
+                             && scopeStatement->kind!=StatementKind::Namespace);
+                } else {
+                    do {
+                        scopeStatement = scopeStatement->parentScope.lock();
+                    } while (scopeStatement && scopeStatement->kind!=StatementKind::Namespace);
+                }
+                continue;
             }
-            if (memberExpression.length()==2 && memberExpression.front()!="~")
-                return;
-            if (memberExpression.length()>2)
-                return;
+            scopeStatement=scopeStatement->parentScope.lock();
+        }
 
-            PStatement scope = mCurrentScope;//the scope the expression in
-            PStatement parentTypeStatement;
-            PEvalStatement ownerStatement = mParser->evalExpression(fileName,
-                                        ownerExpression,
-                                        scope);
+        if (isCancelled())
+            return;
+        // add all global members and not added before
+        addChildren(nullptr, fileName, line, isLambdaReturnType);
 
-            if(!ownerStatement || !ownerStatement->effectiveTypeStatement) {
-                return;
-            }
-            if (memberOperator == "::") {
-                if (ownerStatement->kind==EvalStatementKind::Namespace) {
-                    //there might be many statements corresponding to one namespace;
-                    PStatementList namespaceStatementsList =
-                            mParser->findNamespace(ownerStatement->baseType);
-                    if (namespaceStatementsList) {
-                        foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
-                            addChildren(namespaceStatement, fileName, line);
-                        }
-                    }
-                    return;
-                }
+        if (isCancelled())
+            return;
+        // add members of all fusings
+        mUsings = mParser->getFileUsings(fileName);
+        foreach (const QString& namespaceName, mUsings) {
+            PStatementList namespaceStatementsList =
+                    mParser->findNamespace(namespaceName);
+            if (!namespaceStatementsList)
+                continue;
+            foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
+                addChildren(namespaceStatement, fileName, line, isLambdaReturnType);
             }
+        }
+        return;
+    }
+
+    //the identifier to be completed is a member of variable/class
+    if (memberOperator == "::" && ownerExpression.isEmpty()) {
+        // start with '::', we only find in global
+        // add all global members and not added before
+        addChildren(nullptr, fileName, line);
+        return;
+    }
+    if (memberExpression.length()==2 && memberExpression.front()!="~")
+        return;
+    if (memberExpression.length()>2)
+        return;
+
+    PStatement scope = mCurrentScope;//the scope the expression in
+    PStatement parentTypeStatement;
+    PEvalStatement ownerStatement = mParser->evalExpression(fileName,
+                                ownerExpression,
+                                scope);
 
-            // find the most inner scope statement that has a name (not a block)
-            PStatement scopeTypeStatement = mCurrentScope;
-            while (scopeTypeStatement && !isScopeTypeKind(scopeTypeStatement->kind)) {
-                scopeTypeStatement = scopeTypeStatement->parentScope.lock();
+    if(!ownerStatement || !ownerStatement->effectiveTypeStatement) {
+        return;
+    }
+    if (memberOperator == "::") {
+        if (ownerStatement->kind==EvalStatementKind::Namespace) {
+            //there might be many statements corresponding to one namespace;
+            PStatementList namespaceStatementsList =
+                    mParser->findNamespace(ownerStatement->baseType);
+            if (namespaceStatementsList) {
+                foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
+                    addChildren(namespaceStatement, fileName, line);
+                }
             }
-            if (
-                    (memberOperator != "::")
-                    && (
-                        ownerStatement->kind == EvalStatementKind::Variable)
-                    ) {
-                // Get type statement  of current (scope) statement
-                PStatement classTypeStatement = ownerStatement->effectiveTypeStatement;
+            return;
+        }
+    }
 
+    // find the most inner scope statement that has a name (not a block)
+    PStatement scopeTypeStatement = mCurrentScope;
+    while (scopeTypeStatement && !isScopeTypeKind(scopeTypeStatement->kind)) {
+        scopeTypeStatement = scopeTypeStatement->parentScope.lock();
+    }
+    if (
+            (memberOperator != "::")
+            && (
+                ownerStatement->kind == EvalStatementKind::Variable)
+            ) {
+        // Get type statement  of current (scope) statement
+        PStatement classTypeStatement = ownerStatement->effectiveTypeStatement;
+
+        if (!classTypeStatement)
+            return;
+        // It's a iterator
+        if (ownerStatement
+                && ownerStatement->typeStatement
+                && STLIterators.contains(ownerStatement->typeStatement->command)
+                && (memberOperator == "->"
+                    || memberOperator == "->*")
+        ) {
+            PStatement parentScope = ownerStatement->typeStatement->parentScope.lock();
+            if (STLContainers.contains(parentScope->fullName)) {
+                QString typeName=mParser->findFirstTemplateParamOf(fileName,ownerStatement->templateParams, parentScope);
+//                        qDebug()<<"typeName"<<typeName<<lastResult->baseStatement->type<<lastResult->baseStatement->command;
+                classTypeStatement=mParser->findTypeDefinitionOf(fileName, typeName,parentScope);
                 if (!classTypeStatement)
                     return;
-                // It's a iterator
-                if (ownerStatement
-                        && ownerStatement->typeStatement
-                        && STLIterators.contains(ownerStatement->typeStatement->command)
-                        && (memberOperator == "->"
-                            || memberOperator == "->*")
-                ) {
-                    PStatement parentScope = ownerStatement->typeStatement->parentScope.lock();
-                    if (STLContainers.contains(parentScope->fullName)) {
-                        QString typeName=mParser->findFirstTemplateParamOf(fileName,ownerStatement->templateParams, parentScope);
-//                        qDebug()<<"typeName"<<typeName<<lastResult->baseStatement->type<<lastResult->baseStatement->command;
-                        classTypeStatement=mParser->findTypeDefinitionOf(fileName, typeName,parentScope);
-                        if (!classTypeStatement)
-                            return;
-                    } else if (STLMaps.contains(parentScope->fullName)) {
-                        QString typeName="std::pair";
-                        classTypeStatement=mParser->findTypeDefinitionOf(fileName, typeName,parentScope);
-                        if (!classTypeStatement)
-                            return;
-                    }
-                } else if (STLPointers.contains(classTypeStatement->fullName)
-                   && (memberOperator == "->"
-                       || memberOperator == "->*")
-                        && ownerStatement->baseStatement) {
-                                   //is a smart pointer
-                    QString typeName= mParser->findFirstTemplateParamOf(
-                                fileName,
-                                ownerStatement->baseStatement->type,
-                                scope);
-                    classTypeStatement = mParser->findTypeDefinitionOf(
-                                fileName,
-                                typeName,
-                                scope);
-                    if (!classTypeStatement)
-                        return;
-                } else {
-                    //normal member access
-                    if (memberOperator=="." && ownerStatement->pointerLevel !=0)
-                        return;
-                    if (memberOperator=="->" && ownerStatement->pointerLevel!=1)
-                        return;
-                }
-                if (!isIncluded(classTypeStatement->fileName) &&
-                    !isIncluded(classTypeStatement->definitionFileName))
+            } else if (STLMaps.contains(parentScope->fullName)) {
+                QString typeName="std::pair";
+                classTypeStatement=mParser->findTypeDefinitionOf(fileName, typeName,parentScope);
+                if (!classTypeStatement)
                     return;
-                if ((classTypeStatement == scopeTypeStatement) || (ownerStatement->effectiveTypeStatement->command == "this")) {
-                    //we can use all members
-                    addChildren(classTypeStatement,fileName,-1);
-                } else { // we can only use public members
-                    const StatementMap& children = mParser->statementList().childrenStatements(classTypeStatement);
-                    if (children.isEmpty())
-                        return;
-                    foreach (const PStatement& childStatement, children) {
-                        if ((childStatement->accessibility==StatementAccessibility::Public)
-                                && !(
-                                    childStatement->kind == StatementKind::Constructor
-                                    || childStatement->kind == StatementKind::Destructor)
-                                && !mAddedStatements.contains(childStatement->command)) {
-                            addStatement(childStatement,fileName,-1);
-                        }
+            }
+        } else if (STLPointers.contains(classTypeStatement->fullName)
+           && (memberOperator == "->"
+               || memberOperator == "->*")
+                && ownerStatement->baseStatement) {
+                           //is a smart pointer
+            QString typeName= mParser->findFirstTemplateParamOf(
+                        fileName,
+                        ownerStatement->baseStatement->type,
+                        scope);
+            classTypeStatement = mParser->findTypeDefinitionOf(
+                        fileName,
+                        typeName,
+                        scope);
+            if (!classTypeStatement)
+                return;
+        } else {
+            //normal member access
+            if (memberOperator=="." && ownerStatement->pointerLevel !=0)
+                return;
+            if (memberOperator=="->" && ownerStatement->pointerLevel!=1)
+                return;
+        }
+        if (!isIncluded(classTypeStatement->fileName) &&
+            !isIncluded(classTypeStatement->definitionFileName))
+            return;
+        if ((classTypeStatement == scopeTypeStatement) || (ownerStatement->effectiveTypeStatement->command == "this")) {
+            //we can use all members
+            addChildren(classTypeStatement,fileName,-1);
+        } else { // we can only use public members
+            const StatementMap& children = mParser->statementList().childrenStatements(classTypeStatement);
+            if (children.isEmpty())
+                return;
+            foreach (const PStatement& childStatement, children) {
+                if ((childStatement->accessibility==StatementAccessibility::Public)
+                        && !(
+                            childStatement->kind == StatementKind::Constructor
+                            || childStatement->kind == StatementKind::Destructor)
+                        && !mAddedStatements.contains(childStatement->command)) {
+                    addStatement(childStatement,fileName,-1);
+                }
+            }
+        }
+    //todo friend
+    } else if ((memberOperator == "::")
+               && (ownerStatement->kind == EvalStatementKind::Type)) {
+        //we can add all child enum definess
+        PStatement classTypeStatement = ownerStatement->effectiveTypeStatement;
+        if (!classTypeStatement)
+            return;
+        if (!isIncluded(classTypeStatement->fileName) &&
+            !isIncluded(classTypeStatement->definitionFileName))
+            return;
+        if (classTypeStatement->kind == StatementKind::EnumType
+                || classTypeStatement->kind == StatementKind::EnumClassType) {
+            const StatementMap& children =
+                    mParser->statementList().childrenStatements(classTypeStatement);
+            foreach (const PStatement& child,children) {
+                addStatement(child,fileName,line);
+            }
+        } else {
+            //class
+            if (classTypeStatement == scopeTypeStatement) {
+                //we can use all static members
+                const StatementMap& children =
+                        mParser->statementList().childrenStatements(classTypeStatement);
+                foreach (const PStatement& childStatement, children) {
+                    if (
+                      (childStatement->isStatic())
+                       || (childStatement->kind == StatementKind::Typedef
+                        || childStatement->kind == StatementKind::Class
+                        || childStatement->kind == StatementKind::Enum
+                        || childStatement->kind == StatementKind::EnumClassType
+                        || childStatement->kind == StatementKind::EnumType
+                           )) {
+                        addStatement(childStatement,fileName,-1);
                     }
                 }
-            //todo friend
-            } else if ((memberOperator == "::")
-                       && (ownerStatement->kind == EvalStatementKind::Type)) {
-                //we can add all child enum definess
-                PStatement classTypeStatement = ownerStatement->effectiveTypeStatement;
-                if (!classTypeStatement)
-                    return;
-                if (!isIncluded(classTypeStatement->fileName) &&
-                    !isIncluded(classTypeStatement->definitionFileName))
-                    return;
-                if (classTypeStatement->kind == StatementKind::EnumType
-                        || classTypeStatement->kind == StatementKind::EnumClassType) {
-                    const StatementMap& children =
-                            mParser->statementList().childrenStatements(classTypeStatement);
-                    foreach (const PStatement& child,children) {
-                        addStatement(child,fileName,line);
-                    }
-                } else {
-                    //class
-                    if (classTypeStatement == scopeTypeStatement) {
-                        //we can use all static members
-                        const StatementMap& children =
-                                mParser->statementList().childrenStatements(classTypeStatement);
-                        foreach (const PStatement& childStatement, children) {
-                            if (
-                              (childStatement->isStatic())
-                               || (childStatement->kind == StatementKind::Typedef
-                                || childStatement->kind == StatementKind::Class
-                                || childStatement->kind == StatementKind::Enum
-                                || childStatement->kind == StatementKind::EnumClassType
-                                || childStatement->kind == StatementKind::EnumType
-                                   )) {
-                                addStatement(childStatement,fileName,-1);
-                            }
-                        }
-                    } else {
-                        // we can only use public static members
-                        const StatementMap& children =
-                                mParser->statementList().childrenStatements(classTypeStatement);
-                        foreach (const PStatement& childStatement,children) {
-                            if (
-                              (childStatement->isStatic())
-                               || (childStatement->kind == StatementKind::Typedef
-                                || childStatement->kind == StatementKind::Class
-                                || childStatement->kind == StatementKind::Enum
-                                || childStatement->kind == StatementKind::EnumClassType
-                                || childStatement->kind == StatementKind::EnumType
-                                   )) {
-                                if (childStatement->accessibility == StatementAccessibility::Public)
-                                    addStatement(childStatement,fileName,-1);
-                            }
-                        }
+            } else {
+                // we can only use public static members
+                const StatementMap& children =
+                        mParser->statementList().childrenStatements(classTypeStatement);
+                foreach (const PStatement& childStatement,children) {
+                    if (
+                      (childStatement->isStatic())
+                       || (childStatement->kind == StatementKind::Typedef
+                        || childStatement->kind == StatementKind::Class
+                        || childStatement->kind == StatementKind::Enum
+                        || childStatement->kind == StatementKind::EnumClassType
+                        || childStatement->kind == StatementKind::EnumType
+                           )) {
+                        if (childStatement->accessibility == StatementAccessibility::Public)
+                            addStatement(childStatement,fileName,-1);
                     }
                 }
             }
@@ -936,7 +1331,7 @@ void CodeCompletionPopup::getCompletionFor(
     }
 }
 
-void CodeCompletionPopup::getCompletionForFunctionWithoutDefinition(const QString& preWord, QStringList ownerExpression, const QString &memberOperator, const QStringList &memberExpression, const QString &fileName, int line)
+void CodeCompletionListBuilder::getCompletionForFunctionWithoutDefinition(const QString& preWord, QStringList ownerExpression, const QString &memberOperator, const QStringList &memberExpression, const QString &fileName, int line)
 {
     if(!mParser) {
         return;
@@ -946,111 +1341,95 @@ void CodeCompletionPopup::getCompletionForFunctionWithoutDefinition(const QStrin
     if (memberOperator.isEmpty() && ownerExpression.isEmpty() && memberExpression.isEmpty())
         return;
 
-    if (!mParser->freeze())
-        return;
-    {
-        auto action = finally([this]{
-            mParser->unFreeze();
-        });
-
-        if (memberOperator.isEmpty()) {
-            getCompletionListForComplexKeyword(preWord);
-            PStatement scopeStatement = mCurrentScope;
-            //add members of current scope that not added before
-            while (scopeStatement && scopeStatement->kind!=StatementKind::Namespace
-                   && scopeStatement->kind!=StatementKind::Class) {
-                scopeStatement = scopeStatement->parentScope.lock();
-            }
-            if (scopeStatement) {
-                if (scopeStatement->kind == StatementKind::Namespace) {
-                    //namespace;
-                    PStatementList namespaceStatementsList =
-                            mParser->findNamespace(scopeStatement->fullName);
-                    if (namespaceStatementsList) {
-                        foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
-                            addFunctionWithoutDefinitionChildren(namespaceStatement, fileName, line);
-                        }
+    if (memberOperator.isEmpty()) {
+        getCompletionListForComplexKeyword(preWord);
+        PStatement scopeStatement = mCurrentScope;
+        //add members of current scope that not added before
+        while (scopeStatement && scopeStatement->kind!=StatementKind::Namespace
+               && scopeStatement->kind!=StatementKind::Class) {
+            scopeStatement = scopeStatement->parentScope.lock();
+        }
+        if (scopeStatement) {
+            if (scopeStatement->kind == StatementKind::Namespace) {
+                //namespace;
+                PStatementList namespaceStatementsList =
+                        mParser->findNamespace(scopeStatement->fullName);
+                if (namespaceStatementsList) {
+                    foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
+                        addFunctionWithoutDefinitionChildren(namespaceStatement, fileName, line);
                     }
-                } else {
-                    //class
-                    addKeyword("operator");
-                    addFunctionWithoutDefinitionChildren(scopeStatement, fileName, line);
                 }
             } else {
-                //global
+                //class
+                addKeyword("operator");
                 addFunctionWithoutDefinitionChildren(scopeStatement, fileName, line);
             }
         } else {
-            if (memberOperator != "::")
-                return;
-            //the identifier to be completed is a member of variable/class
+            //global
+            addFunctionWithoutDefinitionChildren(scopeStatement, fileName, line);
+        }
+    } else {
+        if (memberOperator != "::")
+            return;
+        //the identifier to be completed is a member of variable/class
 
-            if (ownerExpression.isEmpty()) {
-                // start with '::', we only find in global
-                // add all global members and not added before
-                addFunctionWithoutDefinitionChildren(nullptr, fileName, line);
-                return;
-            }
-            if (memberExpression.length()==2 && memberExpression.front()!="~")
-                return;
-            if (memberExpression.length()>2)
-                return;
+        if (ownerExpression.isEmpty()) {
+            // start with '::', we only find in global
+            // add all global members and not added before
+            addFunctionWithoutDefinitionChildren(nullptr, fileName, line);
+            return;
+        }
+        if (memberExpression.length()==2 && memberExpression.front()!="~")
+            return;
+        if (memberExpression.length()>2)
+            return;
 
-            PStatement scope = mCurrentScope;//the scope the expression in
-            PStatement parentTypeStatement;
-            PEvalStatement ownerStatement = mParser->evalExpression(fileName,
-                                        ownerExpression,
-                                        scope);
-            if(!ownerStatement  || !ownerStatement->effectiveTypeStatement) {
-                return;
-            }
-            if (ownerStatement->kind==EvalStatementKind::Namespace) {
-                //there might be many statements corresponding to one namespace;
-                PStatementList namespaceStatementsList =
-                        mParser->findNamespace(ownerStatement->baseType);
-                if (namespaceStatementsList) {
-                    foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
-                        addFunctionWithoutDefinitionChildren(namespaceStatement, fileName, line);
-                    }
+        PStatement scope = mCurrentScope;//the scope the expression in
+        PStatement parentTypeStatement;
+        PEvalStatement ownerStatement = mParser->evalExpression(fileName,
+                                    ownerExpression,
+                                    scope);
+        if(!ownerStatement  || !ownerStatement->effectiveTypeStatement) {
+            return;
+        }
+        if (ownerStatement->kind==EvalStatementKind::Namespace) {
+            //there might be many statements corresponding to one namespace;
+            PStatementList namespaceStatementsList =
+                    mParser->findNamespace(ownerStatement->baseType);
+            if (namespaceStatementsList) {
+                foreach (const PStatement& namespaceStatement, *namespaceStatementsList) {
+                    addFunctionWithoutDefinitionChildren(namespaceStatement, fileName, line);
                 }
-                return;
-            } else if (ownerStatement->effectiveTypeStatement->kind == StatementKind::Class) {
-                addKeyword("operator");
-                addFunctionWithoutDefinitionChildren(ownerStatement->effectiveTypeStatement, fileName, line);
             }
+            return;
+        } else if (ownerStatement->effectiveTypeStatement->kind == StatementKind::Class) {
+            addKeyword("operator");
+            addFunctionWithoutDefinitionChildren(ownerStatement->effectiveTypeStatement, fileName, line);
         }
     }
 }
 
-void CodeCompletionPopup::getCompletionListForLabels(const QString &fileName, int line)
+void CodeCompletionListBuilder::getCompletionListForLabels(const QString &fileName, int line)
 {
     if (!mParser->enabled())
         return;
 
-    if (!mParser->freeze())
-        return;
-    {
-        auto action = finally([this]{
-            mParser->unFreeze();
-        });
-        PStatement scopeStatement = mParser->findScopeStatement(fileName,line);
-        if (scopeStatement && (scopeStatement->kind == StatementKind::Function
-                || scopeStatement->kind == StatementKind::Constructor
-                || scopeStatement->kind == StatementKind::Destructor
-                || scopeStatement->kind == StatementKind::Lambda)
-                ) {
-            foreach(const PStatement &child, scopeStatement->children) {
-                if (child->kind == StatementKind::Label) {
-                    mFullCompletionStatementList.append(child);
-                }
+    PStatement scopeStatement = mParser->findScopeStatement(fileName,line);
+    if (scopeStatement && (scopeStatement->kind == StatementKind::Function
+            || scopeStatement->kind == StatementKind::Constructor
+            || scopeStatement->kind == StatementKind::Destructor
+            || scopeStatement->kind == StatementKind::Lambda)
+            ) {
+        foreach(const PStatement &child, scopeStatement->children) {
+            if (child->kind == StatementKind::Label) {
+                appendStatement(child);
             }
         }
     }
 }
 
-void CodeCompletionPopup::getCompletionListForComplexKeyword(const QString &preWord)
+void CodeCompletionListBuilder::getCompletionListForComplexKeyword(const QString &preWord)
 {
-    mFullCompletionStatementList.clear();
     if (preWord == "long") {
         addKeyword("long");
         addKeyword("double");
@@ -1072,35 +1451,27 @@ void CodeCompletionPopup::getCompletionListForComplexKeyword(const QString &preW
     }
 }
 
-void CodeCompletionPopup::getCompletionListForNamespaces(const QString &/*preWord*/,
+void CodeCompletionListBuilder::getCompletionListForNamespaces(const QString &/*preWord*/,
                                                          const QString& fileName,
                                                          int line)
 {
     if (!mParser->enabled())
         return;
 
-    if (!mParser->freeze())
-        return;
-    {
-        auto action = finally([this]{
-            mParser->unFreeze();
-        });
-        QList<QString> namespaceNames = mParser->namespaces();
-        foreach (const QString& name, namespaceNames) {
-            PStatementList namespaces = mParser->findNamespace(name);
-            foreach(const PStatement& statement, *namespaces) {
-                if (isIncluded(statement->fileName)
-                        || isIncluded(statement->definitionFileName)) {
-                    addStatement(statement,fileName,line);
-                    continue;
-                }
+    QList<QString> namespaceNames = mParser->namespaces();
+    foreach (const QString& name, namespaceNames) {
+        PStatementList namespaces = mParser->findNamespace(name);
+        foreach(const PStatement& statement, *namespaces) {
+            if (isIncluded(statement->fileName)
+                    || isIncluded(statement->definitionFileName)) {
+                addStatement(statement,fileName,line);
+                continue;
             }
-
         }
     }
 }
 
-void CodeCompletionPopup::getCompletionListForTypes(const QString &preWord, const QString &fileName, int line)
+void CodeCompletionListBuilder::getCompletionListForTypes(const QString &preWord, const QString &fileName, int line)
 {
     if (preWord=="typedef") {
         addKeyword("const");
@@ -1117,231 +1488,44 @@ void CodeCompletionPopup::getCompletionListForTypes(const QString &preWord, cons
     if (!mParser->enabled())
         return;
 
-    if (!mParser->freeze())
-        return;
-    {
-        auto action = finally([this]{
-            mParser->unFreeze();
-        });
-        QList<PStatement> statements = mParser->listTypeStatements(fileName,line);
-        foreach(const PStatement& statement, statements) {
-            if (isIncluded(statement->fileName)
-                    || isIncluded(statement->definitionFileName)) {
-                addStatement(statement,fileName,line);
-            }
+    QList<PStatement> statements = mParser->listTypeStatements(fileName,line);
+    foreach(const PStatement& statement, statements) {
+        if (isIncluded(statement->fileName)
+                || isIncluded(statement->definitionFileName)) {
+            addStatement(statement,fileName,line);
         }
     }
 }
 
-void CodeCompletionPopup::getCompletionListForLiteralOperators(const QString &fileName, int line)
+void CodeCompletionListBuilder::getCompletionListForLiteralOperators(const QString &fileName, int line)
 {
     if (!mParser->enabled())
         return;
 
-    if (!mParser->freeze())
-        return;
-    {
-        auto action = finally([this]{
-            mParser->unFreeze();
-        });
-        QList<PStatement> statements = mParser->listLiteralOperators(fileName,line);
-        foreach(const PStatement& statement, statements) {
-            if (isIncluded(statement->fileName)
-                    || isIncluded(statement->definitionFileName)) {
-                addStatement(statement,fileName,line);
-            }
+    QList<PStatement> statements = mParser->listLiteralOperators(fileName,line);
+    foreach(const PStatement& statement, statements) {
+        if (isIncluded(statement->fileName)
+                || isIncluded(statement->definitionFileName)) {
+            addStatement(statement,fileName,line);
         }
     }
 }
 
-void CodeCompletionPopup::addKeyword(const QString &keyword)
+void CodeCompletionListBuilder::addKeyword(const QString &keyword)
 {
     PStatement statement = std::make_shared<Statement>();
     statement->command = keyword;
     statement->kind = StatementKind::Keyword;
     statement->fullName = keyword;
     statement->usageCount = 0;
-    mFullCompletionStatementList.append(statement);
+    appendStatement(statement);
 }
 
-bool CodeCompletionPopup::isIncluded(const QString &fileName)
+bool CodeCompletionListBuilder::isIncluded(const QString &fileName)
 {
     return mIncludedFiles.contains(fileName);
 }
 
-SymbolUsageManager *CodeCompletionPopup::symbolUsageManager() const
-{
-    return mSymbolUsageManager;
-}
-
-void CodeCompletionPopup::setSymbolUsageManager(SymbolUsageManager *newSymbolUsageManager)
-{
-    mSymbolUsageManager = newSymbolUsageManager;
-}
-
-void CodeCompletionPopup::setHideSymbolsStartWithTwoUnderline(bool newHideSymbolsStartWithTwoUnderline)
-{
-    mHideSymbolsStartWithTwoUnderline = newHideSymbolsStartWithTwoUnderline;
-}
-
-void CodeCompletionPopup::setLineHeightFactor(float factor)
-{
-    mDelegate->setLineHeightFactor(factor);
-}
-
-bool CodeCompletionPopup::hideSymbolsStartWithTwoUnderline() const
-{
-    return mHideSymbolsStartWithTwoUnderline;
-}
-
-bool CodeCompletionPopup::hideSymbolsStartWithUnderline() const
-{
-    return mHideSymbolsStartWithUnderline;
-}
-
-void CodeCompletionPopup::setHideSymbolsStartWithUnderline(bool newHideSymbolsStartWithUnderline)
-{
-    mHideSymbolsStartWithUnderline = newHideSymbolsStartWithUnderline;
-}
-
-const QString &CodeCompletionPopup::memberOperator() const
-{
-    return mMemberOperator;
-}
-
-const QList<PCodeSnippet> &CodeCompletionPopup::codeSnippets() const
-{
-    return mCodeSnippets;
-}
-
-void CodeCompletionPopup::setCodeSnippets(const QList<PCodeSnippet> &newCodeSnippets)
-{
-    mCodeSnippets = newCodeSnippets;
-}
-
-void CodeCompletionPopup::setColors(const std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > > &newColors)
-{
-    mColors = newColors;
-}
-
-const QString &CodeCompletionPopup::memberPhrase() const
-{
-    return mMemberPhrase;
-}
-
-const PStatement &CodeCompletionPopup::currentScope() const
-{
-    return mCurrentScope;
-}
-
-void CodeCompletionPopup::setCurrentScope(const PStatement &newCurrentStatement)
-{
-    mCurrentScope = newCurrentStatement;
-}
-
-const std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > >& CodeCompletionPopup::colors() const
-{
-    return mColors;
-}
-
-bool CodeCompletionPopup::sortByScope() const
-{
-    return mSortByScope;
-}
-
-void CodeCompletionPopup::setSortByScope(bool newSortByScope)
-{
-    mSortByScope = newSortByScope;
-}
-
-bool CodeCompletionPopup::ignoreCase() const
-{
-    return mIgnoreCase;
-}
-
-void CodeCompletionPopup::setIgnoreCase(bool newIgnoreCase)
-{
-    mIgnoreCase = newIgnoreCase;
-}
-
-bool CodeCompletionPopup::showCodeSnippets() const
-{
-    return mShowCodeSnippets;
-}
-
-void CodeCompletionPopup::setShowCodeSnippets(bool newShowCodeIns)
-{
-    mShowCodeSnippets = newShowCodeIns;
-}
-
-bool CodeCompletionPopup::showKeywords() const
-{
-    return mShowKeywords;
-}
-
-void CodeCompletionPopup::setShowKeywords(bool newShowKeywords)
-{
-    mShowKeywords = newShowKeywords;
-}
-
-bool CodeCompletionPopup::recordUsage() const
-{
-    return mRecordUsage;
-}
-
-void CodeCompletionPopup::setRecordUsage(bool newRecordUsage)
-{
-    mRecordUsage = newRecordUsage;
-}
-
-int CodeCompletionPopup::showCount() const
-{
-    return mShowCount;
-}
-
-void CodeCompletionPopup::setShowCount(int newShowCount)
-{
-    mShowCount = newShowCount;
-}
-
-const PCppParser &CodeCompletionPopup::parser() const
-{
-    return mParser;
-}
-
-void CodeCompletionPopup::setParser(const PCppParser &newParser)
-{
-    mParser = newParser;
-}
-
-void CodeCompletionPopup::hideEvent(QHideEvent *event)
-{
-    QMutexLocker locker(&mMutex);
-    mListView->setKeypressedCallback(nullptr);
-    mCompletionStatementList.clear();
-//    foreach (PStatement statement, mFullCompletionStatementList) {
-//        statement->matchPositions.clear();
-//    }
-    mFullCompletionStatementList.clear();
-    mIncludedFiles.clear();
-    mUsings.clear();
-    mAddedStatements.clear();
-    mCurrentScope = nullptr;
-    mParser = nullptr;
-    QWidget::hideEvent(event);
-}
-
-bool CodeCompletionPopup::event(QEvent *event)
-{
-    bool result = QWidget::event(event);
-    if (event->type() == QEvent::FontChange) {
-        if (mListView) {
-            mListView->setFont(font());
-            mDelegate->setFont(font());
-        }
-    }
-    return result;
-}
 
 CodeCompletionListModel::CodeCompletionListModel(const StatementList *statements, IconsManager *iconsManager,QObject *parent):
     QAbstractListModel(parent),
@@ -20,6 +20,8 @@
 #include <QListView>
 #include <QWidget>
 #include <QStyledItemDelegate>
+#include <QThread>
+#include <QMutex>
 #include "../parser/cppparser.h"
 #include "codecompletionlistview.h"
 
@@ -53,6 +55,107 @@ enum class CodeCompletionType {
     LiteralOperators
 };
 
+using CompletionAutoInsertCallback = std::function<void ()>;
+
+/*
+ * Collects the completion candidates of one request in a worker thread.
+ * Found statements are handed to the popup in batches (see statementsFound()),
+ * so the popup can be shown before the parser's statements are fully walked.
+ */
+class CodeCompletionListBuilder : public QThread {
+    Q_OBJECT
+public:
+    explicit CodeCompletionListBuilder(
+            const PCppParser& parser,
+            CodeCompletionType type,
+            const QString& preWord,
+            const QStringList& ownerExpression,
+            const QString& memberOperator,
+            const QStringList& memberExpression,
+            const QString& fileName,
+            int line,
+            const QSet<QString>& customKeywords,
+            QObject *parent = nullptr);
+
+    void setShowKeywords(bool newShowKeywords);
+    void setShowCodeSnippets(bool newShowCodeSnippets);
+    void setCodeSnippets(const QList<PCodeSnippet> &newCodeSnippets);
+
+    void build();
+    void cancel();
+    bool isCancelled() const;
+    StatementList takeFoundStatements();
+signals:
+    void statementsFound();
+private:
+    void addChildren(const PStatement& scopeStatement, const QString& fileName,
+                     int line, bool onlyTypes=false);
+    void addFunctionWithoutDefinitionChildren(const PStatement& scopeStatement, const QString& fileName,
+                     int line);
+    void addStatement(const PStatement& statement, const QString& fileName, int line);
+    void getKeywordCompletionFor(const QSet<QString>& customKeywords);
+    void getMacroCompletionList(const QString &fileName, int line);
+    void getCompletionFor(
+            QStringList ownerExpression,
+            const QString& memberOperator,
+            const QStringList& memberExpression,
+            const QString& fileName,
+            int line,
+            const QSet<QString>& customKeywords);
+
+    void getCompletionForFunctionWithoutDefinition(
+            const QString& preWord,
+            QStringList ownerExpression,
+            const QString& memberOperator,
+            const QStringList& memberExpression,
+            const QString& fileName,
+            int line);
+
+    void getCompletionListForLabels(const QString& fileName,
+                                    int line);
+    void getCompletionListForComplexKeyword(const QString& preWord);
+    void getCompletionListForNamespaces(const QString &preWord,
+                                        const QString& fileName,
+                                        int line);
+    void getCompletionListForTypes(const QString &preWord,
+                                        const QString& fileName,
+                                        int line);
+    void getCompletionListForLiteralOperators(const QString& fileName,
+                                        int line);
+    void addKeyword(const QString& keyword);
+    bool isIncluded(const QString& fileName);
+    bool freezeParser();
+    void appendStatement(const PStatement& statement);
+    void flushFoundStatements();
+private:
+    PCppParser mParser;
+    PStatement mCurrentScope;
+    CodeCompletionType mType;
+    QString mPreWord;
+    QStringList mOwnerExpression;
+    QString mMemberOperator;
+    QStringList mMemberExpression;
+    QString mMemberPhrase;
+    QString mFileName;
+    int mLine;
+    QSet<QString> mCustomKeywords;
+    bool mShowKeywords;
+    bool mShowCodeSnippets;
+    QList<PCodeSnippet> mCodeSnippets;
+
+    QSet<QString> mIncludedFiles;
+    QSet<QString> mUsings;
+    QSet<QString> mAddedStatements;
+    StatementList mStatements; // found, not flushed yet
+    StatementList mFoundStatements; // flushed, waiting to be taken by the popup
+    QMutex mFoundStatementsMutex;
+    QAtomicInt mCancelled;
+
+    // QThread interface
+protected:
+    void run() override;
+};
+
 class CodeCompletionListItemDelegate: public QStyledItemDelegate {
     Q_OBJECT
 public:
@@ -99,6 +202,7 @@ public:
 
     void setKeypressedCallback(const KeyPressedCallback &newKeypressedCallback);
     void setShowEditorCaretFunc(const ShowEditorCaretFunc &newShowEditorCaretFunc);
+    void setAutoInsertCallback(const CompletionAutoInsertCallback &newAutoInsertCallback);
     void prepareSearch(const QString& preWord,
                        const QStringList & ownerExpression,
                        const QString& memberOperator,
@@ -138,51 +242,19 @@ public:
     void setHideSymbolsStartWithTwoUnderline(bool newHideSymbolsStartWithTwoUnderline);
     void setLineHeightFactor(float factor);
 
-    const PStatement &currentScope() const;
-    void setCurrentScope(const PStatement &newCurrentStatement);
     const std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > >& colors() const;
     void setColors(const std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > > &newColors);
     const QString &memberPhrase() const;
     const QList<PCodeSnippet> &codeSnippets() const;
     void setCodeSnippets(const QList<PCodeSnippet> &newCodeSnippets);
+    bool building() const;
 private:
-    void addChildren(const PStatement& scopeStatement, const QString& fileName,
-                     int line, bool onlyTypes=false);
-    void addFunctionWithoutDefinitionChildren(const PStatement& scopeStatement, const QString& fileName,
-                     int line);
-    void addStatement(const PStatement& statement, const QString& fileName, int line);
     void filterList(const QString& member);
-    void getKeywordCompletionFor(const QSet<QString>& customKeywords);
-    void getMacroCompletionList(const QString &fileName, int line);
-    void getCompletionFor(
-            QStringList ownerExpression,
-            const QString& memberOperator,
-            const QStringList& memberExpression,
-            const QString& fileName,
-            int line,
-            const QSet<QString>& customKeywords);
-
-    void getCompletionForFunctionWithoutDefinition(
-            const QString& preWord,
-            QStringList ownerExpression,
-            const QString& memberOperator,
-            const QStringList& memberExpression,
-            const QString& fileName,
-            int line);
-
-    void getCompletionListForLabels(const QString& fileName,
-                                    int line);
-    void getCompletionListForComplexKeyword(const QString& preWord);
-    void getCompletionListForNamespaces(const QString &preWord,
-                                        const QString& fileName,
-                                        int line);
-    void getCompletionListForTypes(const QString &preWord,
-                                        const QString& fileName,
-                                        int line);
-    void getCompletionListForLiteralOperators(const QString& fileName,
-                                        int line);
-    void addKeyword(const QString& keyword);
-    bool isIncluded(const QString& fileName);
+    void cancelBuilding();
+    void updateCompletionList();
+    void onStatementsFound(CodeCompletionListBuilder *builder);
+    void onBuildFinished(CodeCompletionListBuilder *builder);
+    void applyColors(const QString& schemeName);
 private:
     CodeCompletionListView * mListView;
     CodeCompletionListModel* mModel;
@@ -190,17 +262,17 @@ private:
     //QList<PStatement> mCodeInsStatements; //temporary (user code template) statements created when show code suggestion
     StatementList mFullCompletionStatementList;
     StatementList mCompletionStatementList;
-    QSet<QString> mIncludedFiles;
-    QSet<QString> mUsings;
-    QSet<QString> mAddedStatements;
     QString mMemberPhrase;
     QString mMemberOperator;
+    CodeCompletionListBuilder *mBuilder;
+    bool mAutoHideOnSingleResult;
+    QString mSchemeName;
+    CompletionAutoInsertCallback mAutoInsertCallback;
     mutable QRecursiveMutex mMutex;
     std::shared_ptr<QHash<StatementKind, std::shared_ptr<ColorSchemeItem> > > mColors;
     CodeCompletionListItemDelegate* mDelegate;
 
     PCppParser mParser;
-    PStatement mCurrentScope;
     int mShowCount;
     bool mRecordUsage;
     bool mShowKeywords;
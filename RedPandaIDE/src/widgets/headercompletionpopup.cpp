@@ -27,7 +27,8 @@
 #include <qsynedit/constants.h>
 
 HeaderCompletionPopup::HeaderCompletionPopup(ColorManager *colorManager,QWidget* parent):QWidget{parent},
-    mListView{nullptr}
+    mListView{nullptr},
+    mHeaderIndexManager{nullptr}
 {
     setWindowFlags(Qt::Popup);
     mColorManager = colorManager;
@@ -48,6 +49,7 @@ HeaderCompletionPopup::HeaderCompletionPopup(ColorManager *colorManager,QWidget*
     mCurrentFile = "";
     mPhrase = "";
     mIgnoreCase = false;
+    mListed = false;
 }
 
 HeaderCompletionPopup::~HeaderCompletionPopup()
@@ -168,6 +170,11 @@ void HeaderCompletionPopup::setLineHeightFactor(float newLineHeightFactor)
     mDelegate->setLineHeightFactor(newLineHeightFactor);
 }
 
+void HeaderCompletionPopup::setHeaderIndexManager(HeaderIndexManager *headerIndexManager)
+{
+    mHeaderIndexManager = headerIndexManager;
+}
+
 static bool sortByUsage(const PHeaderCompletionListItem& item1,const PHeaderCompletionListItem& item2){
     if (item1->usageCount != item2->usageCount)
         return item1->usageCount > item2->usageCount;
@@ -184,20 +191,29 @@ static bool sortByUsage(const PHeaderCompletionListItem& item1,const PHeaderComp
 
 void HeaderCompletionPopup::filterList(const QString &member)
 {
-    Qt::CaseSensitivity caseSensitivity=mIgnoreCase?Qt::CaseInsensitive:Qt::CaseSensitive;
     mCompletionList.clear();
     mModel->setMatched(0);
-    if (member.isEmpty()) {
-        foreach (const PHeaderCompletionListItem& item,mFullCompletionList.values()) {
-            mCompletionList.append(item);
+    Qt::CaseSensitivity caseSensitivity = mIgnoreCase?Qt::CaseInsensitive:Qt::CaseSensitive;
+    if (mListed && member.startsWith(mListedPrefix, caseSensitivity)) {
+        // the prefix grows while typing, narrow the previous result
+        for (auto it = mFullCompletionList.begin(); it != mFullCompletionList.end();) {
+            if (it.key().startsWith(member, caseSensitivity))
+                ++it;
+            else
+                it = mFullCompletionList.erase(it);
         }
     } else {
-        foreach (const PHeaderCompletionListItem& item,mFullCompletionList.values()) {
-            if (item->filename.startsWith(member, caseSensitivity)) {
-                mCompletionList.append(item);
-            }
+        // the index is queried by prefix, so we don't need to filter it again
+        mFullCompletionList.clear();
+        foreach (const auto& searchDir, mSearchDirs) {
+            addFilesInPath(searchDir.first, member, searchDir.second);
         }
     }
+    mListed = true;
+    mListedPrefix = member;
+    foreach (const PHeaderCompletionListItem& item,mFullCompletionList.values()) {
+        mCompletionList.append(item);
+    }
     std::sort(mCompletionList.begin(),mCompletionList.end(), sortByUsage);
     mModel->setMatched(member.length());
 }
@@ -210,79 +226,59 @@ void HeaderCompletionPopup::getCompletionFor(const QString &phrase)
         idx = phrase.lastIndexOf('/');
     }
     mFullCompletionList.clear();
-    if (idx < 0) { // dont have basedir
-        if (mSearchLocal) {
-            QFileInfo fileInfo(mCurrentFile);
-            addFilesInPath(fileInfo.absolutePath(), HeaderCompletionListItemType::LocalHeader);
-        };
-
-        for (const QString& path: mParser->includePaths()) {
-            addFilesInPath(path, HeaderCompletionListItemType::ProjectHeader);
-        }
-
-        for (const QString& path: mParser->projectIncludePaths()) {
-            addFilesInPath(path, HeaderCompletionListItemType::SystemHeader);
-        }
-    } else {
-        QString current = phrase.mid(0,idx);
-        if (mSearchLocal) {
-            QFileInfo fileInfo(mCurrentFile);
-            addFilesInSubDir(fileInfo.absolutePath(),current, HeaderCompletionListItemType::LocalHeader);
-        }
-        for (const QString& path: mParser->includePaths()) {
-            addFilesInSubDir(path,current, HeaderCompletionListItemType::ProjectHeader);
-        }
+    mSearchDirs.clear();
+    mListed = false;
+    QString current;
+    if (idx >= 0) // have basedir
+        current = phrase.mid(0,idx);
+    if (mSearchLocal) {
+        QFileInfo fileInfo(mCurrentFile);
+        mSearchDirs.append(qMakePair(QDir(fileInfo.absolutePath()).filePath(current),
+                                     HeaderCompletionListItemType::LocalHeader));
+    }
+    for (const QString& path: mParser->includePaths()) {
+        mSearchDirs.append(qMakePair(QDir(path).filePath(current),
+                                     HeaderCompletionListItemType::ProjectHeader));
+    }
 
-        for (const QString& path: mParser->projectIncludePaths()) {
-            addFilesInSubDir(path,current, HeaderCompletionListItemType::SystemHeader);
-        }
+    for (const QString& path: mParser->projectIncludePaths()) {
+        mSearchDirs.append(qMakePair(QDir(path).filePath(current),
+                                     HeaderCompletionListItemType::SystemHeader));
     }
 }
 
-void HeaderCompletionPopup::addFilesInPath(const QString &path, HeaderCompletionListItemType type)
+void HeaderCompletionPopup::addFilesInPath(const QString &path, const QString &prefix, HeaderCompletionListItemType type)
 {
+    Q_ASSERT(mHeaderIndexManager!=nullptr);
     QDir dir(path);
-    if (!dir.exists())
-        return;
-    foreach (const QFileInfo& fileInfo, dir.entryInfoList()) {
-        if (fileInfo.fileName().startsWith("."))
-            continue;
-        if (fileInfo.isDir()) {
-            addFile(dir, fileInfo, type);
-            continue;
-        }
-        QString suffix = fileInfo.suffix().toLower();
-        if (suffix == "h" || suffix == "hpp" || suffix == "") {
-            addFile(dir, fileInfo, type);
-        }
+    foreach (const HeaderIndexEntry& entry,
+             mHeaderIndexManager->findEntries(
+                 path, prefix,
+                 mIgnoreCase?Qt::CaseInsensitive:Qt::CaseSensitive)) {
+        addFile(dir, entry, type);
     }
 }
 
-void HeaderCompletionPopup::addFile(const QDir& dir, const QFileInfo& fileInfo, HeaderCompletionListItemType type)
+void HeaderCompletionPopup::addFile(const QDir& dir, const HeaderIndexEntry& entry, HeaderCompletionListItemType type)
 {
-    QString fileName = fileInfo.fileName();
+    const QString& fileName = entry.name;
     if (fileName.isEmpty())
         return;
     if (fileName.startsWith('.'))
         return;
     PHeaderCompletionListItem item = std::make_shared<HeaderCompletionListItem>();
     item->filename = fileName;
-    item->noSuffixFilename = fileInfo.baseName();
-    item->suffix = fileInfo.suffix();
+    int idx = fileName.indexOf('.');
+    item->noSuffixFilename = (idx<0)?fileName:fileName.left(idx);
+    idx = fileName.lastIndexOf('.');
+    item->suffix = (idx<0)?QString():fileName.mid(idx+1);
     item->itemType = type;
     item->fullpath = cleanPath(dir.absoluteFilePath(fileName));
     item->usageCount = mHeaderUsageCounts.value(item->fullpath,0);
-    item->isFolder = fileInfo.isDir();
+    item->isFolder = entry.isFolder;
     mFullCompletionList.insert(fileName,item);
 }
 
-void HeaderCompletionPopup::addFilesInSubDir(const QString &baseDirPath, const QString &subDirName, HeaderCompletionListItemType type)
-{
-    QDir baseDir(baseDirPath);
-    QString subDirPath = baseDir.filePath(subDirName);
-    addFilesInPath(subDirPath, type);
-}
-
 bool HeaderCompletionPopup::searchLocal() const
 {
     return mSearchLocal;
@@ -319,6 +315,8 @@ void HeaderCompletionPopup::hideEvent(QHideEvent *)
     mCompletionList.clear();
     mModel->setMatched(0);
     mFullCompletionList.clear();
+    mSearchDirs.clear();
+    mListed = false;
     mParser = nullptr;
 }
 
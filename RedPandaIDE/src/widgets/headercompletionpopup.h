@@ -22,6 +22,7 @@
 #include <QWidget>
 #include "codecompletionlistview.h"
 #include "../parser/cppparser.h"
+#include "../headerindexmanager.h"
 
 enum class HeaderCompletionListItemType {
     LocalHeader,
@@ -114,13 +115,13 @@ public:
                             const QColor& folderColor);
     QString selectedFilename(bool updateUsageCount);
     void setLineHeightFactor(float newLineHeightFactor);
+    void setHeaderIndexManager(HeaderIndexManager *headerIndexManager);
 
 private:
     void filterList(const QString& member);
     void getCompletionFor(const QString& phrase);
-    void addFilesInPath(const QString& path, HeaderCompletionListItemType type);
-    void addFile(const QDir& dir,  const QFileInfo &fileInfo, HeaderCompletionListItemType type);
-    void addFilesInSubDir(const QString& baseDirPath, const QString& subDirName, HeaderCompletionListItemType type);
+    void addFilesInPath(const QString& path, const QString& prefix, HeaderCompletionListItemType type);
+    void addFile(const QDir& dir,  const HeaderIndexEntry &entry, HeaderCompletionListItemType type);
 private:
 
     CodeCompletionListView* mListView;
@@ -131,6 +132,12 @@ private:
     int mShowCount;
     QSet<QString> mAddedFileNames;
     ColorManager *mColorManager;
+    HeaderIndexManager *mHeaderIndexManager;
+    // dirs to search in, found by getCompletionFor()
+    QList<QPair<QString, HeaderCompletionListItemType>> mSearchDirs;
+    // mFullCompletionList holds the entries of mSearchDirs that start with mListedPrefix
+    bool mListed;
+    QString mListedPrefix;
 
     PCppParser mParser;
     QString mPhrase;
@@ -95,7 +95,7 @@ void LineNumberTextEditor::clearAll()
     clearStartFormat();
 }
 
-void LineNumberTextEditor::highlightLine(int line, QColor highlightColor)
+void LineNumberTextEditor::highlightLine(int line, QColor highlightColor, int column)
 {
     QTextBlock block = document()->findBlockByLineNumber(line);
     if (!block.isValid())
@@ -114,9 +114,10 @@ void LineNumberTextEditor::highlightLine(int line, QColor highlightColor)
     cur.setCharFormat(oldFormat);
     setTextCursor(cur);
     moveCursor(QTextCursor::MoveOperation::StartOfLine);
+    moveToColumn(block, column);
 }
 
-void LineNumberTextEditor::locateLine(int line)
+void LineNumberTextEditor::locateLine(int line, int column)
 {
     QTextBlock block = document()->findBlockByLineNumber(line);
     if (!block.isValid())
@@ -126,6 +127,16 @@ void LineNumberTextEditor::locateLine(int line)
         return;
     setTextCursor(cur);
     moveCursor(QTextCursor::MoveOperation::StartOfLine);
+    moveToColumn(block, column);
+}
+
+void LineNumberTextEditor::moveToColumn(const QTextBlock &block, int column)
+{
+    if (column <= 0)
+        return;
+    QTextCursor cur = textCursor();
+    cur.setPosition(block.position() + std::min(column, block.length() - 1));
+    setTextCursor(cur);
 }
 
 const QColor &LineNumberTextEditor::lineNumberAreaBackground() const
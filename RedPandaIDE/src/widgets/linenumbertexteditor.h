@@ -19,6 +19,7 @@
 
 #include <QPlainTextEdit>
 #include <QSyntaxHighlighter>
+#include <QTextBlock>
 
 class LineNumberTextEditor : public QPlainTextEdit
 {
@@ -42,9 +43,9 @@ public:
 
     void clearAll();
 
-    void highlightLine(int line, QColor highlightColor);
+    void highlightLine(int line, QColor highlightColor, int column = 0);
 
-    void locateLine(int line);
+    void locateLine(int line, int column = 0);
 
 signals:
     void lineNumberAreaCurrentLineChanged();
@@ -58,6 +59,7 @@ private slots:
     void updateLineNumberArea(const QRect &rect, int dy);
 private:
     void clearStartFormat();
+    void moveToColumn(const QTextBlock& block, int column);
 
 private:
     QWidget *lineNumberArea;
@@ -0,0 +1,31 @@
+#include <QTest>
+#include <QCoreApplication>
+#include "test_buildtiming.h"
+#include "test_compilecache.h"
+#include "test_jsondiagnostics.h"
+#include "test_syntaxcheck.h"
+
+int main(int argc, char *argv[]) {
+    int status = 0;
+    QTest::setMainSourcePath(__FILE__, QT_TESTCASE_BUILDDIR); // Optional: for source path resolution
+
+    QCoreApplication app(argc,argv);
+    {
+        TestBuildTiming tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+    {
+        TestCompileCache tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+    {
+        TestJsonDiagnostics tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+    {
+        TestSyntaxCheck tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    return status;
+}
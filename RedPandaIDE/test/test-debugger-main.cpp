@@ -0,0 +1,31 @@
+#include <QTest>
+#include <QCoreApplication>
+#include "test_addressrangecache.h"
+#include "test_dapprotocol.h"
+#include "test_dapsession.h"
+#include "test_gdbmiresultparser.h"
+
+int main(int argc, char *argv[]) {
+    int status = 0;
+    QTest::setMainSourcePath(__FILE__, QT_TESTCASE_BUILDDIR); // Optional: for source path resolution
+
+    QCoreApplication app(argc,argv);
+    {
+        TestAddressRangeCache tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+    {
+        TestDAPProtocol tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+    {
+        TestDAPSession tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+    {
+        TestGDBMIResultParser tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    return status;
+}
@@ -1,5 +1,6 @@
 #include <QTest>
 #include <QGuiApplication>
+#include "test_codecompletionlistbuilder.h"
 #include "test_editor_symbol_completion.h"
 
 int main(int argc, char *argv[]) {
@@ -12,6 +13,10 @@ int main(int argc, char *argv[]) {
         TestEditorSymbolCompletion tc;
         status |= QTest::qExec(&tc, argc, argv);
     }
+    {
+        TestCodeCompletionListBuilder tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
 
     return status;
 }
@@ -0,0 +1,16 @@
+#include <QTest>
+#include <QCoreApplication>
+#include "test_gitstatus.h"
+
+int main(int argc, char *argv[]) {
+    int status = 0;
+    QTest::setMainSourcePath(__FILE__, QT_TESTCASE_BUILDDIR); // Optional: for source path resolution
+
+    QCoreApplication app(argc,argv);
+    {
+        TestGitStatus tc;
+        status |= QTest::qExec(&tc, argc, argv);
+    }
+
+    return status;
+}
@@ -0,0 +1,94 @@
+#include <QTest>
+#include "test_addressrangecache.h"
+#include "src/debugger/addressrangecache.h"
+
+TestAddressRangeCache::TestAddressRangeCache(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestAddressRangeCache::test_memory_missing_ranges()
+{
+    MemoryCache cache;
+    QCOMPARE(cache.missingRanges(0x1000, 16), QList<AddressRange>{AddressRange(0x1000, 16)});
+    cache.insert(0x1004, QByteArray(4, 'a'));
+    cache.insert(0x100c, QByteArray(8, 'b'));
+    QList<AddressRange> expected{AddressRange(0x1000, 4), AddressRange(0x1008, 4)};
+    QCOMPARE(cache.missingRanges(0x1000, 16), expected);
+    QVERIFY(cache.missingRanges(0x100c, 8).isEmpty());
+    QCOMPARE(cache.missingRanges(0x1010, 8), QList<AddressRange>{AddressRange(0x1014, 4)});
+    // not fully cached
+    QCOMPARE(cache.read(0x1006, 8), QByteArray(2, 'a'));
+    QVERIFY(cache.read(0x1000, 8).isEmpty());
+}
+
+void TestAddressRangeCache::test_memory_merge_chunks()
+{
+    MemoryCache cache;
+    cache.insert(0x1000, "abcd");
+    cache.insert(0x1008, "ijkl");
+    cache.insert(0x1004, "efgh");
+    QCOMPARE(cache.read(0x1000, 12), QByteArray("abcdefghijkl"));
+    QCOMPARE(cache.read(0x1002, 4), QByteArray("cdef"));
+    QVERIFY(cache.missingRanges(0x1000, 12).isEmpty());
+    cache.clear();
+    QVERIFY(cache.isEmpty());
+}
+
+void TestAddressRangeCache::test_memory_overwrite()
+{
+    MemoryCache cache;
+    cache.insert(0x1000, "abcdefgh");
+    cache.insert(0x1002, "XY");
+    QCOMPARE(cache.read(0x1000, 8), QByteArray("abXYefgh"));
+    cache.insert(0x0ffe, "1234");
+    QCOMPARE(cache.read(0x0ffe, 10), QByteArray("1234XYefgh"));
+    cache.insert(0x1006, "5678");
+    QCOMPARE(cache.read(0x0ffe, 12), QByteArray("1234XYef5678"));
+}
+
+void TestAddressRangeCache::test_disassembly_find()
+{
+    DisassemblyCache cache;
+    QStringList lines{
+        "   0x0000000000401550 <+0>:\tpush   %rbp",
+        "=> 0x0000000000401551 <+1>:\tmov    %rsp,%rbp",
+        "   0x0000000000401554 <+4>:\tpop    %rbp",
+        "   0x0000000000401555 <+5>:\tret",
+    };
+    cache.insert("att /s", lines);
+    QStringList result;
+    QVERIFY(!cache.find("intel /s", 0x401554, result));
+    QVERIFY(!cache.find("att /s", 0x401556, result));
+    QVERIFY(cache.find("att /s", 0x401554, result));
+    QCOMPARE(result.count(), 4);
+    QCOMPARE(result[1], QString("   0x0000000000401551 <+1>:\tmov    %rsp,%rbp"));
+    QCOMPARE(result[2], QString("=> 0x0000000000401554 <+4>:\tpop    %rbp"));
+    // the last instruction
+    QVERIFY(cache.find("att /s", 0x401555, result));
+    QCOMPARE(result[3], QString("=> 0x0000000000401555 <+5>:\tret"));
+    // inside an instruction
+    QVERIFY(!cache.find("att /s", 0x401552, result));
+}
+
+void TestAddressRangeCache::test_disassembly_invalidate()
+{
+    DisassemblyCache cache;
+    cache.insert("att ", QStringList{
+                     "   0x0000000000401550 <+0>:\tpush   %rbp",
+                     "   0x0000000000401551 <+1>:\tret"});
+    QStringList result;
+    cache.invalidate(0x401600, 1);
+    QVERIFY(cache.find("att ", 0x401550, result));
+    cache.invalidate(0x401540, 0x10);
+    QVERIFY(cache.find("att ", 0x401550, result));
+    // starts before the function and overlaps it
+    cache.invalidate(0x40154e, 4);
+    QVERIFY(!cache.find("att ", 0x401550, result));
+    // inside the bytes of the last instruction
+    cache.insert("att ", QStringList{
+                     "   0x0000000000401550 <+0>:\tpush   %rbp",
+                     "   0x0000000000401551 <+1>:\tret"});
+    cache.invalidate(0x401552, 1);
+    QVERIFY(!cache.find("att ", 0x401550, result));
+}
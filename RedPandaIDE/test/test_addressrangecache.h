@@ -0,0 +1,18 @@
+#ifndef TEST_ADDRESSRANGECACHE_H
+#define TEST_ADDRESSRANGECACHE_H
+#include <QObject>
+
+class TestAddressRangeCache: public QObject
+{
+    Q_OBJECT
+public:
+    TestAddressRangeCache(QObject *parent=nullptr);
+private slots:
+    void test_memory_missing_ranges();
+    void test_memory_merge_chunks();
+    void test_memory_overwrite();
+    void test_disassembly_find();
+    void test_disassembly_invalidate();
+};
+
+#endif
@@ -0,0 +1,126 @@
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include "test_buildtiming.h"
+#include "src/compiler/buildtiming.h"
+
+TestBuildTiming::TestBuildTiming(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestBuildTiming::test_process_line()
+{
+    BuildTimingRecorder recorder;
+    QVERIFY(recorder.isEmpty());
+    QVERIFY(!recorder.processLine("g++ -c main.cpp -o main.o", 0));
+    QVERIFY(!recorder.processLine("", 0));
+    QVERIFY(recorder.processLine("build-timing: begin compile main.o", 100));
+    QVERIFY(recorder.isEmpty());
+    QVERIFY(recorder.processLine("  build-timing: end compile main.o\r", 350));
+    QVERIFY(!recorder.isEmpty());
+    // malformed markers are swallowed
+    QVERIFY(recorder.processLine("build-timing:", 400));
+    QVERIFY(recorder.processLine("build-timing: begin", 400));
+
+    PBuildTimingReport report = recorder.createReport(QHash<QString,QString>(), QString(), 1000);
+    QCOMPARE(report->totalTime, qint64(1000));
+    QCOMPARE(report->entries.count(), 1);
+    QCOMPARE(report->entries[0].target, QString("main.o"));
+    QCOMPARE(report->entries[0].isLink, false);
+    QCOMPARE(report->entries[0].start, qint64(100));
+    QCOMPARE(report->entries[0].duration, qint64(250));
+
+    recorder.clear();
+    QVERIFY(recorder.isEmpty());
+}
+
+void TestBuildTiming::test_quoted_target()
+{
+    BuildTimingRecorder recorder;
+    QVERIFY(recorder.processLine("build-timing: begin link \"my app.exe\"", 10));
+    QVERIFY(recorder.processLine("build-timing: end link \"my app.exe\"", 30));
+    PBuildTimingReport report = recorder.createReport(QHash<QString,QString>(), QString(), 30);
+    QCOMPARE(report->entries.count(), 1);
+    QCOMPARE(report->entries[0].target, QString("my app.exe"));
+    QCOMPARE(report->entries[0].isLink, true);
+    QCOMPARE(report->entries[0].duration, qint64(20));
+}
+
+void TestBuildTiming::test_unmatched_markers()
+{
+    BuildTimingRecorder recorder;
+    // an end without a begin is ignored
+    QVERIFY(recorder.processLine("build-timing: end compile a.o", 10));
+    QVERIFY(recorder.isEmpty());
+    // a target that never ended isn't reported
+    QVERIFY(recorder.processLine("build-timing: begin compile b.o", 20));
+    PBuildTimingReport report = recorder.createReport(QHash<QString,QString>(), QString(), 30);
+    QVERIFY(report->entries.isEmpty());
+    QVERIFY(report->headers.isEmpty());
+}
+
+void TestBuildTiming::test_report_lanes()
+{
+    BuildTimingRecorder recorder;
+    // b.o runs in parallel with a.o, c.o starts after a.o is done
+    recorder.processLine("build-timing: begin compile b.o", 50);
+    recorder.processLine("build-timing: begin compile a.o", 0);
+    recorder.processLine("build-timing: end compile a.o", 100);
+    recorder.processLine("build-timing: begin compile c.o", 100);
+    recorder.processLine("build-timing: end compile b.o", 150);
+    recorder.processLine("build-timing: end compile c.o", 200);
+    recorder.processLine("build-timing: begin link app", 200);
+    recorder.processLine("build-timing: end link app", 260);
+
+    PBuildTimingReport report = recorder.createReport(QHash<QString,QString>(), QString(), 260);
+    QCOMPARE(report->entries.count(), 4);
+    // in starting order
+    QCOMPARE(report->entries[0].target, QString("a.o"));
+    QCOMPARE(report->entries[1].target, QString("b.o"));
+    QCOMPARE(report->entries[2].target, QString("c.o"));
+    QCOMPARE(report->entries[3].target, QString("app"));
+    QCOMPARE(report->entries[0].lane, 0);
+    QCOMPARE(report->entries[1].lane, 1);
+    QCOMPARE(report->entries[2].lane, 0);
+    QCOMPARE(report->entries[3].lane, 0);
+    QCOMPARE(report->entries[3].isLink, true);
+}
+
+void TestBuildTiming::test_report_headers()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    auto writeFile = [&dir](const QString& name, const QByteArray& content) {
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+        file.write(content);
+    };
+    writeFile("a.d", "a.o: a.cpp common.h \\\n a.h\n");
+    writeFile("b.d", "b.o: b.cpp common.h\n");
+
+    BuildTimingRecorder recorder;
+    recorder.processLine("build-timing: begin compile a.o", 0);
+    recorder.processLine("build-timing: end compile a.o", 300);
+    recorder.processLine("build-timing: begin compile b.o", 300);
+    recorder.processLine("build-timing: end compile b.o", 400);
+    recorder.processLine("build-timing: begin link app", 400);
+    recorder.processLine("build-timing: end link app", 500);
+
+    QHash<QString,QString> dependencyFiles;
+    dependencyFiles.insert("a.o", "a.d");
+    dependencyFiles.insert("b.o", "b.d");
+    // the link target has no dependency file and is skipped
+    dependencyFiles.insert("app", "missing.d");
+    PBuildTimingReport report = recorder.createReport(dependencyFiles, dir.path(), 500);
+
+    // slowest first, the source files aren't counted
+    QCOMPARE(report->headers.count(), 2);
+    QCOMPARE(report->headers[0].filename, QDir::cleanPath(dir.filePath("common.h")));
+    QCOMPARE(report->headers[0].unitCount, 2);
+    QCOMPARE(report->headers[0].totalDuration, qint64(400));
+    QCOMPARE(report->headers[1].filename, QDir::cleanPath(dir.filePath("a.h")));
+    QCOMPARE(report->headers[1].unitCount, 1);
+    QCOMPARE(report->headers[1].totalDuration, qint64(300));
+}
@@ -0,0 +1,18 @@
+#ifndef TEST_BUILDTIMING_H
+#define TEST_BUILDTIMING_H
+#include <QObject>
+
+class TestBuildTiming: public QObject
+{
+    Q_OBJECT
+public:
+    TestBuildTiming(QObject *parent=nullptr);
+private slots:
+    void test_process_line();
+    void test_quoted_target();
+    void test_unmatched_markers();
+    void test_report_lanes();
+    void test_report_headers();
+};
+
+#endif
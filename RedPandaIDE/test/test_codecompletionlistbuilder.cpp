@@ -0,0 +1,142 @@
+#include <QTest>
+#include "src/parser/cppparser.h"
+#include "src/widgets/codecompletionpopup.h"
+#include "test_codecompletionlistbuilder.h"
+
+static const QString TestFileName{"test.cpp"};
+static constexpr int GlobalCount = 250; // more than a batch of found statements
+static constexpr int CompletionLine = GlobalCount + 4; // the blank line in foo()
+
+static QStringList testFileContent()
+{
+    QStringList lines{"struct Point { int x; int y; };"};
+    for (int i = 0; i < GlobalCount; i++)
+        lines.append(QString("int global%1;").arg(i));
+    lines.append("void foo(Point p) {");
+    lines.append("    int localValue = 0;");
+    lines.append("    ");
+    lines.append("}");
+    return lines;
+}
+
+static QSet<QString> commands(const StatementList& statements)
+{
+    QSet<QString> result;
+    foreach (const PStatement& statement, statements) {
+        result.insert(statement->command);
+    }
+    return result;
+}
+
+static std::unique_ptr<CodeCompletionListBuilder> createBuilder(
+        const PCppParser& parser,
+        CodeCompletionType type,
+        const QStringList& ownerExpression,
+        const QString& memberOperator,
+        const QStringList& memberExpression)
+{
+    std::unique_ptr<CodeCompletionListBuilder> builder = std::make_unique<CodeCompletionListBuilder>(
+                parser, type, QString(), ownerExpression, memberOperator, memberExpression,
+                TestFileName, CompletionLine, QSet<QString>());
+    builder->setShowKeywords(false);
+    builder->setShowCodeSnippets(false);
+    return builder;
+}
+
+TestCodeCompletionListBuilder::TestCodeCompletionListBuilder(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestCodeCompletionListBuilder::initTestCase()
+{
+    mParser = std::make_shared<CppParser>();
+    mParser->setOnGetFileStream([](const QString& filename, QStringList& buffer){
+        if (filename != TestFileName)
+            return false;
+        buffer = testFileContent();
+        return true;
+    });
+    CppParser::parseFileBlocking(mParser, TestFileName, false, "");
+    QVERIFY(mParser->findStatement("global0") != nullptr);
+}
+
+void TestCodeCompletionListBuilder::test_scope_statements()
+{
+    std::unique_ptr<CodeCompletionListBuilder> builder = createBuilder(
+                mParser, CodeCompletionType::Normal, QStringList(), QString(), QStringList{"lo"});
+    builder->build();
+    QSet<QString> found = commands(builder->takeFoundStatements());
+    QVERIFY(found.contains("localValue"));
+    QVERIFY(found.contains("p"));
+    QVERIFY(found.contains("foo"));
+    QVERIFY(found.contains("Point"));
+    QVERIFY(found.contains("global0"));
+    QVERIFY(found.contains(QString("global%1").arg(GlobalCount - 1)));
+    // members are not in the scope
+    QVERIFY(!found.contains("x"));
+    // taken only once
+    QVERIFY(builder->takeFoundStatements().isEmpty());
+}
+
+void TestCodeCompletionListBuilder::test_member_statements()
+{
+    std::unique_ptr<CodeCompletionListBuilder> builder = createBuilder(
+                mParser, CodeCompletionType::Normal, QStringList{"p"}, ".", QStringList{"x"});
+    builder->build();
+    QCOMPARE(commands(builder->takeFoundStatements()), QSet<QString>({"x", "y"}));
+}
+
+void TestCodeCompletionListBuilder::test_no_parser()
+{
+    std::unique_ptr<CodeCompletionListBuilder> builder = createBuilder(
+                nullptr, CodeCompletionType::Normal, QStringList(), QString(), QStringList{"lo"});
+    builder->build();
+    QVERIFY(builder->takeFoundStatements().isEmpty());
+
+    // keywords don't need the parser
+    builder = std::make_unique<CodeCompletionListBuilder>(
+                nullptr, CodeCompletionType::KeywordsOnly, QString(), QStringList(),
+                QString(), QStringList(), TestFileName, 1, QSet<QString>{"alpha", "beta"});
+    builder->build();
+    QCOMPARE(commands(builder->takeFoundStatements()), QSet<QString>({"alpha", "beta"}));
+}
+
+void TestCodeCompletionListBuilder::test_cancelled()
+{
+    std::unique_ptr<CodeCompletionListBuilder> builder = createBuilder(
+                mParser, CodeCompletionType::Normal, QStringList(), QString(), QStringList{"lo"});
+    int foundCount = 0;
+    connect(builder.get(), &CodeCompletionListBuilder::statementsFound,
+            this, [&foundCount](){
+        foundCount++;
+    }, Qt::DirectConnection);
+    builder->cancel();
+    QVERIFY(builder->isCancelled());
+    builder->build();
+    QCOMPARE(foundCount, 0);
+    QVERIFY(builder->takeFoundStatements().isEmpty());
+    // the parser is not left frozen
+    QVERIFY(mParser->freeze());
+    mParser->unFreeze();
+}
+
+void TestCodeCompletionListBuilder::test_parser_frozen_while_building()
+{
+    std::unique_ptr<CodeCompletionListBuilder> builder = createBuilder(
+                mParser, CodeCompletionType::Normal, QStringList(), QString(), QStringList{"lo"});
+    QList<bool> parsedWhileBuilding;
+    // the first batch is handed over while the statements are still walked
+    connect(builder.get(), &CodeCompletionListBuilder::statementsFound,
+            this, [this, &parsedWhileBuilding](){
+        parsedWhileBuilding.append(mParser->parseFile(TestFileName, false, ""));
+    }, Qt::DirectConnection);
+    builder->build();
+    QVERIFY(parsedWhileBuilding.count() >= 2);
+    // deferred until the whole list is built
+    QCOMPARE(parsedWhileBuilding.front(), false);
+    // the last batch is handed over after the parser is unfrozen
+    QCOMPARE(parsedWhileBuilding.back(), true);
+    QTRY_VERIFY(!mParser->parsing());
+    QVERIFY(mParser->findStatement("global0") != nullptr);
+}
@@ -0,0 +1,24 @@
+#ifndef TEST_CODECOMPLETIONLISTBUILDER_H
+#define TEST_CODECOMPLETIONLISTBUILDER_H
+#include <QObject>
+#include <memory>
+
+class CppParser;
+
+class TestCodeCompletionListBuilder: public QObject
+{
+    Q_OBJECT
+public:
+    TestCodeCompletionListBuilder(QObject *parent=nullptr);
+private slots:
+    void initTestCase();
+    void test_scope_statements();
+    void test_member_statements();
+    void test_no_parser();
+    void test_cancelled();
+    void test_parser_frozen_while_building();
+private:
+    std::shared_ptr<CppParser> mParser;
+};
+
+#endif
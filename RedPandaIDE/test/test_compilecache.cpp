@@ -0,0 +1,106 @@
+#include <QTest>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include "test_compilecache.h"
+#include "src/compiler/compilecache.h"
+
+static bool writeFile(const QString& filename, const QByteArray& content)
+{
+    QFile file(filename);
+    if (!file.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+    return file.write(content) == content.size();
+}
+
+TestCompileCache::TestCompileCache(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestCompileCache::test_parse_dependency_file()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filename = dir.filePath("main.d");
+    // several targets, line continuations and the phony rules of -MP
+    QVERIFY(writeFile(filename,
+                      "main.o main.d: main.cpp include/a.h \\\n"
+                      "  include/b.h \\\r\n"
+                      " c.h\n"
+                      "include/a.h:\n"
+                      "include/b.h:\n"));
+    QCOMPARE(CompileCache::parseDependencyFile(filename),
+             QStringList({"main.cpp", "include/a.h", "include/b.h", "c.h"}));
+    // a drive letter isn't the end of the target
+    QVERIFY(writeFile(filename, "C:/src/main.o: C:/src/main.cpp C:/include/a.h\n"));
+    QCOMPARE(CompileCache::parseDependencyFile(filename),
+             QStringList({"C:/src/main.cpp", "C:/include/a.h"}));
+}
+
+void TestCompileCache::test_parse_escaped_dependency_file()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filename = dir.filePath("main.d");
+    QVERIFY(writeFile(filename,
+                      "my\\ main.o: my\\ main.cpp my\\ dir/a\\#1.h \\\n"
+                      " cost$$.h\n"));
+    QCOMPARE(CompileCache::parseDependencyFile(filename),
+             QStringList({"my main.cpp", "my dir/a#1.h", "cost$.h"}));
+}
+
+void TestCompileCache::test_parse_invalid_dependency_file()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(CompileCache::parseDependencyFile(dir.filePath("missing.d")).isEmpty());
+    QString filename = dir.filePath("main.d");
+    QVERIFY(writeFile(filename, "no rule here\n"));
+    QVERIFY(CompileCache::parseDependencyFile(filename).isEmpty());
+}
+
+void TestCompileCache::test_up_to_date()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QDir base(dir.path());
+    QVERIFY(base.mkpath("src"));
+    QString source = base.filePath("src/main.cpp");
+    QString header = base.filePath("src/main.h");
+    QString output = base.filePath("main.exe");
+    QVERIFY(writeFile(source, "#include \"main.h\"\nint main() { return N; }\n"));
+    QVERIFY(writeFile(header, "#define N 0\n"));
+    QVERIFY(writeFile(output, "binary"));
+
+    CompileCache cache(base.filePath("cache"));
+    QByteArray key = CompileCache::computeKey("gcc", QStringList{"-O2"}, source);
+    QVERIFY(!key.isEmpty());
+    QVERIFY(key != CompileCache::computeKey("gcc", QStringList{"-O0"}, source));
+    QVERIFY(!cache.isUpToDate(source, key, output));
+
+    // no dependency file, nothing is recorded
+    cache.update(source, key, output);
+    QVERIFY(!cache.isUpToDate(source, key, output));
+
+    QVERIFY(base.mkpath("cache"));
+    // relative to the source file
+    QVERIFY(writeFile(cache.dependencyFilename(source), "main.o: main.cpp main.h\n"));
+    cache.update(source, key, output);
+    QVERIFY(cache.isUpToDate(source, key, output));
+    QVERIFY(!cache.isUpToDate(source, QByteArray(), output));
+    QVERIFY(!cache.isUpToDate(source, CompileCache::computeKey("gcc", QStringList{"-O0"}, source), output));
+    QVERIFY(!cache.isUpToDate(source, key, base.filePath("other.exe")));
+    // another cache object reads the saved index
+    QVERIFY(CompileCache(base.filePath("cache")).isUpToDate(source, key, output));
+
+    // a header is changed
+    QVERIFY(writeFile(header, "#define N 10\n"));
+    QVERIFY(!cache.isUpToDate(source, key, output));
+    cache.update(source, key, output);
+    QVERIFY(cache.isUpToDate(source, key, output));
+
+    // the output is removed
+    QVERIFY(QFile::remove(output));
+    QVERIFY(!cache.isUpToDate(source, key, output));
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_COMPILECACHE_H
+#define TEST_COMPILECACHE_H
+#include <QObject>
+
+class TestCompileCache: public QObject
+{
+    Q_OBJECT
+public:
+    TestCompileCache(QObject *parent=nullptr);
+private slots:
+    void test_parse_dependency_file();
+    void test_parse_escaped_dependency_file();
+    void test_parse_invalid_dependency_file();
+    void test_up_to_date();
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include <QTest>
+#include <QRegularExpression>
 #include "src/parser/cppparser.h"
 #include "test_cppparser.h"
 
@@ -383,3 +384,83 @@ void TestCppParser::test_structured_bindings()
     QCOMPARE(statement->type,"double");
     QCOMPARE(statement->args,"");
 }
+
+void TestCppParser::test_reference_lines()
+{
+    mParser->setOnGetFileStream([](const QString& filename, QStringList& buffer){
+        buffer=QStringList({
+                               "int counter=0;",
+                               "void inc() {",
+                               "    counter++;",
+                               "}",
+                               "int main() {",
+                               "    inc(); inc();",
+                               "    return counter;",
+                               "}",
+                           });
+           return true;
+                                });
+    CppParser::parseFileBlocking(mParser,"refs.cpp",false,"");
+    QList<int> lines;
+    QVERIFY(mParser->findReferenceLines("refs.cpp","counter",lines));
+    QCOMPARE(lines,QList<int>({0,2,6}));
+    QVERIFY(mParser->findReferenceLines("refs.cpp","inc",lines));
+    QCOMPARE(lines,QList<int>({1,5}));
+    QVERIFY(mParser->findReferenceLines("refs.cpp","notExist",lines));
+    QVERIFY(lines.isEmpty());
+    QVERIFY(!mParser->findReferenceLines("notParsed.cpp","counter",lines));
+}
+
+void TestCppParser::test_macro_references()
+{
+    QStringList source({
+                           "#define LIMIT 10",
+                           "int values[LIMIT];",
+                           "int clamp(int x) {",
+                           "    return x>LIMIT?LIMIT:x;",
+                           "}",
+                       });
+    mParser->setOnGetFileStream([source](const QString& filename, QStringList& buffer){
+        buffer=source;
+        return true;
+    });
+    CppParser::parseFileBlocking(mParser,"macros.cpp",false,"");
+    PStatement statement = mParser->findStatementOf("macros.cpp",QStringList({"LIMIT"}),1);
+    QVERIFY(statement!=nullptr);
+    QCOMPARE(statement->kind,StatementKind::Preprocessor);
+    // macro names are expanded before references are recorded, so every line must be searched
+    QList<int> lines;
+    QVERIFY(!mParser->findStatementReferenceLines("macros.cpp",statement,lines));
+    QVERIFY(lines.isEmpty());
+    QVERIFY(mParser->findStatementReferenceLines("macros.cpp",mParser->findStatement("clamp"),lines));
+
+    QRegularExpression word("\\bLIMIT\\b");
+    QStringList renamed;
+    QList<int> foundLines;
+    for (int i=0;i<source.count();i++) {
+        QString line = source[i];
+        QList<int> starts;
+        QRegularExpressionMatchIterator it = word.globalMatch(line);
+        while (it.hasNext()) {
+            int start = it.next().capturedStart();
+            PStatement tokenStatement = mParser->findStatementOf("macros.cpp",QStringList({"LIMIT"}),i);
+            if (tokenStatement
+                    && tokenStatement->line == statement->line
+                    && tokenStatement->fileName == statement->fileName)
+                starts.prepend(start);
+        }
+        if (!starts.isEmpty())
+            foundLines.append(i);
+        foreach (int start, starts)
+            line.replace(start, QString("LIMIT").length(), "MAX_COUNT");
+        renamed.append(line);
+    }
+    QCOMPARE(foundLines,QList<int>({0,1,3}));
+    QCOMPARE(renamed,QStringList({
+                                     "#define MAX_COUNT 10",
+                                     "int values[MAX_COUNT];",
+                                     "int clamp(int x) {",
+                                     "    return x>MAX_COUNT?MAX_COUNT:x;",
+                                     "}",
+                                 }));
+}
@@ -16,6 +16,8 @@ private slots:
     void test_parse_vars();
     void test_struct();
     void test_structured_bindings();
+    void test_reference_lines();
+    void test_macro_references();
 protected:
     std::shared_ptr<CppParser> mParser;
 };
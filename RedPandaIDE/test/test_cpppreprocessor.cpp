@@ -119,6 +119,75 @@ void TestCppPreprocessor::test_macro_replace_8()
     QCOMPARE(text1,text2);
 }
 
+void TestCppPreprocessor::test_macro_replace_9()
+{
+    CppPreprocessor preprocessor;
+    preprocessor.addHardDefineByLine("#define PRINT(fmt,...) printf(fmt \"%d%%\", __VA_ARGS__)");
+    preprocessor.addHardDefineByLine("#define STR(x) #x");
+    QCOMPARE("printf(\"x\" \"%d%%\", 1,2)",
+             preprocessor.expandMacros("PRINT(\"x\", 1, 2)"));
+    QCOMPARE("\"100%%\"",
+             preprocessor.expandMacros("STR(100%%)"));
+    // macros without args
+    preprocessor.addHardDefineByLine("#define PERCENT() \"100%%\"");
+    QCOMPARE("\"100%%\"",
+             preprocessor.expandMacros("PERCENT()"));
+    // too few args to be expanded
+    preprocessor.addHardDefineByLine("#define PERCENT2(x,y) \"100%%\"");
+    QCOMPARE("\"100%%\"",
+             preprocessor.expandMacros("PERCENT2(1)"));
+}
+
+void TestCppPreprocessor::benchmark_object_like_macros()
+{
+    CppPreprocessor preprocessor;
+    QStringList lines;
+    for (int i=0;i<500;i++) {
+        preprocessor.addHardDefineByLine(QString("#define CONST_%1 (%1)").arg(i));
+        lines.append(QString("int v%1 = CONST_%1 + CONST_%2 * other_%1;").arg(i).arg((i*7)%500));
+    }
+    QBENCHMARK {
+        foreach (const QString& line, lines)
+            preprocessor.expandMacros(line);
+    }
+}
+
+void TestCppPreprocessor::benchmark_function_like_macros()
+{
+    CppPreprocessor preprocessor;
+    preprocessor.addHardDefineByLine("#define MAX(a,b) ((a)>(b)?(a):(b))");
+    preprocessor.addHardDefineByLine("#define MIN(a,b) ((a)<(b)?(a):(b))");
+    preprocessor.addHardDefineByLine("#define CLAMP(x,lo,hi) MIN(MAX(x,lo),hi)");
+    preprocessor.addHardDefineByLine("#define FIELD(type,name) type m_##name; type name() const { return m_##name; }");
+    QStringList lines;
+    for (int i=0;i<200;i++) {
+        lines.append(QString("int c%1 = CLAMP(v%1, 0, %1);").arg(i));
+        lines.append(QString("FIELD(int, field%1)").arg(i));
+    }
+    QBENCHMARK {
+        foreach (const QString& line, lines)
+            preprocessor.expandMacros(line);
+    }
+}
+
+void TestCppPreprocessor::benchmark_nested_macros()
+{
+    // Boost.PP style repetition
+    CppPreprocessor preprocessor;
+    preprocessor.addHardDefineByLine("#define CAT(a,b) a##b");
+    preprocessor.addHardDefineByLine("#define REPEAT_0(m)");
+    for (int i=1;i<=16;i++) {
+        preprocessor.addHardDefineByLine(
+                    QString("#define REPEAT_%1(m) REPEAT_%2(m) m(%2)").arg(i).arg(i-1));
+    }
+    preprocessor.addHardDefineByLine("#define REPEAT(n,m) CAT(REPEAT_,n)(m)");
+    preprocessor.addHardDefineByLine("#define DECL(n) int CAT(var,n);");
+    QBENCHMARK {
+        for (int i=0;i<50;i++)
+            preprocessor.expandMacros("REPEAT(16,DECL)");
+    }
+}
+
 QStringList TestCppPreprocessor::filterIncludes(const QStringList &text)
 {
     QStringList result;
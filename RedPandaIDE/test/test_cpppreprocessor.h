@@ -21,6 +21,10 @@ private slots:
     void test_macro_replace_6();
     void test_macro_replace_7();
     void test_macro_replace_8();
+    void test_macro_replace_9();
+    void benchmark_object_like_macros();
+    void benchmark_function_like_macros();
+    void benchmark_nested_macros();
 private:
     static QStringList filterIncludes(const QStringList& text);
 };
@@ -0,0 +1,98 @@
+#include <QTest>
+#include "test_dapprotocol.h"
+#include "src/debugger/dapprotocol.h"
+
+TestDAPProtocol::TestDAPProtocol(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestDAPProtocol::test_take_messages()
+{
+    QJsonObject args;
+    args["expression"] = QString::fromUtf8("\xe4\xb8\xad\xe6\x96\x87"); // not ascii
+    QByteArray buffer = createDAPRequestMessage(1, "evaluate", args)
+            + createDAPRequestMessage(2, "threads", QJsonObject());
+    QByteArray contentPart;
+    QVERIFY(takeDAPMessage(buffer, contentPart));
+    PDAPProtocolMessage message = parseDAPMessage(contentPart);
+    QCOMPARE(message->seq, 1LL);
+    QCOMPARE(message->type, QString("request"));
+    std::shared_ptr<DAPRequest> request = std::static_pointer_cast<DAPRequest>(message);
+    QCOMPARE(request->command, QString("evaluate"));
+    QCOMPARE(request->arguments["expression"].toString(), args["expression"].toString());
+    QVERIFY(takeDAPMessage(buffer, contentPart));
+    QCOMPARE(parseDAPMessage(contentPart)->seq, 2LL);
+    QVERIFY(buffer.isEmpty());
+    QVERIFY(!takeDAPMessage(buffer, contentPart));
+}
+
+void TestDAPProtocol::test_take_incomplete_message()
+{
+    QByteArray message = createDAPEventMessage(3, "initialized", QJsonObject());
+    QByteArray buffer = message.left(10);
+    QByteArray contentPart;
+    QVERIFY(!takeDAPMessage(buffer, contentPart));
+    buffer += message.mid(10, message.length() - 12);
+    QVERIFY(!takeDAPMessage(buffer, contentPart));
+    buffer += message.right(2);
+    QVERIFY(takeDAPMessage(buffer, contentPart));
+    QVERIFY(buffer.isEmpty());
+}
+
+void TestDAPProtocol::test_take_invalid_header()
+{
+    QByteArray buffer = "Content-Type: text\r\n\r\n"
+            + createDAPEventMessage(4, "initialized", QJsonObject());
+    QByteArray contentPart;
+    bool thrown = false;
+    try {
+        takeDAPMessage(buffer, contentPart);
+    } catch (const DAPMessageError&) {
+        thrown = true;
+    }
+    QVERIFY(thrown);
+    // the broken header is skipped
+    QVERIFY(takeDAPMessage(buffer, contentPart));
+    QCOMPARE(parseDAPMessage(contentPart)->seq, 4LL);
+}
+
+void TestDAPProtocol::test_parse_response()
+{
+    QJsonObject body;
+    body["result"] = "42";
+    body["variablesReference"] = 0;
+    QByteArray buffer = createDAPResponseMessage(5, 2, true, "evaluate", QString(), body);
+    QByteArray contentPart;
+    QVERIFY(takeDAPMessage(buffer, contentPart));
+    PDAPProtocolMessage message = parseDAPMessage(contentPart);
+    QCOMPARE(message->type, QString("response"));
+    std::shared_ptr<DAPResponse> response = std::static_pointer_cast<DAPResponse>(message);
+    QCOMPARE(response->request_seq, 2LL);
+    QVERIFY(response->success);
+    QCOMPARE(response->command, QString("evaluate"));
+    QCOMPARE(response->body["result"].toString(), QString("42"));
+}
+
+void TestDAPProtocol::test_parse_event()
+{
+    QJsonObject body;
+    body["reason"] = "breakpoint";
+    body["threadId"] = 1;
+    QByteArray buffer = createDAPEventMessage(6, "stopped", body);
+    QByteArray contentPart;
+    QVERIFY(takeDAPMessage(buffer, contentPart));
+    PDAPProtocolMessage message = parseDAPMessage(contentPart);
+    QCOMPARE(message->type, QString("event"));
+    std::shared_ptr<DAPEvent> event = std::static_pointer_cast<DAPEvent>(message);
+    QCOMPARE(event->event, QString("stopped"));
+    QCOMPARE(event->body["threadId"].toInt(), 1);
+    // a message without the type
+    bool thrown = false;
+    try {
+        parseDAPMessage("{\"seq\":7}");
+    } catch (const DAPMessageError&) {
+        thrown = true;
+    }
+    QVERIFY(thrown);
+}
@@ -0,0 +1,18 @@
+#ifndef TEST_DAPPROTOCOL_H
+#define TEST_DAPPROTOCOL_H
+#include <QObject>
+
+class TestDAPProtocol: public QObject
+{
+    Q_OBJECT
+public:
+    TestDAPProtocol(QObject *parent=nullptr);
+private slots:
+    void test_take_messages();
+    void test_take_incomplete_message();
+    void test_take_invalid_header();
+    void test_parse_response();
+    void test_parse_event();
+};
+
+#endif
@@ -0,0 +1,279 @@
+#include <QTest>
+#include <QJsonArray>
+#include "test_dapsession.h"
+#include "src/debugger/dapsession.h"
+
+struct TestCommand {
+    QString command;
+    QJsonObject arguments;
+};
+
+using PTestCommand = std::shared_ptr<TestCommand>;
+using Session = DAPSession<PTestCommand>;
+
+static PTestCommand createCommand(const QString& command, const QJsonObject& arguments = QJsonObject())
+{
+    PTestCommand cmd = std::make_shared<TestCommand>();
+    cmd->command = command;
+    cmd->arguments = arguments;
+    return cmd;
+}
+
+// what the client does with the adapter's output
+static QList<PDAPProtocolMessage> receive(Session& session, const QByteArray& output)
+{
+    session.receive(output);
+    QStringList errors;
+    QList<PDAPProtocolMessage> messages;
+    foreach (const QByteArray& contentPart, session.takeMessages(errors)) {
+        messages.append(parseDAPMessage(contentPart));
+    }
+    return messages;
+}
+
+static QByteArray response(qint64 seq, qint64 requestSeq, const QString& command,
+                           const QJsonObject& body = QJsonObject())
+{
+    return createDAPResponseMessage(seq, requestSeq, true, command, QString(), body);
+}
+
+static std::shared_ptr<DAPResponse> toResponse(const PDAPProtocolMessage& message)
+{
+    if (!message || message->type != "response")
+        return nullptr;
+    return std::static_pointer_cast<DAPResponse>(message);
+}
+
+TestDAPSession::TestDAPSession(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestDAPSession::test_seq_matching()
+{
+    Session session;
+    QVERIFY(!session.hasPendingRequests());
+    session.enqueue(createCommand("initialize"));
+    session.enqueue(createCommand("attach"));
+    session.enqueue(createCommand("setBreakpoints"));
+    session.enqueue(createCommand("configurationDone"));
+    // configurations wait for the "initialized" event
+    QList<QPair<qint64, PTestCommand>> sent = session.takeSendable();
+    QCOMPARE(sent.count(), 2);
+    QCOMPARE(sent[0].first, 1LL);
+    QCOMPARE(sent[0].second->command, QString("initialize"));
+    QCOMPARE(sent[1].first, 2LL);
+    QCOMPARE(sent[1].second->command, QString("attach"));
+    QVERIFY(session.takeSendable().isEmpty());
+    QVERIFY(session.hasRunningRequests());
+
+    // responses come in any order, and a message may be split between reads
+    QByteArray output = response(1, 2, "attach")
+            + createDAPEventMessage(2, "initialized", QJsonObject())
+            + response(3, 1, "initialize", QJsonObject{{"supportsConfigurationDoneRequest", true}});
+    QVERIFY(receive(session, output.left(10)).isEmpty());
+    QList<PDAPProtocolMessage> messages = receive(session, output.mid(10));
+    QCOMPARE(messages.count(), 3);
+
+    std::shared_ptr<DAPResponse> resp = toResponse(messages[0]);
+    QVERIFY(resp);
+    PTestCommand cmd = session.takeRequest(resp->request_seq);
+    QVERIFY(cmd);
+    QCOMPARE(cmd->command, QString("attach"));
+    // it's answered only once
+    QVERIFY(!session.takeRequest(resp->request_seq));
+
+    QCOMPARE(messages[1]->type, QString("event"));
+    QCOMPARE(std::static_pointer_cast<DAPEvent>(messages[1])->event, QString("initialized"));
+    session.setInitialized();
+
+    resp = toResponse(messages[2]);
+    QVERIFY(resp);
+    cmd = session.takeRequest(resp->request_seq);
+    QVERIFY(cmd);
+    QCOMPARE(cmd->command, QString("initialize"));
+    QCOMPARE(resp->body["supportsConfigurationDoneRequest"].toBool(), true);
+    QVERIFY(!session.hasRunningRequests());
+    // an unknown request
+    QVERIFY(!session.takeRequest(99));
+
+    // the queued configurations are sent now, in order
+    QVERIFY(session.hasPendingRequests());
+    sent = session.takeSendable();
+    QCOMPARE(sent.count(), 2);
+    QCOMPARE(sent[0].first, 3LL);
+    QCOMPARE(sent[0].second->command, QString("setBreakpoints"));
+    QCOMPARE(sent[1].first, 4LL);
+    QCOMPARE(sent[1].second->command, QString("configurationDone"));
+    QCOMPARE(session.runningRequests().count(), 2);
+
+    // a broken header is skipped
+    QStringList errors;
+    session.receive("Content-Type: text\r\n\r\n" + response(4, 4, "configurationDone"));
+    QList<QByteArray> contentParts = session.takeMessages(errors);
+    QCOMPARE(errors.count(), 1);
+    QCOMPARE(contentParts.count(), 1);
+    resp = toResponse(parseDAPMessage(contentParts[0]));
+    QVERIFY(resp);
+    QCOMPARE(session.takeRequest(resp->request_seq)->command, QString("configurationDone"));
+    // still waiting for the breakpoints
+    QVERIFY(session.hasPendingRequests());
+    QVERIFY(session.takeRequest(3));
+    QVERIFY(!session.hasPendingRequests());
+}
+
+void TestDAPSession::test_reset()
+{
+    Session session;
+    session.enqueue(createCommand("initialize"));
+    QCOMPARE(session.takeSendable().count(), 1);
+    QCOMPARE(session.takeSeq(), 2LL);
+    session.setInitialized();
+    session.receive("Content-Length: 100\r\n\r\n{");
+    // posted before the adapter is started again
+    session.enqueue(createCommand("threads"));
+    session.reset();
+    QVERIFY(!session.initialized());
+    QVERIFY(!session.hasRunningRequests());
+    QStringList errors;
+    QVERIFY(session.takeMessages(errors).isEmpty());
+    QVERIFY(session.hasPendingRequests());
+    QVERIFY(session.takeSendable().isEmpty());
+    session.enqueue(createCommand("initialize"));
+    session.setInitialized();
+    QList<QPair<qint64, PTestCommand>> sent = session.takeSendable();
+    QCOMPARE(sent.count(), 2);
+    QCOMPARE(sent[0].first, 1LL);
+    QCOMPARE(sent[0].second->command, QString("threads"));
+}
+
+void TestDAPSession::test_stopped_to_variables()
+{
+    Session session;
+    session.setInitialized();
+    qint64 adapterSeq = 1;
+
+    // stopped: the stack of the stopped thread is asked for
+    QList<PDAPProtocolMessage> messages = receive(session, createDAPEventMessage(
+            adapterSeq++, "stopped", QJsonObject{{"reason", "breakpoint"}, {"threadId", 7}}));
+    QCOMPARE(messages.count(), 1);
+    QCOMPARE(messages[0]->type, QString("event"));
+    std::shared_ptr<DAPEvent> event = std::static_pointer_cast<DAPEvent>(messages[0]);
+    QCOMPARE(event->event, QString("stopped"));
+    session.enqueue(createCommand("stackTrace", QJsonObject{
+                                      {"threadId", event->body["threadId"]},
+                                      {"startFrame", 0},
+                                      {"levels", 100}}));
+    QList<QPair<qint64, PTestCommand>> sent = session.takeSendable();
+    QCOMPARE(sent.count(), 1);
+    QCOMPARE(sent[0].second->arguments["threadId"].toInt(), 7);
+
+    QJsonArray frames{
+        QJsonObject{{"id", 1000}, {"name", "main"}, {"line", 5}},
+        QJsonObject{{"id", 1001}, {"name", "__libc_start_main"}}};
+    messages = receive(session, response(adapterSeq++, sent[0].first, "stackTrace",
+                                         QJsonObject{{"stackFrames", frames}}));
+    std::shared_ptr<DAPResponse> resp = toResponse(messages.value(0));
+    QVERIFY(resp);
+    QCOMPARE(session.takeRequest(resp->request_seq)->command, QString("stackTrace"));
+    qint64 frameId = static_cast<qint64>(resp->body["stackFrames"].toArray()[0].toObject()["id"].toDouble());
+    QCOMPARE(frameId, 1000LL);
+
+    // scopes of the top frame
+    session.enqueue(createCommand("scopes", QJsonObject{{"frameId", frameId}}));
+    sent = session.takeSendable();
+    QCOMPARE(sent.count(), 1);
+    QJsonArray scopes{
+        QJsonObject{{"name", "Locals"}, {"variablesReference", 11}},
+        QJsonObject{{"name", "Registers"}, {"presentationHint", "registers"}, {"variablesReference", 12}},
+        QJsonObject{{"name", "Globals"}, {"variablesReference", 13}, {"expensive", true}}};
+    messages = receive(session, response(adapterSeq++, sent[0].first, "scopes",
+                                         QJsonObject{{"scopes", scopes}}));
+    resp = toResponse(messages.value(0));
+    QVERIFY(resp);
+    QCOMPARE(session.takeRequest(resp->request_seq)->command, QString("scopes"));
+    // the locals are read from the cheap, non register scopes
+    foreach (const QJsonValue& value, resp->body["scopes"].toArray()) {
+        QJsonObject scope = value.toObject();
+        if (isDAPRegisterScope(scope) || scope["expensive"].toBool())
+            continue;
+        session.enqueue(createCommand("variables", QJsonObject{
+                                          {"variablesReference", scope["variablesReference"]}}));
+    }
+    QVERIFY(isDAPRegisterScope(QJsonObject{{"name", "General Purpose Registers"}}));
+    sent = session.takeSendable();
+    QCOMPARE(sent.count(), 1);
+    QCOMPARE(sent[0].second->arguments["variablesReference"].toInt(), 11);
+
+    QJsonArray variables{
+        QJsonObject{{"name", "i"}, {"value", "1"}, {"variablesReference", 0}},
+        QJsonObject{{"name", "arr"}, {"value", "{...}"}, {"variablesReference", 14},
+                    {"indexedVariables", 250}}};
+    messages = receive(session, response(adapterSeq++, sent[0].first, "variables",
+                                         QJsonObject{{"variables", variables}}));
+    resp = toResponse(messages.value(0));
+    QVERIFY(resp);
+    QCOMPARE(session.takeRequest(resp->request_seq)->command, QString("variables"));
+    QJsonObject arr = resp->body["variables"].toArray()[1].toObject();
+    QCOMPARE(arr["indexedVariables"].toInt(), 250);
+    QVERIFY(!session.hasPendingRequests());
+
+    // the children of arr are listed page by page
+    int indexedCount = arr["indexedVariables"].toInt();
+    qint64 reference = static_cast<qint64>(arr["variablesReference"].toDouble());
+    int from = 0;
+    int pages = 0;
+    while (true) {
+        session.enqueue(createCommand("variables",
+                                      createDAPVariablesArguments(reference, indexedCount, from, 100)));
+        sent = session.takeSendable();
+        QCOMPARE(sent.count(), 1);
+        QJsonObject args = sent[0].second->arguments;
+        QCOMPARE(args["filter"].toString(), QString("indexed"));
+        QCOMPARE(args["start"].toInt(), from);
+        QJsonArray children;
+        for (int i = 0; i < args["count"].toInt(); i++)
+            children.append(QJsonObject{{"name", QString("[%1]").arg(from + i)}, {"value", "0"}});
+        messages = receive(session, response(adapterSeq++, sent[0].first, "variables",
+                                             QJsonObject{{"variables", children}}));
+        resp = toResponse(messages.value(0));
+        QVERIFY(resp);
+        PTestCommand cmd = session.takeRequest(resp->request_seq);
+        QVERIFY(cmd);
+        int listed = resp->body["variables"].toArray().count();
+        pages++;
+        if (!hasMoreDAPVariables(indexedCount, cmd->arguments["start"].toInt(), listed, 100))
+            break;
+        from += listed;
+    }
+    QCOMPARE(pages, 3);
+    QCOMPARE(from, 200);
+    QCOMPARE(resp->body["variables"].toArray().count(), 50);
+}
+
+void TestDAPSession::test_variables_paging()
+{
+    QJsonObject args = createDAPVariablesArguments(5, 250, 200, 100);
+    QCOMPARE(static_cast<qint64>(args["variablesReference"].toDouble()), 5LL);
+    QCOMPARE(args["filter"].toString(), QString("indexed"));
+    QCOMPARE(args["start"].toInt(), 200);
+    // not past the last element
+    QCOMPARE(args["count"].toInt(), 50);
+    args = createDAPVariablesArguments(5, 250, 100, 0);
+    QCOMPARE(args["start"].toInt(), 100);
+    QCOMPARE(args["count"].toInt(), 150);
+    // struct members
+    args = createDAPVariablesArguments(6, 0, 10, 20);
+    QVERIFY(!args.contains("filter"));
+    QCOMPARE(args["start"].toInt(), 10);
+    QCOMPARE(args["count"].toInt(), 20);
+    args = createDAPVariablesArguments(6, 0, 0, 0);
+    QCOMPARE(args.count(), 1);
+
+    QVERIFY(hasMoreDAPVariables(250, 100, 100, 100));
+    QVERIFY(!hasMoreDAPVariables(250, 200, 50, 100));
+    // the count isn't known, a full page may be followed by more
+    QVERIFY(hasMoreDAPVariables(0, 0, 100, 100));
+    QVERIFY(!hasMoreDAPVariables(0, 100, 30, 100));
+    QVERIFY(!hasMoreDAPVariables(0, 0, 30, 0));
+}
@@ -0,0 +1,17 @@
+#ifndef TEST_DAPSESSION_H
+#define TEST_DAPSESSION_H
+#include <QObject>
+
+class TestDAPSession: public QObject
+{
+    Q_OBJECT
+public:
+    TestDAPSession(QObject *parent=nullptr);
+private slots:
+    void test_seq_matching();
+    void test_reset();
+    void test_stopped_to_variables();
+    void test_variables_paging();
+};
+
+#endif
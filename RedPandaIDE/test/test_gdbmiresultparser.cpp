@@ -0,0 +1,168 @@
+#include <QTest>
+#include <QFile>
+#include <QHash>
+#include "test_gdbmiresultparser.h"
+#include "src/debugger/gdbmiresultparser.h"
+
+TestGDBMIResultParser::TestGDBMIResultParser(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestGDBMIResultParser::test_parse_frame()
+{
+    GDBMIResultParser parser;
+    GDBMIResultType type;
+    GDBMIResultParser::ParseObject multiValues;
+    QByteArray record = "frame={level=\"0\",addr=\"0x0000555555555189\",func=\"main\",file=\"main.cpp\",line=\"12\"}";
+    QVERIFY(parser.parse(record, "-stack-info-frame", type, multiValues));
+    QCOMPARE(type, GDBMIResultType::Frame);
+    GDBMIResultParser::ParseValue frame = multiValues["frame"];
+    QCOMPARE(frame.type(), GDBMIResultParser::ParseValueType::Object);
+    GDBMIResultParser::ParseObject frameObj = frame.object();
+    bool ok;
+    QCOMPARE(frameObj["addr"].hexValue(ok), 0x555555555189ULL);
+    QVERIFY(ok);
+    QCOMPARE(frameObj["func"].value(), QByteArray("main"));
+    QCOMPARE(frameObj["line"].intValue(), 12LL);
+    QVERIFY(!frameObj["fullname"].isValid());
+    QVERIFY(!multiValues["stack"].isValid());
+}
+
+void TestGDBMIResultParser::test_parse_frame_stack()
+{
+    GDBMIResultParser parser;
+    GDBMIResultType type;
+    GDBMIResultParser::ParseObject multiValues;
+    QByteArray record = "stack=[frame={level=\"0\",func=\"f\"},frame={level=\"1\",func=\"main\"}], extra = [ ] ";
+    QVERIFY(parser.parse(record, "-stack-list-frames", type, multiValues));
+    QCOMPARE(type, GDBMIResultType::FrameStack);
+    QList<GDBMIResultParser::ParseValue> stack = multiValues["stack"].array();
+    QCOMPARE(stack.count(), 2);
+    QCOMPARE(stack[0].object()["func"].value(), QByteArray("f"));
+    QCOMPARE(stack[1].object()["level"].intValue(), 1LL);
+    QCOMPARE(multiValues["extra"].type(), GDBMIResultParser::ParseValueType::Array);
+    QVERIFY(multiValues["extra"].array().isEmpty());
+}
+
+void TestGDBMIResultParser::test_parse_escaped_string()
+{
+    GDBMIResultParser parser;
+    GDBMIResultType type;
+    GDBMIResultParser::ParseObject multiValues;
+    QByteArray record = "value=\"\\\"a\\tb\\\\\\101\\0\\\"\",plain=\"x\"";
+    QVERIFY(parser.parse(record, "-data-evaluate-expression", type, multiValues));
+    QCOMPARE(type, GDBMIResultType::Evaluation);
+    QCOMPARE(multiValues["value"].value(), QByteArray("\"a\tb\\A\0\"", 8));
+    QCOMPARE(multiValues["plain"].value(), QByteArray("x"));
+    // strings without escapes are not copied
+    QVERIFY(multiValues["plain"].value().constData() >= record.constData());
+    QVERIFY(multiValues["plain"].value().constData() < record.constData() + record.length());
+}
+
+void TestGDBMIResultParser::test_parse_async_stopped()
+{
+    GDBMIResultParser parser;
+    QByteArray result;
+    GDBMIResultParser::ParseObject multiValues;
+    QByteArray record = "*stopped,reason=\"breakpoint-hit\",frame={addr=\"0x1\",args=[{name=\"a\",value=\"1\"}]}";
+    QVERIFY(parser.parseAsyncResult(record, result, multiValues));
+    QCOMPARE(result, QByteArray("stopped"));
+    QCOMPARE(multiValues["reason"].value(), QByteArray("breakpoint-hit"));
+    QList<GDBMIResultParser::ParseValue> args = multiValues["frame"].object()["args"].array();
+    QCOMPARE(args.count(), 1);
+    QCOMPARE(args[0].object()["value"].intValue(), 1LL);
+
+    QByteArray record2 = "*running";
+    QVERIFY(parser.parseAsyncResult(record2, result, multiValues));
+    QCOMPARE(result, QByteArray("running"));
+    QVERIFY(!multiValues["reason"].isValid());
+}
+
+void TestGDBMIResultParser::test_parse_unknown_command()
+{
+    GDBMIResultParser parser;
+    GDBMIResultType type;
+    GDBMIResultParser::ParseObject multiValues;
+    QVERIFY(!parser.parse("value=\"1\"", "-gdb-set", type, multiValues));
+}
+
+void TestGDBMIResultParser::test_parse_unterminated_string()
+{
+    GDBMIResultParser parser;
+    GDBMIResultType type;
+    GDBMIResultParser::ParseObject multiValues;
+    QByteArray record = "value=\"abc\\\"";
+    // the parser must not read past the end of a record that isn't null-terminated
+    QVERIFY(!parser.parse(QByteArray::fromRawData(record.constData(), record.length()),
+                          "-data-evaluate-expression", type, multiValues));
+    QVERIFY(!parser.parse(QByteArray::fromRawData(record.constData(), 7),
+                          "-data-evaluate-expression", type, multiValues));
+    QVERIFY(!parser.parse("stack=[frame={level=\"0\"}", "-stack-list-frames", type, multiValues));
+}
+
+void TestGDBMIResultParser::test_parse_transcript()
+{
+    QList<QPair<QString,QByteArray>> results = loadResults("resources/gdbmi-session-1.txt");
+    QCOMPARE(results.count(), 9);
+    GDBMIResultParser parser;
+    for (const QPair<QString,QByteArray>& result : results) {
+        GDBMIResultType type;
+        GDBMIResultParser::ParseObject multiValues;
+        QVERIFY2(parser.parse(result.second, result.first, type, multiValues),
+                 result.first.toLocal8Bit());
+    }
+    GDBMIResultType type;
+    GDBMIResultParser::ParseObject multiValues;
+    QVERIFY(parser.parse(results[0].second, results[0].first, type, multiValues));
+    QList<GDBMIResultParser::ParseValue> stack = multiValues["stack"].array();
+    QCOMPARE(stack.count(), 64);
+    QCOMPARE(stack[63].object()["func"].value(), QByteArray("main"));
+    QVERIFY(parser.parse(results[1].second, results[1].first, type, multiValues));
+    QList<GDBMIResultParser::ParseValue> variables = multiValues["variables"].array();
+    QCOMPARE(variables.count(), 6);
+    QCOMPARE(variables[4].object()["value"].value(), QByteArray("\"pivot\\t\\\"x\\\"\\n\""));
+    QVERIFY(!variables[5].object()["value"].isValid());
+    QVERIFY(parser.parse(results[6].second, results[6].first, type, multiValues));
+    QCOMPARE(type, GDBMIResultType::Disassembly);
+    QCOMPARE(multiValues["asm_insns"].array().count(), 300);
+}
+
+void TestGDBMIResultParser::benchmark_parse_transcript()
+{
+    QList<QPair<QString,QByteArray>> results = loadResults("resources/gdbmi-session-1.txt");
+    GDBMIResultParser parser;
+    QBENCHMARK {
+        for (const QPair<QString,QByteArray>& result : results) {
+            GDBMIResultType type;
+            GDBMIResultParser::ParseObject multiValues;
+            parser.parse(result.second, result.first, type, multiValues);
+        }
+    }
+}
+
+QList<QPair<QString, QByteArray>> TestGDBMIResultParser::loadResults(const QString &filename)
+{
+    QList<QPair<QString,QByteArray>> results;
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly))
+        return results;
+    // commands are logged as "<token><command>", results as "<token>^done,..."
+    QHash<QByteArray, QString> commands;
+    foreach (const QByteArray& line, file.readAll().split('\n')) {
+        int p = 0;
+        while (p < line.length() && line[p] >= '0' && line[p] <= '9')
+            p++;
+        if (p == 0 || p >= line.length())
+            continue;
+        QByteArray token = line.left(p);
+        if (line[p] == '-') {
+            QByteArray command = line.mid(p);
+            int pos = command.indexOf(' ');
+            commands.insert(token, QString::fromLatin1(pos < 0 ? command : command.left(pos)));
+        } else if (line.mid(p).startsWith("^done,")) {
+            results.append(QPair<QString,QByteArray>(commands.value(token), line.mid(p + 6)));
+        }
+    }
+    return results;
+}
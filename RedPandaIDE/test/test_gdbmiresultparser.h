@@ -0,0 +1,26 @@
+#ifndef TEST_GDBMIRESULTPARSER_H
+#define TEST_GDBMIRESULTPARSER_H
+#include <QObject>
+#include <QList>
+#include <QPair>
+
+class TestGDBMIResultParser: public QObject
+{
+    Q_OBJECT
+public:
+    TestGDBMIResultParser(QObject *parent=nullptr);
+private slots:
+    void test_parse_frame();
+    void test_parse_frame_stack();
+    void test_parse_escaped_string();
+    void test_parse_async_stopped();
+    void test_parse_unknown_command();
+    void test_parse_unterminated_string();
+    void test_parse_transcript();
+    void benchmark_parse_transcript();
+private:
+    // (command, result) of each result record in the recorded transcript
+    static QList<QPair<QString,QByteArray>> loadResults(const QString& filename);
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include <QTest>
+#include <QDir>
+#include <qt_utils/utils.h>
+#include "test_gitstatus.h"
+#include "src/vcs/gitutils.h"
+
+static QString pathInFolder(const QString& folder, const QString& path)
+{
+    return cleanPath(QDir(folder).absoluteFilePath(path));
+}
+
+TestGitStatus::TestGitStatus(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestGitStatus::test_parse_branch()
+{
+    QByteArray output;
+    output += QByteArray("# branch.oid 4b825dc642cb6eb9a060e54bf8d69288fbee4904") + '\0';
+    output += QByteArray("# branch.head main") + '\0';
+    output += QByteArray("# branch.upstream origin/main") + '\0';
+    output += QByteArray("# branch.ab +1 -0") + '\0';
+    GitStatus status;
+    parseGitStatus(output, QDir::tempPath(), status);
+    QVERIFY(status.inRepository);
+    QCOMPARE(status.branch, QString("main"));
+    QVERIFY(status.changedFiles.isEmpty());
+    QVERIFY(status.stagedFiles.isEmpty());
+    QVERIFY(status.conflicts.isEmpty());
+}
+
+void TestGitStatus::test_parse_changed()
+{
+    QString folder = QDir::tempPath();
+    QByteArray output;
+    output += QByteArray("# branch.oid 4b825dc642cb6eb9a060e54bf8d69288fbee4904") + '\0';
+    output += QByteArray("# branch.head dev") + '\0';
+    output += QByteArray("1 .M N... 100644 100644 100644 e69de29 e69de29 src/main.cpp") + '\0';
+    output += QByteArray("1 A. N... 000000 100644 100644 0000000 e69de29 include/with space.h") + '\0';
+    output += QByteArray("1 MM N... 100644 100644 100644 e69de29 e69de29 both.c") + '\0';
+    GitStatus status;
+    parseGitStatus(output, folder, status);
+    QVERIFY(status.inRepository);
+    QCOMPARE(status.branch, QString("dev"));
+    QCOMPARE(status.changedFiles, QSet<QString>({
+                                                    pathInFolder(folder, "src/main.cpp"),
+                                                    pathInFolder(folder, "both.c")}));
+    QCOMPARE(status.stagedFiles, QSet<QString>({
+                                                   pathInFolder(folder, "include/with space.h"),
+                                                   pathInFolder(folder, "both.c")}));
+    QVERIFY(status.conflicts.isEmpty());
+}
+
+void TestGitStatus::test_parse_renamed()
+{
+    QString folder = QDir::tempPath();
+    QByteArray output;
+    output += QByteArray("# branch.oid 4b825dc642cb6eb9a060e54bf8d69288fbee4904") + '\0';
+    output += QByteArray("# branch.head main") + '\0';
+    // the original path follows the entry, it must not be taken as a changed file
+    output += QByteArray("2 R. N... 100644 100644 100644 e69de29 e69de29 R100 new name.cpp") + '\0';
+    output += QByteArray("old.cpp") + '\0';
+    output += QByteArray("2 RM N... 100644 100644 100644 e69de29 e69de29 R87 include/moved.h") + '\0';
+    output += QByteArray("moved.h") + '\0';
+    output += QByteArray("1 .M N... 100644 100644 100644 e69de29 e69de29 main.cpp") + '\0';
+    GitStatus status;
+    parseGitStatus(output, folder, status);
+    QCOMPARE(status.stagedFiles, QSet<QString>({
+                                                   pathInFolder(folder, "new name.cpp"),
+                                                   pathInFolder(folder, "include/moved.h")}));
+    QCOMPARE(status.changedFiles, QSet<QString>({
+                                                    pathInFolder(folder, "include/moved.h"),
+                                                    pathInFolder(folder, "main.cpp")}));
+}
+
+void TestGitStatus::test_parse_unmerged()
+{
+    QString folder = QDir::tempPath();
+    QByteArray output;
+    output += QByteArray("# branch.oid 4b825dc642cb6eb9a060e54bf8d69288fbee4904") + '\0';
+    output += QByteArray("# branch.head main") + '\0';
+    output += QByteArray("u UU N... 100644 100644 100644 100644 e69de29 e69de29 e69de29 conflict.cpp") + '\0';
+    output += QByteArray("1 M. N... 100644 100644 100644 e69de29 e69de29 merged.cpp") + '\0';
+    GitStatus status;
+    parseGitStatus(output, folder, status);
+    QCOMPARE(status.conflicts, QSet<QString>({pathInFolder(folder, "conflict.cpp")}));
+    QCOMPARE(status.changedFiles, QSet<QString>({pathInFolder(folder, "conflict.cpp")}));
+    QCOMPARE(status.stagedFiles, QSet<QString>({pathInFolder(folder, "merged.cpp")}));
+}
+
+void TestGitStatus::test_parse_not_in_repository()
+{
+    GitStatus status;
+    parseGitStatus(QByteArray(), QDir::tempPath(), status);
+    QVERIFY(!status.inRepository);
+    QVERIFY(status.branch.isEmpty());
+}
@@ -0,0 +1,18 @@
+#ifndef TEST_GITSTATUS_H
+#define TEST_GITSTATUS_H
+#include <QObject>
+
+class TestGitStatus: public QObject
+{
+    Q_OBJECT
+public:
+    TestGitStatus(QObject *parent=nullptr);
+private slots:
+    void test_parse_branch();
+    void test_parse_changed();
+    void test_parse_renamed();
+    void test_parse_unmerged();
+    void test_parse_not_in_repository();
+};
+
+#endif
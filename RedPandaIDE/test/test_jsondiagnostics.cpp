@@ -0,0 +1,253 @@
+#include <QTest>
+#include <QFile>
+#include <QJsonArray>
+#include "test_jsondiagnostics.h"
+#include "src/compiler/jsondiagnostics.h"
+
+static const char *const DIAGNOSTICS_OUTPUT =
+        "In file included from main.cpp:1:\n"
+        "[{\"kind\": \"error\", \"message\": \"expected '}' at end of input {\\\"[\\\"}\","
+        " \"children\": [], \"column-origin\": 1,"
+        " \"locations\": [{\"caret\": {\"file\": \"main.cpp\", \"line\": 3, \"column\": 2}}],"
+        " \"escape-source\": false},"
+        " {\"kind\": \"warning\", \"message\": \"unused variable 'x'\", \"option\": \"-Wunused-variable\","
+        " \"children\": [], \"column-origin\": 1,"
+        " \"locations\": [{\"caret\": {\"file\": \"main.cpp\", \"line\": 2, \"column\": 9}}],"
+        " \"escape-source\": false}]\n"
+        "compilation terminated.\n";
+
+TestJsonDiagnostics::TestJsonDiagnostics(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestJsonDiagnostics::test_chunked_input()
+{
+    QString output = DIAGNOSTICS_OUTPUT;
+    // the output may be split at any position
+    for (int i = 0; i <= output.length(); i++) {
+        JsonDiagnosticsReader reader;
+        QStringList lines;
+        QList<QJsonObject> diagnostics;
+        reader.feed(output.left(i), lines, diagnostics);
+        reader.feed(output.mid(i), lines, diagnostics);
+        reader.finish(lines);
+        lines.removeAll("");
+        QCOMPARE(lines, QStringList({"In file included from main.cpp:1:", "compilation terminated."}));
+        QCOMPARE(diagnostics.count(), 2);
+        QCOMPARE(diagnostics[0]["kind"].toString(), QString("error"));
+        QCOMPARE(diagnostics[0]["message"].toString(), QString("expected '}' at end of input {\"[\"}"));
+        QCOMPARE(diagnostics[1]["kind"].toString(), QString("warning"));
+        QCOMPARE(diagnostics[1]["option"].toString(), QString("-Wunused-variable"));
+        QCOMPARE(diagnostics[1]["locations"].toArray()[0].toObject()["caret"].toObject()["line"].toInt(), 2);
+    }
+}
+
+void TestJsonDiagnostics::test_nested_children()
+{
+    QString output =
+            "[{\"kind\": \"error\", \"message\": \"no matching function for call to 'f(int)'\","
+            " \"children\": [{\"kind\": \"note\", \"message\": \"candidate: 'void f()'\","
+            " \"locations\": [{\"caret\": {\"file\": \"main.cpp\", \"line\": 1, \"column\": 6}}],"
+            " \"children\": [{\"kind\": \"note\", \"message\": \"candidate expects 0 arguments, 1 provided\","
+            " \"locations\": []}]}],"
+            " \"locations\": [{\"caret\": {\"file\": \"main.cpp\", \"line\": 5, \"column\": 6}}]}]\n";
+    JsonDiagnosticsReader reader;
+    QStringList lines;
+    QList<QJsonObject> diagnostics;
+    reader.feed(output, lines, diagnostics);
+    reader.finish(lines);
+    lines.removeAll("");
+    QVERIFY(lines.isEmpty());
+    // children belong to their parent, not to the top level
+    QCOMPARE(diagnostics.count(), 1);
+    QJsonArray children = diagnostics[0]["children"].toArray();
+    QCOMPARE(children.count(), 1);
+    QJsonObject child = children[0].toObject();
+    QCOMPARE(child["message"].toString(), QString("candidate: 'void f()'"));
+    QCOMPARE(child["locations"].toArray()[0].toObject()["caret"].toObject()["line"].toInt(), 1);
+    QJsonArray grandChildren = child["children"].toArray();
+    QCOMPARE(grandChildren.count(), 1);
+    QCOMPARE(grandChildren[0].toObject()["message"].toString(), QString("candidate expects 0 arguments, 1 provided"));
+}
+
+void TestJsonDiagnostics::test_fixits()
+{
+    QString output = QString::fromUtf8(
+            "[{\"kind\": \"error\", \"message\": \"expected ';' before '}' token\","
+            " \"fixits\": [{\"start\": {\"file\": \"main.cpp\", \"line\": 2, \"display-column\": 10,"
+            " \"byte-column\": 14, \"column\": 14},"
+            " \"next\": {\"file\": \"main.cpp\", \"line\": 2, \"display-column\": 10,"
+            " \"byte-column\": 14, \"column\": 14}, \"string\": \";\"},"
+            " {\"start\": {\"file\": \"main.cpp\", \"line\": 3, \"column\": 1},"
+            " \"next\": {\"file\": \"main.cpp\", \"line\": 3, \"column\": 4}, \"string\": \"\\\"\xe4\xb8\xad\\\"]\"}],"
+            " \"locations\": [{\"caret\": {\"file\": \"main.cpp\", \"line\": 2, \"column\": 14}}]}]\n");
+    JsonDiagnosticsReader reader;
+    QStringList lines;
+    QList<QJsonObject> diagnostics;
+    // feed one char at a time
+    for (int i = 0; i < output.length(); i++)
+        reader.feed(output.mid(i, 1), lines, diagnostics);
+    reader.finish(lines);
+    QCOMPARE(diagnostics.count(), 1);
+    QJsonArray fixIts = diagnostics[0]["fixits"].toArray();
+    QCOMPARE(fixIts.count(), 2);
+    QJsonObject fixIt = fixIts[0].toObject();
+    QCOMPARE(fixIt["string"].toString(), QString(";"));
+    QCOMPARE(fixIt["start"].toObject()["byte-column"].toInt(), 14);
+    QCOMPARE(fixIt["next"].toObject()["display-column"].toInt(), 10);
+    fixIt = fixIts[1].toObject();
+    QCOMPARE(fixIt["string"].toString(), QString::fromUtf8("\"\xe4\xb8\xad\"]"));
+    QCOMPARE(fixIt["next"].toObject()["column"].toInt(), 4);
+}
+
+void TestJsonDiagnostics::test_unterminated_line()
+{
+    JsonDiagnosticsReader reader;
+    QStringList lines;
+    QList<QJsonObject> diagnostics;
+    reader.feed("ld returned 1 exit status\r\ncollect2: error: ", lines, diagnostics);
+    QCOMPARE(lines, QStringList({"ld returned 1 exit status"}));
+    lines.clear();
+    reader.feed("ld returned", lines, diagnostics);
+    QVERIFY(lines.isEmpty());
+    reader.finish(lines);
+    QCOMPARE(lines, QStringList({"collect2: error: ld returned"}));
+    // an unfinished array element is dropped
+    lines.clear();
+    reader.feed("[{\"kind\": \"error\"", lines, diagnostics);
+    reader.finish(lines);
+    QVERIFY(lines.isEmpty());
+    QVERIFY(diagnostics.isEmpty());
+}
+
+void TestJsonDiagnostics::test_byte_column_to_char_column()
+{
+    QString lineText = QString::fromUtf8("int \xe4\xb8\xad\xe6\x96\x87 = 1;");
+    QCOMPARE(byteColumnToCharColumn(lineText, 0), 0);
+    QCOMPARE(byteColumnToCharColumn(lineText, 4), 4);
+    // each chinese char takes 3 bytes
+    QCOMPARE(byteColumnToCharColumn(lineText, 7), 5);
+    QCOMPARE(byteColumnToCharColumn(lineText, 10), 6);
+    QCOMPARE(byteColumnToCharColumn(lineText, 11), 7);
+    // past the end of the line
+    QCOMPARE(byteColumnToCharColumn(lineText, 100), lineText.length());
+    // a char out of the bmp takes 4 bytes and 2 utf-16 units
+    lineText = QString::fromUtf8("s=\"\xf0\x9f\x98\x80\";");
+    QCOMPARE(byteColumnToCharColumn(lineText, 3), 3);
+    QCOMPARE(byteColumnToCharColumn(lineText, 7), 5);
+    QCOMPARE(byteColumnToCharColumn(lineText, 8), 6);
+}
+
+static QString toFilename(const QString& filename)
+{
+    return "/work/" + filename;
+}
+
+void TestJsonDiagnostics::test_convert_diagnostics()
+{
+    // output of gcc -fdiagnostics-format=json -fanalyzer for a small test file
+    QFile file("resources/gcc-json-diagnostics.json");
+    QVERIFY(file.open(QFile::ReadOnly));
+    QString output = QString::fromUtf8(file.readAll());
+    JsonDiagnosticsReader reader;
+    QStringList lines;
+    QList<QJsonObject> diagnostics;
+    for (int i = 0; i < output.length(); i += 7)
+        reader.feed(output.mid(i, 7), lines, diagnostics);
+    reader.finish(lines);
+    QCOMPARE(diagnostics.count(), 3);
+
+    CompileIssueList issues;
+    QStringList logLines;
+    int errorCount = 0;
+    int warningCount = 0;
+    foreach (const QJsonObject& diagnostic, diagnostics) {
+        convertJsonDiagnostic(diagnostic, toFilename, issues, logLines, errorCount, warningCount);
+    }
+    QCOMPARE(errorCount, 2);
+    // notes are counted as warnings, like the text messages, but the path events aren't
+    QCOMPARE(warningCount, 2);
+    QCOMPARE(logLines, QStringList({
+                                       "main.cpp:5:5: error: expected ',' or ';' before 'f'",
+                                       "main.cpp:5:6: error: too many arguments to function 'void f()'",
+                                       "main.cpp:2:6: note: declared here",
+                                       "main.cpp:7:12: warning: use of uninitialized value 'p'",
+                                   }));
+    QCOMPARE(issues.count(), 6);
+
+    PCompileIssue issue = issues[0];
+    QCOMPARE(issue->type, CompileIssueType::Error);
+    QCOMPARE(issue->filename, QString("/work/main.cpp"));
+    QCOMPARE(issue->line, 4);
+    QCOMPARE(issue->column, 4);
+    QCOMPARE(issue->endColumn, 5);
+    QCOMPARE(issue->description, QString("[Error] expected ',' or ';' before 'f'"));
+    // fix-its are in bytes
+    QCOMPARE(issue->fixIts.count(), 1);
+    QCOMPARE(issue->fixIts[0].line, 3);
+    QCOMPARE(issue->fixIts[0].column, 28);
+    QCOMPARE(issue->fixIts[0].endLine, 3);
+    QCOMPARE(issue->fixIts[0].endColumn, 28);
+    QCOMPARE(issue->fixIts[0].text, QString(";"));
+    QString lineText = QString::fromUtf8("    const char* s = \"\xe4\xb8\xad\xe6\x96\x87\"");
+    QCOMPARE(byteColumnToCharColumn(lineText, issue->fixIts[0].column), lineText.length());
+
+    // the range is on the same line
+    issue = issues[1];
+    QCOMPARE(issue->type, CompileIssueType::Error);
+    QCOMPARE(issue->line, 4);
+    QCOMPARE(issue->column, 5);
+    QCOMPARE(issue->endColumn, 9);
+    QVERIFY(issue->fixIts.isEmpty());
+
+    // children follow their parent
+    issue = issues[2];
+    QCOMPARE(issue->type, CompileIssueType::Note);
+    QCOMPARE(issue->filename, QString("/work/main.cpp"));
+    QCOMPARE(issue->line, 1);
+    QCOMPARE(issue->column, 5);
+    QCOMPARE(issue->endColumn, -1);
+    QCOMPARE(issue->description, QString("[Note] declared here"));
+
+    issue = issues[3];
+    QCOMPARE(issue->type, CompileIssueType::Warning);
+    QCOMPARE(issue->line, 6);
+    QCOMPARE(issue->column, 11);
+    QCOMPARE(issue->endColumn, 13);
+    QCOMPARE(issue->description, QString("[Warning] use of uninitialized value 'p' [-Wanalyzer-use-of-uninitialized-value]"));
+
+    // events of the analyzer's path
+    issue = issues[4];
+    QCOMPARE(issue->type, CompileIssueType::Note);
+    QCOMPARE(issue->filename, QString("/work/main.cpp"));
+    QCOMPARE(issue->line, 5);
+    QCOMPARE(issue->column, 9);
+    QCOMPARE(issue->endColumn, -1);
+    QCOMPARE(issue->description, QString("[Note] region created on stack here"));
+    issue = issues[5];
+    QCOMPARE(issue->line, 6);
+    QCOMPARE(issue->column, 11);
+    QCOMPARE(issue->description, QString("[Note] use of uninitialized value 'p' here"));
+}
+
+void TestJsonDiagnostics::test_convert_diagnostic_without_location()
+{
+    QJsonObject diagnostic;
+    diagnostic["kind"] = "fatal error";
+    diagnostic["message"] = "no input files";
+    diagnostic["locations"] = QJsonArray();
+    CompileIssueList issues;
+    QStringList logLines;
+    int errorCount = 0;
+    int warningCount = 0;
+    convertJsonDiagnostic(diagnostic, toFilename, issues, logLines, errorCount, warningCount);
+    QCOMPARE(errorCount, 1);
+    QCOMPARE(warningCount, 0);
+    QCOMPARE(logLines, QStringList({"fatal error: no input files"}));
+    QCOMPARE(issues.count(), 1);
+    QCOMPARE(issues[0]->type, CompileIssueType::Error);
+    QCOMPARE(issues[0]->line, -1);
+    QCOMPARE(issues[0]->column, -1);
+    QVERIFY(issues[0]->filename.isEmpty());
+}
@@ -0,0 +1,20 @@
+#ifndef TEST_JSONDIAGNOSTICS_H
+#define TEST_JSONDIAGNOSTICS_H
+#include <QObject>
+
+class TestJsonDiagnostics: public QObject
+{
+    Q_OBJECT
+public:
+    TestJsonDiagnostics(QObject *parent=nullptr);
+private slots:
+    void test_chunked_input();
+    void test_nested_children();
+    void test_fixits();
+    void test_unterminated_line();
+    void test_byte_column_to_char_column();
+    void test_convert_diagnostics();
+    void test_convert_diagnostic_without_location();
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include <QTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include "test_problemcasevalidator.h"
+#include "src/problems/problemcasevalidator.h"
+
+static POJProblemCase createCase(const QString& output, const QString& expected)
+{
+    POJProblemCase problemCase = std::make_shared<OJProblemCase>();
+    problemCase->output = output;
+    problemCase->setExpected(expected);
+    return problemCase;
+}
+
+TestProblemCaseValidator::TestProblemCaseValidator(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestProblemCaseValidator::test_crlf()
+{
+    ProblemCaseValidator validator;
+    POJProblemCase problemCase = createCase("1 2\n3\n", "1 2\r\n3\r\n");
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->outputLineCounts, 2);
+    QCOMPARE(problemCase->expectedLineCounts, 2);
+    problemCase = createCase("1 2\r3\r\n", "1 2\n3");
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::Exact));
+}
+
+void TestProblemCaseValidator::test_final_newline()
+{
+    ProblemCaseValidator validator;
+    POJProblemCase problemCase = createCase("1\n2", "1\n2\n");
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->firstDiffLine, -1);
+    // an extra empty line is a difference
+    problemCase = createCase("1\n2\n", "1\n2\n\n");
+    QVERIFY(!validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->firstDiffLine, 2);
+    QCOMPARE(problemCase->firstDiffColumn, 0);
+    QCOMPARE(problemCase->outputLineCounts, 2);
+    QCOMPARE(problemCase->expectedLineCounts, 3);
+}
+
+void TestProblemCaseValidator::test_trailing_spaces()
+{
+    ProblemCaseValidator validator;
+    POJProblemCase problemCase = createCase("1\n 2 3 \t\n", "1\n2 3\n");
+    QVERIFY(!validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->firstDiffLine, 1);
+    QCOMPARE(problemCase->firstDiffColumn, 0);
+    problemCase = createCase("1\n2 3 \t\n", "1\n2 3\n");
+    QVERIFY(!validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->firstDiffLine, 1);
+    QCOMPARE(problemCase->firstDiffColumn, 3);
+    problemCase = createCase("1\n 2 3 \t\n", "1\n2 3\n");
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::IgnoreLeadingTrailingSpaces));
+    // spaces inside the line still count
+    problemCase = createCase("2  3\n", "2 3\n");
+    QVERIFY(!validator.validate(problemCase, ProblemCaseValidateType::IgnoreLeadingTrailingSpaces));
+    QCOMPARE(problemCase->firstDiffColumn, 2);
+}
+
+void TestProblemCaseValidator::test_ignore_spaces()
+{
+    ProblemCaseValidator validator;
+    POJProblemCase problemCase = createCase(" 2 \t 3 \n", "2 3\n");
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::IgnoreSpaces));
+    problemCase = createCase("2 34\n", "2 3 4\n");
+    QVERIFY(!validator.validate(problemCase, ProblemCaseValidateType::IgnoreSpaces));
+    QCOMPARE(problemCase->firstDiffLine, 0);
+    QCOMPARE(problemCase->firstDiffColumn, 2);
+}
+
+void TestProblemCaseValidator::test_bom()
+{
+    ProblemCaseValidator validator;
+    const QString bom{QChar(0xFEFF)};
+    POJProblemCase problemCase = createCase(bom + "hello\n", "hello\n");
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    problemCase = createCase("hello\n", bom + "hello\n");
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    // the column is counted after the BOM
+    problemCase = createCase(bom + "hallo\n", "hello\n");
+    QVERIFY(!validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->firstDiffLine, 0);
+    QCOMPARE(problemCase->firstDiffColumn, 1);
+}
+
+void TestProblemCaseValidator::test_bom_in_expected_file()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filename = dir.filePath("expected.txt");
+    QFile file(filename);
+    QVERIFY(file.open(QFile::WriteOnly | QFile::Truncate));
+    file.write("\xEF\xBB\xBF" "1 2\r\n3\r\n");
+    file.close();
+
+    ProblemCaseValidator validator;
+    POJProblemCase problemCase = createCase("1 2\n3", QString());
+    problemCase->setExpectedOutputFileName(filename);
+    QVERIFY(validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->expectedLineCounts, 2);
+    problemCase->output = "1 2\n4\n";
+    QVERIFY(!validator.validate(problemCase, ProblemCaseValidateType::Exact));
+    QCOMPARE(problemCase->firstDiffLine, 1);
+    QCOMPARE(problemCase->firstDiffColumn, 0);
+}
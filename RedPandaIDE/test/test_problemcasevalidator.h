@@ -0,0 +1,19 @@
+#ifndef TEST_PROBLEMCASEVALIDATOR_H
+#define TEST_PROBLEMCASEVALIDATOR_H
+#include <QObject>
+
+class TestProblemCaseValidator: public QObject
+{
+    Q_OBJECT
+public:
+    TestProblemCaseValidator(QObject *parent=nullptr);
+private slots:
+    void test_crlf();
+    void test_final_newline();
+    void test_trailing_spaces();
+    void test_ignore_spaces();
+    void test_bom();
+    void test_bom_in_expected_file();
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include <QTest>
+#include "test_syntaxcheck.h"
+#include "src/compiler/syntaxcheck.h"
+
+using Scheduler = SyntaxCheckScheduler<QString>;
+
+TestSyntaxCheck::TestSyntaxCheck(QObject *parent):
+    QObject{parent}
+{
+}
+
+void TestSyntaxCheck::test_leading_system_includes()
+{
+    QStringList lines{
+        "// comment",
+        "/* block",
+        "   comment */ #include <stdio.h>",
+        "",
+        "#include <vector> // comment",
+        "  #  include <map>",
+        "#include \"local.h\"",
+        "#include <string>",
+    };
+    QCOMPARE(findLeadingSystemIncludes(lines), QList<int>({2, 4, 5}));
+    lines = QStringList{
+        "#include <stdio.h>",
+        "int x;",
+        "#include <stdlib.h>",
+    };
+    QCOMPARE(findLeadingSystemIncludes(lines), QList<int>({0}));
+    lines = QStringList{
+        "#define N 10",
+        "#include <stdio.h>",
+    };
+    QVERIFY(findLeadingSystemIncludes(lines).isEmpty());
+    // something else after the include
+    lines = QStringList{
+        "#include <stdio.h> int x;",
+    };
+    QVERIFY(findLeadingSystemIncludes(lines).isEmpty());
+}
+
+void TestSyntaxCheck::test_precompiled_header_name()
+{
+    QStringList arguments{"-x", "c++-header", "-I", "include", "-"};
+    QByteArray content = "#include <vector>\n";
+    QString name = precompiledHeaderName("gcc", "/usr/bin/g++", "/home/a", arguments, content);
+    QVERIFY(name.endsWith(".h"));
+    QCOMPARE(precompiledHeaderName("gcc", "/usr/bin/g++", "/home/a", arguments, content), name);
+    QVERIFY(precompiledHeaderName("clang", "/usr/bin/g++", "/home/a", arguments, content) != name);
+    QVERIFY(precompiledHeaderName("gcc", "/usr/bin/clang++", "/home/a", arguments, content) != name);
+    // relative include dirs are resolved against the working dir
+    QVERIFY(precompiledHeaderName("gcc", "/usr/bin/g++", "/home/b", arguments, content) != name);
+    QVERIFY(precompiledHeaderName("gcc", "/usr/bin/g++", "/home/a",
+                                  QStringList{"-x", "c++-header", "-I", "include", "-O2", "-"},
+                                  content) != name);
+    QVERIFY(precompiledHeaderName("gcc", "/usr/bin/g++", "/home/a", arguments,
+                                  "#include <map>\n") != name);
+    // arguments are separated
+    QVERIFY(precompiledHeaderName("gcc", "/usr/bin/g++", "/home/a", QStringList{"-Ia", "b"}, content)
+            != precompiledHeaderName("gcc", "/usr/bin/g++", "/home/a", QStringList{"-I", "ab"}, content));
+}
+
+void TestSyntaxCheck::test_coalesce_requests()
+{
+    Scheduler scheduler;
+    QVERIFY(!scheduler.running());
+    QVERIFY(scheduler.request("1"));
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Check);
+    QVERIFY(scheduler.running());
+    // only the latest request is kept
+    QVERIFY(!scheduler.request("2"));
+    QVERIFY(!scheduler.request("3"));
+    QString pending;
+    QVERIFY(scheduler.finish(pending));
+    QCOMPARE(pending, QString("3"));
+    QVERIFY(!scheduler.running());
+    QCOMPARE(scheduler.start("key3"), Scheduler::Action::Check);
+    QVERIFY(!scheduler.finish(pending));
+    QVERIFY(!scheduler.running());
+}
+
+void TestSyntaxCheck::test_replay()
+{
+    Scheduler scheduler;
+    QString pending;
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Check);
+    QVERIFY(!scheduler.finish(pending));
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Replay);
+    QVERIFY(scheduler.running());
+    QVERIFY(!scheduler.request("2"));
+    QVERIFY(scheduler.finish(pending));
+    QCOMPARE(pending, QString("2"));
+    // still replayable after a replay
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Replay);
+    scheduler.finish(pending);
+    QCOMPARE(scheduler.start("key2"), Scheduler::Action::Check);
+    scheduler.finish(pending);
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Check);
+    scheduler.finish(pending);
+    // no key, no replay
+    QCOMPARE(scheduler.start(QByteArray()), Scheduler::Action::Check);
+    scheduler.finish(pending);
+    QCOMPARE(scheduler.start(QByteArray()), Scheduler::Action::Check);
+    scheduler.finish(pending);
+}
+
+void TestSyntaxCheck::test_stop()
+{
+    Scheduler scheduler;
+    QString pending;
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Check);
+    QVERIFY(!scheduler.request("2"));
+    scheduler.stop();
+    // the kept request is dropped, and the stopped check isn't replayed
+    QVERIFY(!scheduler.finish(pending));
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Check);
+    QVERIFY(!scheduler.finish(pending));
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Replay);
+    QVERIFY(!scheduler.finish(pending));
+    // stopping while idle doesn't affect the next check
+    scheduler.stop();
+    QCOMPARE(scheduler.start("key1"), Scheduler::Action::Replay);
+    QVERIFY(!scheduler.finish(pending));
+}
@@ -0,0 +1,18 @@
+#ifndef TEST_SYNTAXCHECK_H
+#define TEST_SYNTAXCHECK_H
+#include <QObject>
+
+class TestSyntaxCheck: public QObject
+{
+    Q_OBJECT
+public:
+    TestSyntaxCheck(QObject *parent=nullptr);
+private slots:
+    void test_leading_system_includes();
+    void test_precompiled_header_name();
+    void test_coalesce_requests();
+    void test_replay();
+    void test_stop();
+};
+
+#endif
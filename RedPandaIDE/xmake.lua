@@ -79,14 +79,22 @@ target("RedPandaIDE")
         "src/customfileiconprovider.cpp",
         "src/projectoptions.cpp",
         "src/settings.cpp",
+        "src/startuptrace.cpp",
         "src/syntaxermanager.cpp",
         "src/systemconsts.cpp",
         "src/utils.cpp",
         "src/visithistorymanager.cpp",
         -- compiler
+        "src/compiler/buildtiming.cpp",
+        "src/compiler/compilecache.cpp",
+        "src/compiler/compilerprobecache.cpp",
         "src/compiler/compilerinfo.cpp",
+        "src/compiler/jsondiagnostics.cpp",
+        "src/compiler/syntaxcheck.cpp",
         -- debugger
+        "src/debugger/addressrangecache.cpp",
         "src/debugger/dapprotocol.cpp",
+        "src/debugger/dapsession.cpp",
         "src/debugger/gdbmiresultparser.cpp",
         -- parser
         "src/parser/cpppreprocessor.cpp",
@@ -126,6 +134,7 @@ target("RedPandaIDE")
         "src/cpprefacter",
         "src/editor",
         "src/editormanager",
+        "src/headerindexmanager",
         "src/iconsmanager",
         "src/main",
         "src/project",
@@ -232,6 +241,7 @@ target("RedPandaIDE")
         "src/settingsdialog/toolsgeneralwidget",
         -- widgets
         "src/widgets/aboutdialog",
+        "src/widgets/buildtimingdialog",
         "src/widgets/choosethemedialog",
         "src/widgets/cpudialog",
         "src/widgets/custommakefileinfodialog",
@@ -352,6 +352,28 @@ QStringList readFileToLines(const QString &fileName)
     return result;
 }
 
+QStringList readFileToLines(const QString &fileName, const QByteArray &encoding)
+{
+    if (encoding.isEmpty() || encoding == ENCODING_AUTO_DETECT)
+        return readFileToLines(fileName);
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly))
+        return QStringList();
+    QByteArray data = file.readAll();
+    QByteArray realEncoding = encoding;
+    if (realEncoding == ENCODING_SYSTEM_DEFAULT)
+        realEncoding = pCharsetInfoManager->getDefaultSystemEncoding();
+    if (realEncoding == ENCODING_UTF8_BOM || realEncoding == ENCODING_UTF8) {
+        if (data.startsWith("\xEF\xBB\xBF"))
+            data = data.mid(3);
+        return textToLines(QString::fromUtf8(data));
+    }
+    TextDecoder decoder(realEncoding);
+    if (!decoder.isValid())
+        return readFileToLines(fileName);
+    return textToLines(decoder.decodeUnchecked(data));
+}
+
 QByteArray readFileToByteArray(const QString &fileName)
 {
     QFile file(fileName);
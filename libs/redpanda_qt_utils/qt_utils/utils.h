@@ -112,6 +112,10 @@ void readStreamToLines(QTextStream* stream, LineProcessFunc lineFunc);
  * @return
  */
 QStringList readFileToLines(const QString& fileName);
+/**
+ * @brief read the file with the given encoding, ENCODING_AUTO_DETECT guesses it like readFileToLines(fileName)
+ */
+QStringList readFileToLines(const QString& fileName, const QByteArray& encoding);
 
 QByteArray readFileToByteArray(const QString& fileName);
 